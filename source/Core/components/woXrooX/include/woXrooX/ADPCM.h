@@ -0,0 +1,113 @@
+/*
+IMA ADPCM (4 bits per sample, 4:1 against 16-bit PCM).
+
+Each block starts from an explicit state (predictor + step index), so every block decodes on
+its own: a lost or skipped block never corrupts the ones after it.
+
+Usage:
+
+	ADPCM_state_type state = { 0 };
+	uint8_t out[ADPCM_BYTES(320)];
+
+	ADPCM_state_type block_start = state;     // store with the block
+	ADPCM_encode(&state, pcm, 320, out);
+
+	ADPCM_decode(&block_start, out, 320, pcm);
+
+Two samples per byte, first sample in the low nibble. Pure C, no RTOS or IDF headers.
+*/
+
+#ifndef woXrooX_ADPCM_H
+#define woXrooX_ADPCM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+////////////// DEFINES
+
+#define ADPCM_BYTES(samples) (((samples) + 1) / 2)
+
+////////////// TYPES
+
+typedef struct {
+	int16_t predictor;
+	uint8_t index;
+} ADPCM_state_type;
+
+////////////// GLOBALS
+
+static const int8_t ADPCM_index_table[16] = {
+	-1, -1, -1, -1, 2, 4, 6, 8,
+	-1, -1, -1, -1, 2, 4, 6, 8
+};
+
+static const int16_t ADPCM_step_table[89] = {
+	7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
+	19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+	50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+	130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+	337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+	876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+	2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+	5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+	15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+////////////// Codec
+
+// Reconstruct one sample and advance the state (shared by encoder and decoder so they never drift)
+static inline int16_t ADPCM_step(ADPCM_state_type *s, uint8_t code) {
+	int32_t step = ADPCM_step_table[s->index];
+	int32_t diff = step >> 3;
+
+	if (code & 4) diff += step;
+	if (code & 2) diff += step >> 1;
+	if (code & 1) diff += step >> 2;
+
+	int32_t predictor = s->predictor + ((code & 8) ? -diff : diff);
+	if (predictor > 32767) predictor = 32767;
+	if (predictor < -32768) predictor = -32768;
+	s->predictor = (int16_t)predictor;
+
+	int32_t index = (int32_t)s->index + ADPCM_index_table[code & 0x0F];
+	if (index < 0) index = 0;
+	if (index > 88) index = 88;
+	s->index = (uint8_t)index;
+
+	return s->predictor;
+}
+
+static inline uint8_t ADPCM_encode_sample(ADPCM_state_type *s, int16_t sample) {
+	int32_t step = ADPCM_step_table[s->index];
+	int32_t diff = (int32_t)sample - s->predictor;
+	uint8_t code = 0;
+
+	if (diff < 0) { code = 8; diff = -diff; }
+	if (diff >= step) { code |= 4; diff -= step; }
+	step >>= 1;
+	if (diff >= step) { code |= 2; diff -= step; }
+	step >>= 1;
+	if (diff >= step) code |= 1;
+
+	ADPCM_step(s, code);
+
+	return code;
+}
+
+// out must hold ADPCM_BYTES(samples)
+static void ADPCM_encode(ADPCM_state_type *s, const int16_t *pcm, size_t samples, uint8_t *out) {
+	for (size_t i = 0; i < samples; i += 2) {
+		uint8_t low = ADPCM_encode_sample(s, pcm[i]);
+		uint8_t high = (i + 1 < samples) ? ADPCM_encode_sample(s, pcm[i + 1]) : 0;
+		out[i / 2] = (uint8_t)(low | (high << 4));
+	}
+}
+
+static void ADPCM_decode(ADPCM_state_type *s, const uint8_t *in, size_t samples, int16_t *pcm) {
+	for (size_t i = 0; i < samples; ++i) {
+		uint8_t code = (i & 1) ? (in[i / 2] >> 4) : (in[i / 2] & 0x0F);
+		pcm[i] = ADPCM_step(s, code);
+	}
+}
+
+#endif
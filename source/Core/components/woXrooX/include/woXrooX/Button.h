@@ -0,0 +1,285 @@
+/*
+
+Usage:
+
+	static button_type button;
+
+	void pressed_callback(button_type *button) {
+		LED_RED_on(500, -1);
+	}
+	void released_callback(button_type *button) {
+		LED_RED_off();
+	}
+
+	button.pin = GPIO_NUM_27;
+	button.on_press = pressed_callback;
+	button.on_release = released_callback;
+
+	Button_task_start(&button);
+
+Interrupt-driven (no polling while idle, same struct and callbacks):
+
+	Button_ISR_start(&button);
+
+	// Callbacks run in the esp_timer task; button.edge_us is the time of the
+	// first edge of the settled transition (esp_timer_get_time())
+
+Or without using callbacks, handle events
+
+	for (;;) {
+		if (button.pressed) { }
+		vTaskDelay(pdMS_TO_TICKS(10));
+	}
+
+*/
+
+
+#ifndef woXrooX_Button_H
+#define woXrooX_Button_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "driver/gpio.h"
+#include "esp_timer.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+
+#include "Metrics.h"
+#include "Tasks.h"
+
+
+////////////// DEFINES
+
+// Debounce window: the level must be stable this long after the last edge
+#define BUTTON_DEBOUNCE_MS 20
+
+
+////////////// GLOBALS
+
+static const char *BUTTON_TAG = "woXrooX::BUTTON:";
+
+
+////////////// Helpers
+
+typedef struct button_type {
+	// which GPIO
+	gpio_num_t pin;
+
+	// Debounced raw level (0/1)
+	volatile uint8_t level;
+
+	// current state (true/false)
+	// 0 = released
+	// 1 = pressed
+	volatile bool pressed;
+
+	// Button task
+	TaskHandle_t task;
+
+	// ISR mode: one-shot debounce timer (NULL in polling mode)
+	esp_timer_handle_t debounce_timer;
+
+	// Time of the first raw edge after the line was last stable (us)
+	volatile uint64_t pending_edge_us;
+
+	// Time of the edge behind the current debounced state (us)
+	volatile uint64_t edge_us;
+
+	void (*on_press)(struct button_type *button);
+	void (*on_release)(struct button_type *button);
+} button_type;
+
+
+
+// Background task: debounced PRESS/RELEASE + set flag
+static void Button_task(void *arg) {
+	button_type *button = (button_type*)arg;
+
+	int last = gpio_get_level(button->pin);
+	button->level = (uint8_t)last;
+
+	// Active-low
+	button->pressed = (last == 0);
+
+	for (;;) {
+		int level = gpio_get_level(button->pin);
+
+		if (level != last) {
+
+			uint64_t edge_us = (uint64_t)esp_timer_get_time();
+
+			// Debounce 20ms
+			vTaskDelay(pdMS_TO_TICKS(BUTTON_DEBOUNCE_MS));
+
+			level = gpio_get_level(button->pin);
+
+			if (level != last) {
+				last = level;
+
+				button->level = (uint8_t)level;
+				bool new_pressed = (level == 0);
+
+				// Only act on edge
+				if (new_pressed != button->pressed) {
+					button->edge_us = edge_us;
+					button->pressed = new_pressed;
+					METRIC_INC(Button_edges);
+
+					if (button->pressed) {
+						if (button->on_press) button->on_press(button);
+					}
+
+					else {
+						if (button->on_release) button->on_release(button);
+					}
+				}
+			}
+		}
+
+		vTaskDelay(pdMS_TO_TICKS(5));
+	}
+}
+
+
+////////////// ISR mode
+
+// Runs when the line has been quiet for BUTTON_DEBOUNCE_MS
+static void Button_debounce_callback(void *arg) {
+	button_type *button = (button_type*)arg;
+
+	int level = gpio_get_level(button->pin);
+	button->level = (uint8_t)level;
+
+	bool new_pressed = (level == 0);
+	uint64_t edge_us = button->pending_edge_us;
+	button->pending_edge_us = 0;
+
+	// Bounced back to where it was: no event
+	if (new_pressed == button->pressed) return;
+
+	button->edge_us = edge_us;
+	button->pressed = new_pressed;
+	METRIC_INC(Button_edges);
+
+	if (button->pressed) {
+		if (button->on_press) button->on_press(button);
+	}
+
+	else {
+		if (button->on_release) button->on_release(button);
+	}
+}
+
+// Every edge (re)arms the one-shot, so it only fires once the contacts settle
+static void IRAM_ATTR Button_ISR(void *arg) {
+	button_type *button = (button_type*)arg;
+
+	uint64_t now = (uint64_t)esp_timer_get_time();
+	if (button->pending_edge_us == 0) button->pending_edge_us = now;
+
+	esp_timer_stop(button->debounce_timer);
+	esp_timer_start_once(button->debounce_timer, BUTTON_DEBOUNCE_MS * 1000);
+}
+
+////////////// API
+
+static void Button_task_start(button_type *button) {
+	// If already running a task, do not create new task
+	if (button->task) return;
+
+	// Configure GPIO using button->pin
+	gpio_config_t io = {
+		.pin_bit_mask = 1ULL << button->pin,
+		.mode = GPIO_MODE_INPUT,
+		.pull_up_en = GPIO_PULLUP_ENABLE,
+		.pull_down_en = GPIO_PULLDOWN_DISABLE,
+		.intr_type = GPIO_INTR_DISABLE,
+	};
+	gpio_config(&io);
+
+	// Start task
+	Tasks_create(TASK_BUTTON, Button_task, (void*)button, &button->task);
+}
+
+static void Button_task_stop(button_type *button) {
+	if (!button->task) return;
+	vTaskDelete(button->task);
+	button->task = NULL;
+}
+
+// Undo a half-done Button_ISR_start() so a later call starts from scratch
+static int Button_ISR_start_failed(button_type *button) {
+	gpio_set_intr_type(button->pin, GPIO_INTR_DISABLE);
+
+	esp_timer_delete(button->debounce_timer);
+	button->debounce_timer = NULL;
+
+	return -1;
+}
+
+// Interrupt-driven alternative to Button_task_start(): no task, no polling while idle.
+// Returns 0 on success.
+static int Button_ISR_start(button_type *button) {
+	// Already running (either mode)
+	if (button->task || button->debounce_timer) return 0;
+
+	const esp_timer_create_args_t timer_args = {
+		.callback = Button_debounce_callback,
+		.arg = (void*)button,
+		.name = "Button_debounce"
+	};
+	if (esp_timer_create(&timer_args, &button->debounce_timer) != ESP_OK) return -1;
+
+	gpio_config_t io = {
+		.pin_bit_mask = 1ULL << button->pin,
+		.mode = GPIO_MODE_INPUT,
+		.pull_up_en = GPIO_PULLUP_ENABLE,
+		.pull_down_en = GPIO_PULLDOWN_DISABLE,
+		.intr_type = GPIO_INTR_ANYEDGE,
+	};
+	esp_err_t err = gpio_config(&io);
+	if (err != ESP_OK) {
+		ESP_LOGE(BUTTON_TAG, "gpio_config failed (%d)", err);
+		return Button_ISR_start_failed(button);
+	}
+
+	int level = gpio_get_level(button->pin);
+	button->level = (uint8_t)level;
+
+	// Active-low
+	button->pressed = (level == 0);
+	button->pending_edge_us = 0;
+	button->edge_us = (uint64_t)esp_timer_get_time();
+
+	// Shared per-pin dispatch; ESP_ERR_INVALID_STATE = already installed by someone else
+	err = gpio_install_isr_service(0);
+	if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+		ESP_LOGE(BUTTON_TAG, "gpio_install_isr_service failed (%d)", err);
+		return Button_ISR_start_failed(button);
+	}
+
+	err = gpio_isr_handler_add(button->pin, Button_ISR, (void*)button);
+	if (err != ESP_OK) {
+		ESP_LOGE(BUTTON_TAG, "gpio_isr_handler_add failed (%d)", err);
+		return Button_ISR_start_failed(button);
+	}
+
+	return 0;
+}
+
+static void Button_ISR_stop(button_type *button) {
+	if (!button->debounce_timer) return;
+
+	gpio_isr_handler_remove(button->pin);
+	gpio_set_intr_type(button->pin, GPIO_INTR_DISABLE);
+
+	esp_timer_stop(button->debounce_timer);
+	esp_timer_delete(button->debounce_timer);
+	button->debounce_timer = NULL;
+}
+
+#endif
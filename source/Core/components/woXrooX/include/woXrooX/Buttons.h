@@ -0,0 +1,363 @@
+/*
+
+Multi-button manager: all buttons in one task, one event queue.
+
+Usage:
+
+	Buttons_add(GPIO_NUM_27, 0);
+	Buttons_add(GPIO_NUM_26, 1);
+	Buttons_start();
+
+	Buttons_event_type event;
+
+	for (;;) {
+		if (xQueueReceive(Buttons_queue(), &event, portMAX_DELAY) == pdTRUE) {
+			if (event.id == 0 && event.type == BUTTONS_EVENT_DOUBLE_CLICK) { }
+		}
+	}
+
+Events per button (event.ts_us = esp_timer_get_time() of the edge that caused it, see below):
+
+	PRESS, RELEASE          every debounced edge
+	CLICK                   press + release, no second press within BUTTONS_DOUBLE_CLICK_MS
+	DOUBLE_CLICK            second click within BUTTONS_DOUBLE_CLICK_MS
+	LONG_PRESS              held for BUTTONS_LONG_PRESS_MS (no CLICK follows)
+	REPEAT                  every BUTTONS_REPEAT_MS while still held after LONG_PRESS
+
+Without CONFIG_WOXROOX_BUTTONS_GESTURES only PRESS and RELEASE are reported.
+
+How it works:
+	The task reads the whole GPIO input register (GPIO_IN_REG + GPIO_IN1_REG) once per scan
+	and debounces every button at the same time with 2-bit vertical counters: a bit only
+	flips after 4 identical samples. When everything is released and settled the task blocks
+	on a notification from a shared any-edge ISR, so there is no polling while idle.
+
+	Debouncing confirms an edge 3 scans (15 ms) after the first sample that saw it. Events are
+	stamped with that first sample instead, so ts_us is within one scan of the real edge, and
+	LONG_PRESS and the double-click window are measured from there too.
+
+	A button already held at Buttons_start() reports no PRESS; its hold counts from the start,
+	so LONG_PRESS fires BUTTONS_LONG_PRESS_MS later (holding a button through boot).
+
+Buttons are active-low with internal pull-ups, same as Button.h.
+*/
+
+#ifndef woXrooX_Buttons_H
+#define woXrooX_Buttons_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+
+#include "driver/gpio.h"
+#include "soc/gpio_reg.h"
+#include "soc/soc.h"
+#include "esp_timer.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+
+#include "Metrics.h"
+#include "DLOG.h"
+#include "Tasks.h"
+
+
+////////////// DEFINES
+
+#define BUTTONS_MAX 16
+
+// Scan period; 4 stable samples → 20 ms debounce
+#define BUTTONS_SCAN_MS 5
+
+#define BUTTONS_LONG_PRESS_MS 800
+#define BUTTONS_DOUBLE_CLICK_MS 300
+#define BUTTONS_REPEAT_MS 200
+
+// Fallbacks when the Kconfig menu is not part of the build (woXrooX → Queues / Features)
+#ifndef CONFIG_WOXROOX_BUTTONS_QUEUE_LEN
+#define CONFIG_WOXROOX_BUTTONS_QUEUE_LEN 16
+#define CONFIG_WOXROOX_BUTTONS_GESTURES 1
+#endif
+
+#define BUTTONS_QUEUE_LEN CONFIG_WOXROOX_BUTTONS_QUEUE_LEN
+
+#define BUTTONS_return_OK 0
+#define BUTTONS_return_error -1
+
+
+////////////// TYPES
+
+typedef enum {
+	BUTTONS_EVENT_PRESS = 0,
+	BUTTONS_EVENT_RELEASE,
+	BUTTONS_EVENT_CLICK,
+	BUTTONS_EVENT_DOUBLE_CLICK,
+	BUTTONS_EVENT_LONG_PRESS,
+	BUTTONS_EVENT_REPEAT
+} Buttons_event_kind_type;
+
+typedef struct {
+	uint64_t ts_us;
+	uint8_t id;
+	uint8_t pin;
+	uint8_t type;
+} Buttons_event_type;
+
+typedef struct {
+	gpio_num_t pin;
+	uint8_t id;
+
+	// First sample that disagreed with the debounced state, the time stamped on the edge
+	uint64_t edge_us;
+
+	// Gesture state
+	uint64_t press_us;
+	uint64_t release_us;
+	uint64_t next_repeat_us;
+	uint8_t clicks;
+	bool long_fired;
+} Buttons_button_type;
+
+
+////////////// GLOBALS
+
+static const char *BUTTONS_TAG = "woXrooX::BUTTONS:";
+
+static Buttons_button_type Buttons[BUTTONS_MAX];
+static size_t Buttons_count = 0;
+
+// Bit n = GPIO n
+static uint64_t Buttons_mask = 0;
+
+// Vertical counters + debounced state (bit n = GPIO n pressed)
+static uint64_t Buttons_state = 0;
+static uint64_t Buttons_count0 = 0;
+static uint64_t Buttons_count1 = 0;
+
+static QueueHandle_t Buttons_events = NULL;
+static TaskHandle_t Buttons_task_handle = NULL;
+
+
+////////////// Helpers
+
+// Raw pressed bits for every GPIO in one go (active-low)
+static inline uint64_t Buttons_sample(void) {
+	uint64_t raw = (uint64_t)REG_READ(GPIO_IN_REG) | ((uint64_t)(REG_READ(GPIO_IN1_REG) & 0xFF) << 32);
+	return ~raw & Buttons_mask;
+}
+
+// One debounce step for all buttons; returns the bits that changed state. *started gets the bits
+// whose first disagreeing sample this is.
+static inline uint64_t Buttons_debounce(uint64_t sample, uint64_t *started) {
+	uint64_t delta = sample ^ Buttons_state;
+	*started = delta & ~(Buttons_count0 | Buttons_count1);
+
+	// 2-bit counter per bit, reset wherever the sample agrees with the state
+	Buttons_count1 = (Buttons_count1 ^ Buttons_count0) & delta;
+	Buttons_count0 = ~Buttons_count0 & delta;
+
+	// Counter wrapped (4 disagreeing samples in a row)
+	uint64_t toggle = delta & ~(Buttons_count0 | Buttons_count1);
+	Buttons_state ^= toggle;
+
+	return toggle;
+}
+
+static inline void Buttons_emit(const Buttons_button_type *button, Buttons_event_kind_type type, uint64_t ts_us) {
+	Buttons_event_type event = {
+		.ts_us = ts_us,
+		.id = button->id,
+		.pin = (uint8_t)button->pin,
+		.type = (uint8_t)type
+	};
+
+	// Never block the scanner; a full queue means the consumer is behind anyway
+	if (xQueueSend(Buttons_events, &event, 0) != pdTRUE) {
+		METRIC_INC(Buttons_dropped);
+		DLOG_W(BUTTONS_TAG, "Event queue full, dropped");
+	}
+}
+
+// Advance the gesture state machine; returns true while it still needs the clock
+static bool Buttons_gesture(Buttons_button_type *button, bool pressed, bool changed, uint64_t now) {
+	if (changed) METRIC_INC(Button_edges);
+
+	// Edges are stamped with their first sample, not with the scan that confirmed them
+	uint64_t edge_us = button->edge_us;
+
+	#ifndef CONFIG_WOXROOX_BUTTONS_GESTURES
+	if (changed) Buttons_emit(button, pressed ? BUTTONS_EVENT_PRESS : BUTTONS_EVENT_RELEASE, edge_us);
+
+	return false;
+	#else
+	const uint64_t long_us = (uint64_t)BUTTONS_LONG_PRESS_MS * 1000;
+	const uint64_t double_us = (uint64_t)BUTTONS_DOUBLE_CLICK_MS * 1000;
+	const uint64_t repeat_us = (uint64_t)BUTTONS_REPEAT_MS * 1000;
+
+	if (changed && pressed) {
+		button->press_us = edge_us;
+		button->long_fired = false;
+		Buttons_emit(button, BUTTONS_EVENT_PRESS, edge_us);
+	}
+
+	else if (changed && !pressed) {
+		button->release_us = edge_us;
+		Buttons_emit(button, BUTTONS_EVENT_RELEASE, edge_us);
+
+		if (!button->long_fired) {
+			button->clicks++;
+
+			if (button->clicks == 2) {
+				Buttons_emit(button, BUTTONS_EVENT_DOUBLE_CLICK, edge_us);
+				button->clicks = 0;
+			}
+		}
+	}
+
+	if (pressed) {
+		if (!button->long_fired && now - button->press_us >= long_us) {
+			button->long_fired = true;
+			button->clicks = 0;
+			button->next_repeat_us = now + repeat_us;
+			Buttons_emit(button, BUTTONS_EVENT_LONG_PRESS, now);
+		}
+
+		else if (button->long_fired && now >= button->next_repeat_us) {
+			button->next_repeat_us += repeat_us;
+			Buttons_emit(button, BUTTONS_EVENT_REPEAT, now);
+		}
+
+		return true;
+	}
+
+	// Single click confirmed once the double-click window closed
+	if (button->clicks == 1) {
+		if (now - button->release_us < double_us) return true;
+
+		button->clicks = 0;
+		Buttons_emit(button, BUTTONS_EVENT_CLICK, button->release_us);
+	}
+
+	return false;
+	#endif
+}
+
+static void IRAM_ATTR Buttons_ISR(void *arg) {
+	(void)arg;
+
+	BaseType_t woken = pdFALSE;
+	if (Buttons_task_handle) vTaskNotifyGiveFromISR(Buttons_task_handle, &woken);
+	if (woken) portYIELD_FROM_ISR();
+}
+
+
+////////////// TASK
+
+static void Buttons_task(void *arg) {
+	(void)arg;
+
+	for (;;) {
+		uint64_t now = (uint64_t)esp_timer_get_time();
+		uint64_t started;
+		uint64_t toggled = Buttons_debounce(Buttons_sample(), &started);
+
+		bool busy = (Buttons_count0 | Buttons_count1) != 0;
+
+		for (size_t i = 0; i < Buttons_count; ++i) {
+			Buttons_button_type *button = &Buttons[i];
+			uint64_t bit = 1ULL << button->pin;
+
+			if (started & bit) button->edge_us = now;
+
+			if (Buttons_gesture(button, (Buttons_state & bit) != 0, (toggled & bit) != 0, now)) busy = true;
+		}
+
+		// Nothing pressed, nothing settling, no gesture pending: sleep until an edge
+		if (!busy) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+		else vTaskDelay(pdMS_TO_TICKS(BUTTONS_SCAN_MS));
+	}
+}
+
+
+////////////// API
+
+// Register a button before Buttons_start(). id is reported back in every event.
+static int Buttons_add(gpio_num_t pin, uint8_t id) {
+	if (Buttons_task_handle) return BUTTONS_return_error;
+	if (Buttons_count >= BUTTONS_MAX) return BUTTONS_return_error;
+	if (!GPIO_IS_VALID_GPIO(pin)) return BUTTONS_return_error;
+
+	Buttons[Buttons_count] = (Buttons_button_type){ .pin = pin, .id = id };
+	Buttons_count++;
+	Buttons_mask |= 1ULL << pin;
+
+	return BUTTONS_return_OK;
+}
+
+// Undo a half-done Buttons_start() so a later call starts from scratch; added = handlers in place
+static int Buttons_start_failed(size_t added) {
+	for (size_t i = 0; i < added; ++i) gpio_isr_handler_remove(Buttons[i].pin);
+	for (size_t i = 0; i < Buttons_count; ++i) gpio_set_intr_type(Buttons[i].pin, GPIO_INTR_DISABLE);
+
+	return BUTTONS_return_error;
+}
+
+static int Buttons_start(void) {
+	if (Buttons_task_handle) return BUTTONS_return_OK;
+	if (Buttons_count == 0) return BUTTONS_return_error;
+
+	if (!Buttons_events) Buttons_events = xQueueCreate(BUTTONS_QUEUE_LEN, sizeof(Buttons_event_type));
+	if (!Buttons_events) return BUTTONS_return_error;
+
+	gpio_config_t io = {
+		.pin_bit_mask = Buttons_mask,
+		.mode = GPIO_MODE_INPUT,
+		.pull_up_en = GPIO_PULLUP_ENABLE,
+		.pull_down_en = GPIO_PULLDOWN_DISABLE,
+		.intr_type = GPIO_INTR_ANYEDGE,
+	};
+	if (gpio_config(&io) != ESP_OK) return BUTTONS_return_error;
+
+	// Start from the current levels so held buttons do not fire PRESS at boot; their hold counts
+	// from now, not from 0 (which would fire LONG_PRESS on the first scan)
+	Buttons_state = Buttons_sample();
+
+	uint64_t now = (uint64_t)esp_timer_get_time();
+	for (size_t i = 0; i < Buttons_count; ++i) Buttons[i].press_us = now;
+
+	// Shared per-pin dispatch; ESP_ERR_INVALID_STATE = already installed by someone else
+	esp_err_t err = gpio_install_isr_service(0);
+	if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+		ESP_LOGE(BUTTONS_TAG, "gpio_install_isr_service failed (%d)", err);
+		return Buttons_start_failed(0);
+	}
+
+	// Handlers before the task: an edge in between finds no task to wake and the first scan reads it
+	for (size_t i = 0; i < Buttons_count; ++i) {
+		err = gpio_isr_handler_add(Buttons[i].pin, Buttons_ISR, NULL);
+		if (err != ESP_OK) {
+			ESP_LOGE(BUTTONS_TAG, "gpio_isr_handler_add(%d) failed (%d)", Buttons[i].pin, err);
+			return Buttons_start_failed(i);
+		}
+	}
+
+	if (Tasks_create(TASK_BUTTONS, Buttons_task, NULL, &Buttons_task_handle) != 0) {
+		Buttons_task_handle = NULL;
+		return Buttons_start_failed(Buttons_count);
+	}
+
+	return BUTTONS_return_OK;
+}
+
+static QueueHandle_t Buttons_queue(void) {
+	return Buttons_events;
+}
+
+// Debounced pressed state of a registered pin
+static inline bool Buttons_pressed(gpio_num_t pin) {
+	return (Buttons_state >> pin) & 1;
+}
+
+#endif
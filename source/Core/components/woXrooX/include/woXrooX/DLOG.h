@@ -0,0 +1,260 @@
+/*
+Deferred binary logging for hot paths.
+
+ESP_LOGx formats and writes to the UART in the caller's context. Inside the audio path that
+means blocking and jitter exactly when things go wrong (a flapping link fails dozens of sends a second).
+DLOG_x instead stores a 32-byte record — timestamp, call-site pointer, up to 4 raw 32-bit
+arguments — in a lock-free ring. A low-priority task formats and prints them later.
+
+Usage:
+#include "woXrooX/DLOG.h"
+
+DLOG_start();
+
+DLOG_W(WS_TAG, "send_bin failed (%d), seq=%u", rc, frame.seq);
+
+Rules:
+	- At most DLOG_ARGS arguments, each a 32-bit integer; cast pointers to uintptr_t (no float / 64-bit).
+	- %s only with strings that live forever (literals, static buffers).
+	- The level is filtered at the call site against LOG_LOCAL_LEVEL, same as ESP_LOGx; the component
+	  sets it from woXrooX → Log level, so calls above it are not compiled in at all.
+
+Rate limiting:
+	Every call site allows DLOG_SITE_BURST records per DLOG_SITE_WINDOW_MS; the rest are counted,
+	not stored, and the next record that gets through reports "(+N suppressed)".
+
+The call-site pointer doubles as the format ID: a host tool can resolve it against the ELF
+instead of running the drain task, using DLOG_pop() to fetch raw records.
+*/
+
+#ifndef woXrooX_DLOG_H
+#define woXrooX_DLOG_H
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "esp_cpu.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+#include "Tasks.h"
+
+////////////// DEFINES
+
+// Records in the ring (power of two)
+#define DLOG_RING 64
+
+#define DLOG_ARGS 4
+
+#define DLOG_SITE_WINDOW_MS 1000
+#define DLOG_SITE_BURST 5
+
+// One printed record, newline included; longer lines are cut short
+#define DLOG_LINE_MAX 192
+
+// Drain task poll period (placement: Tasks.h)
+#define DLOG_IDLE_MS 100
+
+// Count the arguments (0..DLOG_ARGS) of a call
+#define DLOG_NARGS(...) DLOG_NARGS_(0, ##__VA_ARGS__, 4, 3, 2, 1, 0)
+#define DLOG_NARGS_(_0, _1, _2, _3, _4, n, ...) n
+
+#define DLOG_AT(log_level, log_tag, log_format, ...) do { \
+	if (LOG_LOCAL_LEVEL >= (log_level)) { \
+		static DLOG_site_type DLOG_site = { .format = (log_format), .level = (log_level) }; \
+		DLOG_site.tag = (log_tag); \
+		const uint32_t DLOG_arguments[DLOG_ARGS + 1] = { 0, ##__VA_ARGS__ }; \
+		DLOG_write(&DLOG_site, &DLOG_arguments[1], DLOG_NARGS(__VA_ARGS__)); \
+	} \
+} while (0)
+
+#define DLOG_E(tag, format, ...) DLOG_AT(ESP_LOG_ERROR, tag, format, ##__VA_ARGS__)
+#define DLOG_W(tag, format, ...) DLOG_AT(ESP_LOG_WARN, tag, format, ##__VA_ARGS__)
+#define DLOG_I(tag, format, ...) DLOG_AT(ESP_LOG_INFO, tag, format, ##__VA_ARGS__)
+#define DLOG_D(tag, format, ...) DLOG_AT(ESP_LOG_DEBUG, tag, format, ##__VA_ARGS__)
+
+////////////// TYPES
+
+// One per call site, static
+typedef struct {
+	const char *format;
+	const char *tag;
+	esp_log_level_t level;
+
+	// Rate limiter
+	uint32_t window_start_ms;
+	uint32_t window_count;
+	uint32_t suppressed;
+} DLOG_site_type;
+
+typedef struct {
+	// Ring bookkeeping, not log data: lap sequence minus the slot index, so all-zero is "empty"
+	volatile uint32_t sequence;
+
+	uint32_t ts_ms;
+	const DLOG_site_type *site;
+	uint16_t suppressed;
+	uint8_t argument_count;
+	uint8_t core;
+	uint32_t arguments[DLOG_ARGS];
+} DLOG_record_type;
+
+////////////// GLOBALS
+
+static DLOG_record_type DLOG_records[DLOG_RING];
+
+// Producers claim positions at head; the single consumer frees them at tail
+static volatile uint32_t DLOG_head = 0;
+static uint32_t DLOG_tail = 0;
+
+// Records lost because the ring was full
+static volatile uint32_t DLOG_dropped = 0;
+
+static TaskHandle_t DLOG_task_handle = NULL;
+
+////////////// Ring
+
+// Per-site fixed window. Races between cores only make the limit slightly fuzzy.
+static inline bool DLOG_allow(DLOG_site_type *site, uint32_t now_ms) {
+	if (now_ms - site->window_start_ms >= DLOG_SITE_WINDOW_MS) {
+		site->window_start_ms = now_ms;
+		site->window_count = 0;
+	}
+
+	if (site->window_count >= DLOG_SITE_BURST) {
+		__atomic_fetch_add(&site->suppressed, 1, __ATOMIC_RELAXED);
+		return false;
+	}
+
+	site->window_count++;
+	return true;
+}
+
+// Lock-free multi-producer write (bounded queue with per-slot sequence numbers). Never blocks.
+static void DLOG_write(DLOG_site_type *site, const uint32_t *arguments, uint8_t argument_count) {
+	uint32_t now_ms = (uint32_t)(esp_timer_get_time() / 1000);
+	if (!DLOG_allow(site, now_ms)) return;
+
+	uint32_t position = __atomic_load_n(&DLOG_head, __ATOMIC_RELAXED);
+	DLOG_record_type *record;
+
+	for (;;) {
+		record = &DLOG_records[position & (DLOG_RING - 1)];
+		int32_t difference = (int32_t)(__atomic_load_n(&record->sequence, __ATOMIC_ACQUIRE) + (position & (DLOG_RING - 1)) - position);
+
+		// Free slot: claim it (on failure `position` is reloaded and we retry)
+		if (difference == 0) {
+			if (__atomic_compare_exchange_n(&DLOG_head, &position, position + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break;
+		}
+
+		// Slot still holds an unread record: full
+		else if (difference < 0) {
+			__atomic_fetch_add(&DLOG_dropped, 1, __ATOMIC_RELAXED);
+			return;
+		}
+
+		else position = __atomic_load_n(&DLOG_head, __ATOMIC_RELAXED);
+	}
+
+	uint32_t suppressed = __atomic_exchange_n(&site->suppressed, 0, __ATOMIC_RELAXED);
+
+	record->ts_ms = now_ms;
+	record->site = site;
+	record->suppressed = suppressed > UINT16_MAX ? UINT16_MAX : (uint16_t)suppressed;
+	record->argument_count = argument_count;
+	record->core = (uint8_t)esp_cpu_get_core_id();
+	for (uint8_t i = 0; i < argument_count; ++i) record->arguments[i] = arguments[i];
+
+	// Publish
+	__atomic_store_n(&record->sequence, position + 1 - (position & (DLOG_RING - 1)), __ATOMIC_RELEASE);
+}
+
+// Single consumer. Returns false when the ring is empty.
+static bool DLOG_pop(DLOG_record_type *out) {
+	uint32_t index = DLOG_tail & (DLOG_RING - 1);
+	DLOG_record_type *record = &DLOG_records[index];
+	if (__atomic_load_n(&record->sequence, __ATOMIC_ACQUIRE) != DLOG_tail + 1 - index) return false;
+
+	*out = *record;
+
+	// Hand the slot back to producers one lap later
+	__atomic_store_n(&record->sequence, DLOG_tail + DLOG_RING - index, __ATOMIC_RELEASE);
+	DLOG_tail++;
+
+	return true;
+}
+
+////////////// Drain
+
+// Append to a line of DLOG_LINE_MAX, keeping the last 2 bytes for "\n" and the terminator
+static void DLOG_append(char *line, size_t *length, const char *format, ...) {
+	if (*length >= DLOG_LINE_MAX - 2) return;
+
+	va_list args;
+	va_start(args, format);
+	int n = vsnprintf(line + *length, DLOG_LINE_MAX - 1 - *length, format, args);
+	va_end(args);
+
+	if (n <= 0) return;
+	*length = (*length + (size_t)n < DLOG_LINE_MAX - 2) ? *length + (size_t)n : DLOG_LINE_MAX - 2;
+}
+
+static void DLOG_print(const DLOG_record_type *r) {
+	const DLOG_site_type *site = r->site;
+	const uint32_t *a = r->arguments;
+
+	static const char letters[] = { 'N', 'E', 'W', 'I', 'D', 'V' };
+	char letter = (site->level < sizeof(letters)) ? letters[site->level] : '?';
+
+	char line[DLOG_LINE_MAX];
+	size_t length = 0;
+
+	// Same layout as ESP_LOGx, with the capture time instead of the print time
+	DLOG_append(line, &length, "%c (%u) %s: ", letter, (unsigned)r->ts_ms, site->tag);
+	DLOG_append(line, &length, site->format, a[0], a[1], a[2], a[3]);
+	if (r->suppressed) DLOG_append(line, &length, " (+%u suppressed)", (unsigned)r->suppressed);
+
+	line[length++] = '\n';
+	line[length] = '\0';
+
+	// One write per record, so other tasks' logs cannot land inside it
+	esp_log_write(site->level, site->tag, "%s", line);
+}
+
+static void DLOG_task(void *arg) {
+	(void)arg;
+
+	uint32_t dropped_reported = 0;
+	DLOG_record_type record;
+
+	for (;;) {
+		while (DLOG_pop(&record)) DLOG_print(&record);
+
+		uint32_t dropped = DLOG_dropped;
+		if (dropped != dropped_reported) {
+			esp_log_write(ESP_LOG_WARN, "DLOG", "W DLOG: ring full, %u records lost\n", (unsigned)(dropped - dropped_reported));
+			dropped_reported = dropped;
+		}
+
+		vTaskDelay(pdMS_TO_TICKS(DLOG_IDLE_MS));
+	}
+}
+
+////////////// API
+
+// Drain task printing to the normal log output. Without it, records wait for DLOG_pop().
+static int DLOG_start(void) {
+	if (DLOG_task_handle) return 0;
+	return Tasks_create(TASK_DLOG, DLOG_task, NULL, &DLOG_task_handle);
+}
+
+static uint32_t DLOG_dropped_count(void) {
+	return DLOG_dropped;
+}
+
+#endif
@@ -0,0 +1,153 @@
+/*
+Polyphase FIR decimator: integer factor, int16 in and out, Q15 taps.
+
+Only every factor-th output is computed, from the last `length` inputs, which is the polyphase
+form folded into a single loop: length / factor = DECIMATOR_TAPS_PER_PHASE multiplies per input
+sample regardless of the factor.
+
+Usage:
+
+	static Decimator_type decimator;
+	Decimator_init(&decimator, 48000, 16000);   // factor 3, 96 taps
+
+	int16_t y;
+	if (Decimator_push(&decimator, x, &y)) {
+		// y is the next 16 kHz sample
+	}
+
+Low-pass: windowed sinc (Blackman) cut off at the output Nyquist frequency, with the transition
+band between 0.4 and 0.6 × output rate, so nothing folds back below 0.4 × output rate. The stop
+band is about -74 dB. Taps are rounded so they sum to exactly 1.0 (unity DC gain). Linear phase:
+the output lags the input by Decimator_delay_us(). Factor 1 passes samples through untouched.
+
+Pure C, no RTOS or IDF headers.
+*/
+
+#ifndef woXrooX_Decimator_H
+#define woXrooX_Decimator_H
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+////////////// DEFINES
+
+#define DECIMATOR_TAPS_PER_PHASE 32
+
+#define DECIMATOR_FACTOR_MAX 6
+#define DECIMATOR_TAPS_MAX (DECIMATOR_TAPS_PER_PHASE * DECIMATOR_FACTOR_MAX)
+
+#define DECIMATOR_return_OK 0
+#define DECIMATOR_return_error -1
+
+////////////// TYPES
+
+typedef struct {
+	int16_t taps[DECIMATOR_TAPS_MAX];
+
+	// Last `length` inputs, written twice (at pos and pos + length) so they are always contiguous
+	int16_t history[2 * DECIMATOR_TAPS_MAX];
+
+	uint32_t rate_in;
+	uint16_t length;
+	uint16_t pos;
+	uint8_t factor;
+	uint8_t phase;
+} Decimator_type;
+
+////////////// Helpers
+
+// Tap n of the unnormalised prototype: Blackman-windowed sinc, cut-off as a fraction of the input rate
+static double Decimator_prototype(int n, int length, double cutoff) {
+	const double pi = 3.14159265358979323846;
+
+	double t = (double)n - (double)(length - 1) / 2.0;
+	double sinc = (t == 0.0) ? 2.0 * cutoff : sin(2.0 * pi * cutoff * t) / (pi * t);
+	double window = 0.42 - 0.5 * cos(2.0 * pi * n / (length - 1)) + 0.08 * cos(4.0 * pi * n / (length - 1));
+
+	return sinc * window;
+}
+
+////////////// API
+
+// Runs on MIC_RX's stack at a runtime reconfigure: taps are computed twice (sum, then quantise)
+// rather than kept in a DECIMATOR_TAPS_MAX double array (1.5 KB)
+static int Decimator_init(Decimator_type *d, uint32_t rate_in, uint32_t rate_out) {
+	if (!d || rate_out == 0 || rate_in % rate_out != 0) return DECIMATOR_return_error;
+
+	uint32_t factor = rate_in / rate_out;
+	if (factor < 1 || factor > DECIMATOR_FACTOR_MAX) return DECIMATOR_return_error;
+
+	memset(d, 0, sizeof(*d));
+	d->rate_in = rate_in;
+	d->factor = (uint8_t)factor;
+	d->length = (uint16_t)(factor == 1 ? 1 : DECIMATOR_TAPS_PER_PHASE * factor);
+
+	if (factor == 1) {
+		d->taps[0] = 32767;
+		return DECIMATOR_return_OK;
+	}
+
+	double cutoff = 0.5 / (double)factor;
+	double sum = 0.0;
+
+	for (int n = 0; n < d->length; ++n) sum += Decimator_prototype(n, d->length, cutoff);
+
+	// Normalise, quantise, then put the rounding error on the centre tap(s)
+	int32_t total = 0;
+	for (int n = 0; n < d->length; ++n) {
+		d->taps[n] = (int16_t)lround(Decimator_prototype(n, d->length, cutoff) / sum * 32768.0);
+		total += d->taps[n];
+	}
+
+	int centre = d->length / 2;
+	d->taps[centre] = (int16_t)(d->taps[centre] + (32768 - total) / 2);
+	d->taps[centre - 1] = (int16_t)(d->taps[centre - 1] + (32768 - total) - (32768 - total) / 2);
+
+	return DECIMATOR_return_OK;
+}
+
+// Feed one input sample; true when *out holds the next output sample
+static inline bool Decimator_push(Decimator_type *d, int16_t x, int16_t *out) {
+	if (d->factor == 1) {
+		*out = x;
+		return true;
+	}
+
+	d->history[d->pos] = x;
+	d->history[d->pos + d->length] = x;
+	if (++d->pos == d->length) d->pos = 0;
+
+	if (++d->phase < d->factor) return false;
+	d->phase = 0;
+
+	// Oldest input first; taps are symmetric so no reversal is needed
+	// Σ|taps| stays below 2.0 in Q15 for every factor, so a full-scale input cannot overflow int32
+	const int16_t *h = d->history + d->pos;
+	int32_t acc = 1 << 14;
+
+	for (int k = 0; k < d->length; ++k) acc += (int32_t)d->taps[k] * h[k];
+
+	acc >>= 15;
+	if (acc > 32767) acc = 32767;
+	if (acc < -32768) acc = -32768;
+
+	*out = (int16_t)acc;
+
+	return true;
+}
+
+// Group delay: an output sample describes the input from this long before it was produced
+static inline uint32_t Decimator_delay_us(const Decimator_type *d) {
+	return (uint32_t)((uint64_t)(d->length - 1) * 1000000ULL / (2ULL * d->rate_in));
+}
+
+static inline void Decimator_reset(Decimator_type *d) {
+	memset(d->history, 0, sizeof(d->history));
+	d->pos = 0;
+	d->phase = 0;
+}
+
+#endif
@@ -0,0 +1,130 @@
+/*
+Broadcast ring of audio frames: one writer, any number of readers, no locks and no per-reader copy.
+
+The writer copies each frame into the next slot once; every reader keeps its own cursor and uses
+the slot in place (e.g. hands slot->pcm straight to send()). Each slot carries a version (seqlock):
+odd while being written, 2 × frame number once stable. A reader checks it before and after using
+the slot; if the writer came round in between, Frame_ring_release() says so and the data must be
+treated as torn. That can only happen to a reader FRAME_RING_SLOTS frames behind.
+
+Usage:
+
+	static Frame_ring_type ring;
+
+	// Writer (one task)
+	Frame_ring_publish(&ring, seq, ts_us, sample_rate, pcm, samples);
+
+	// Reader
+	uint32_t cursor = Frame_ring_head(&ring) + 1;
+	const Frame_ring_slot_type *slot;
+
+	switch (Frame_ring_acquire(&ring, cursor, &slot)) {
+		case FRAME_RING_return_OK:
+			send(slot->pcm, slot->samples * 2);
+			if (!Frame_ring_release(&ring, slot, cursor)) {
+				// torn: what was sent is garbage, drop the consumer
+			}
+			cursor++;
+			break;
+
+		case FRAME_RING_return_empty: wait for the writer; break;
+		case FRAME_RING_return_lapped: cursor = Frame_ring_head(&ring); break;
+	}
+
+A zero-initialised ring is valid. Pure C (GCC __atomic builtins), no RTOS or IDF headers.
+*/
+
+#ifndef woXrooX_Frame_ring_H
+#define woXrooX_Frame_ring_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+////////////// DEFINES
+
+#ifndef FRAME_RING_SLOTS
+#define FRAME_RING_SLOTS 16
+#endif
+
+#ifndef FRAME_RING_SAMPLES_MAX
+#define FRAME_RING_SAMPLES_MAX 640
+#endif
+
+#define FRAME_RING_return_OK 0
+#define FRAME_RING_return_empty -1
+#define FRAME_RING_return_lapped -2
+
+////////////// TYPES
+
+typedef struct {
+	// 2 × n once frame n is complete, odd while it is being written
+	uint32_t version;
+
+	uint32_t seq;
+	uint64_t ts_us;
+	uint32_t sample_rate;
+	uint16_t samples;
+	int16_t pcm[FRAME_RING_SAMPLES_MAX];
+} Frame_ring_slot_type;
+
+typedef struct {
+	Frame_ring_slot_type slots[FRAME_RING_SLOTS];
+
+	// Number of the newest complete frame (1-based; 0 = nothing yet)
+	uint32_t head;
+} Frame_ring_type;
+
+////////////// Writer
+
+static void Frame_ring_publish(Frame_ring_type *ring, uint32_t seq, uint64_t ts_us, uint32_t sample_rate, const int16_t *pcm, uint16_t samples) {
+	if (samples > FRAME_RING_SAMPLES_MAX) samples = FRAME_RING_SAMPLES_MAX;
+
+	uint32_t n = ring->head + 1;
+	Frame_ring_slot_type *slot = &ring->slots[n % FRAME_RING_SLOTS];
+
+	__atomic_store_n(&slot->version, 2 * n - 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	slot->seq = seq;
+	slot->ts_us = ts_us;
+	slot->sample_rate = sample_rate;
+	slot->samples = samples;
+	memcpy(slot->pcm, pcm, (size_t)samples * sizeof(int16_t));
+
+	__atomic_store_n(&slot->version, 2 * n, __ATOMIC_RELEASE);
+	__atomic_store_n(&ring->head, n, __ATOMIC_RELEASE);
+}
+
+////////////// Readers
+
+static inline uint32_t Frame_ring_head(const Frame_ring_type *ring) {
+	return __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+}
+
+// Frame number `cursor`, in place. lapped: it was overwritten (or is being), move the cursor up.
+static int Frame_ring_acquire(const Frame_ring_type *ring, uint32_t cursor, const Frame_ring_slot_type **out) {
+	uint32_t head = Frame_ring_head(ring);
+
+	if (cursor == 0 || (int32_t)(cursor - head) > 0) return FRAME_RING_return_empty;
+	if (head - cursor >= FRAME_RING_SLOTS - 1) return FRAME_RING_return_lapped;
+
+	const Frame_ring_slot_type *slot = &ring->slots[cursor % FRAME_RING_SLOTS];
+	if (__atomic_load_n(&slot->version, __ATOMIC_ACQUIRE) != 2 * cursor) return FRAME_RING_return_lapped;
+
+	*out = slot;
+
+	return FRAME_RING_return_OK;
+}
+
+// Done with the slot from Frame_ring_acquire(); false if the writer reused it meanwhile (torn)
+static bool Frame_ring_release(const Frame_ring_type *ring, const Frame_ring_slot_type *slot, uint32_t cursor) {
+	(void)ring;
+
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+	return __atomic_load_n(&slot->version, __ATOMIC_RELAXED) == 2 * cursor;
+}
+
+#endif
@@ -0,0 +1,451 @@
+#ifndef woXrooX_HTTP_CLIENT_H
+#define woXrooX_HTTP_CLIENT_H
+
+/*
+Usage:
+	char *body = NULL;
+	int status = 0;
+
+	// GET
+	if (HTTP_GET("http://127.0.0.1:8000/", &body, &status) == 0) {
+		ESP_LOGI("woXrooX::HTTP_CLIENT", "status=%d\n%s", status, body);
+		free(body);
+	}
+
+	// POST JSON
+	if (HTTP_POST_JSON("http://127.0.0.1:8000/api", "{\"for\":\"woXrooX.com\"}", &body, &status) == 0) {
+		ESP_LOGI("woXrooX::HTTP_CLIENT", "status=%d\n%s", status, body);
+		free(body);
+	}
+
+Return values:
+0 = success
+-1 = invalid arg
+-2 = no memory
+-3 = client init failed
+-4 = open/connect failed
+-5 = write failed
+-6 = read failed
+-7 = response body larger than HTTP_BODY_MAX
+
+HTTPS:
+- Use https:// URLs and enable the cert bundle in menuconfig:
+  Component config → mbedTLS → Certificate Bundle → Enable trusted root certificates bundle
+- Trust anchors come from the shared context in TLS.h (bundle or pinned CA).
+- With woXrooX → Features → https:// off, TLS.h is left out and https:// URLs return -1.
+
+Connection reuse:
+- One keep-alive client is cached per scheme://host:port (HTTP_CONNECTION_CACHE_SIZE slots).
+- Follow-up requests to the same host skip TCP + TLS setup entirely; see TLS_stats().
+- HTTP_close_all() drops every cached connection (e.g. on Wi-Fi loss).
+*/
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+
+#include "esp_http_client.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+#include "Metrics.h"
+
+////////////// DEFINES
+
+// Fallbacks when the Kconfig menu is not part of the build (woXrooX → Queues / Features)
+#ifndef CONFIG_WOXROOX_HTTP_CONNECTIONS
+#define CONFIG_WOXROOX_HTTP_CONNECTIONS 2
+#define CONFIG_WOXROOX_HTTPS 1
+#endif
+
+// Number of hosts we keep a live connection to
+#define HTTP_CONNECTION_CACHE_SIZE CONFIG_WOXROOX_HTTP_CONNECTIONS
+
+#ifdef CONFIG_WOXROOX_HTTPS
+#include "TLS.h"
+#endif
+
+// "https://" + host + ":" + port
+#define HTTP_ORIGIN_MAX 96
+
+#define HTTP_TIMEOUT_MS 10000
+
+// Used instead while WiFi_link.h reports a degraded link, so slow is not mistaken for dead
+#define HTTP_TIMEOUT_DEGRADED_MS 20000
+
+// Largest response body we buffer; anything bigger is refused instead of growing the heap
+#define HTTP_BODY_MAX 16384
+
+// First allocation when the server does not send Content-Length
+#define HTTP_BODY_CHUNK 1024
+
+////////////// TYPES
+
+typedef struct {
+	char origin[HTTP_ORIGIN_MAX];
+	esp_http_client_handle_t client;
+
+	// Owned by a request right now
+	bool busy;
+
+	// At least one request completed on it, so the socket (and TLS session) is up
+	bool connected;
+
+	// For LRU eviction
+	uint64_t last_used_us;
+} HTTP_connection_type;
+
+////////////// GLOBALS
+
+static const char *HTTP_CLIENT_TAG = "woXrooX::HTTP_client";
+
+static HTTP_connection_type HTTP_connections[HTTP_CONNECTION_CACHE_SIZE];
+
+static portMUX_TYPE HTTP_connections_lock = portMUX_INITIALIZER_UNLOCKED;
+
+////////////// Connection cache
+
+// Copies "scheme://host[:port]" out of URL. Returns 0 on success.
+static int HTTP_origin_of(const char *URL, char *out, size_t cap) {
+	const char *p = strstr(URL, "://");
+	if (!p) return -1;
+
+	p += 3;
+	while (*p && *p != '/' && *p != '?' && *p != '#') p++;
+
+	size_t length = (size_t)(p - URL);
+	if (length + 1 > cap) return -1;
+
+	memcpy(out, URL, length);
+	out[length] = '\0';
+
+	return 0;
+}
+
+// Returns a client for URL's origin, reusing a cached keep-alive connection when possible.
+// *slot is set to the cache index, or -1 if the client is not cached (caller must clean it up).
+// *reused tells whether the connection is already established.
+static esp_http_client_handle_t HTTP_connection_acquire(const char *URL, int *slot, bool *reused) {
+	char origin[HTTP_ORIGIN_MAX];
+	*slot = -1;
+	*reused = false;
+
+	if (HTTP_origin_of(URL, origin, sizeof(origin)) != 0) origin[0] = '\0';
+
+	int free_slot = -1;
+	int lru_slot = -1;
+	esp_http_client_handle_t hit = NULL;
+	esp_http_client_handle_t evicted = NULL;
+
+	portENTER_CRITICAL(&HTTP_connections_lock);
+
+	for (int i = 0; origin[0] && i < HTTP_CONNECTION_CACHE_SIZE; ++i) {
+		HTTP_connection_type *c = &HTTP_connections[i];
+		if (c->busy) continue;
+
+		if (c->client && strcmp(c->origin, origin) == 0) {
+			c->busy = true;
+			hit = c->client;
+			*slot = i;
+			*reused = c->connected;
+			break;
+		}
+
+		if (!c->client && free_slot < 0) free_slot = i;
+		if (c->client && (lru_slot < 0 || c->last_used_us < HTTP_connections[lru_slot].last_used_us)) lru_slot = i;
+	}
+
+	// No match: take a free slot or evict the least recently used idle connection
+	if (!hit && origin[0]) {
+		int target = (free_slot >= 0) ? free_slot : lru_slot;
+
+		if (target >= 0) {
+			HTTP_connection_type *c = &HTTP_connections[target];
+			evicted = c->client;
+			c->client = NULL;
+			c->connected = false;
+			c->busy = true;
+			strcpy(c->origin, origin);
+			*slot = target;
+		}
+	}
+
+	portEXIT_CRITICAL(&HTTP_connections_lock);
+
+	if (hit) {
+		esp_http_client_set_url(hit, URL);
+		return hit;
+	}
+
+	if (evicted) esp_http_client_cleanup(evicted);
+
+	esp_http_client_config_t configuration = {
+		.url = URL,
+		.timeout_ms = HTTP_TIMEOUT_MS,
+		.keep_alive_enable = true,
+	};
+
+	#ifdef CONFIG_WOXROOX_HTTPS
+	if (strncmp(URL, "https://", 8) == 0) TLS_HTTP_config_apply(&configuration);
+	#endif
+
+	esp_http_client_handle_t client = esp_http_client_init(&configuration);
+
+	if (*slot >= 0) {
+		portENTER_CRITICAL(&HTTP_connections_lock);
+
+		if (client) HTTP_connections[*slot].client = client;
+		else HTTP_connections[*slot].busy = false;
+
+		portEXIT_CRITICAL(&HTTP_connections_lock);
+
+		if (!client) *slot = -1;
+	}
+
+	return client;
+}
+
+// keep = connection is in a clean state and may serve the next request
+static void HTTP_connection_release(esp_http_client_handle_t client, int slot, bool keep) {
+	if (slot < 0) {
+		esp_http_client_close(client);
+		esp_http_client_cleanup(client);
+		return;
+	}
+
+	portENTER_CRITICAL(&HTTP_connections_lock);
+
+	HTTP_connection_type *c = &HTTP_connections[slot];
+	c->busy = false;
+	c->connected = keep;
+	c->last_used_us = (uint64_t)esp_timer_get_time();
+	if (!keep) c->client = NULL;
+
+	portEXIT_CRITICAL(&HTTP_connections_lock);
+
+	if (!keep) {
+		esp_http_client_close(client);
+		esp_http_client_cleanup(client);
+	}
+}
+
+// Drop every idle cached connection (busy ones are dropped on release).
+static void HTTP_close_all(void) {
+	esp_http_client_handle_t drop[HTTP_CONNECTION_CACHE_SIZE] = {0};
+
+	portENTER_CRITICAL(&HTTP_connections_lock);
+
+	for (int i = 0; i < HTTP_CONNECTION_CACHE_SIZE; ++i) {
+		HTTP_connection_type *c = &HTTP_connections[i];
+		if (c->busy || !c->client) continue;
+
+		drop[i] = c->client;
+		c->client = NULL;
+		c->connected = false;
+	}
+
+	portEXIT_CRITICAL(&HTTP_connections_lock);
+
+	for (int i = 0; i < HTTP_CONNECTION_CACHE_SIZE; ++i) if (drop[i]) esp_http_client_cleanup(drop[i]);
+}
+
+////////////// Body
+
+// content_length < 0 = unknown (chunked); then the buffer grows by doubling up to HTTP_BODY_MAX
+static int HTTP_read_all(esp_http_client_handle_t client, int64_t content_length, char **out_body, size_t *out_length) {
+	if (!out_body) return -1;
+	if (content_length > HTTP_BODY_MAX) return -7;
+
+	// Exact size when known, so the common case is one allocation and no realloc copies
+	size_t cap = (content_length >= 0) ? (size_t)content_length + 1 : HTTP_BODY_CHUNK;
+	size_t length = 0;
+	char *buffer = (char *)malloc(cap);
+
+	if (!buffer) return -2;
+
+	for (;;) {
+		if (content_length >= 0 && length == (size_t)content_length) break;
+
+		if (length + 1 >= cap) {
+			// Full at HTTP_BODY_MAX: fine if that was the whole body, too long if anything follows
+			if (cap > HTTP_BODY_MAX) {
+				char scratch[16];
+				int n = esp_http_client_read(client, scratch, sizeof(scratch));
+				if (n == 0) break;
+
+				free(buffer);
+				return (n < 0) ? -6 : -7;
+			}
+
+			size_t new_cap = cap * 2;
+			if (new_cap > HTTP_BODY_MAX + 1) new_cap = HTTP_BODY_MAX + 1;
+			char *tmp = (char *)realloc(buffer, new_cap);
+			if (!tmp) { free(buffer); return -2; }
+			buffer = tmp;
+			cap = new_cap;
+		}
+
+		int n = esp_http_client_read(client, buffer + length, cap - length - 1);
+
+		if (n < 0) { free(buffer); return -6; }
+		if (n == 0) break;
+		length += (size_t)n;
+	}
+
+	buffer[length] = '\0';
+	*out_body = buffer;
+	if (out_length) *out_length = length;
+
+	return 0;
+}
+
+////////////// Request
+
+// One request/response on a (possibly reused) connection.
+// JSON_body == NULL → GET, otherwise POST application/json.
+static int HTTP_request_once(
+	const char *URL,
+	const char *JSON_body,
+	char **out_body,
+	int *out_status_code,
+	bool *out_reused
+) {
+	int slot;
+	esp_http_client_handle_t client = HTTP_connection_acquire(URL, &slot, out_reused);
+	if (!client) return -3;
+
+	size_t body_length = 0;
+
+	if (JSON_body) {
+		esp_http_client_set_method(client, HTTP_METHOD_POST);
+		esp_http_client_set_header(client, "Content-Type", "application/json");
+		body_length = strlen(JSON_body);
+	}
+
+	else {
+		esp_http_client_set_method(client, HTTP_METHOD_GET);
+		esp_http_client_delete_header(client, "Content-Type");
+	}
+
+	#ifdef woXrooX_WiFi_link_H
+	esp_http_client_set_timeout_ms(client, WiFi_link_degraded() ? HTTP_TIMEOUT_DEGRADED_MS : HTTP_TIMEOUT_MS);
+	#endif
+
+	uint64_t started_us = (uint64_t)esp_timer_get_time();
+
+	esp_err_t err = esp_http_client_open(client, (int)body_length);
+	if (err != ESP_OK) {
+		HTTP_connection_release(client, slot, false);
+		return -4;
+	}
+
+	if (*out_reused) METRIC_INC(HTTP_reused);
+
+	// TLS_stats() counts TLS connections only; plain http:// opens have no handshake to save
+	#ifdef CONFIG_WOXROOX_HTTPS
+	if (strncmp(URL, "https://", 8) == 0) {
+		if (*out_reused) TLS_record_reuse();
+		else TLS_record_handshake(started_us);
+	}
+	#else
+	(void)started_us;
+	#endif
+
+	if (JSON_body) {
+		int written = esp_http_client_write(client, JSON_body, body_length);
+		if (written < 0 || (size_t)written != body_length) {
+			HTTP_connection_release(client, slot, false);
+			return -5;
+		}
+	}
+
+	int64_t content_length = esp_http_client_fetch_headers(client);
+	if (content_length < 0) {
+		HTTP_connection_release(client, slot, false);
+		return -6;
+	}
+
+	// 0 with chunked encoding means "unknown", not "empty"
+	if (esp_http_client_is_chunked_response(client)) content_length = -1;
+
+	if (out_status_code) *out_status_code = esp_http_client_get_status_code(client);
+
+	char *body = NULL;
+	int response = HTTP_read_all(client, content_length, &body, NULL);
+
+	HTTP_connection_release(client, slot, response == 0 && esp_http_client_is_complete_data_received(client));
+
+	#ifdef woXrooX_WiFi_link_H
+	WiFi_link_report_TX((uint32_t)body_length, response == 0);
+	#endif
+
+	if (response != 0) return response;
+	*out_body = body;
+
+	return 0;
+}
+
+// A kept-alive connection may have been closed by the server while idle; then retry once on a
+// fresh connection, but only when the request cannot have reached the server twice: the open
+// itself failed (-4: nothing was sent), or it is a GET. A POST whose body went out is not re-sent.
+static int HTTP_request(
+	const char *URL,
+	const char *JSON_body,
+	char **out_body,
+	int *out_status_code
+) {
+	bool reused = false;
+
+	#ifndef CONFIG_WOXROOX_HTTPS
+	if (strncmp(URL, "https://", 8) == 0) return -1;
+	#endif
+
+	#ifdef woXrooX_WiFi_H
+	// Wait for the Wi-Fi manager instead of failing fast during a reconnect
+	if (!WiFi_wait_connected(pdMS_TO_TICKS(10000))) return -4;
+	#endif
+
+	uint64_t started_us = (uint64_t)esp_timer_get_time();
+	METRIC_INC(HTTP_requests);
+
+	int response = HTTP_request_once(URL, JSON_body, out_body, out_status_code, &reused);
+
+	bool retry = reused && (response == -4 || (!JSON_body && (response == -5 || response == -6)));
+
+	if (retry) {
+		ESP_LOGD(HTTP_CLIENT_TAG, "Stale keep-alive connection (%d), reconnecting", response);
+		response = HTTP_request_once(URL, JSON_body, out_body, out_status_code, &reused);
+	}
+
+	METRIC_OBSERVE(HTTP_latency_us, (uint64_t)esp_timer_get_time() - started_us);
+	if (response != 0) METRIC_INC(HTTP_errors);
+
+	return response;
+}
+
+////////////// API
+
+static int HTTP_GET(
+	const char *URL,
+	char **out_body,
+	int *out_status_code
+) {
+	if (!URL || !out_body) return -1;
+
+	return HTTP_request(URL, NULL, out_body, out_status_code);
+}
+
+static int HTTP_POST_JSON(
+	const char *URL,
+	const char *JSON_body,
+	char **out_body,
+	int *out_status_code
+) {
+	if (!URL || !JSON_body || !out_body) return -1;
+
+	return HTTP_request(URL, JSON_body, out_body, out_status_code);
+}
+
+#endif
@@ -0,0 +1,361 @@
+#ifndef woXrooX_HTTP_server_H
+#define woXrooX_HTTP_server_H
+
+/*
+LAN pull: live microphone audio and device status over plain HTTP, so consumers connect to the
+device instead of every unit pushing to a hard-coded WS_URL.
+
+Usage (after MIC.h; Wi-Fi up):
+#include "woXrooX/MIC.h"
+#include "woXrooX/HTTP_server.h"
+
+MIC_listen_start();
+HTTP_server_start();
+
+Endpoints:
+	GET /stream.wav   chunked audio/wav: 44-byte header (sizes 0xFFFFFFFF), then s16le mono
+	GET /stream.raw   chunked application/octet-stream, s16le mono; rate in X-Sample-Rate
+	GET /status       JSON: uptime, heap, capture config, stream clients, every Metrics.h counter and gauge
+
+	curl -N http://<device>/stream.raw | ffplay -f s16le -ar 16000 -ac 1 -
+	ffplay http://<device>/stream.wav
+
+Streaming: MIC_RX copies every frame once into a shared Frame_ring.h; each client (up to
+HTTP_STREAM_CLIENTS_MAX) has its own task and cursor and sends straight from the ring slot, so
+there is no per-client copy. A client that falls more than half the ring behind skips ahead
+to the newest frame (a gap in its stream). A client so slow that the writer reuses a slot while
+it is being sent gets disconnected, because the torn data is already on the wire. A capture
+rate change ends open streams, since a WAV header cannot change its rate; clients reconnect.
+*/
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/event_groups.h"
+
+#include "esp_http_server.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+#include "WS_protocol.h"
+#include "Metrics.h"
+#include "DLOG.h"
+#include "Tasks.h"
+
+#define FRAME_RING_SAMPLES_MAX MIC_FRAME_SAMPLES_MAX
+#include "Frame_ring.h"
+
+////////////// DEFINES
+
+// Fallbacks when the Kconfig menu is not part of the build (woXrooX → Network / Queues)
+#ifndef CONFIG_WOXROOX_HTTP_SERVER_PORT
+#define CONFIG_WOXROOX_HTTP_SERVER_PORT 80
+#define CONFIG_WOXROOX_HTTP_STREAM_CLIENTS 3
+#endif
+
+#define HTTP_SERVER_PORT CONFIG_WOXROOX_HTTP_SERVER_PORT
+
+#define HTTP_STREAM_CLIENTS_MAX CONFIG_WOXROOX_HTTP_STREAM_CLIENTS
+
+// Wait for the next frame at most this long before re-checking the ring
+#define HTTP_STREAM_WAIT_MS 100
+
+// Behind by more than this many frames: skip ahead instead of risking a torn send
+#define HTTP_STREAM_LAG_MAX (FRAME_RING_SLOTS / 2)
+
+#define HTTP_STATUS_MAX 2048
+
+////////////// TYPES
+
+typedef struct {
+	httpd_req_t *req;
+	bool wav;
+
+	// Header values must outlive httpd_resp_set_hdr()
+	char sample_rate[12];
+} HTTP_stream_client_type;
+
+////////////// GLOBALS
+
+static const char *HTTP_SERVER_TAG = "woXrooX::HTTP_server:";
+
+static httpd_handle_t HTTP_server = NULL;
+
+static Frame_ring_type HTTP_ring;
+
+// HTTP_FRAME is set and cleared by MIC_RX for every frame: wakes every waiting client at once
+#define HTTP_FRAME (1 << 0)
+static EventGroupHandle_t HTTP_event_group = NULL;
+static StaticEventGroup_t HTTP_event_group_storage;
+
+static HTTP_stream_client_type HTTP_clients[HTTP_STREAM_CLIENTS_MAX];
+static portMUX_TYPE HTTP_clients_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static char HTTP_status_buffer[HTTP_STATUS_MAX];
+
+////////////// Producer (MIC_RX)
+
+static void HTTP_tap(const MIC_frame_type *frame) {
+	Frame_ring_publish(&HTTP_ring, frame->seq, frame->ts_us, frame->sample_rate, frame->pcm, frame->samples);
+
+	xEventGroupSetBits(HTTP_event_group, HTTP_FRAME);
+	xEventGroupClearBits(HTTP_event_group, HTTP_FRAME);
+}
+
+////////////// Clients
+
+static HTTP_stream_client_type *HTTP_client_claim(void) {
+	HTTP_stream_client_type *client = NULL;
+	int active = 0;
+
+	taskENTER_CRITICAL(&HTTP_clients_lock);
+	for (int i = 0; i < HTTP_STREAM_CLIENTS_MAX; ++i) {
+		if (HTTP_clients[i].req) active++;
+		else if (!client) client = &HTTP_clients[i];
+	}
+	// Placeholder until the async request is known; keeps the slot taken
+	if (client) client->req = (httpd_req_t *)1;
+	taskEXIT_CRITICAL(&HTTP_clients_lock);
+
+	METRIC_SET(HTTP_stream_clients, active + (client ? 1 : 0));
+
+	return client;
+}
+
+static void HTTP_client_release(HTTP_stream_client_type *client) {
+	int active = 0;
+
+	taskENTER_CRITICAL(&HTTP_clients_lock);
+	client->req = NULL;
+	for (int i = 0; i < HTTP_STREAM_CLIENTS_MAX; ++i) if (HTTP_clients[i].req) active++;
+	taskEXIT_CRITICAL(&HTTP_clients_lock);
+
+	METRIC_SET(HTTP_stream_clients, active);
+}
+
+// RIFF/WAVE header for an endless s16le mono stream
+static void HTTP_wav_header(uint8_t *out, uint32_t sample_rate) {
+	memcpy(out + 0, "RIFF", 4);
+	little_endian_32(out + 4, 0xFFFFFFFFu);
+	memcpy(out + 8, "WAVEfmt ", 8);
+	little_endian_32(out + 16, 16);
+	out[20] = 1;
+	out[21] = 0;
+	out[22] = 1;
+	out[23] = 0;
+	little_endian_32(out + 24, sample_rate);
+	little_endian_32(out + 28, sample_rate * 2);
+	out[32] = 2;
+	out[33] = 0;
+	out[34] = 16;
+	out[35] = 0;
+	memcpy(out + 36, "data", 4);
+	little_endian_32(out + 40, 0xFFFFFFFFu);
+}
+
+static void HTTP_stream_task(void *param) {
+	HTTP_stream_client_type *client = (HTTP_stream_client_type *)param;
+	httpd_req_t *req = client->req;
+
+	uint32_t cursor = Frame_ring_head(&HTTP_ring) + 1;
+	uint32_t sample_rate = 0;
+
+	// false: the connection is in an unknown state and gets closed instead of finished
+	bool clean = true;
+
+	while (1) {
+		const Frame_ring_slot_type *slot = NULL;
+		int response = Frame_ring_acquire(&HTTP_ring, cursor, &slot);
+
+		if (response == FRAME_RING_return_empty) {
+			xEventGroupWaitBits(HTTP_event_group, HTTP_FRAME, pdFALSE, pdFALSE, pdMS_TO_TICKS(HTTP_STREAM_WAIT_MS));
+			continue;
+		}
+
+		uint32_t head = Frame_ring_head(&HTTP_ring);
+
+		if (response == FRAME_RING_return_lapped || head - cursor > HTTP_STREAM_LAG_MAX) {
+			METRIC_ADD(HTTP_stream_skipped, head - cursor);
+			cursor = head;
+			continue;
+		}
+
+		// First frame fixes the format; a rate change ends the stream
+		if (!sample_rate) {
+			sample_rate = slot->sample_rate;
+			snprintf(client->sample_rate, sizeof(client->sample_rate), "%u", (unsigned)sample_rate);
+
+			httpd_resp_set_type(req, client->wav ? "audio/wav" : "application/octet-stream");
+			httpd_resp_set_hdr(req, "X-Sample-Rate", client->sample_rate);
+			httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+
+			if (client->wav) {
+				uint8_t header[44];
+				HTTP_wav_header(header, sample_rate);
+				if (httpd_resp_send_chunk(req, (const char *)header, sizeof(header)) != ESP_OK) {
+					clean = false;
+					break;
+				}
+			}
+		}
+
+		if (slot->sample_rate != sample_rate) break;
+
+		// Straight from the shared slot
+		if (httpd_resp_send_chunk(req, (const char *)slot->pcm, slot->samples * sizeof(int16_t)) != ESP_OK) {
+			clean = false;
+			break;
+		}
+
+		if (!Frame_ring_release(&HTTP_ring, slot, cursor)) {
+			DLOG_W(HTTP_SERVER_TAG, "Stream client too slow, frame %u overwritten while sending", cursor);
+			clean = false;
+			break;
+		}
+
+		METRIC_INC(HTTP_stream_frames);
+		cursor++;
+	}
+
+	if (clean) httpd_resp_send_chunk(req, NULL, 0);
+	else httpd_sess_trigger_close(HTTP_server, httpd_req_to_sockfd(req));
+
+	httpd_req_async_handler_complete(req);
+	HTTP_client_release(client);
+
+	vTaskDelete(NULL);
+}
+
+////////////// Handlers
+
+static esp_err_t HTTP_stream_handler(httpd_req_t *req) {
+	HTTP_stream_client_type *client = HTTP_client_claim();
+
+	if (!client) {
+		httpd_resp_set_status(req, "503 Service Unavailable");
+		httpd_resp_set_hdr(req, "Retry-After", "5");
+		httpd_resp_set_hdr(req, "Connection", "close");
+		httpd_sess_trigger_close(HTTP_server, httpd_req_to_sockfd(req));
+		return httpd_resp_send(req, "Too many stream clients\n", HTTPD_RESP_USE_STRLEN);
+	}
+
+	client->wav = (bool)(uintptr_t)req->user_ctx;
+
+	// The request outlives this handler: the server task stays free for other clients
+	httpd_req_t *async = NULL;
+	if (httpd_req_async_handler_begin(req, &async) != ESP_OK) {
+		HTTP_client_release(client);
+		return httpd_resp_send_500(req);
+	}
+
+	client->req = async;
+
+	if (Tasks_create(TASK_HTTP_STREAM, HTTP_stream_task, client, NULL) != 0) {
+		httpd_resp_send_500(async);
+		httpd_req_async_handler_complete(async);
+		HTTP_client_release(client);
+	}
+
+	return ESP_OK;
+}
+
+// Append to HTTP_status_buffer; stops quietly at the end of the buffer
+static void HTTP_status_append(size_t *length, const char *format, ...) {
+	if (*length >= sizeof(HTTP_status_buffer)) return;
+
+	va_list args;
+	va_start(args, format);
+	int n = vsnprintf(HTTP_status_buffer + *length, sizeof(HTTP_status_buffer) - *length, format, args);
+	va_end(args);
+
+	if (n > 0) *length += (size_t)n;
+	if (*length > sizeof(HTTP_status_buffer)) *length = sizeof(HTTP_status_buffer);
+}
+
+static esp_err_t HTTP_status_handler(httpd_req_t *req) {
+	MIC_config_type capture;
+	MIC_config(&capture);
+
+	size_t length = 0;
+
+	HTTP_status_append(&length, "{\"uptime_ms\":%llu,\"heap_free\":%u,\"heap_min_free\":%u,",
+		(unsigned long long)(esp_timer_get_time() / 1000),
+		(unsigned)heap_caps_get_free_size(MALLOC_CAP_8BIT),
+		(unsigned)heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT));
+
+	HTTP_status_append(&length, "\"capture\":{\"sample_rate\":%u,\"frame_ms\":%u},", (unsigned)capture.sample_rate, capture.frame_ms);
+
+	HTTP_status_append(&length, "\"stream\":{\"clients\":%d,\"clients_max\":%d,\"frames\":%u},",
+		(int)Metrics_gauge(METRIC_GAUGE_HTTP_stream_clients), HTTP_STREAM_CLIENTS_MAX, (unsigned)Frame_ring_head(&HTTP_ring));
+
+	HTTP_status_append(&length, "\"counters\":{");
+	for (int i = 0; i < METRICS_COUNTER_COUNT; ++i) {
+		HTTP_status_append(&length, "%s\"%s\":%u", i ? "," : "", Metrics_counter_name(i), (unsigned)Metrics_counter(i));
+	}
+
+	HTTP_status_append(&length, "},\"gauges\":{");
+	for (int i = 0; i < METRICS_GAUGE_COUNT; ++i) {
+		HTTP_status_append(&length, "%s\"%s\":%d", i ? "," : "", Metrics_gauge_name(i), (int)Metrics_gauge(i));
+	}
+
+	HTTP_status_append(&length, "}}");
+
+	if (length >= sizeof(HTTP_status_buffer)) {
+		ESP_LOGW(HTTP_SERVER_TAG, "Status larger than HTTP_STATUS_MAX");
+		return httpd_resp_send_500(req);
+	}
+
+	httpd_resp_set_type(req, "application/json");
+	httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+
+	// One request per connection: the socket slot is free again as soon as the reply is out
+	httpd_resp_set_hdr(req, "Connection", "close");
+	httpd_sess_trigger_close(HTTP_server, httpd_req_to_sockfd(req));
+
+	return httpd_resp_send(req, HTTP_status_buffer, (ssize_t)length);
+}
+
+////////////// API
+
+static int HTTP_server_start(void) {
+	if (HTTP_server) return 0;
+
+	if (!HTTP_event_group) HTTP_event_group = xEventGroupCreateStatic(&HTTP_event_group_storage);
+
+	httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+	config.server_port = HTTP_SERVER_PORT;
+	config.core_id = Tasks_table[TASK_HTTP_STREAM].core;
+
+	// Stream sockets stay open; keep room for /status next to them. No LRU purge: an idle-looking
+	// stream socket (its handler runs async) would be the first one closed to make room for a poller.
+	// /status and 503 replies close their socket instead, so pollers never pile up.
+	config.max_open_sockets = HTTP_STREAM_CLIENTS_MAX + 2;
+	config.lru_purge_enable = false;
+
+	if (httpd_start(&HTTP_server, &config) != ESP_OK) {
+		ESP_LOGE(HTTP_SERVER_TAG, "httpd_start failed on port %d", HTTP_SERVER_PORT);
+		HTTP_server = NULL;
+		return -1;
+	}
+
+	const httpd_uri_t uris[] = {
+		{ .uri = "/stream.wav", .method = HTTP_GET, .handler = HTTP_stream_handler, .user_ctx = (void *)1 },
+		{ .uri = "/stream.raw", .method = HTTP_GET, .handler = HTTP_stream_handler, .user_ctx = (void *)0 },
+		{ .uri = "/status", .method = HTTP_GET, .handler = HTTP_status_handler, .user_ctx = NULL },
+	};
+
+	for (size_t i = 0; i < sizeof(uris) / sizeof(uris[0]); ++i) httpd_register_uri_handler(HTTP_server, &uris[i]);
+
+	MIC_tap_set(HTTP_tap);
+
+	ESP_LOGI(HTTP_SERVER_TAG, "Listening on port %d (/stream.wav, /stream.raw, /status)", HTTP_SERVER_PORT);
+
+	return 0;
+}
+
+#endif
@@ -0,0 +1,512 @@
+/*
+Usage:
+#include "woXrooX/LED_LOGGER.h"
+
+if (LEDs_init() != 0) return;
+
+LED_RED_on(200, 20);
+LED_ORANGE_on(500, 10);
+LED_GREEN_on(100, 40);
+
+// Any bytecode pattern (see LED_pattern.h)
+LED_GREEN_pattern(LED_PATTERN_HEARTBEAT);
+LED_RED_pattern(LED_PATTERN_ERROR_2S1L);
+
+// LEDC backend (LED_USE_LEDC 1): brightness and hardware fades
+LED_GREEN_brightness(64);
+LED_GREEN_pattern(LED_PATTERN_BREATHE);
+
+// Manual switch off
+LED_RED_off();
+LED_ORANGE_off();
+LED_GREEN_off();
+
+All LEDs share one one-shot timer that is always armed for the earliest pending
+transition across every LED, so the timer service wakes only when something changes.
+
+With LED_USE_LEDC each LED is driven by an LEDC PWM channel: duty cycle sets the brightness
+and FADE steps run in the LEDC hardware (ledc_set_fade_with_time), so a breathing pattern costs
+one software wakeup per fade segment. An LED whose channel fails to set up falls back to GPIO.
+*/
+
+#ifndef LED_LOGGER_H
+#define LED_LOGGER_H
+
+#include <stddef.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/timers.h"
+
+#include "driver/gpio.h"
+#include "driver/ledc.h"
+
+#include "LED_pattern.h"
+#include "Metrics.h"
+
+////////////// DEFINES
+
+#define LED_level_on 1
+#define LED_level_off 0
+
+#define LED_return_OK 0
+#define LED_return_error -1
+#define LED_return_not_initialized -2
+
+// Fallbacks when the Kconfig menu is not part of the build (woXrooX → Pins / Features)
+#ifndef CONFIG_WOXROOX_LED_PIN_RED
+#define CONFIG_WOXROOX_LED_PIN_RED 18
+#define CONFIG_WOXROOX_LED_PIN_ORANGE 19
+#define CONFIG_WOXROOX_LED_PIN_GREEN 23
+#define CONFIG_WOXROOX_LED_LEDC 1
+#endif
+
+// 1 = LEDC PWM backend (brightness, hardware fades), 0 = plain GPIO on/off
+#ifdef CONFIG_WOXROOX_LED_LEDC
+#define LED_USE_LEDC 1
+#else
+#define LED_USE_LEDC 0
+#endif
+
+#define LED_LEDC_MODE LEDC_LOW_SPEED_MODE
+#define LED_LEDC_TIMER LEDC_TIMER_0
+#define LED_LEDC_FREQUENCY_HZ 5000
+#define LED_LEDC_RESOLUTION LEDC_TIMER_10_BIT
+#define LED_LEDC_DUTY_MAX ((1 << 10) - 1)
+
+// No LEDC channel: drive the pin as plain GPIO
+#define LED_CHANNEL_NONE -1
+
+////////////// GLOBALS
+
+typedef struct {
+	gpio_num_t pin;
+
+	// 1 = active-high, 0 = active-low
+	int active_high;
+
+	// 1 after successful init
+	int initialized;
+
+	// LEDC channel, or LED_CHANNEL_NONE for the GPIO path
+	int channel;
+
+	// Duty at full "on" (0..255), LEDC only
+	uint8_t brightness;
+
+	// Running pattern (program may point at `blink` below)
+	LED_pattern_state_type pattern;
+
+	// A hardware fade may still own the channel (LEDC only)
+	bool fading;
+
+	// Program buffer for LED_blink_start()
+	uint16_t blink[5];
+} LED_type;
+
+
+// active_high: flip to 0 if you wired active-LOW
+static LED_type LEDs[] = {
+	// RED | Error
+	{
+		// D18 by default
+		.pin = (gpio_num_t)CONFIG_WOXROOX_LED_PIN_RED,
+		.active_high = 1,
+		.initialized = 0,
+		.channel = LEDC_CHANNEL_0,
+		.brightness = 255
+	},
+
+	// ORANGNE | Warning
+	{
+		// D19 by default
+		.pin = (gpio_num_t)CONFIG_WOXROOX_LED_PIN_ORANGE,
+		.active_high = 1,
+		.initialized = 0,
+		.channel = LEDC_CHANNEL_1,
+		.brightness = 255
+	},
+
+	// GREEN | Success
+	{
+		// D23 by default
+		.pin = (gpio_num_t)CONFIG_WOXROOX_LED_PIN_GREEN,
+		.active_high = 1,
+		.initialized = 0,
+		.channel = LEDC_CHANNEL_2,
+		.brightness = 255
+	},
+};
+
+static const size_t LEDs_count = (sizeof(LEDs) / sizeof(LEDs[0]));
+
+// One timer for all LEDs, armed for the earliest next transition
+static TimerHandle_t LEDs_timer = NULL;
+
+// Uses static allocation (no heap)
+static StaticTimer_t LEDs_timer_storage;
+
+// Guards pattern state, brightness and `fading` between API callers and the timer callback
+static portMUX_TYPE LEDs_lock = portMUX_INITIALIZER_UNLOCKED;
+
+////////////// Built-in patterns
+
+static const uint16_t LED_PATTERN_HEARTBEAT[] = {
+	LED_P_LOOP, LED_P_ON(100), LED_P_OFF(100), LED_P_ON(100), LED_P_OFF(700), LED_P_REPEAT(0), LED_P_END
+};
+
+static const uint16_t LED_PATTERN_ERROR_2S1L[] = {
+	LED_P_LOOP,
+		LED_P_LOOP, LED_P_ON(150), LED_P_OFF(150), LED_P_REPEAT(2),
+		LED_P_ON(600), LED_P_OFF(1000),
+	LED_P_REPEAT(0), LED_P_END
+};
+
+static const uint16_t LED_PATTERN_BREATHE[] = {
+	LED_P_LOOP, LED_P_FADE(1500, 255), LED_P_FADE(1500, 0), LED_P_REPEAT(0), LED_P_END
+};
+
+////////////// Forward declarations
+
+static void LEDs_timer_callback(TimerHandle_t tmr);
+
+////////////// Helpers
+
+static inline uint32_t LEDs_now_ms(void) {
+	return (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS);
+}
+
+static inline int get_LED_level_on(const LED_type *LED) {
+	return LED->active_high ? LED_level_on : LED_level_off;
+}
+
+static inline int get_LED_level_off(const LED_type *LED) {
+	return LED->active_high ? LED_level_off : LED_level_on;
+}
+
+static inline int LED_init(LED_type *LED) {
+	if (LED->initialized == 1) return LED_return_OK;
+
+	if (!GPIO_IS_VALID_OUTPUT_GPIO(LED->pin)) return LED_return_error;
+
+	// Glitch-free: reset -> preload OFF (still input) -> configure as output
+	if (gpio_reset_pin(LED->pin) != ESP_OK) return LED_return_error;
+	if (gpio_set_level(LED->pin, get_LED_level_off(LED)) != ESP_OK) return LED_return_error;
+
+	gpio_config_t LED_IO_config = {
+		.pin_bit_mask = 1ULL << LED->pin,
+		.mode = GPIO_MODE_OUTPUT,
+		.pull_up_en = GPIO_PULLUP_DISABLE,
+		.pull_down_en = GPIO_PULLDOWN_DISABLE,
+		.intr_type = GPIO_INTR_DISABLE
+	};
+
+	if (gpio_config(&LED_IO_config) != ESP_OK) return LED_return_error;
+
+	#if LED_USE_LEDC
+	if (LED->channel != LED_CHANNEL_NONE) {
+		ledc_channel_config_t channel_config = {
+			.gpio_num = LED->pin,
+			.speed_mode = LED_LEDC_MODE,
+			.channel = (ledc_channel_t)LED->channel,
+			.intr_type = LEDC_INTR_DISABLE,
+			.timer_sel = LED_LEDC_TIMER,
+			.duty = 0,
+			.hpoint = 0,
+			.flags.output_invert = LED->active_high ? 0 : 1
+		};
+
+		// Keep the GPIO path for this LED if the channel is not available
+		if (ledc_channel_config(&channel_config) != ESP_OK) LED->channel = LED_CHANNEL_NONE;
+	}
+	#else
+	LED->channel = LED_CHANNEL_NONE;
+	#endif
+
+	LED->pattern.running = false;
+	LED->pattern.level = LED_PATTERN_LEVEL_OFF;
+
+	LED->initialized = 1;
+
+	return LED_return_OK;
+}
+
+#if LED_USE_LEDC
+static inline uint32_t LED_duty(uint8_t brightness, uint8_t level) {
+	return ((uint32_t)level * brightness * LED_LEDC_DUTY_MAX) / (255 * 255);
+}
+
+// fading: a fade started earlier may still be running. The fade engine owns the channel until it
+// ends, and a duty written meanwhile is lost, so it is stopped first.
+static int LED_LEDC_set(LED_type *LED, uint32_t duty, uint16_t fade_ms, bool fading) {
+	ledc_channel_t channel = (ledc_channel_t)LED->channel;
+
+	if (fading && ledc_fade_stop(LED_LEDC_MODE, channel) != ESP_OK) return LED_return_error;
+
+	if (fade_ms) {
+		if (ledc_set_fade_with_time(LED_LEDC_MODE, channel, duty, fade_ms) != ESP_OK) return LED_return_error;
+		if (ledc_fade_start(LED_LEDC_MODE, channel, LEDC_FADE_NO_WAIT) != ESP_OK) return LED_return_error;
+		return LED_return_OK;
+	}
+
+	if (ledc_set_duty_and_update(LED_LEDC_MODE, channel, duty, 0) != ESP_OK) return LED_return_error;
+
+	return LED_return_OK;
+}
+#endif
+
+static inline int LED_on_RAW(LED_type *LED) {
+	if (gpio_set_level(LED->pin, get_LED_level_on(LED)) != ESP_OK) return LED_return_error;
+	return LED_return_OK;
+}
+
+static inline int LED_off_RAW(LED_type *LED) {
+	if (gpio_set_level(LED->pin, get_LED_level_off(LED)) != ESP_OK) return LED_return_error;
+	return LED_return_OK;
+}
+
+// Drive the current pattern level; GPIO treats anything from half brightness up as on.
+// The state is read in one go under the lock, so a concurrent API call never tears it.
+static int LED_apply_RAW(LED_type *LED) {
+	portENTER_CRITICAL(&LEDs_lock);
+	uint8_t level = LED->pattern.level;
+	uint16_t fade_ms = LED->pattern.fade_ms;
+	uint8_t brightness = LED->brightness;
+	bool fading = LED->fading;
+	LED->fading = fade_ms > 0;
+	portEXIT_CRITICAL(&LEDs_lock);
+
+	#if LED_USE_LEDC
+	if (LED->channel != LED_CHANNEL_NONE) return LED_LEDC_set(LED, LED_duty(brightness, level), fade_ms, fading);
+	#else
+	(void)fading;
+	(void)brightness;
+	#endif
+
+	return (level >= 128) ? LED_on_RAW(LED) : LED_off_RAW(LED);
+}
+
+////////////// Scheduler
+
+// Re-arm the shared timer for the earliest pending transition (or stop it)
+static int LEDs_reschedule(uint32_t now_ms) {
+	bool any = false;
+	uint32_t earliest = 0;
+
+	portENTER_CRITICAL(&LEDs_lock);
+
+	for (size_t i = 0; i < LEDs_count; ++i) {
+		const LED_pattern_state_type *p = &LEDs[i].pattern;
+		if (!LEDs[i].initialized || !p->running) continue;
+
+		if (!any || (int32_t)(p->next_ms - earliest) < 0) earliest = p->next_ms;
+		any = true;
+	}
+
+	portEXIT_CRITICAL(&LEDs_lock);
+
+	if (!LEDs_timer) return LED_return_error;
+
+	if (!any) {
+		xTimerStop(LEDs_timer, 0);
+		return LED_return_OK;
+	}
+
+	int32_t delay_ms = (int32_t)(earliest - now_ms);
+	TickType_t d = (delay_ms > 0) ? pdMS_TO_TICKS((uint32_t)delay_ms) : 0;
+	if (d == 0) d = 1;
+
+	// ChangePeriod also starts the timer
+	if (xTimerChangePeriod(LEDs_timer, d, 0) != pdPASS) return LED_return_error;
+
+	return LED_return_OK;
+}
+
+static void LEDs_timer_callback(TimerHandle_t tmr) {
+	(void)tmr;
+
+	uint32_t now = LEDs_now_ms();
+
+	for (size_t i = 0; i < LEDs_count; ++i) {
+		LED_type *LED = &LEDs[i];
+		if (!LED->initialized) continue;
+
+		portENTER_CRITICAL(&LEDs_lock);
+
+		LED_pattern_state_type before = LED->pattern;
+		LED_pattern_step(&LED->pattern, now);
+
+		// A step always moves next_ms on. A new FADE segment is driven even if it targets the level
+		// the LED is already at, and so is any change between fading and jumping.
+		bool stepped = before.running && LED->pattern.next_ms != before.next_ms;
+		bool changed = before.running && (LED->pattern.level != before.level || LED->pattern.fade_ms != before.fade_ms || (stepped && LED->pattern.fade_ms > 0));
+
+		portEXIT_CRITICAL(&LEDs_lock);
+
+		// Only touch the pin on a real transition
+		if (changed) {
+			LED_apply_RAW(LED);
+			METRIC_INC(LED_transitions);
+		}
+	}
+
+	LEDs_reschedule(now);
+}
+
+////////////// Patterns
+
+// Play a bytecode pattern (LED_pattern.h). program must outlive the pattern.
+// Returns 0 on success, -2 if not initialized, -1 on driver error or a program LED_pattern_valid() rejects.
+static int LED_pattern_play(LED_type *LED, const uint16_t *program) {
+	if (LED->initialized == 0) return LED_return_not_initialized;
+	if (!LED_pattern_valid(program)) return LED_return_error;
+
+	uint32_t now = LEDs_now_ms();
+
+	portENTER_CRITICAL(&LEDs_lock);
+	LED_pattern_start(&LED->pattern, program, now);
+	portEXIT_CRITICAL(&LEDs_lock);
+
+	if (LED_apply_RAW(LED) != LED_return_OK) return LED_return_error;
+
+	return LEDs_reschedule(now);
+}
+
+static inline int LED_off(LED_type *LED) {
+	portENTER_CRITICAL(&LEDs_lock);
+	LED->pattern.running = false;
+	LED->pattern.level = LED_PATTERN_LEVEL_OFF;
+	LED->pattern.fade_ms = 0;
+	portEXIT_CRITICAL(&LEDs_lock);
+
+	if (LED_apply_RAW(LED) != LED_return_OK) return LED_return_error;
+
+	return LEDs_reschedule(LEDs_now_ms());
+}
+
+
+// Blink: ON for interval_ms, then OFF for interval_ms, repeated `times` times.
+// times <= 0 → forever, interval_ms == 0 → solid ON.
+// Returns 0 on success, -2 if not initialized, -1 on driver error.
+static int LED_blink_start(LED_type *LED, uint32_t interval_ms, int times) {
+	if (LED->initialized == 0) return LED_return_not_initialized;
+
+	// Solid ON request
+	if (interval_ms == 0) {
+		portENTER_CRITICAL(&LEDs_lock);
+		LED->pattern.running = false;
+		LED->pattern.level = LED_PATTERN_LEVEL_ON;
+		LED->pattern.fade_ms = 0;
+		portEXIT_CRITICAL(&LEDs_lock);
+
+		if (LED_apply_RAW(LED) != LED_return_OK) return LED_return_error;
+		return LEDs_reschedule(LEDs_now_ms());
+	}
+
+	if (times == 0) return LED_return_OK;
+
+	uint32_t ticks = LED_P_DURATION(interval_ms);
+	if (ticks > 0x0FFF) ticks = 0x0FFF;
+
+	int repeat = (times < 0) ? 0 : times;
+	if (repeat > 0x0FFF) repeat = 0x0FFF;
+
+	// ON → OFF, `times` cycles, ends OFF.
+	// Stopped first so the timer never interprets a half-written buffer.
+	portENTER_CRITICAL(&LEDs_lock);
+	LED->pattern.running = false;
+	LED->blink[0] = LED_P_LOOP;
+	LED->blink[1] = LED_P_OP(LED_OP_ON, ticks);
+	LED->blink[2] = LED_P_OP(LED_OP_OFF, ticks);
+	LED->blink[3] = LED_P_REPEAT(repeat);
+	LED->blink[4] = LED_P_END;
+	portEXIT_CRITICAL(&LEDs_lock);
+
+	return LED_pattern_play(LED, LED->blink);
+}
+
+
+////////////// APIs
+
+static int LEDs_init(void) {
+	#if LED_USE_LEDC
+	static int LEDC_ready = 0;
+
+	if (!LEDC_ready) {
+		ledc_timer_config_t timer_config = {
+			.speed_mode = LED_LEDC_MODE,
+			.duty_resolution = LED_LEDC_RESOLUTION,
+			.timer_num = LED_LEDC_TIMER,
+			.freq_hz = LED_LEDC_FREQUENCY_HZ,
+			.clk_cfg = LEDC_AUTO_CLK
+		};
+
+		// On failure every LED stays on the GPIO path
+		if (ledc_timer_config(&timer_config) == ESP_OK && ledc_fade_func_install(0) == ESP_OK) LEDC_ready = 1;
+		else for (size_t i = 0; i < LEDs_count; ++i) LEDs[i].channel = LED_CHANNEL_NONE;
+	}
+	#endif
+
+	if (!LEDs_timer) {
+		LEDs_timer = xTimerCreateStatic(
+			// name
+			"LEDs",
+
+			// dummy period; the real one is set on every reschedule
+			1,
+
+			// one-shot: re-armed for the next earliest transition
+			pdFALSE,
+
+			// timer ID (unused)
+			NULL,
+
+			// Callback
+			LEDs_timer_callback,
+
+			// static storage
+			&LEDs_timer_storage
+		);
+
+		if (LEDs_timer == NULL) return LED_return_error;
+	}
+
+	for (size_t i = 0; i < LEDs_count; ++i) {
+		int return_value = LED_init(&LEDs[i]);
+		if (return_value != LED_return_OK) return LED_return_error;
+	}
+
+	return LED_return_OK;
+}
+
+// Brightness at full "on" (0..255). Takes effect at the next transition; LEDC only.
+static int LED_brightness_set(LED_type *LED, uint8_t brightness) {
+	if (LED->initialized == 0) return LED_return_not_initialized;
+
+	portENTER_CRITICAL(&LEDs_lock);
+	LED->brightness = brightness;
+
+	// Re-drive a steady LED right away
+	bool steady = !LED->pattern.running;
+	if (steady) LED->pattern.fade_ms = 0;
+	portEXIT_CRITICAL(&LEDs_lock);
+
+	return steady ? LED_apply_RAW(LED) : LED_return_OK;
+}
+
+static int LED_RED_on(int interval_ms, int times) { return LED_blink_start(&LEDs[0], (uint32_t)interval_ms, times); }
+static int LED_RED_pattern(const uint16_t *program) { return LED_pattern_play(&LEDs[0], program); }
+static int LED_RED_brightness(uint8_t brightness) { return LED_brightness_set(&LEDs[0], brightness); }
+static int LED_RED_off() { return LED_off(&LEDs[0]); }
+
+static int LED_ORANGE_on(int interval_ms, int times) { return LED_blink_start(&LEDs[1], (uint32_t)interval_ms, times); }
+static int LED_ORANGE_pattern(const uint16_t *program) { return LED_pattern_play(&LEDs[1], program); }
+static int LED_ORANGE_brightness(uint8_t brightness) { return LED_brightness_set(&LEDs[1], brightness); }
+static int LED_ORANGE_off() { return LED_off(&LEDs[1]); }
+
+static int LED_GREEN_on(int interval_ms, int times) { return LED_blink_start(&LEDs[2], (uint32_t)interval_ms, times); }
+static int LED_GREEN_pattern(const uint16_t *program) { return LED_pattern_play(&LEDs[2], program); }
+static int LED_GREEN_brightness(uint8_t brightness) { return LED_brightness_set(&LEDs[2], brightness); }
+static int LED_GREEN_off() { return LED_off(&LEDs[2]); }
+
+#endif
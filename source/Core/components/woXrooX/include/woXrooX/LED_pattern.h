@@ -0,0 +1,246 @@
+/*
+Tiny LED pattern bytecode + interpreter.
+
+A pattern is a const array of 16-bit instructions: 4-bit opcode, 12-bit argument.
+
+	LED_P_ON(ms)        level on, hold for ms  (10 ms units, up to 40.95 s)
+	LED_P_OFF(ms)       level off, hold for ms
+	LED_P_FADE(ms, l)   fade to level l (0..255) over ms, then continue (two words; the level word
+	                    carries the FADE opcode too, so a level of 0 never reads as END)
+	LED_P_LOOP          loop start (loops nest LED_PATTERN_MAX_DEPTH deep)
+	LED_P_REPEAT(n)     run the loop body n times in total, 0 = forever
+	LED_P_END           stop; the level stays as it is
+
+Examples:
+
+	// Heartbeat: double flash, pause
+	static const uint16_t heartbeat[] = {
+		LED_P_LOOP, LED_P_ON(100), LED_P_OFF(100), LED_P_ON(100), LED_P_OFF(700), LED_P_REPEAT(0), LED_P_END
+	};
+
+	// Breathing (hardware fade on an LEDC backend, stepped on plain GPIO)
+	static const uint16_t breathe[] = {
+		LED_P_LOOP, LED_P_FADE(1500, 255), LED_P_FADE(1500, 0), LED_P_REPEAT(0), LED_P_END
+	};
+
+	// Error code: 2 short, 1 long
+	static const uint16_t error_2s1l[] = {
+		LED_P_LOOP,
+			LED_P_LOOP, LED_P_ON(150), LED_P_OFF(150), LED_P_REPEAT(2),
+			LED_P_ON(600), LED_P_OFF(1000),
+		LED_P_REPEAT(0), LED_P_END
+	};
+
+LED_pattern_valid() checks a program before it is played: LOOPs nested deeper than
+LED_PATTERN_MAX_DEPTH, a REPEAT with no LOOP, an unknown opcode, a FADE without its level word or a
+missing END reject it.
+
+The interpreter is plain C with no RTOS or driver dependencies: the caller passes the clock
+(ms, wrapping uint32_t) and applies `level` itself, so it runs the same against a simulated
+clock on a host as under the LED_LOGGER timer.
+*/
+
+#ifndef woXrooX_LED_pattern_H
+#define woXrooX_LED_pattern_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+////////////// DEFINES
+
+#define LED_OP_END 0x0
+#define LED_OP_ON 0x1
+#define LED_OP_OFF 0x2
+#define LED_OP_LOOP 0x3
+#define LED_OP_REPEAT 0x4
+#define LED_OP_FADE 0x5
+
+// Levels are brightness, 0..255; ON/OFF are the extremes
+#define LED_PATTERN_LEVEL_ON 255
+#define LED_PATTERN_LEVEL_OFF 0
+
+// Argument unit for ON/OFF/FADE durations (ms)
+#define LED_PATTERN_TICK_MS 10
+
+#define LED_PATTERN_MAX_DEPTH 2
+
+// Longest program LED_pattern_valid() will scan for its END (words)
+#define LED_PATTERN_MAX_LENGTH 256
+
+// Instructions executed per step without reaching a wait (guards against empty loops)
+#define LED_PATTERN_MAX_STEPS 32
+
+#define LED_P_OP(op, arg) ((uint16_t)(((op) << 12) | ((arg) & 0x0FFF)))
+#define LED_P_DURATION(ms) (((ms) + LED_PATTERN_TICK_MS - 1) / LED_PATTERN_TICK_MS)
+
+#define LED_P_END LED_P_OP(LED_OP_END, 0)
+#define LED_P_ON(ms) LED_P_OP(LED_OP_ON, LED_P_DURATION(ms))
+#define LED_P_OFF(ms) LED_P_OP(LED_OP_OFF, LED_P_DURATION(ms))
+#define LED_P_LOOP LED_P_OP(LED_OP_LOOP, 0)
+#define LED_P_REPEAT(n) LED_P_OP(LED_OP_REPEAT, (n))
+#define LED_P_FADE(ms, level) LED_P_OP(LED_OP_FADE, LED_P_DURATION(ms)), LED_P_OP(LED_OP_FADE, (level) & 0xFF)
+
+// Loop counter not yet loaded from its REPEAT
+#define LED_PATTERN_LOOP_UNSET 0xFFFF
+
+////////////// TYPES
+
+typedef struct {
+	const uint16_t *program;
+	uint16_t pc;
+
+	uint8_t depth;
+	uint16_t loop_pc[LED_PATTERN_MAX_DEPTH];
+	uint16_t loop_left[LED_PATTERN_MAX_DEPTH];
+
+	// Output the caller should drive: brightness 0..255
+	uint8_t level;
+
+	// Non-zero if reaching `level` should be a fade of this many ms (0 = jump)
+	uint16_t fade_ms;
+
+	// Clock value (ms) at which LED_pattern_step() must run next
+	uint32_t next_ms;
+
+	bool running;
+} LED_pattern_state_type;
+
+////////////// Interpreter
+
+// true if the program can be played as written: nesting within LED_PATTERN_MAX_DEPTH, every
+// REPEAT inside a LOOP, known opcodes only, and an END within LED_PATTERN_MAX_LENGTH words
+static bool LED_pattern_valid(const uint16_t *program) {
+	if (program == NULL) return false;
+
+	uint8_t depth = 0;
+
+	for (uint16_t pc = 0; pc < LED_PATTERN_MAX_LENGTH; ++pc) {
+		switch (program[pc] >> 12) {
+			case LED_OP_END:
+				return true;
+
+			case LED_OP_ON:
+			case LED_OP_OFF:
+				break;
+
+			// The level word follows, tagged FADE: an END (or anything else) there means it is missing
+			case LED_OP_FADE:
+				if (++pc >= LED_PATTERN_MAX_LENGTH || (program[pc] >> 12) != LED_OP_FADE) return false;
+				break;
+
+			case LED_OP_LOOP:
+				if (depth >= LED_PATTERN_MAX_DEPTH) return false;
+				depth++;
+				break;
+
+			case LED_OP_REPEAT:
+				if (depth == 0) return false;
+				depth--;
+				break;
+
+			default:
+				return false;
+		}
+	}
+
+	return false;
+}
+
+// true if the clock has reached `deadline` (wrap-safe)
+static inline bool LED_pattern_due(uint32_t now_ms, uint32_t deadline_ms) {
+	return (int32_t)(now_ms - deadline_ms) >= 0;
+}
+
+// Run instructions until the next wait or the end
+static void LED_pattern_run(LED_pattern_state_type *s, uint32_t now_ms) {
+	for (int steps = 0; steps < LED_PATTERN_MAX_STEPS; ++steps) {
+		uint16_t instruction = s->program[s->pc++];
+		uint16_t op = instruction >> 12;
+		uint16_t arg = instruction & 0x0FFF;
+
+		switch (op) {
+			case LED_OP_ON:
+			case LED_OP_OFF:
+				s->level = (op == LED_OP_ON) ? LED_PATTERN_LEVEL_ON : LED_PATTERN_LEVEL_OFF;
+				s->fade_ms = 0;
+				s->next_ms = now_ms + (uint32_t)(arg ? arg : 1) * LED_PATTERN_TICK_MS;
+				return;
+
+			case LED_OP_FADE:
+				// No level word: malformed program
+				if ((s->program[s->pc] >> 12) != LED_OP_FADE) {
+					s->running = false;
+					return;
+				}
+
+				s->level = (uint8_t)s->program[s->pc++];
+				s->fade_ms = (uint16_t)((arg ? arg : 1) * LED_PATTERN_TICK_MS);
+				s->next_ms = now_ms + s->fade_ms;
+				return;
+
+			case LED_OP_LOOP:
+				// Too deep: its REPEAT would jump to the enclosing loop instead
+				if (s->depth >= LED_PATTERN_MAX_DEPTH) {
+					s->running = false;
+					return;
+				}
+
+				s->loop_pc[s->depth] = s->pc;
+				s->loop_left[s->depth] = LED_PATTERN_LOOP_UNSET;
+				s->depth++;
+				break;
+
+			case LED_OP_REPEAT: {
+				if (s->depth == 0) break;
+
+				uint16_t *left = &s->loop_left[s->depth - 1];
+
+				if (arg == 0) { s->pc = s->loop_pc[s->depth - 1]; break; }
+				if (*left == LED_PATTERN_LOOP_UNSET) *left = arg - 1;
+
+				if (*left > 0) {
+					(*left)--;
+					s->pc = s->loop_pc[s->depth - 1];
+				}
+
+				// Done: leave the loop
+				else s->depth--;
+
+				break;
+			}
+
+			default:
+				s->running = false;
+				return;
+		}
+	}
+
+	// No wait reached: malformed program
+	s->running = false;
+}
+
+static void LED_pattern_start(LED_pattern_state_type *s, const uint16_t *program, uint32_t now_ms) {
+	s->program = program;
+	s->pc = 0;
+	s->depth = 0;
+	s->level = LED_PATTERN_LEVEL_OFF;
+	s->fade_ms = 0;
+	s->running = (program != NULL);
+
+	if (s->running) LED_pattern_run(s, now_ms);
+}
+
+// Advance if due. Returns true while the pattern is still running.
+// Catches up by at most one transition per call; the caller reschedules on next_ms.
+static bool LED_pattern_step(LED_pattern_state_type *s, uint32_t now_ms) {
+	if (!s->running) return false;
+	if (!LED_pattern_due(now_ms, s->next_ms)) return true;
+
+	// Schedule from the planned edge, not from when we got to run, so timing does not drift
+	LED_pattern_run(s, s->next_ms);
+
+	return s->running;
+}
+
+#endif
@@ -0,0 +1,328 @@
+/*
+Priority-arbitrated LED status layer on top of LED_LOGGER.h.
+
+Subsystems post named states instead of calling LED_*_on() directly. Per LED, the active state
+with the highest priority wins (ties: the most recent post), and the LED is only touched when
+the winner changes, so a Wi-Fi retry blink can no longer hide an error or overwrite streaming.
+
+Usage:
+#include "woXrooX/LED_LOGGER.h"
+#include "woXrooX/LED_status.h"
+
+if (LEDs_init() != 0) return;
+LED_status_init();
+
+// name, LED, priority (higher wins), pattern, TTL in ms (0 = until cleared)
+LED_status_post("wifi_retry", LED_STATUS_ORANGE, 10, LED_PATTERN_HEARTBEAT, 0);
+LED_status_post("stream", LED_STATUS_GREEN, 20, LED_STATUS_SOLID, 0);
+LED_status_post("ws_error", LED_STATUS_RED, 50, LED_PATTERN_ERROR_2S1L, 5000);
+
+LED_status_clear("wifi_retry");
+
+// From an ISR (name and pattern must be static)
+LED_status_post_from_ISR("button", LED_STATUS_GREEN, 30, LED_STATUS_SOLID, 200, &woken);
+
+Names are compared by content; pass string literals. Patterns must outlive the post.
+*/
+
+#ifndef woXrooX_LED_status_H
+#define woXrooX_LED_status_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/timers.h"
+
+#include "esp_timer.h"
+#include "esp_log.h"
+
+#include "LED_LOGGER.h"
+
+////////////// DEFINES
+
+// Indices into LEDs[] (LED_LOGGER.h)
+#define LED_STATUS_RED 0
+#define LED_STATUS_ORANGE 1
+#define LED_STATUS_GREEN 2
+
+#define LED_STATUS_MAX 16
+
+// Posts from ISRs waiting for the timer task
+#define LED_STATUS_PENDING 8
+
+////////////// TYPES
+
+typedef struct {
+	const char *name;
+	uint8_t LED;
+	uint8_t priority;
+	const uint16_t *program;
+
+	// 0 = never
+	uint64_t expires_us;
+
+	// Post order, for ties
+	uint32_t stamp;
+
+	bool active;
+} LED_status_entry_type;
+
+////////////// GLOBALS
+
+static const char *LED_STATUS_TAG = "woXrooX::LED_status:";
+
+// Solid on until replaced
+static const uint16_t LED_STATUS_SOLID[] = {
+	LED_P_LOOP, LED_P_ON(40950), LED_P_REPEAT(0), LED_P_END
+};
+
+static LED_status_entry_type LED_status_entries[LED_STATUS_MAX];
+static uint32_t LED_status_stamp = 0;
+
+// Currently displayed winner per LED (entry index, -1 = none/off); LEDs_count <= LED_STATUS_MAX
+static int LED_status_winner[LED_STATUS_MAX];
+static const uint16_t *LED_status_winner_program[LED_STATUS_MAX];
+
+// Registry (short critical sections, ISR-safe)
+static portMUX_TYPE LED_status_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Serialises resolve → apply so two tasks cannot apply winners out of order
+static SemaphoreHandle_t LED_status_mutex = NULL;
+static StaticSemaphore_t LED_status_mutex_storage;
+
+// Fires at the earliest TTL expiry
+static TimerHandle_t LED_status_timer = NULL;
+static StaticTimer_t LED_status_timer_storage;
+
+// ISR posts, drained by the timer task
+static LED_status_entry_type LED_status_pending[LED_STATUS_PENDING];
+static uint32_t LED_status_pending_ttl_ms[LED_STATUS_PENDING];
+static size_t LED_status_pending_count = 0;
+
+////////////// Registry (call with LED_status_lock held)
+
+static int LED_status_find(const char *name) {
+	for (int i = 0; i < LED_STATUS_MAX; ++i) {
+		if (LED_status_entries[i].active && strcmp(LED_status_entries[i].name, name) == 0) return i;
+	}
+
+	return -1;
+}
+
+static int LED_status_store(const char *name, uint8_t LED, uint8_t priority, const uint16_t *program, uint64_t expires_us) {
+	int slot = LED_status_find(name);
+
+	for (int i = 0; slot < 0 && i < LED_STATUS_MAX; ++i) {
+		if (!LED_status_entries[i].active) slot = i;
+	}
+
+	if (slot < 0) return LED_return_error;
+
+	LED_status_entries[slot] = (LED_status_entry_type){
+		.name = name,
+		.LED = LED,
+		.priority = priority,
+		.program = program,
+		.expires_us = expires_us,
+		.stamp = ++LED_status_stamp,
+		.active = true
+	};
+
+	return LED_return_OK;
+}
+
+////////////// Resolve
+
+// Re-arm the TTL timer for the earliest expiry (called from tasks / timer task only)
+static void LED_status_arm_expiry(uint64_t now_us) {
+	uint64_t earliest = 0;
+
+	portENTER_CRITICAL(&LED_status_lock);
+	for (int i = 0; i < LED_STATUS_MAX; ++i) {
+		const LED_status_entry_type *e = &LED_status_entries[i];
+		if (!e->active || e->expires_us == 0) continue;
+		if (earliest == 0 || e->expires_us < earliest) earliest = e->expires_us;
+	}
+	portEXIT_CRITICAL(&LED_status_lock);
+
+	if (earliest == 0) {
+		xTimerStop(LED_status_timer, 0);
+		return;
+	}
+
+	uint64_t delay_ms = (earliest > now_us) ? (earliest - now_us + 999) / 1000 : 1;
+	TickType_t d = pdMS_TO_TICKS(delay_ms);
+	if (d == 0) d = 1;
+
+	xTimerChangePeriod(LED_status_timer, d, 0);
+}
+
+// Expire, pick the winner per LED, and touch only LEDs whose winner changed
+static void LED_status_resolve(void) {
+	uint64_t now_us = (uint64_t)esp_timer_get_time();
+
+	xSemaphoreTake(LED_status_mutex, portMAX_DELAY);
+
+	int winner[LED_STATUS_MAX];
+	const uint16_t *program[LED_STATUS_MAX];
+
+	portENTER_CRITICAL(&LED_status_lock);
+
+	for (size_t l = 0; l < LEDs_count; ++l) { winner[l] = -1; program[l] = NULL; }
+
+	for (int i = 0; i < LED_STATUS_MAX; ++i) {
+		LED_status_entry_type *e = &LED_status_entries[i];
+		if (!e->active) continue;
+
+		if (e->expires_us && e->expires_us <= now_us) {
+			e->active = false;
+			continue;
+		}
+
+		if (e->LED >= LEDs_count) continue;
+
+		int w = winner[e->LED];
+		if (w < 0
+			|| e->priority > LED_status_entries[w].priority
+			|| (e->priority == LED_status_entries[w].priority && (int32_t)(e->stamp - LED_status_entries[w].stamp) > 0)
+		) {
+			winner[e->LED] = i;
+			program[e->LED] = e->program;
+		}
+	}
+
+	portEXIT_CRITICAL(&LED_status_lock);
+
+	for (size_t l = 0; l < LEDs_count; ++l) {
+		if (winner[l] == LED_status_winner[l] && program[l] == LED_status_winner_program[l]) continue;
+
+		LED_status_winner[l] = winner[l];
+		LED_status_winner_program[l] = program[l];
+
+		if (program[l]) LED_pattern_play(&LEDs[l], program[l]);
+		else LED_off(&LEDs[l]);
+	}
+
+	LED_status_arm_expiry(now_us);
+
+	xSemaphoreGive(LED_status_mutex);
+}
+
+static void LED_status_timer_callback(TimerHandle_t tmr) {
+	(void)tmr;
+	LED_status_resolve();
+}
+
+// Runs in the timer task: move ISR posts into the registry
+static void LED_status_drain_pending(void *arg1, uint32_t arg2) {
+	(void)arg1;
+	(void)arg2;
+
+	uint64_t now_us = (uint64_t)esp_timer_get_time();
+
+	portENTER_CRITICAL(&LED_status_lock);
+
+	for (size_t i = 0; i < LED_status_pending_count; ++i) {
+		const LED_status_entry_type *p = &LED_status_pending[i];
+		uint32_t ttl_ms = LED_status_pending_ttl_ms[i];
+
+		if (p->program) LED_status_store(p->name, p->LED, p->priority, p->program, ttl_ms ? now_us + (uint64_t)ttl_ms * 1000 : 0);
+		else {
+			int slot = LED_status_find(p->name);
+			if (slot >= 0) LED_status_entries[slot].active = false;
+		}
+	}
+
+	LED_status_pending_count = 0;
+
+	portEXIT_CRITICAL(&LED_status_lock);
+
+	LED_status_resolve();
+}
+
+////////////// API
+
+static int LED_status_init(void) {
+	if (LED_status_mutex) return LED_return_OK;
+
+	for (int i = 0; i < LED_STATUS_MAX; ++i) {
+		LED_status_winner[i] = -1;
+		LED_status_winner_program[i] = NULL;
+	}
+
+	LED_status_mutex = xSemaphoreCreateMutexStatic(&LED_status_mutex_storage);
+	LED_status_timer = xTimerCreateStatic("LED_status", 1, pdFALSE, NULL, LED_status_timer_callback, &LED_status_timer_storage);
+
+	if (!LED_status_mutex || !LED_status_timer) return LED_return_error;
+
+	return LED_return_OK;
+}
+
+// Post or update a named state. ttl_ms = 0 → stays until LED_status_clear().
+static int LED_status_post(const char *name, uint8_t LED, uint8_t priority, const uint16_t *program, uint32_t ttl_ms) {
+	if (!LED_status_mutex) return LED_return_not_initialized;
+	if (!name || !program || LED >= LEDs_count) return LED_return_error;
+
+	uint64_t expires_us = ttl_ms ? (uint64_t)esp_timer_get_time() + (uint64_t)ttl_ms * 1000 : 0;
+
+	portENTER_CRITICAL(&LED_status_lock);
+	int response = LED_status_store(name, LED, priority, program, expires_us);
+	portEXIT_CRITICAL(&LED_status_lock);
+
+	if (response != LED_return_OK) {
+		ESP_LOGW(LED_STATUS_TAG, "Registry full, '%s' dropped", name);
+		return response;
+	}
+
+	LED_status_resolve();
+
+	return LED_return_OK;
+}
+
+static int LED_status_clear(const char *name) {
+	if (!LED_status_mutex) return LED_return_not_initialized;
+
+	portENTER_CRITICAL(&LED_status_lock);
+	int slot = LED_status_find(name);
+	if (slot >= 0) LED_status_entries[slot].active = false;
+	portEXIT_CRITICAL(&LED_status_lock);
+
+	if (slot >= 0) LED_status_resolve();
+
+	return LED_return_OK;
+}
+
+// ISR-safe: queued and applied from the timer task
+static int LED_status_post_from_ISR(const char *name, uint8_t LED, uint8_t priority, const uint16_t *program, uint32_t ttl_ms, BaseType_t *woken) {
+	if (!LED_status_mutex || !name || LED >= LEDs_count) return LED_return_error;
+
+	portENTER_CRITICAL_ISR(&LED_status_lock);
+
+	bool queued = LED_status_pending_count < LED_STATUS_PENDING;
+	bool first = LED_status_pending_count == 0;
+
+	if (queued) {
+		LED_status_pending[LED_status_pending_count] = (LED_status_entry_type){ .name = name, .LED = LED, .priority = priority, .program = program };
+		LED_status_pending_ttl_ms[LED_status_pending_count] = ttl_ms;
+		LED_status_pending_count++;
+	}
+
+	portEXIT_CRITICAL_ISR(&LED_status_lock);
+
+	if (!queued) return LED_return_error;
+
+	// One deferred call drains everything queued until it runs
+	if (first && xTimerPendFunctionCallFromISR(LED_status_drain_pending, NULL, 0, woken) != pdPASS) return LED_return_error;
+
+	return LED_return_OK;
+}
+
+static int LED_status_clear_from_ISR(const char *name, BaseType_t *woken) {
+	// program == NULL marks a clear
+	return LED_status_post_from_ISR(name, 0, 0, NULL, 0, woken);
+}
+
+#endif
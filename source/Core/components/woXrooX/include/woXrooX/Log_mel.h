@@ -0,0 +1,256 @@
+/*
+Log-mel features: Hann window → 512-point FFT → LOG_MEL_BANDS triangular mel bands → dB.
+
+Every LOG_MEL_HOP_MS the last LOG_MEL_WINDOW_MS of audio becomes one vector of LOG_MEL_BANDS
+bytes, q = 2 × 10·log10(band power / FFT size), clamped to 0..255 (0.5 dB steps, 0..127.5 dB).
+Hops fall on multiples of LOG_MEL_HOP_MS since init, so when frames are a whole number of hops,
+vector i of a frame covers the window ending (i + 1) hops after the frame start.
+At 16 kHz that is 40 bytes per 10 ms instead of 320 bytes of PCM.
+
+Usage:
+
+	static Log_mel_state_type mel;
+	Log_mel_init(&mel, 16000);
+
+	uint8_t features[4][LOG_MEL_BANDS];
+	size_t hops = Log_mel_push(&mel, frame.pcm, frame.samples, features, 4);   // 2 hops per 20 ms frame
+
+	// On the device: cycles per hop (logged)
+	Log_mel_measure_cost(&mel);
+
+Single-precision float throughout: the ESP32 has an FPU, and the same code runs unchanged on a
+host next to a double-precision reference (host_test/test_Log_mel.c: every band within 0.6 q,
+i.e. rounding plus 0.1 q). Tables are built once in Log_mel_init(); the per-hop path has no
+allocation and no trig calls. Sample rates up to LOG_MEL_RATE_MAX.
+*/
+
+#ifndef woXrooX_Log_mel_H
+#define woXrooX_Log_mel_H
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+////////////// DEFINES
+
+#define LOG_MEL_BANDS 40
+
+#define LOG_MEL_FFT 512
+#define LOG_MEL_BINS (LOG_MEL_FFT / 2 + 1)
+
+#define LOG_MEL_WINDOW_MS 25
+#define LOG_MEL_HOP_MS 10
+
+#define LOG_MEL_RATE_MAX 16000
+#define LOG_MEL_WINDOW_MAX (LOG_MEL_RATE_MAX * LOG_MEL_WINDOW_MS / 1000)
+
+// Band edges (Hz); the top one is pulled below Nyquist at low sample rates
+#define LOG_MEL_F_MIN 20.0f
+#define LOG_MEL_F_MAX 7600.0f
+
+// q = dB × LOG_MEL_Q_PER_DB
+#define LOG_MEL_Q_PER_DB 2.0f
+
+#define LOG_MEL_return_OK 0
+#define LOG_MEL_return_error -1
+
+////////////// TYPES
+
+typedef struct {
+	uint32_t sample_rate;
+	uint16_t window;
+	uint16_t hop;
+
+	float window_table[LOG_MEL_WINDOW_MAX];
+	float cos_table[LOG_MEL_FFT / 2];
+	float sin_table[LOG_MEL_FFT / 2];
+	uint16_t bit_reverse[LOG_MEL_FFT];
+
+	// Bin k feeds band[k] (rising edge, weight[k]) and band[k] - 1 (falling edge, 1 - weight[k]); -1 = no band
+	int8_t band[LOG_MEL_BINS];
+	float weight[LOG_MEL_BINS];
+
+	// Last `window` samples (ring) and progress towards the next hop
+	int16_t history[LOG_MEL_WINDOW_MAX];
+	uint16_t history_pos;
+	uint16_t history_fill;
+	uint16_t since_hop;
+
+	float re[LOG_MEL_FFT];
+	float im[LOG_MEL_FFT];
+} Log_mel_state_type;
+
+////////////// Tables
+
+static inline float Log_mel_from_Hz(float f) {
+	return 2595.0f * log10f(1.0f + f / 700.0f);
+}
+
+static inline float Log_mel_to_Hz(float m) {
+	return 700.0f * (powf(10.0f, m / 2595.0f) - 1.0f);
+}
+
+static int Log_mel_init(Log_mel_state_type *s, uint32_t sample_rate) {
+	if (!s || sample_rate == 0 || sample_rate > LOG_MEL_RATE_MAX) return LOG_MEL_return_error;
+
+	memset(s, 0, sizeof(*s));
+	s->sample_rate = sample_rate;
+	s->window = (uint16_t)(sample_rate * LOG_MEL_WINDOW_MS / 1000);
+	s->hop = (uint16_t)(sample_rate * LOG_MEL_HOP_MS / 1000);
+
+	const float pi = 3.14159265358979f;
+
+	for (int i = 0; i < s->window; ++i) s->window_table[i] = 0.5f - 0.5f * cosf(2.0f * pi * (float)i / (float)(s->window - 1));
+
+	for (int i = 0; i < LOG_MEL_FFT / 2; ++i) {
+		s->cos_table[i] = cosf(2.0f * pi * (float)i / LOG_MEL_FFT);
+		s->sin_table[i] = -sinf(2.0f * pi * (float)i / LOG_MEL_FFT);
+	}
+
+	for (int i = 0; i < LOG_MEL_FFT; ++i) {
+		uint16_t r = 0;
+		for (int b = 0; (1 << b) < LOG_MEL_FFT; ++b) if (i & (1 << b)) r |= (uint16_t)(LOG_MEL_FFT >> (b + 1));
+		s->bit_reverse[i] = r;
+	}
+
+	// LOG_MEL_BANDS + 2 points evenly spaced in mel
+	float f_max = LOG_MEL_F_MAX;
+	if (f_max > 0.475f * (float)sample_rate) f_max = 0.475f * (float)sample_rate;
+
+	float mel_min = Log_mel_from_Hz(LOG_MEL_F_MIN);
+	float mel_max = Log_mel_from_Hz(f_max);
+	float points[LOG_MEL_BANDS + 2];
+
+	for (int j = 0; j < LOG_MEL_BANDS + 2; ++j) points[j] = Log_mel_to_Hz(mel_min + (mel_max - mel_min) * (float)j / (LOG_MEL_BANDS + 1));
+
+	for (int k = 0; k < LOG_MEL_BINS; ++k) {
+		float f = (float)k * (float)sample_rate / LOG_MEL_FFT;
+
+		s->band[k] = -1;
+		s->weight[k] = 0.0f;
+
+		for (int j = 0; j <= LOG_MEL_BANDS; ++j) {
+			if (f >= points[j] && f < points[j + 1]) {
+				s->band[k] = (int8_t)j;
+				s->weight[k] = (f - points[j]) / (points[j + 1] - points[j]);
+				break;
+			}
+		}
+	}
+
+	return LOG_MEL_return_OK;
+}
+
+////////////// Hop
+
+// In-place iterative radix-2 FFT on s->re / s->im (input already bit-reversed)
+static void Log_mel_FFT(Log_mel_state_type *s) {
+	for (int size = 2; size <= LOG_MEL_FFT; size <<= 1) {
+		int half = size >> 1;
+		int stride = LOG_MEL_FFT / size;
+
+		for (int start = 0; start < LOG_MEL_FFT; start += size) {
+			for (int k = 0; k < half; ++k) {
+				float wr = s->cos_table[k * stride];
+				float wi = s->sin_table[k * stride];
+
+				int a = start + k;
+				int b = a + half;
+
+				float tr = s->re[b] * wr - s->im[b] * wi;
+				float ti = s->re[b] * wi + s->im[b] * wr;
+
+				s->re[b] = s->re[a] - tr;
+				s->im[b] = s->im[a] - ti;
+				s->re[a] += tr;
+				s->im[a] += ti;
+			}
+		}
+	}
+}
+
+// Window the current history into the FFT input and produce one feature vector
+static void Log_mel_hop(Log_mel_state_type *s, uint8_t *out) {
+	for (int i = 0; i < LOG_MEL_FFT; ++i) {
+		s->re[i] = 0.0f;
+		s->im[i] = 0.0f;
+	}
+
+	// Oldest sample first; zero-padded up to the FFT size
+	for (int i = 0; i < s->window; ++i) {
+		int16_t sample = s->history[(s->history_pos + i) % s->window];
+		s->re[s->bit_reverse[i]] = (float)sample * s->window_table[i];
+	}
+
+	Log_mel_FFT(s);
+
+	float energy[LOG_MEL_BANDS];
+	for (int b = 0; b < LOG_MEL_BANDS; ++b) energy[b] = 0.0f;
+
+	for (int k = 0; k < LOG_MEL_BINS; ++k) {
+		int j = s->band[k];
+		if (j < 0) continue;
+
+		float power = (s->re[k] * s->re[k] + s->im[k] * s->im[k]) * (1.0f / LOG_MEL_FFT);
+
+		if (j < LOG_MEL_BANDS) energy[j] += s->weight[k] * power;
+		if (j > 0) energy[j - 1] += (1.0f - s->weight[k]) * power;
+	}
+
+	for (int b = 0; b < LOG_MEL_BANDS; ++b) {
+		// +1 floors silence at 0 dB
+		float q = 10.0f * log10f(energy[b] + 1.0f) * LOG_MEL_Q_PER_DB + 0.5f;
+		out[b] = (q <= 0.0f) ? 0 : (q >= 255.0f) ? 255 : (uint8_t)q;
+	}
+}
+
+////////////// API
+
+// Feed samples; writes one LOG_MEL_BANDS vector per completed hop (at most max_hops). Returns hops written.
+static size_t Log_mel_push(Log_mel_state_type *s, const int16_t *pcm, size_t n, uint8_t (*out)[LOG_MEL_BANDS], size_t max_hops) {
+	size_t hops = 0;
+
+	for (size_t i = 0; i < n; ++i) {
+		s->history[s->history_pos] = pcm[i];
+		s->history_pos = (uint16_t)((s->history_pos + 1) % s->window);
+		if (s->history_fill < s->window) s->history_fill++;
+
+		if (++s->since_hop < s->hop) continue;
+		s->since_hop = 0;
+
+		// Hops land on multiples of `hop` samples since init/reset; the first once a full window is in
+		if (s->history_fill == s->window && hops < max_hops) Log_mel_hop(s, out[hops++]);
+	}
+
+	return hops;
+}
+
+// Clear the audio history (e.g. between PTT spans) without rebuilding tables
+static void Log_mel_reset(Log_mel_state_type *s) {
+	memset(s->history, 0, sizeof(s->history));
+	s->history_pos = 0;
+	s->history_fill = 0;
+	s->since_hop = 0;
+}
+
+#ifdef ESP_PLATFORM
+#include "esp_cpu.h"
+#include "esp_log.h"
+
+// Cycles for one hop on this chip (recomputes the current window; output discarded)
+static uint32_t Log_mel_measure_cost(Log_mel_state_type *s) {
+	const int N = 20;
+	uint8_t out[LOG_MEL_BANDS];
+
+	uint32_t t0 = esp_cpu_get_cycle_count();
+	for (int i = 0; i < N; ++i) Log_mel_hop(s, out);
+	uint32_t per_hop = (esp_cpu_get_cycle_count() - t0) / N;
+
+	ESP_LOGI("woXrooX::Log_mel:", "%u cycles per hop (%u bands, %u-point FFT)", (unsigned)per_hop, LOG_MEL_BANDS, LOG_MEL_FFT);
+
+	return per_hop;
+}
+#endif
+
+#endif
@@ -0,0 +1,481 @@
+#ifndef woXrooX_MIC_H
+#define woXrooX_MIC_H
+
+/////// I²S
+// Wiring (INMP441, default pins; woXrooX → Pins in menuconfig):
+// VDD → 3v3
+// GND → GND
+// SCK (BCLK) → D33 (GPIO33)
+// WS (LRCLK) → D25 (GPIO25)
+// SD (data out) → D32 (GPIO32)
+// L/R → GND (mic = Left channel)
+
+/*
+Usage:
+
+MIC_listen_start();
+
+// Any time later (e.g. on a WS_TYPE_CONFIG message from the server): 8 kHz, 10 ms frames
+MIC_config_type config = { .sample_rate = 8000, .frame_ms = 10 };
+MIC_configure(&config);
+
+QueueHandle_t que = MIC_listen_queue();
+MIC_frame_type frame;
+
+for (;;) {
+	if (xQueueReceive(que, &frame, portMAX_DELAY) == pdTRUE) {
+		// frame.seq, frame.ts_us, frame.pcm[frame.samples] at frame.sample_rate → WebSocket streamer / VAD / STT
+		// frame.ts_us = esp_timer_get_time() at which pcm[0] was captured
+	}
+}
+
+// Capture health: read jitter and DMA buffers lost because MIC_RX was late
+MIC_timing_type timing;
+MIC_timing(&timing);
+
+MIC_RX placement (core / priority / stack) comes from Tasks.h.
+
+I2S always runs at MIC_I2S_RATE; MIC_RX decimates to the configured rate (Decimator.h), so a
+change never touches the clock. DMA buffers are sized from the frame: one buffer per frame (split
+evenly above the 4092-byte DMA limit), so a frame is complete the moment its last buffer lands,
+and enough of them for MIC_DMA_SLACK_MS of scheduling slack. A change is applied by MIC_RX between
+two reads, by recreating the channel; frames already queued keep their own rate and length. If
+the driver refuses the new channel, MIC_RX goes back to the previous config (MIC_config() shows
+it); with no channel at all it retries every MIC_RETRY_MS.
+*/
+
+
+
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+
+#include "esp_timer.h"
+#include "esp_log.h"
+
+#include "esp_attr.h"
+
+#include "driver/i2s_std.h"
+
+#include "Decimator.h"
+#include "Metrics.h"
+#include "DLOG.h"
+#include "Tasks.h"
+
+////////////// DEFINES
+
+// Fallbacks when the Kconfig menu is not part of the build (woXrooX → Pins / Queues)
+#ifndef CONFIG_WOXROOX_MIC_PIN_BCLK
+#define CONFIG_WOXROOX_MIC_PIN_BCLK 33
+#define CONFIG_WOXROOX_MIC_PIN_LRCK 25
+#define CONFIG_WOXROOX_MIC_PIN_DIN 32
+#define CONFIG_WOXROOX_MIC_QUEUE_LEN 32
+#endif
+
+#define PIN_BCLK CONFIG_WOXROOX_MIC_PIN_BCLK
+#define PIN_LRCK CONFIG_WOXROOX_MIC_PIN_LRCK
+#define PIN_DIN CONFIG_WOXROOX_MIC_PIN_DIN
+
+// I2S clock; every supported output rate divides it
+#define MIC_I2S_RATE 48000
+
+// Capture until MIC_configure(): STT framing, 20 ms = 320 samples @ 16 kHz
+#define MIC_DEFAULT_SAMPLE_RATE 16000
+#define MIC_DEFAULT_FRAME_MS 20
+
+// Accepted by MIC_configure(): 8 / 12 / 16 kHz, 10..40 ms in whole hops of 10 ms
+#define MIC_SAMPLE_RATE_MIN 8000
+#define MIC_SAMPLE_RATE_MAX 16000
+#define MIC_FRAME_MS_STEP 10
+#define MIC_FRAME_MS_MAX 40
+
+#define MIC_FRAME_SAMPLES_MAX (MIC_SAMPLE_RATE_MAX * MIC_FRAME_MS_MAX / 1000)
+
+// One DMA buffer can hold at most 4092 bytes
+#define MIC_DMA_BUFFER_WORDS_MAX 1023
+
+// Audio the DMA ring can hold while MIC_RX is late
+#define MIC_DMA_SLACK_MS 60
+#define MIC_DMA_BUFFERS_MIN 3
+
+// No I2S channel (the driver refused even the previous config): retry this often
+#define MIC_RETRY_MS 1000
+
+// Right-shift from 24-bit-left-justified to 16-bit PCM (tune 8..12)
+#define SHIFT_BITS 11
+
+// Queue capacity (frames), sized for MIC_FRAME_SAMPLES_MAX. 32 ≈ 0.64 s at 20 ms/frame, 1.28 s at 40 ms
+#define MIC_QUEUE_LEN CONFIG_WOXROOX_MIC_QUEUE_LEN
+
+#define MIC_return_OK 0
+#define MIC_return_error -1
+
+////////////// TYPES
+
+typedef struct {
+	uint32_t sample_rate;
+	uint16_t frame_ms;
+} MIC_config_type;
+
+typedef struct {
+	uint32_t seq;
+	uint64_t ts_us;
+	uint32_t sample_rate;
+	uint16_t samples;
+	int16_t  pcm[MIC_FRAME_SAMPLES_MAX];
+} MIC_frame_type;
+
+typedef void (*MIC_tap_type)(const MIC_frame_type *frame);
+
+typedef struct {
+	uint32_t reads;
+
+	// Read-to-read interval vs. the audio it returned, |actual - expected|
+	uint32_t jitter_max_us;
+	uint32_t jitter_mean_us;
+
+	// DMA buffers the driver had to drop (MIC_RX did not read in time)
+	uint32_t DMA_overflows;
+} MIC_timing_type;
+
+////////////// GLOBALS
+
+static const char *MIC_TAG = "woXrooX::MIC:";
+
+// Read buffer (one DMA buffer): 32-bit words. Mic gives 24 valid bits left-justified in 32.
+static int32_t MIC_buffer[MIC_DMA_BUFFER_WORDS_MAX];
+
+static i2s_chan_handle_t RX_channel = NULL;
+
+// Active capture; owned by MIC_RX once it runs
+static MIC_config_type MIC_active = { .sample_rate = MIC_DEFAULT_SAMPLE_RATE, .frame_ms = MIC_DEFAULT_FRAME_MS };
+static uint16_t MIC_frame_samples = 0;
+static uint32_t MIC_DMA_words = 0;
+static Decimator_type MIC_decimator;
+
+// Requested by MIC_configure(), picked up by MIC_RX between reads
+static portMUX_TYPE MIC_config_lock = portMUX_INITIALIZER_UNLOCKED;
+static MIC_config_type MIC_pending;
+static bool MIC_config_pending = false;
+
+// Frame assembly (carry remainder across I2S reads); static, too big for the MIC_RX stack
+static MIC_frame_type MIC_frame;
+static MIC_frame_type MIC_frame_dump;
+static size_t  frame_fill = 0;
+static uint32_t frame_seq = 0;
+
+static QueueHandle_t MIC_queue = NULL;
+
+// Called by MIC_RX with every complete frame, before it is queued (HTTP_server.h uses it)
+static MIC_tap_type MIC_tap = NULL;
+
+// Read timing (written by MIC_RX only; overflows by the I2S ISR)
+static uint64_t MIC_last_read_us = 0;
+static uint32_t MIC_reads = 0;
+static uint32_t MIC_jitter_max_us = 0;
+static uint64_t MIC_jitter_sum_us = 0;
+static volatile uint32_t MIC_DMA_overflows = 0;
+
+////////////// I2S
+
+// The driver's receive queue was full: a DMA buffer of audio is gone
+static bool IRAM_ATTR MIC_on_recv_q_ovf(i2s_chan_handle_t handle, i2s_event_data_t *event, void *user_ctx) {
+	(void)handle;
+	(void)event;
+	(void)user_ctx;
+
+	MIC_DMA_overflows++;
+	METRIC_INC(MIC_DMA_overflows);
+
+	return false;
+}
+
+static bool MIC_config_valid(const MIC_config_type *config) {
+	return config->sample_rate >= MIC_SAMPLE_RATE_MIN
+		&& config->sample_rate <= MIC_SAMPLE_RATE_MAX
+		&& MIC_I2S_RATE % config->sample_rate == 0
+		&& config->frame_ms >= MIC_FRAME_MS_STEP
+		&& config->frame_ms <= MIC_FRAME_MS_MAX
+		&& config->frame_ms % MIC_FRAME_MS_STEP == 0;
+}
+
+// DMA buffers aligned to frames: buffers_per_frame × words = one frame of I2S input
+static void MIC_DMA_layout(const MIC_config_type *config, uint32_t *buffers, uint32_t *words) {
+	uint32_t frame_words = MIC_I2S_RATE / 1000 * config->frame_ms;
+	uint32_t buffers_per_frame = (frame_words + MIC_DMA_BUFFER_WORDS_MAX - 1) / MIC_DMA_BUFFER_WORDS_MAX;
+	uint32_t buffer_ms = config->frame_ms / buffers_per_frame;
+
+	*words = frame_words / buffers_per_frame;
+	*buffers = (MIC_DMA_SLACK_MS + buffer_ms - 1) / buffer_ms;
+	if (*buffers < MIC_DMA_BUFFERS_MIN) *buffers = MIC_DMA_BUFFERS_MIN;
+}
+
+// Create, configure and enable RX_channel; on failure nothing is left behind
+static esp_err_t init_i2s(const MIC_config_type *config) {
+	uint32_t buffers = 0;
+	MIC_DMA_layout(config, &buffers, &MIC_DMA_words);
+
+	// Create RX channel
+	i2s_chan_config_t chan_cfg = I2S_CHANNEL_DEFAULT_CONFIG(0, I2S_ROLE_MASTER);
+	chan_cfg.dma_desc_num  = buffers;
+	chan_cfg.dma_frame_num = MIC_DMA_words;
+
+	esp_err_t err = i2s_new_channel(&chan_cfg, NULL, &RX_channel);
+	if (err != ESP_OK) {
+		ESP_LOGE(MIC_TAG, "i2s_new_channel failed (%s)", esp_err_to_name(err));
+		RX_channel = NULL;
+		return err;
+	}
+
+	// Clock config (APLL = cleaner clock)
+	i2s_std_clk_config_t clk_cfg = I2S_STD_CLK_DEFAULT_CONFIG(MIC_I2S_RATE);
+	clk_cfg.clk_src = I2S_CLK_SRC_APLL;
+
+	// Slot config: Philips I2S, 32-bit slots, mono LEFT
+	i2s_std_slot_config_t slot_cfg = {
+		.data_bit_width = I2S_DATA_BIT_WIDTH_32BIT,
+		.slot_bit_width = I2S_SLOT_BIT_WIDTH_32BIT,
+		.slot_mode = I2S_SLOT_MODE_MONO,
+		.slot_mask = I2S_STD_SLOT_LEFT,
+
+		// auto: 1 BCLK for Philips
+		.ws_width = 0,
+
+		// standard WS polarity
+		.ws_pol = false,
+
+		// Philips format (data delayed by 1 BCLK)
+		.bit_shift = true
+	};
+
+	// GPIO config
+	i2s_std_gpio_config_t gpio_cfg = {
+		.mclk = I2S_GPIO_UNUSED,
+		.bclk = PIN_BCLK,
+		.ws = PIN_LRCK,
+		.dout = I2S_GPIO_UNUSED,
+		.din = PIN_DIN,
+
+		.invert_flags = {
+			.mclk_inv = false,
+			.bclk_inv = false,
+			.ws_inv = false
+		}
+	};
+
+	// STD config
+	i2s_std_config_t std_cfg = {
+		.clk_cfg = clk_cfg,
+		.slot_cfg = slot_cfg,
+		.gpio_cfg = gpio_cfg
+	};
+
+	err = i2s_channel_init_std_mode(RX_channel, &std_cfg);
+
+	// Must be registered before the channel is enabled
+	i2s_event_callbacks_t callbacks = { .on_recv_q_ovf = MIC_on_recv_q_ovf };
+	if (err == ESP_OK) err = i2s_channel_register_event_callback(RX_channel, &callbacks, NULL);
+
+	if (err == ESP_OK) err = i2s_channel_enable(RX_channel);
+
+	if (err != ESP_OK) {
+		ESP_LOGE(MIC_TAG, "I2S setup for %u Hz, %u ms failed (%s)", (unsigned)config->sample_rate, config->frame_ms, esp_err_to_name(err));
+		i2s_del_channel(RX_channel);
+		RX_channel = NULL;
+		return err;
+	}
+
+	ESP_LOGI(MIC_TAG, "%u Hz, %u ms frames: I2S %u Hz, %u DMA buffers × %u words", (unsigned)config->sample_rate, config->frame_ms, MIC_I2S_RATE, (unsigned)buffers, (unsigned)MIC_DMA_words);
+
+	return ESP_OK;
+}
+
+// Framing and filter for config; the partial frame in progress is discarded
+static void MIC_chain_set(const MIC_config_type *config) {
+	MIC_active = *config;
+	MIC_frame_samples = (uint16_t)(config->sample_rate * config->frame_ms / 1000);
+	Decimator_init(&MIC_decimator, MIC_I2S_RATE, config->sample_rate);
+
+	frame_fill = 0;
+	MIC_last_read_us = 0;
+}
+
+// (Re)build the capture chain for config. If the driver refuses it, the previous config is
+// restored and MIC_return_error returned; RX_channel stays NULL only if that fails too.
+static int MIC_apply(const MIC_config_type *config) {
+	const MIC_config_type previous = MIC_active;
+
+	if (RX_channel) {
+		i2s_channel_disable(RX_channel);
+		i2s_del_channel(RX_channel);
+		RX_channel = NULL;
+	}
+
+	if (init_i2s(config) == ESP_OK) {
+		MIC_chain_set(config);
+		return MIC_return_OK;
+	}
+
+	if (config != &MIC_active && init_i2s(&previous) == ESP_OK) {
+		ESP_LOGW(MIC_TAG, "Kept %u Hz, %u ms", (unsigned)previous.sample_rate, previous.frame_ms);
+		MIC_chain_set(&previous);
+	}
+
+	return MIC_return_error;
+}
+
+////////////// TASK: read I2S → decimate → make frames → enqueue
+
+static void mic_rx_task(void *param) {
+	(void)param;
+
+	while (1) {
+		if (MIC_config_pending) {
+			MIC_config_type config;
+
+			taskENTER_CRITICAL(&MIC_config_lock);
+			config = MIC_pending;
+			MIC_config_pending = false;
+			taskEXIT_CRITICAL(&MIC_config_lock);
+
+			MIC_apply(&config);
+		}
+
+		if (!RX_channel) {
+			vTaskDelay(pdMS_TO_TICKS(MIC_RETRY_MS));
+			MIC_apply(&MIC_active);
+			continue;
+		}
+
+		size_t nbytes = 0;
+		esp_err_t err = i2s_channel_read(RX_channel, MIC_buffer, MIC_DMA_words * sizeof(int32_t), &nbytes, portMAX_DELAY);
+		if (err != ESP_OK || nbytes == 0) {
+			DLOG_W(MIC_TAG, "i2s read failed (%d), %u bytes", err, nbytes);
+			continue;
+		}
+
+		// The last sample of this read was captured (roughly) now
+		const uint64_t read_us = (uint64_t)esp_timer_get_time();
+
+		const size_t n = nbytes / sizeof(int32_t);
+
+		// Reads should come back exactly one buffer of audio apart
+		if (MIC_last_read_us) {
+			int64_t interval_us = (int64_t)(read_us - MIC_last_read_us);
+			int64_t expected_us = (int64_t)((uint64_t)n * 1000000ULL / MIC_I2S_RATE);
+			uint32_t jitter_us = (uint32_t)(interval_us > expected_us ? interval_us - expected_us : expected_us - interval_us);
+
+			MIC_reads++;
+			MIC_jitter_sum_us += jitter_us;
+			if (jitter_us > MIC_jitter_max_us) MIC_jitter_max_us = jitter_us;
+			METRIC_OBSERVE(MIC_read_jitter_us, jitter_us);
+		}
+
+		MIC_last_read_us = read_us;
+
+		const uint32_t delay_us = Decimator_delay_us(&MIC_decimator);
+
+		for (size_t i = 0; i < n; ++i) {
+			int32_t s32 = MIC_buffer[i] >> SHIFT_BITS;
+			int16_t s16 = (int16_t)(s32 > 32767 ? 32767 : s32 < -32768 ? -32768 : s32);
+
+			if (!Decimator_push(&MIC_decimator, s16, &s16)) continue;
+
+			// Capture time of the first sample of an empty frame, back-dated from the read and the filter delay
+			if (frame_fill == 0) MIC_frame.ts_us = read_us - ((uint64_t)(n - i) * 1000000ULL) / MIC_I2S_RATE - delay_us;
+
+			MIC_frame.pcm[frame_fill++] = s16;
+
+			if (frame_fill == MIC_frame_samples) {
+				MIC_frame.seq = ++frame_seq;
+				MIC_frame.sample_rate = MIC_active.sample_rate;
+				MIC_frame.samples = MIC_frame_samples;
+
+				METRIC_INC(MIC_frames);
+
+				if (MIC_tap) MIC_tap(&MIC_frame);
+
+				if (MIC_queue) {
+					// If full, drop the oldest to keep latency bounded
+					if (xQueueSend(MIC_queue, &MIC_frame, 0) != pdTRUE) {
+						xQueueReceive(MIC_queue, &MIC_frame_dump, 0);
+						xQueueSend(MIC_queue, &MIC_frame, 0);
+						METRIC_INC(MIC_dropped);
+						DLOG_W(MIC_TAG, "Queue full, dropped oldest frame before seq=%u", MIC_frame.seq);
+					}
+
+					METRIC_SET(MIC_queue_depth, uxQueueMessagesWaiting(MIC_queue));
+				}
+
+				frame_fill = 0;
+			}
+		}
+	}
+}
+
+////////////// API
+
+// Call once at startup to begin capturing and enqueuing frames. MIC_return_error if I2S could not
+// be set up yet (MIC_RX keeps retrying) or the task could not be created.
+static int MIC_listen_start(void) {
+	if (!MIC_queue) MIC_queue = xQueueCreate(MIC_QUEUE_LEN, sizeof(MIC_frame_type));
+
+	int response = MIC_apply(&MIC_active);
+	if (Tasks_create(TASK_MIC_RX, mic_rx_task, NULL, NULL) != 0) return MIC_return_error;
+
+	return response;
+}
+
+// Change rate / frame length at runtime; applied by MIC_RX before its next read (≤ one DMA buffer)
+static int MIC_configure(const MIC_config_type *config) {
+	if (!config || !MIC_config_valid(config)) {
+		ESP_LOGW(MIC_TAG, "Unsupported capture config: %u Hz, %u ms", config ? (unsigned)config->sample_rate : 0, config ? config->frame_ms : 0);
+		return MIC_return_error;
+	}
+
+	taskENTER_CRITICAL(&MIC_config_lock);
+	MIC_pending = *config;
+	MIC_config_pending = true;
+	taskEXIT_CRITICAL(&MIC_config_lock);
+
+	return MIC_return_OK;
+}
+
+// Requested capture (a pending change counts as applied)
+static void MIC_config(MIC_config_type *out) {
+	taskENTER_CRITICAL(&MIC_config_lock);
+	*out = MIC_config_pending ? MIC_pending : MIC_active;
+	taskEXIT_CRITICAL(&MIC_config_lock);
+}
+
+// Duration of a frame in us
+static inline uint64_t MIC_frame_us(const MIC_frame_type *frame) {
+	return (uint64_t)frame->samples * 1000000ULL / frame->sample_rate;
+}
+
+// Second consumer next to the queue; runs on MIC_RX, so it must be quick and never block
+static void MIC_tap_set(MIC_tap_type tap) {
+	MIC_tap = tap;
+}
+
+// Getter for your STT task: pop frames with xQueueReceive()
+static QueueHandle_t MIC_listen_queue(void) {
+	return MIC_queue;
+}
+
+// Snapshot of the capture timing since start (reads from another task may be off by one read)
+static void MIC_timing(MIC_timing_type *out) {
+	uint32_t reads = MIC_reads;
+
+	out->reads = reads;
+	out->jitter_max_us = MIC_jitter_max_us;
+	out->jitter_mean_us = reads ? (uint32_t)(MIC_jitter_sum_us / reads) : 0;
+	out->DMA_overflows = MIC_DMA_overflows;
+}
+
+#endif
@@ -0,0 +1,255 @@
+/*
+Runtime metrics: counters, gauges and fixed-bucket histograms for every woXrooX module.
+
+All metrics are declared in the lists below (X-macros), so registration happens at compile
+time: each metric is an enum ID indexing static arrays, and an increment is a single relaxed
+atomic add on the calling core's own slot. No names, locks or lookups on the hot path.
+
+Usage:
+
+	METRIC_INC(WS_sent);
+	METRIC_ADD(HTTP_bytes, n);
+	METRIC_SET(WiFi_RSSI, rssi);
+	METRIC_OBSERVE(HTTP_latency_us, dt);
+
+	uint8_t buffer[METRICS_SNAPSHOT_MAX];
+	size_t n = Metrics_snapshot(buffer, sizeof(buffer));
+
+	// Cycles per METRIC_INC on this chip (logged, and kept in the Metrics_inc_cycles gauge)
+	Metrics_measure_cost();
+
+Snapshot (little-endian):
+	"WXM1" | u8 cores | u8 counters | u8 gauges | u8 histograms | u64 ts_us
+	| counters × u32 (summed over cores)
+	| gauges × i32
+	| histograms × (u32 count | u64 sum | METRICS_BUCKETS × u32)
+
+Histogram bucket i holds values in [2^(i-1), 2^i), bucket 0 holds 0; the last one is open-ended.
+IDs follow the order of the lists below; Metrics_counter_name() etc. give the names.
+*/
+
+#ifndef woXrooX_Metrics_H
+#define woXrooX_Metrics_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "esp_cpu.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+////////////// METRICS
+
+#define METRICS_COUNTERS(X) \
+	X(MIC_frames) \
+	X(MIC_dropped) \
+	X(MIC_DMA_overflows) \
+	X(WS_sent) \
+	X(WS_send_failed) \
+	X(WS_PTT_markers) \
+	X(HTTP_requests) \
+	X(HTTP_errors) \
+	X(HTTP_reused) \
+	X(WiFi_disconnects) \
+	X(WiFi_connects) \
+	X(Button_edges) \
+	X(Buttons_dropped) \
+	X(PTT_edges_coalesced) \
+	X(LED_transitions) \
+	X(Spool_written) \
+	X(Spool_drained) \
+	X(Spool_erased_ahead) \
+	X(Spool_erase_waits) \
+	X(HTTP_stream_frames) \
+	X(HTTP_stream_skipped)
+
+#define METRICS_GAUGES(X) \
+	X(WiFi_RSSI) \
+	X(WiFi_link_degraded) \
+	X(MIC_queue_depth) \
+	X(Metrics_inc_cycles) \
+	X(Heap_free) \
+	X(Heap_min_free) \
+	X(Heap_largest_block) \
+	X(Stack_min_free) \
+	X(Spool_pending) \
+	X(Log_mel_hop_cycles) \
+	X(HTTP_stream_clients)
+
+#define METRICS_HISTOGRAMS(X) \
+	X(MIC_read_jitter_us) \
+	X(WS_send_us) \
+	X(HTTP_latency_us) \
+	X(WiFi_time_to_IP_ms)
+
+////////////// DEFINES
+
+#define METRICS_BUCKETS 16
+
+#define METRIC_ID_COUNTER(name) METRIC_COUNTER_##name,
+#define METRIC_ID_GAUGE(name) METRIC_GAUGE_##name,
+#define METRIC_ID_HISTOGRAM(name) METRIC_HISTOGRAM_##name,
+
+typedef enum { METRICS_COUNTERS(METRIC_ID_COUNTER) METRICS_COUNTER_COUNT } Metrics_counter_id_type;
+typedef enum { METRICS_GAUGES(METRIC_ID_GAUGE) METRICS_GAUGE_COUNT } Metrics_gauge_id_type;
+typedef enum { METRICS_HISTOGRAMS(METRIC_ID_HISTOGRAM) METRICS_HISTOGRAM_COUNT } Metrics_histogram_id_type;
+
+#define METRICS_SNAPSHOT_HEADER 16
+#define METRICS_SNAPSHOT_MAX ( \
+	METRICS_SNAPSHOT_HEADER \
+	+ METRICS_COUNTER_COUNT * 4 \
+	+ METRICS_GAUGE_COUNT * 4 \
+	+ METRICS_HISTOGRAM_COUNT * (4 + 8 + METRICS_BUCKETS * 4) \
+)
+
+#define METRIC_INC(name) Metrics_counter_add(METRIC_COUNTER_##name, 1)
+#define METRIC_ADD(name, n) Metrics_counter_add(METRIC_COUNTER_##name, (uint32_t)(n))
+#define METRIC_SET(name, v) Metrics_gauge_set(METRIC_GAUGE_##name, (int32_t)(v))
+#define METRIC_OBSERVE(name, v) Metrics_histogram_observe(METRIC_HISTOGRAM_##name, (uint32_t)(v))
+
+////////////// TYPES
+
+typedef struct {
+	uint32_t count;
+	uint64_t sum;
+	uint32_t buckets[METRICS_BUCKETS];
+} Metrics_histogram_type;
+
+////////////// GLOBALS
+
+static const char *METRICS_TAG = "woXrooX::Metrics:";
+
+// Per-core so the two cores never fight over one word
+static uint32_t Metrics_counters[portNUM_PROCESSORS][METRICS_COUNTER_COUNT];
+
+static int32_t Metrics_gauges[METRICS_GAUGE_COUNT];
+
+static Metrics_histogram_type Metrics_histograms[METRICS_HISTOGRAM_COUNT];
+static portMUX_TYPE Metrics_histograms_lock = portMUX_INITIALIZER_UNLOCKED;
+
+#define METRIC_NAME(name) #name,
+static const char *const Metrics_counter_names[] = { METRICS_COUNTERS(METRIC_NAME) };
+static const char *const Metrics_gauge_names[] = { METRICS_GAUGES(METRIC_NAME) };
+static const char *const Metrics_histogram_names[] = { METRICS_HISTOGRAMS(METRIC_NAME) };
+#undef METRIC_NAME
+
+////////////// Hot path
+
+static inline void Metrics_counter_add(Metrics_counter_id_type id, uint32_t n) {
+	// A migration between reading the core ID and the add is harmless: the add is atomic
+	__atomic_fetch_add(&Metrics_counters[esp_cpu_get_core_id()][id], n, __ATOMIC_RELAXED);
+}
+
+static inline void Metrics_gauge_set(Metrics_gauge_id_type id, int32_t v) {
+	__atomic_store_n(&Metrics_gauges[id], v, __ATOMIC_RELAXED);
+}
+
+static inline uint32_t Metrics_bucket(uint32_t v) {
+	uint32_t bucket = v ? 32 - (uint32_t)__builtin_clz(v) : 0;
+	return bucket < METRICS_BUCKETS ? bucket : METRICS_BUCKETS - 1;
+}
+
+static inline void Metrics_histogram_observe(Metrics_histogram_id_type id, uint32_t v) {
+	Metrics_histogram_type *h = &Metrics_histograms[id];
+
+	// count/sum/bucket must agree in a snapshot; the section is a handful of instructions
+	portENTER_CRITICAL_SAFE(&Metrics_histograms_lock);
+	h->count++;
+	h->sum += v;
+	h->buckets[Metrics_bucket(v)]++;
+	portEXIT_CRITICAL_SAFE(&Metrics_histograms_lock);
+}
+
+////////////// Read side
+
+static uint32_t Metrics_counter(Metrics_counter_id_type id) {
+	uint32_t total = 0;
+	for (int core = 0; core < portNUM_PROCESSORS; ++core) total += __atomic_load_n(&Metrics_counters[core][id], __ATOMIC_RELAXED);
+	return total;
+}
+
+static int32_t Metrics_gauge(Metrics_gauge_id_type id) {
+	return __atomic_load_n(&Metrics_gauges[id], __ATOMIC_RELAXED);
+}
+
+static const char *Metrics_counter_name(Metrics_counter_id_type id) { return Metrics_counter_names[id]; }
+static const char *Metrics_gauge_name(Metrics_gauge_id_type id) { return Metrics_gauge_names[id]; }
+static const char *Metrics_histogram_name(Metrics_histogram_id_type id) { return Metrics_histogram_names[id]; }
+
+static inline uint8_t *Metrics_put_32(uint8_t *p, uint32_t v) {
+	p[0] = (uint8_t)(v);
+	p[1] = (uint8_t)(v >> 8);
+	p[2] = (uint8_t)(v >> 16);
+	p[3] = (uint8_t)(v >> 24);
+	return p + 4;
+}
+
+static inline uint8_t *Metrics_put_64(uint8_t *p, uint64_t v) {
+	p = Metrics_put_32(p, (uint32_t)v);
+	return Metrics_put_32(p, (uint32_t)(v >> 32));
+}
+
+// Compact binary snapshot (format above). Returns bytes written, 0 if cap is too small.
+static size_t Metrics_snapshot(uint8_t *out, size_t cap) {
+	if (cap < METRICS_SNAPSHOT_MAX) return 0;
+
+	uint8_t *p = out;
+
+	memcpy(p, "WXM1", 4);
+	p[4] = portNUM_PROCESSORS;
+	p[5] = METRICS_COUNTER_COUNT;
+	p[6] = METRICS_GAUGE_COUNT;
+	p[7] = METRICS_HISTOGRAM_COUNT;
+	p = Metrics_put_64(p + 8, (uint64_t)esp_timer_get_time());
+
+	for (int i = 0; i < METRICS_COUNTER_COUNT; ++i) p = Metrics_put_32(p, Metrics_counter((Metrics_counter_id_type)i));
+	for (int i = 0; i < METRICS_GAUGE_COUNT; ++i) p = Metrics_put_32(p, (uint32_t)Metrics_gauge((Metrics_gauge_id_type)i));
+
+	for (int i = 0; i < METRICS_HISTOGRAM_COUNT; ++i) {
+		Metrics_histogram_type h;
+
+		portENTER_CRITICAL(&Metrics_histograms_lock);
+		h = Metrics_histograms[i];
+		portEXIT_CRITICAL(&Metrics_histograms_lock);
+
+		p = Metrics_put_32(p, h.count);
+		p = Metrics_put_64(p, h.sum);
+		for (int b = 0; b < METRICS_BUCKETS; ++b) p = Metrics_put_32(p, h.buckets[b]);
+	}
+
+	return (size_t)(p - out);
+}
+
+////////////// Cost
+
+// Measure the cost of METRIC_INC in CPU cycles (loop overhead subtracted)
+static uint32_t Metrics_measure_cost(void) {
+	const int N = 1000;
+
+	uint32_t t0 = esp_cpu_get_cycle_count();
+	for (volatile int i = 0; i < N; ++i) { }
+	uint32_t empty = esp_cpu_get_cycle_count() - t0;
+
+	uint32_t scratch = 0;
+	t0 = esp_cpu_get_cycle_count();
+	for (volatile int i = 0; i < N; ++i) __atomic_fetch_add(&scratch, 1, __ATOMIC_RELAXED);
+	uint32_t atomic = esp_cpu_get_cycle_count() - t0;
+
+	t0 = esp_cpu_get_cycle_count();
+	// Adds 0, so no real counter moves
+	for (volatile int i = 0; i < N; ++i) Metrics_counter_add(METRIC_COUNTER_LED_transitions, 0);
+	uint32_t full = esp_cpu_get_cycle_count() - t0;
+
+	uint32_t per_inc = (full > empty) ? (full - empty) / N : 0;
+	Metrics_gauge_set(METRIC_GAUGE_Metrics_inc_cycles, (int32_t)per_inc);
+
+	ESP_LOGI(METRICS_TAG, "METRIC_INC: %u cycles (bare atomic add: %u)", (unsigned)per_inc, (unsigned)((atomic > empty) ? (atomic - empty) / N : 0));
+
+	return per_inc;
+}
+
+#endif
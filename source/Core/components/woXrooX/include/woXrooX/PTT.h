@@ -0,0 +1,183 @@
+/*
+
+Push-to-talk edges with capture-clock timestamps.
+
+Every press/release is stored with the esp_timer_get_time() of the debounced edge, so the
+audio sender can gate on the exact frame (and sample) in which it happened rather than on
+whichever frame it happens to dequeue when the flag flips.
+
+Usage:
+
+	static button_type PTT_button = { .pin = GPIO_NUM_27 };
+
+	PTT_button_attach(&PTT_button);
+	Button_ISR_start(&PTT_button);   // or Button_task_start()
+
+	// Custom sources can record edges directly
+	PTT_edge_record(true, esp_timer_get_time());
+
+The consumer (WebSocket_client.h) pops edges with PTT_edge_take() as frames pass by.
+
+If the consumer falls PTT_EDGE_RING edges behind, later edges coalesce into one slot that keeps
+only the newest. It is handed out after the ring drains, and the ring is used again once it has
+been taken. Order is kept, and the consumer always ends on the button's latest state: a burst
+loses intermediate toggles, never the final release.
+*/
+
+#ifndef woXrooX_PTT_H
+#define woXrooX_PTT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "freertos/FreeRTOS.h"
+
+#include "esp_timer.h"
+#include "esp_log.h"
+
+#include "Button.h"
+#include "Metrics.h"
+#include "DLOG.h"
+
+
+////////////// DEFINES
+
+// Edges buffered between the button and the audio sender (power of two)
+#define PTT_EDGE_RING 32
+
+
+////////////// TYPES
+
+typedef struct {
+	uint64_t ts_us;
+	bool active;
+} PTT_edge_type;
+
+
+////////////// GLOBALS
+
+static const char *PTT_TAG = "woXrooX::PTT:";
+
+// Live state (what the button says right now)
+static volatile bool PTT_active = false;
+
+// Single producer (button context) / single consumer (audio sender)
+static PTT_edge_type PTT_edges[PTT_EDGE_RING];
+static volatile uint32_t PTT_edges_head = 0;
+static volatile uint32_t PTT_edges_tail = 0;
+
+// Overflow slot: newest edge since the ring filled. PTT_coalesced_seq is odd while it is being
+// written and moves by 2 per edge; it is pending while it differs from PTT_coalesced_taken.
+static PTT_edge_type PTT_coalesced;
+static volatile uint32_t PTT_coalesced_seq = 0;
+static volatile uint32_t PTT_coalesced_taken = 0;
+
+
+////////////// Edges
+
+static void PTT_edge_record(bool active, uint64_t ts_us) {
+	PTT_active = active;
+
+	uint32_t head = PTT_edges_head;
+	uint32_t seq = PTT_coalesced_seq;
+	bool pending = seq != PTT_coalesced_taken;
+
+	// Full, or already coalescing: the ring stays closed until the consumer took the overflow slot,
+	// so nothing newer can overtake it
+	if (pending || head - PTT_edges_tail >= PTT_EDGE_RING) {
+		if (!pending) DLOG_W(PTT_TAG, "Edge ring full, coalescing edges");
+
+		PTT_coalesced_seq = seq + 1;
+		__atomic_thread_fence(__ATOMIC_RELEASE);
+
+		PTT_coalesced = (PTT_edge_type){ .ts_us = ts_us, .active = active };
+
+		__atomic_thread_fence(__ATOMIC_RELEASE);
+		PTT_coalesced_seq = seq + 2;
+
+		METRIC_INC(PTT_edges_coalesced);
+		return;
+	}
+
+	PTT_edges[head & (PTT_EDGE_RING - 1)] = (PTT_edge_type){ .ts_us = ts_us, .active = active };
+
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	PTT_edges_head = head + 1;
+}
+
+// The overflow slot once the ring is drained
+static bool PTT_coalesced_take(uint64_t before_us, PTT_edge_type *out) {
+	PTT_edge_type edge;
+	uint32_t seq;
+
+	// Retry while the button is rewriting it
+	do {
+		seq = PTT_coalesced_seq;
+		if (seq == PTT_coalesced_taken) return false;
+
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		edge = PTT_coalesced;
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	} while ((seq & 1) || seq != PTT_coalesced_seq);
+
+	if (edge.ts_us >= before_us) return false;
+
+	*out = edge;
+
+	// A newer edge coalesced meanwhile moved the seq on: it stays pending
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	PTT_coalesced_taken = seq;
+
+	return true;
+}
+
+// Pops the oldest edge if it happened before before_us. Returns false otherwise.
+static bool PTT_edge_take(uint64_t before_us, PTT_edge_type *out) {
+	// The overflow slot is only written once the ring is full, and the ring is closed while it is
+	// pending. Reading its seq before the ring means an empty ring really is drained up to it,
+	// not just empty when looked at, then refilled and overflowed before the slot is read.
+	bool pending = PTT_coalesced_seq != PTT_coalesced_taken;
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+	uint32_t tail = PTT_edges_tail;
+	if (tail == PTT_edges_head) return pending && PTT_coalesced_take(before_us, out);
+
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+	const PTT_edge_type *edge = &PTT_edges[tail & (PTT_EDGE_RING - 1)];
+	if (edge->ts_us >= before_us) return false;
+
+	*out = *edge;
+
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	PTT_edges_tail = tail + 1;
+
+	return true;
+}
+
+
+////////////// Button glue
+
+static void PTT_on_press(button_type *button) {
+	PTT_edge_record(true, button->edge_us);
+}
+
+static void PTT_on_release(button_type *button) {
+	PTT_edge_record(false, button->edge_us);
+}
+
+// Wire a button_type as the PTT source (call before starting the button)
+static void PTT_button_attach(button_type *button) {
+	button->on_press = PTT_on_press;
+	button->on_release = PTT_on_release;
+}
+
+
+////////////// API
+
+// Live PTT state; for sample-accurate gating use the edge ring instead
+static bool get_Button_PTT_FLAG_active(void) {
+	return PTT_active;
+}
+
+#endif
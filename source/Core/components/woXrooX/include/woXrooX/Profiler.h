@@ -0,0 +1,336 @@
+/*
+Optional task / stack / heap profiler.
+
+A low-priority task samples every PROFILER_PERIOD_MS:
+	- per task: CPU share since the previous sample, stack high-water mark (bytes never touched)
+	- per heap capability (internal, DMA, 8-bit): free, minimum ever free, largest free block, fragmentation
+
+The last PROFILER_RING samples are kept for inspection, and every sample is checked against the
+thresholds below. A warning is logged once when something crosses a threshold (and once when it recovers),
+so the log shows regressions instead of a wall of numbers.
+
+Usage:
+#include "woXrooX/Profiler.h"
+
+// Also measures METRIC_INC once (Metrics_measure_cost)
+Profiler_start();
+
+// Full table on demand
+Profiler_report();
+
+// Latest sample / history (oldest first)
+Profiler_sample_type sample;
+if (Profiler_latest(&sample) == 0) { }
+
+Requires in menuconfig (Component config → FreeRTOS → Kernel):
+	- configUSE_TRACE_FACILITY                 (task list and stack marks)
+	- configGENERATE_RUN_TIME_STATS            (CPU share; without it cpu_permille stays 0)
+
+Nothing is compiled in unless this header is included.
+*/
+
+#ifndef woXrooX_Profiler_H
+#define woXrooX_Profiler_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+#include "Metrics.h"
+#include "Tasks.h"
+
+////////////// DEFINES
+
+#define PROFILER_PERIOD_MS 5000
+
+// Samples kept
+#define PROFILER_RING 8
+
+// Tasks tracked per sample. A full build (Wi-Fi, lwIP, httpd, every woXrooX task and three stream
+// clients) runs about 25 with the IDF's own; with more than this a sample has no task data at all.
+#ifndef PROFILER_TASKS_MAX
+#define PROFILER_TASKS_MAX 32
+#endif
+
+// Thresholds
+#define PROFILER_STACK_MIN_FREE 512
+#define PROFILER_HEAP_MIN_FREE 16384
+#define PROFILER_FRAGMENTATION_MAX_PCT 60
+#define PROFILER_CPU_MAX_PERMILLE 800
+
+#define PROFILER_HEAPS 3
+
+////////////// TYPES
+
+typedef struct {
+	char name[configMAX_TASK_NAME_LEN];
+	TaskHandle_t handle;
+
+	// Bytes of stack never used
+	uint32_t stack_free;
+
+	// Of all cores, since the previous sample
+	uint16_t cpu_permille;
+
+	// Threshold state, for edge-triggered warnings
+	bool stack_low;
+	bool cpu_high;
+} Profiler_task_type;
+
+typedef struct {
+	uint32_t caps;
+	uint32_t free;
+	uint32_t min_free;
+	uint32_t largest;
+
+	// 100 - largest / free
+	uint8_t fragmentation_pct;
+
+	bool low;
+	bool fragmented;
+} Profiler_heap_type;
+
+typedef struct {
+	uint64_t ts_us;
+
+	Profiler_heap_type heaps[PROFILER_HEAPS];
+
+	uint8_t task_count;
+	Profiler_task_type tasks[PROFILER_TASKS_MAX];
+} Profiler_sample_type;
+
+////////////// GLOBALS
+
+static const char *PROFILER_TAG = "woXrooX::Profiler:";
+
+static const uint32_t Profiler_heap_caps[PROFILER_HEAPS] = { MALLOC_CAP_INTERNAL, MALLOC_CAP_DMA, MALLOC_CAP_8BIT };
+static const char *const Profiler_heap_names[PROFILER_HEAPS] = { "internal", "DMA", "8bit" };
+
+static Profiler_sample_type Profiler_ring[PROFILER_RING];
+static size_t Profiler_head = 0;
+static size_t Profiler_count = 0;
+static portMUX_TYPE Profiler_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static TaskHandle_t Profiler_task_handle = NULL;
+
+// Only touched by the profiler task
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY
+static TaskStatus_t Profiler_status[PROFILER_TASKS_MAX];
+static configRUN_TIME_COUNTER_TYPE Profiler_previous_runtime[PROFILER_TASKS_MAX];
+static TaskHandle_t Profiler_previous_handle[PROFILER_TASKS_MAX];
+static UBaseType_t Profiler_previous_count = 0;
+static configRUN_TIME_COUNTER_TYPE Profiler_previous_total = 0;
+
+// More tasks than PROFILER_TASKS_MAX at the last sample, for an edge-triggered warning
+static bool Profiler_tasks_overflow = false;
+#endif
+
+static Profiler_sample_type Profiler_current;
+
+////////////// Sampling
+
+static void Profiler_sample_heaps(Profiler_sample_type *s, const Profiler_sample_type *previous) {
+	for (int i = 0; i < PROFILER_HEAPS; ++i) {
+		Profiler_heap_type *h = &s->heaps[i];
+
+		h->caps = Profiler_heap_caps[i];
+		h->free = (uint32_t)heap_caps_get_free_size(h->caps);
+		h->min_free = (uint32_t)heap_caps_get_minimum_free_size(h->caps);
+		h->largest = (uint32_t)heap_caps_get_largest_free_block(h->caps);
+		h->fragmentation_pct = h->free ? (uint8_t)(100 - (uint64_t)h->largest * 100 / h->free) : 0;
+
+		h->low = h->min_free < PROFILER_HEAP_MIN_FREE;
+		h->fragmented = h->fragmentation_pct > PROFILER_FRAGMENTATION_MAX_PCT;
+
+		const Profiler_heap_type *p = previous ? &previous->heaps[i] : NULL;
+
+		if (h->low && (!p || !p->low)) ESP_LOGW(PROFILER_TAG, "Heap %s: min free %u < %u", Profiler_heap_names[i], (unsigned)h->min_free, PROFILER_HEAP_MIN_FREE);
+		if (h->fragmented && (!p || !p->fragmented)) ESP_LOGW(PROFILER_TAG, "Heap %s: %u%% fragmented (largest block %u of %u free)", Profiler_heap_names[i], h->fragmentation_pct, (unsigned)h->largest, (unsigned)h->free);
+		else if (!h->fragmented && p && p->fragmented) ESP_LOGI(PROFILER_TAG, "Heap %s: fragmentation back to %u%%", Profiler_heap_names[i], h->fragmentation_pct);
+	}
+
+	METRIC_SET(Heap_free, s->heaps[0].free);
+	METRIC_SET(Heap_min_free, s->heaps[0].min_free);
+	METRIC_SET(Heap_largest_block, s->heaps[0].largest);
+}
+
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY
+static const Profiler_task_type *Profiler_find_task(const Profiler_sample_type *s, TaskHandle_t handle) {
+	if (!s) return NULL;
+
+	for (int i = 0; i < s->task_count; ++i) {
+		if (s->tasks[i].handle == handle) return &s->tasks[i];
+	}
+
+	return NULL;
+}
+
+static configRUN_TIME_COUNTER_TYPE Profiler_previous_runtime_of(TaskHandle_t handle, bool *found) {
+	for (UBaseType_t i = 0; i < Profiler_previous_count; ++i) {
+		if (Profiler_previous_handle[i] == handle) { *found = true; return Profiler_previous_runtime[i]; }
+	}
+
+	*found = false;
+	return 0;
+}
+#endif
+
+static void Profiler_sample_tasks(Profiler_sample_type *s, const Profiler_sample_type *previous) {
+	s->task_count = 0;
+
+	#if CONFIG_FREERTOS_USE_TRACE_FACILITY
+	configRUN_TIME_COUNTER_TYPE total = 0;
+	UBaseType_t n = uxTaskGetSystemState(Profiler_status, PROFILER_TASKS_MAX, &total);
+
+	// More tasks than slots: uxTaskGetSystemState fills nothing
+	if (n == 0) {
+		if (!Profiler_tasks_overflow) ESP_LOGW(PROFILER_TAG, "%u tasks, only %d tracked: raise PROFILER_TASKS_MAX", (unsigned)uxTaskGetNumberOfTasks(), PROFILER_TASKS_MAX);
+		Profiler_tasks_overflow = true;
+		return;
+	}
+
+	Profiler_tasks_overflow = false;
+
+	// The counter runs on every core at once
+	uint64_t elapsed = (uint64_t)(configRUN_TIME_COUNTER_TYPE)(total - Profiler_previous_total) * portNUM_PROCESSORS;
+	uint32_t stack_min = UINT32_MAX;
+
+	for (UBaseType_t i = 0; i < n; ++i) {
+		const TaskStatus_t *t = &Profiler_status[i];
+		Profiler_task_type *task = &s->tasks[s->task_count++];
+
+		strncpy(task->name, t->pcTaskName, sizeof(task->name) - 1);
+		task->name[sizeof(task->name) - 1] = '\0';
+		task->handle = t->xHandle;
+
+		// IDF stacks are in bytes (StackType_t is uint8_t)
+		task->stack_free = (uint32_t)t->usStackHighWaterMark * sizeof(StackType_t);
+		if (task->stack_free < stack_min) stack_min = task->stack_free;
+
+		bool found;
+		configRUN_TIME_COUNTER_TYPE before = Profiler_previous_runtime_of(t->xHandle, &found);
+		task->cpu_permille = (found && elapsed) ? (uint16_t)((uint64_t)(configRUN_TIME_COUNTER_TYPE)(t->ulRunTimeCounter - before) * 1000 / elapsed) : 0;
+
+		task->stack_low = task->stack_free < PROFILER_STACK_MIN_FREE;
+
+		// Idle tasks soak up whatever is left, they are not a regression
+		task->cpu_high = task->cpu_permille > PROFILER_CPU_MAX_PERMILLE && strncmp(task->name, "IDLE", 4) != 0;
+
+		const Profiler_task_type *p = Profiler_find_task(previous, t->xHandle);
+
+		if (task->stack_low && (!p || !p->stack_low)) ESP_LOGW(PROFILER_TAG, "Task %s: only %u stack bytes never used", task->name, (unsigned)task->stack_free);
+		if (task->cpu_high && (!p || !p->cpu_high)) ESP_LOGW(PROFILER_TAG, "Task %s: %u.%u%% CPU", task->name, task->cpu_permille / 10, task->cpu_permille % 10);
+		else if (!task->cpu_high && p && p->cpu_high) ESP_LOGI(PROFILER_TAG, "Task %s: CPU back to %u.%u%%", task->name, task->cpu_permille / 10, task->cpu_permille % 10);
+
+		Profiler_previous_handle[i] = t->xHandle;
+		Profiler_previous_runtime[i] = t->ulRunTimeCounter;
+	}
+
+	Profiler_previous_count = n;
+	Profiler_previous_total = total;
+
+	METRIC_SET(Stack_min_free, stack_min);
+	#else
+	(void)previous;
+	#endif
+}
+
+static void Profiler_sample(void) {
+	Profiler_sample_type *s = &Profiler_current;
+	const Profiler_sample_type *previous = Profiler_count ? &Profiler_ring[(Profiler_head + PROFILER_RING - 1) % PROFILER_RING] : NULL;
+
+	// Only this task writes the ring, so reading the previous slot without the lock is fine
+	s->ts_us = (uint64_t)esp_timer_get_time();
+	Profiler_sample_heaps(s, previous);
+	Profiler_sample_tasks(s, previous);
+
+	portENTER_CRITICAL(&Profiler_lock);
+	Profiler_ring[Profiler_head] = *s;
+	Profiler_head = (Profiler_head + 1) % PROFILER_RING;
+	if (Profiler_count < PROFILER_RING) Profiler_count++;
+	portEXIT_CRITICAL(&Profiler_lock);
+}
+
+////////////// TASK
+
+static void Profiler_task(void *arg) {
+	(void)arg;
+
+	TickType_t last = xTaskGetTickCount();
+
+	for (;;) {
+		Profiler_sample();
+		vTaskDelayUntil(&last, pdMS_TO_TICKS(PROFILER_PERIOD_MS));
+	}
+}
+
+////////////// API
+
+static int Profiler_start(void) {
+	if (Profiler_task_handle) return 0;
+
+	#if !CONFIG_FREERTOS_USE_TRACE_FACILITY
+	ESP_LOGW(PROFILER_TAG, "configUSE_TRACE_FACILITY is off: heap only, no task data");
+	#elif !CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+	ESP_LOGW(PROFILER_TAG, "configGENERATE_RUN_TIME_STATS is off: no CPU share");
+	#endif
+
+	// Cycles per METRIC_INC on this chip, once: logged and kept in the Metrics_inc_cycles gauge
+	Metrics_measure_cost();
+
+	return Tasks_create(TASK_PROFILER, Profiler_task, NULL, &Profiler_task_handle);
+}
+
+// Newest sample. -1 if none yet.
+static int Profiler_latest(Profiler_sample_type *out) {
+	if (!out) return -1;
+
+	portENTER_CRITICAL(&Profiler_lock);
+	bool any = Profiler_count > 0;
+	if (any) *out = Profiler_ring[(Profiler_head + PROFILER_RING - 1) % PROFILER_RING];
+	portEXIT_CRITICAL(&Profiler_lock);
+
+	return any ? 0 : -1;
+}
+
+// Copy up to max samples, oldest first. Returns how many were copied.
+static size_t Profiler_history(Profiler_sample_type *out, size_t max) {
+	if (!out) return 0;
+
+	portENTER_CRITICAL(&Profiler_lock);
+
+	size_t n = Profiler_count < max ? Profiler_count : max;
+	size_t first = (Profiler_head + PROFILER_RING - n) % PROFILER_RING;
+
+	for (size_t i = 0; i < n; ++i) out[i] = Profiler_ring[(first + i) % PROFILER_RING];
+
+	portEXIT_CRITICAL(&Profiler_lock);
+
+	return n;
+}
+
+// Log the newest sample as a table
+static void Profiler_report(void) {
+	// Too big for most callers' stacks
+	static Profiler_sample_type s;
+	if (Profiler_latest(&s) != 0) return;
+
+	for (int i = 0; i < PROFILER_HEAPS; ++i) {
+		const Profiler_heap_type *h = &s.heaps[i];
+		ESP_LOGI(PROFILER_TAG, "heap %-8s free %6u  min %6u  largest %6u  frag %3u%%", Profiler_heap_names[i], (unsigned)h->free, (unsigned)h->min_free, (unsigned)h->largest, h->fragmentation_pct);
+	}
+
+	for (int i = 0; i < s.task_count; ++i) {
+		const Profiler_task_type *t = &s.tasks[i];
+		ESP_LOGI(PROFILER_TAG, "task %-16s stack free %5u  CPU %3u.%u%%", t->name, (unsigned)t->stack_free, t->cpu_permille / 10, t->cpu_permille % 10);
+	}
+}
+
+#endif
@@ -0,0 +1,402 @@
+/*
+Offline audio spool: PTT audio captured while the WebSocket is down goes to flash, ADPCM-compressed,
+and is sent after reconnect alongside live audio.
+
+Needs a raw data partition labelled SPOOL_PARTITION_LABEL in partitions.csv, e.g.
+
+	spool, data, 0x40, , 256K
+
+Usage (include before WebSocket_client.h, which then spools and drains on its own):
+#include "woXrooX/MIC.h"
+#include "woXrooX/PTT.h"
+#include "woXrooX/Spool.h"
+#include "woXrooX/WebSocket_client.h"
+
+Spool_init();
+WS_start(MIC_listen_queue());
+
+Record payload (SPOOL_PAYLOAD_BYTES = 172, little-endian):
+	predictor i16 | step index u8 | PTT edges u8 | PTT sample offset u16 | samples u16
+	| sample rate u16 (Hz) | PTT END sample offset u16 | IMA ADPCM, up to SPOOL_FRAME_SAMPLES samples (160 bytes)
+
+PTT edges: SPOOL_PTT_START | SPOOL_PTT_END, 0 = none. A record keeps the last START and the last
+END inside it, so a press and release within one frame both survive; SPOOL_PTT_START_LAST says the
+START came after the END. The first offset is the START's, or the END's when it is the only edge;
+the END offset field is used only when both are present (0 otherwise, as in older records).
+
+A frame longer than SPOOL_FRAME_SAMPLES (16 kHz, 40 ms) is stored as consecutive records with the
+same seq, each with its own ts_us; each PTT edge goes with the record it falls in.
+
+Format and recovery: Spool_log.h. 256 KB hold 1344 records ≈ 27 s of 16 kHz speech, one sector
+(21 records) less while the next one is erased ahead.
+
+Spool_push() runs on WS_TX and never erases: the Spool_erase task erases the sector after the head
+while the head fills (21 records = 420 ms of audio for a 4 KB erase of 40-400 ms), outside the lock
+WS_TX takes. Only an append that reaches a sector not erased yet waits for it (Spool_erase_waits).
+Flash writes and erases pause the cache for a few ms; MIC_RX rides that out on its DMA buffers.
+*/
+
+#ifndef woXrooX_Spool_H
+#define woXrooX_Spool_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#include "esp_partition.h"
+#include "esp_log.h"
+
+#include "ADPCM.h"
+#include "Spool_log.h"
+#include "Metrics.h"
+#include "DLOG.h"
+#include "Tasks.h"
+
+////////////// DEFINES
+
+#define SPOOL_PARTITION_LABEL "spool"
+
+#define SPOOL_FRAME_SAMPLES 320
+#define SPOOL_ADPCM_BYTES ADPCM_BYTES(SPOOL_FRAME_SAMPLES)
+
+// Spooled frames sent per live frame period: drains at up to this × realtime
+#define SPOOL_DRAIN_BURST 3
+
+// Per spooled send; live audio never waits longer than this for the backlog
+#define SPOOL_DRAIN_TIMEOUT_MS 5
+
+// An append that catches up with the erase ahead waits at most this long, then the frame is lost
+#define SPOOL_ERASE_WAIT_MS 1000
+
+#define SPOOL_OFFSET_PREDICTOR 0
+#define SPOOL_OFFSET_INDEX 2
+#define SPOOL_OFFSET_PTT_KIND 3
+#define SPOOL_OFFSET_PTT_SAMPLE 4
+#define SPOOL_OFFSET_SAMPLES 6
+#define SPOOL_OFFSET_RATE 8
+#define SPOOL_OFFSET_PTT_END_SAMPLE 10
+#define SPOOL_OFFSET_ADPCM 12
+
+// PTT edges bits (START and END have the values of WS_PTT_START / WS_PTT_END)
+#define SPOOL_PTT_START 1
+#define SPOOL_PTT_END 2
+#define SPOOL_PTT_START_LAST 4
+
+////////////// TYPES
+
+// PTT edges inside one frame or record: the last of each kind, offsets in samples from its ts_us
+typedef struct {
+	uint8_t edges;
+	uint16_t start_offset;
+	uint16_t end_offset;
+} Spool_PTT_type;
+
+typedef struct {
+	uint32_t seq;
+	uint64_t ts_us;
+	uint32_t sample_rate;
+	uint16_t samples;
+
+	ADPCM_state_type state;
+
+	// edges == 0: no PTT edge in this record
+	Spool_PTT_type PTT;
+
+	const uint8_t *adpcm;
+} Spool_frame_type;
+
+////////////// GLOBALS
+
+static const char *SPOOL_TAG = "woXrooX::Spool:";
+
+static const esp_partition_t *Spool_partition = NULL;
+static Spool_device_type Spool_device;
+static Spool_log_type Spool_log;
+static bool Spool_ready = false;
+
+// Spool_log is shared by WS_TX (push, peek, consume) and the erase task (begin/end only)
+static SemaphoreHandle_t Spool_mutex = NULL;
+static StaticSemaphore_t Spool_mutex_storage;
+
+static TaskHandle_t Spool_erase_handle = NULL;
+
+// Encoder state carries across frames for quality; each record stores where it started
+static ADPCM_state_type Spool_encoder;
+
+static Spool_record_type Spool_record;
+
+////////////// Device
+
+static int Spool_partition_read(void *context, uint32_t offset, void *out, uint32_t length) {
+	return esp_partition_read((const esp_partition_t *)context, offset, out, length) == ESP_OK ? 0 : -1;
+}
+
+static int Spool_partition_write(void *context, uint32_t offset, const void *data, uint32_t length) {
+	return esp_partition_write((const esp_partition_t *)context, offset, data, length) == ESP_OK ? 0 : -1;
+}
+
+static int Spool_partition_erase(void *context, uint32_t offset, uint32_t length) {
+	return esp_partition_erase_range((const esp_partition_t *)context, offset, length) == ESP_OK ? 0 : -1;
+}
+
+////////////// Erase ahead
+
+// Under Spool_mutex: wake the erase task if the next sector is not erased yet
+static void Spool_erase_kick(void) {
+	if (Spool_erase_handle && Spool_log_erase_needed(&Spool_log)) xTaskNotifyGive(Spool_erase_handle);
+}
+
+static void Spool_erase_task(void *arg) {
+	for (;;) {
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+		uint32_t offset;
+
+		xSemaphoreTake(Spool_mutex, portMAX_DELAY);
+		uint32_t dropped = Spool_log.dropped;
+		int response = Spool_log_erase_begin(&Spool_log, &offset);
+		dropped = Spool_log.dropped - dropped;
+		xSemaphoreGive(Spool_mutex);
+
+		if (response != SPOOL_return_OK) continue;
+
+		if (dropped) DLOG_W(SPOOL_TAG, "Spool full, %u oldest frames dropped", dropped);
+
+		// The slow part, with WS_TX free to append to the head sector meanwhile
+		bool ok = Spool_partition_erase((void *)Spool_partition, offset, SPOOL_SECTOR_BYTES) == 0;
+
+		xSemaphoreTake(Spool_mutex, portMAX_DELAY);
+		Spool_log_erase_end(&Spool_log, ok);
+		METRIC_SET(Spool_pending, Spool_log_pending(&Spool_log));
+		xSemaphoreGive(Spool_mutex);
+
+		if (ok) METRIC_INC(Spool_erased_ahead);
+		else DLOG_W(SPOOL_TAG, "Erase ahead failed at 0x%x, next append erases inline", (unsigned)offset);
+	}
+}
+
+// Under Spool_mutex. While the erase task runs, WS_TX never erases: a sector it has not
+// got to yet (it starves behind a busy WS_TX) is waited for like one being erased.
+static int Spool_log_append_ahead(void) {
+	if (Spool_erase_handle && Spool_log_head_full(&Spool_log) && Spool_log_erase_needed(&Spool_log)) {
+		Spool_erase_kick();
+		return SPOOL_return_busy;
+	}
+
+	return Spool_log_append(&Spool_log, &Spool_record);
+}
+
+////////////// API
+
+// Mount the spool partition and recover what is left from before a reset
+static int Spool_init(void) {
+	if (Spool_ready) return SPOOL_return_OK;
+
+	Spool_partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, SPOOL_PARTITION_LABEL);
+	if (!Spool_partition) {
+		ESP_LOGW(SPOOL_TAG, "No '%s' partition, spool disabled", SPOOL_PARTITION_LABEL);
+		return SPOOL_return_error;
+	}
+
+	Spool_device = (Spool_device_type){
+		.context = (void *)Spool_partition,
+		.size = Spool_partition->size,
+		.read = Spool_partition_read,
+		.write = Spool_partition_write,
+		.erase = Spool_partition_erase
+	};
+
+	int response = Spool_log_mount(&Spool_log, &Spool_device);
+	if (response != SPOOL_return_OK) {
+		ESP_LOGE(SPOOL_TAG, "Mount failed (%d)", response);
+		return response;
+	}
+
+	Spool_mutex = xSemaphoreCreateMutexStatic(&Spool_mutex_storage);
+	if (!Spool_mutex) return SPOOL_return_error;
+
+	// Boot can wait for one erase; WS_TX starts with the next sector ready
+	if (Spool_log_erase_ahead(&Spool_log) != SPOOL_return_OK) ESP_LOGW(SPOOL_TAG, "Erase ahead failed, next append erases inline");
+
+	// Without the task every sector is erased inline, as before
+	if (Tasks_create(TASK_SPOOL_ERASE, Spool_erase_task, NULL, &Spool_erase_handle) != 0) Spool_erase_handle = NULL;
+
+	Spool_ready = true;
+	METRIC_SET(Spool_pending, Spool_log_pending(&Spool_log));
+	Spool_erase_kick();
+
+	ESP_LOGI(SPOOL_TAG, "%u of %u frames pending, %u torn records retired", (unsigned)Spool_log_pending(&Spool_log), (unsigned)Spool_log_capacity(&Spool_log), (unsigned)Spool_log.corrupted);
+
+	return SPOOL_return_OK;
+}
+
+static inline bool Spool_enabled(void) {
+	return Spool_ready;
+}
+
+// Add a PTT edge, in the order they happened
+static inline void Spool_PTT_add(Spool_PTT_type *PTT, bool active, uint16_t offset) {
+	if (active) {
+		if (PTT->edges & SPOOL_PTT_END) PTT->edges |= SPOOL_PTT_START_LAST;
+		PTT->edges |= SPOOL_PTT_START;
+		PTT->start_offset = offset;
+	}
+
+	else {
+		PTT->edges = (uint8_t)((PTT->edges | SPOOL_PTT_END) & ~SPOOL_PTT_START_LAST);
+		PTT->end_offset = offset;
+	}
+}
+
+// true if the record's START marker goes out before its END marker
+static inline bool Spool_PTT_start_first(const Spool_PTT_type *PTT) {
+	return !(PTT->edges & SPOOL_PTT_END) || !(PTT->edges & SPOOL_PTT_START_LAST);
+}
+
+static int Spool_append(uint32_t seq, uint64_t ts_us, uint32_t sample_rate, const int16_t *pcm, uint16_t samples, const Spool_PTT_type *PTT) {
+	uint8_t *p = Spool_record.payload;
+
+	bool both = (PTT->edges & SPOOL_PTT_START) && (PTT->edges & SPOOL_PTT_END);
+	uint16_t PTT_offset = (PTT->edges & SPOOL_PTT_START) ? PTT->start_offset : PTT->end_offset;
+	uint16_t PTT_end_offset = both ? PTT->end_offset : 0;
+
+	Spool_record.seq = seq;
+	Spool_record.ts_us = ts_us;
+
+	p[SPOOL_OFFSET_PREDICTOR] = (uint8_t)Spool_encoder.predictor;
+	p[SPOOL_OFFSET_PREDICTOR + 1] = (uint8_t)((uint16_t)Spool_encoder.predictor >> 8);
+	p[SPOOL_OFFSET_INDEX] = Spool_encoder.index;
+	p[SPOOL_OFFSET_PTT_KIND] = PTT->edges;
+	p[SPOOL_OFFSET_PTT_SAMPLE] = (uint8_t)PTT_offset;
+	p[SPOOL_OFFSET_PTT_SAMPLE + 1] = (uint8_t)(PTT_offset >> 8);
+	p[SPOOL_OFFSET_SAMPLES] = (uint8_t)samples;
+	p[SPOOL_OFFSET_SAMPLES + 1] = (uint8_t)(samples >> 8);
+	p[SPOOL_OFFSET_RATE] = (uint8_t)sample_rate;
+	p[SPOOL_OFFSET_RATE + 1] = (uint8_t)(sample_rate >> 8);
+	p[SPOOL_OFFSET_PTT_END_SAMPLE] = (uint8_t)PTT_end_offset;
+	p[SPOOL_OFFSET_PTT_END_SAMPLE + 1] = (uint8_t)(PTT_end_offset >> 8);
+
+	memset(p + SPOOL_OFFSET_ADPCM, 0, SPOOL_ADPCM_BYTES);
+	ADPCM_encode(&Spool_encoder, pcm, samples, p + SPOOL_OFFSET_ADPCM);
+
+	xSemaphoreTake(Spool_mutex, portMAX_DELAY);
+
+	uint32_t dropped = Spool_log.dropped;
+	int response = Spool_log_append_ahead();
+
+	// Caught up with the erase ahead: give it the lock and the CPU until it is done
+	for (uint32_t waited_ms = 0; response == SPOOL_return_busy && waited_ms < SPOOL_ERASE_WAIT_MS; waited_ms += portTICK_PERIOD_MS) {
+		if (waited_ms == 0) METRIC_INC(Spool_erase_waits);
+
+		xSemaphoreGive(Spool_mutex);
+		vTaskDelay(1);
+		xSemaphoreTake(Spool_mutex, portMAX_DELAY);
+
+		response = Spool_log_append_ahead();
+	}
+
+	// Erase task stuck: erase inline rather than lose the frame (still busy if it is mid-erase)
+	if (response == SPOOL_return_busy) response = Spool_log_append(&Spool_log, &Spool_record);
+
+	dropped = Spool_log.dropped - dropped;
+	Spool_erase_kick();
+
+	xSemaphoreGive(Spool_mutex);
+
+	if (response != SPOOL_return_OK) DLOG_W(SPOOL_TAG, "Append failed (%d), seq=%u", response, seq);
+	else METRIC_INC(Spool_written);
+
+	if (dropped) DLOG_W(SPOOL_TAG, "Spool full, %u oldest frames dropped", dropped);
+
+	return response;
+}
+
+// Compress and append one frame (split into SPOOL_FRAME_SAMPLES records). PTT may be NULL: no edge in this frame.
+static int Spool_push(uint32_t seq, uint64_t ts_us, uint32_t sample_rate, const int16_t *pcm, uint16_t samples, const Spool_PTT_type *PTT) {
+	if (!Spool_ready) return SPOOL_return_error;
+
+	static const Spool_PTT_type none = { 0 };
+	if (!PTT) PTT = &none;
+
+	int response = SPOOL_return_OK;
+
+	for (uint16_t start = 0; start < samples && response == SPOOL_return_OK; start += SPOOL_FRAME_SAMPLES) {
+		uint16_t chunk = (uint16_t)(samples - start < SPOOL_FRAME_SAMPLES ? samples - start : SPOOL_FRAME_SAMPLES);
+		uint64_t chunk_ts_us = ts_us + (uint64_t)start * 1000000ULL / sample_rate;
+
+		// Each edge goes with the record it falls in; the order bit only matters when both do
+		Spool_PTT_type here = { 0 };
+
+		if ((PTT->edges & SPOOL_PTT_START) && PTT->start_offset >= start && PTT->start_offset < start + chunk) {
+			here.edges |= SPOOL_PTT_START;
+			here.start_offset = (uint16_t)(PTT->start_offset - start);
+		}
+
+		if ((PTT->edges & SPOOL_PTT_END) && PTT->end_offset >= start && PTT->end_offset < start + chunk) {
+			here.edges |= SPOOL_PTT_END;
+			here.end_offset = (uint16_t)(PTT->end_offset - start);
+		}
+
+		if (here.edges == (SPOOL_PTT_START | SPOOL_PTT_END)) here.edges |= PTT->edges & SPOOL_PTT_START_LAST;
+
+		response = Spool_append(seq, chunk_ts_us, sample_rate, pcm + start, chunk, &here);
+	}
+
+	METRIC_SET(Spool_pending, Spool_log_pending(&Spool_log));
+
+	return response;
+}
+
+// Oldest spooled frame; out->adpcm stays valid until the next Spool_* call
+static int Spool_peek(Spool_frame_type *out) {
+	if (!Spool_ready) return SPOOL_return_empty;
+
+	xSemaphoreTake(Spool_mutex, portMAX_DELAY);
+	int response = Spool_log_peek(&Spool_log, &Spool_record);
+	xSemaphoreGive(Spool_mutex);
+
+	if (response != SPOOL_return_OK) return response;
+
+	const uint8_t *p = Spool_record.payload;
+
+	out->seq = Spool_record.seq;
+	out->ts_us = Spool_record.ts_us;
+	out->samples = (uint16_t)(p[SPOOL_OFFSET_SAMPLES] | (p[SPOOL_OFFSET_SAMPLES + 1] << 8));
+	out->sample_rate = (uint32_t)(p[SPOOL_OFFSET_RATE] | (p[SPOOL_OFFSET_RATE + 1] << 8));
+	out->state.predictor = (int16_t)(p[SPOOL_OFFSET_PREDICTOR] | (p[SPOOL_OFFSET_PREDICTOR + 1] << 8));
+	out->state.index = p[SPOOL_OFFSET_INDEX];
+	uint8_t edges = p[SPOOL_OFFSET_PTT_KIND];
+	uint16_t PTT_offset = (uint16_t)(p[SPOOL_OFFSET_PTT_SAMPLE] | (p[SPOOL_OFFSET_PTT_SAMPLE + 1] << 8));
+	uint16_t PTT_end_offset = (uint16_t)(p[SPOOL_OFFSET_PTT_END_SAMPLE] | (p[SPOOL_OFFSET_PTT_END_SAMPLE + 1] << 8));
+
+	out->PTT.edges = edges;
+	out->PTT.start_offset = (edges & SPOOL_PTT_START) ? PTT_offset : 0;
+	out->PTT.end_offset = (edges & SPOOL_PTT_END) ? ((edges & SPOOL_PTT_START) ? PTT_end_offset : PTT_offset) : 0;
+	out->adpcm = p + SPOOL_OFFSET_ADPCM;
+
+	return SPOOL_return_OK;
+}
+
+// The frame from Spool_peek() was delivered
+static int Spool_consume(void) {
+	if (!Spool_ready) return SPOOL_return_error;
+
+	xSemaphoreTake(Spool_mutex, portMAX_DELAY);
+	int response = Spool_log_consume(&Spool_log);
+	METRIC_SET(Spool_pending, Spool_log_pending(&Spool_log));
+	xSemaphoreGive(Spool_mutex);
+
+	if (response == SPOOL_return_OK) METRIC_INC(Spool_drained);
+
+	return response;
+}
+
+static inline uint32_t Spool_pending(void) {
+	return Spool_ready ? Spool_log_pending(&Spool_log) : 0;
+}
+
+#endif
@@ -0,0 +1,470 @@
+/*
+Append-only ring log of fixed-size records on raw flash.
+
+Layout (sector = SPOOL_SECTOR_BYTES, written strictly in order, wrapping):
+
+	sector:  header (16)   "WXS2" | seq u32 | ~seq u32 | 0xFFFFFFFF
+	         records       SPOOL_RECORDS_PER_SECTOR × SPOOL_RECORD_BYTES, then padding
+	record:  flags u8 | 0xFF | crc16 u16 | seq u32 | ts_us u64 | payload (SPOOL_PAYLOAD_BYTES)
+
+	flags    0xFF erased, 0xFE pending, 0x00 consumed
+	crc16    CRC-16/CCITT over seq, ts_us and payload
+
+Wear: a sector is erased only when the writer reaches it again, once per lap, so every sector
+gets the same number of erases. Consuming a record only clears bits in its flags byte (no erase).
+When the writer laps the reader, the oldest sector is dropped whole.
+
+Erase ahead: a 4 KB erase takes tens of ms, too long for the appending task. The sector after the
+head can be erased in advance, between Spool_log_erase_begin() and Spool_log_erase_end() (or in one
+go with Spool_log_erase_ahead()), so opening it later only writes its header. Its pending records
+are dropped when the erase begins, i.e. a full log holds one sector less. Without it, the append
+that opens a sector erases it inline.
+
+Recovery (Spool_log_mount): the sector headers give the write order (highest seq = head); the head
+sector is scanned for the first erased slot, and every sector for pending records. Records torn by a
+reset (bad CRC) are marked consumed. The result is the small in-RAM index: per sector its seq
+and pending count, plus the head and tail positions.
+
+Usage:
+
+	Spool_device_type device = { .context = ..., .size = ..., .read = ..., .write = ..., .erase = ... };
+	static Spool_log_type log;
+
+	Spool_log_mount(&log, &device);
+
+	Spool_log_append(&log, &record);
+
+	if (Spool_log_peek(&log, &record) == SPOOL_return_OK) {
+		// deliver, then
+		Spool_log_consume(&log);
+	}
+
+	// Any time, e.g. right after an append opened a sector
+	Spool_log_erase_ahead(&log);
+
+Pure C over a read/write/erase interface: runs against esp_partition (Spool.h) on the device and
+against a plain file on a host. Not thread-safe; one task owns a log. The erase between
+Spool_log_erase_begin() and Spool_log_erase_end() may run elsewhere without the owner's lock.
+*/
+
+#ifndef woXrooX_Spool_log_H
+#define woXrooX_Spool_log_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+////////////// DEFINES
+
+#define SPOOL_SECTOR_BYTES 4096
+#define SPOOL_SECTOR_HEADER 16
+
+// 256 KB partition at most
+#define SPOOL_SECTORS_MAX 64
+
+#ifndef SPOOL_PAYLOAD_BYTES
+#define SPOOL_PAYLOAD_BYTES 172
+#endif
+
+#define SPOOL_RECORD_HEADER 16
+#define SPOOL_RECORD_BYTES (SPOOL_RECORD_HEADER + SPOOL_PAYLOAD_BYTES)
+#define SPOOL_RECORDS_PER_SECTOR ((SPOOL_SECTOR_BYTES - SPOOL_SECTOR_HEADER) / SPOOL_RECORD_BYTES)
+
+// "WXS2"; sectors from another record layout read as blank and are reused
+#define SPOOL_MAGIC 0x32535857u
+
+#define SPOOL_FLAGS_ERASED 0xFF
+#define SPOOL_FLAGS_PENDING 0xFE
+#define SPOOL_FLAGS_CONSUMED 0x00
+
+#define SPOOL_return_OK 0
+#define SPOOL_return_error -1
+#define SPOOL_return_empty -2
+#define SPOOL_return_device -3
+
+// The sector to open is still being erased ahead
+#define SPOOL_return_busy -4
+
+#define SPOOL_AHEAD_NONE 0
+#define SPOOL_AHEAD_ERASING 1
+#define SPOOL_AHEAD_READY 2
+
+////////////// TYPES
+
+// All offsets are relative to the start of the region; functions return 0 on success
+typedef struct {
+	void *context;
+	uint32_t size;
+	int (*read)(void *context, uint32_t offset, void *out, uint32_t length);
+	int (*write)(void *context, uint32_t offset, const void *data, uint32_t length);
+	int (*erase)(void *context, uint32_t offset, uint32_t length);
+} Spool_device_type;
+
+typedef struct {
+	uint32_t seq;
+	uint64_t ts_us;
+	uint8_t payload[SPOOL_PAYLOAD_BYTES];
+} Spool_record_type;
+
+typedef struct {
+	const Spool_device_type *device;
+	uint32_t sectors;
+
+	// Index: 0 = no valid header
+	uint32_t sector_seq[SPOOL_SECTORS_MAX];
+	uint8_t sector_pending[SPOOL_SECTORS_MAX];
+
+	// Next slot to write (head_record == SPOOL_RECORDS_PER_SECTOR: open the next sector first)
+	uint32_t head_sector;
+	uint32_t head_record;
+	uint32_t next_seq;
+
+	// Oldest pending record (valid while pending > 0)
+	uint32_t tail_sector;
+	uint32_t tail_record;
+
+	uint32_t pending;
+
+	// Records lost to the writer lapping the reader, and to bad CRCs
+	uint32_t dropped;
+	uint32_t corrupted;
+
+	// Erase ahead: SPOOL_AHEAD_* for ahead_sector
+	uint32_t ahead_sector;
+	uint8_t ahead_state;
+
+	uint8_t scratch[SPOOL_RECORD_BYTES];
+} Spool_log_type;
+
+////////////// Helpers
+
+static uint16_t Spool_crc16(const uint8_t *data, size_t length) {
+	uint16_t crc = 0xFFFF;
+
+	for (size_t i = 0; i < length; ++i) {
+		crc ^= (uint16_t)data[i] << 8;
+		for (int b = 0; b < 8; ++b) crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+	}
+
+	return crc;
+}
+
+static inline uint32_t Spool_get_32(const uint8_t *p) {
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void Spool_put_32(uint8_t *p, uint32_t v) {
+	p[0] = (uint8_t)v;
+	p[1] = (uint8_t)(v >> 8);
+	p[2] = (uint8_t)(v >> 16);
+	p[3] = (uint8_t)(v >> 24);
+}
+
+static inline uint32_t Spool_sector_offset(uint32_t sector) {
+	return sector * SPOOL_SECTOR_BYTES;
+}
+
+static inline uint32_t Spool_record_offset(uint32_t sector, uint32_t record) {
+	return sector * SPOOL_SECTOR_BYTES + SPOOL_SECTOR_HEADER + record * SPOOL_RECORD_BYTES;
+}
+
+static inline uint32_t Spool_next_sector(const Spool_log_type *log, uint32_t sector) {
+	return (sector + 1) % log->sectors;
+}
+
+static int Spool_read_flags(Spool_log_type *log, uint32_t sector, uint32_t record, uint8_t *flags) {
+	return log->device->read(log->device->context, Spool_record_offset(sector, record), flags, 1) == 0 ? SPOOL_return_OK : SPOOL_return_device;
+}
+
+static int Spool_mark_consumed(Spool_log_type *log, uint32_t sector, uint32_t record) {
+	const uint8_t flags = SPOOL_FLAGS_CONSUMED;
+	return log->device->write(log->device->context, Spool_record_offset(sector, record), &flags, 1) == 0 ? SPOOL_return_OK : SPOOL_return_device;
+}
+
+// Read a record into scratch and check it. true = intact.
+static bool Spool_read_record(Spool_log_type *log, uint32_t sector, uint32_t record) {
+	if (log->device->read(log->device->context, Spool_record_offset(sector, record), log->scratch, SPOOL_RECORD_BYTES) != 0) return false;
+
+	uint16_t crc = (uint16_t)(log->scratch[2] | (log->scratch[3] << 8));
+	return crc == Spool_crc16(log->scratch + 4, SPOOL_RECORD_BYTES - 4);
+}
+
+// Move the tail to the first pending record at or after (sector, record)
+static void Spool_seek_tail(Spool_log_type *log, uint32_t sector, uint32_t record) {
+	if (log->pending == 0) return;
+
+	for (uint32_t visited = 0; visited <= log->sectors; ++visited) {
+		if (log->sector_pending[sector] > 0) {
+			for (; record < SPOOL_RECORDS_PER_SECTOR; ++record) {
+				uint8_t flags;
+				if (Spool_read_flags(log, sector, record, &flags) != SPOOL_return_OK) break;
+
+				if (flags == SPOOL_FLAGS_PENDING) {
+					log->tail_sector = sector;
+					log->tail_record = record;
+					return;
+				}
+			}
+		}
+
+		sector = Spool_next_sector(log, sector);
+		record = 0;
+	}
+
+	// Index and flash disagree (device errors): start over empty rather than loop
+	log->pending = 0;
+	memset(log->sector_pending, 0, sizeof(log->sector_pending));
+}
+
+// The writer is about to reuse `sector`: whatever is still pending there is lost
+static void Spool_drop_sector(Spool_log_type *log, uint32_t sector) {
+	if (log->sector_pending[sector] > 0) {
+		log->dropped += log->sector_pending[sector];
+		log->pending -= log->sector_pending[sector];
+		log->sector_pending[sector] = 0;
+	}
+
+	log->sector_seq[sector] = 0;
+
+	if (log->pending > 0 && log->tail_sector == sector) Spool_seek_tail(log, Spool_next_sector(log, sector), 0);
+}
+
+// Make the next sector the head; it is erased here unless that was done ahead
+static int Spool_open_sector(Spool_log_type *log) {
+	uint32_t next = Spool_next_sector(log, log->head_sector);
+	bool erased = log->ahead_sector == next && log->ahead_state == SPOOL_AHEAD_READY;
+
+	if (log->ahead_sector == next && log->ahead_state == SPOOL_AHEAD_ERASING) return SPOOL_return_busy;
+
+	if (!erased) {
+		// Writer lapped the reader: the oldest sector goes
+		Spool_drop_sector(log, next);
+
+		if (log->device->erase(log->device->context, Spool_sector_offset(next), SPOOL_SECTOR_BYTES) != 0) return SPOOL_return_device;
+	}
+
+	log->ahead_state = SPOOL_AHEAD_NONE;
+
+	uint32_t seq = log->next_seq++;
+	uint8_t header[SPOOL_SECTOR_HEADER];
+	Spool_put_32(header + 0, SPOOL_MAGIC);
+	Spool_put_32(header + 4, seq);
+	Spool_put_32(header + 8, ~seq);
+	Spool_put_32(header + 12, 0xFFFFFFFFu);
+
+	if (log->device->write(log->device->context, Spool_sector_offset(next), header, SPOOL_SECTOR_HEADER) != 0) return SPOOL_return_device;
+
+	log->sector_seq[next] = seq;
+	log->head_sector = next;
+	log->head_record = 0;
+
+	return SPOOL_return_OK;
+}
+
+////////////// API
+
+static int Spool_log_mount(Spool_log_type *log, const Spool_device_type *device) {
+	if (!log || !device || !device->read || !device->write || !device->erase) return SPOOL_return_error;
+
+	memset(log, 0, sizeof(*log));
+	log->device = device;
+	log->ahead_state = SPOOL_AHEAD_NONE;
+	log->sectors = device->size / SPOOL_SECTOR_BYTES;
+	if (log->sectors > SPOOL_SECTORS_MAX) log->sectors = SPOOL_SECTORS_MAX;
+	if (log->sectors < 2) return SPOOL_return_error;
+
+	// Sector headers → write order
+	bool any = false;
+
+	for (uint32_t s = 0; s < log->sectors; ++s) {
+		uint8_t header[SPOOL_SECTOR_HEADER];
+		if (device->read(device->context, Spool_sector_offset(s), header, SPOOL_SECTOR_HEADER) != 0) return SPOOL_return_device;
+
+		uint32_t seq = Spool_get_32(header + 4);
+		if (Spool_get_32(header) != SPOOL_MAGIC || seq != ~Spool_get_32(header + 8) || seq == 0) continue;
+
+		log->sector_seq[s] = seq;
+
+		if (!any || (int32_t)(seq - log->sector_seq[log->head_sector]) > 0) log->head_sector = s;
+		any = true;
+	}
+
+	// Blank (or foreign) region: the first append opens sector 0
+	if (!any) {
+		log->head_sector = log->sectors - 1;
+		log->head_record = SPOOL_RECORDS_PER_SECTOR;
+		log->next_seq = 1;
+		return SPOOL_return_OK;
+	}
+
+	log->next_seq = log->sector_seq[log->head_sector] + 1;
+	log->head_record = SPOOL_RECORDS_PER_SECTOR;
+
+	// Pending records per sector; torn ones are retired now so the index stays exact
+	for (uint32_t s = 0; s < log->sectors; ++s) {
+		if (log->sector_seq[s] == 0) continue;
+
+		for (uint32_t r = 0; r < SPOOL_RECORDS_PER_SECTOR; ++r) {
+			uint8_t flags;
+			if (Spool_read_flags(log, s, r, &flags) != SPOOL_return_OK) return SPOOL_return_device;
+
+			if (flags == SPOOL_FLAGS_ERASED) {
+				if (s == log->head_sector) log->head_record = r;
+				break;
+			}
+
+			if (flags != SPOOL_FLAGS_PENDING) continue;
+
+			if (Spool_read_record(log, s, r)) {
+				log->sector_pending[s]++;
+				log->pending++;
+			}
+
+			else {
+				log->corrupted++;
+				Spool_mark_consumed(log, s, r);
+			}
+		}
+	}
+
+	// Oldest data sits right after the head
+	Spool_seek_tail(log, Spool_next_sector(log, log->head_sector), 0);
+
+	return SPOOL_return_OK;
+}
+
+static int Spool_log_append(Spool_log_type *log, const Spool_record_type *record) {
+	if (!log || !log->device || !record) return SPOOL_return_error;
+
+	if (log->head_record >= SPOOL_RECORDS_PER_SECTOR) {
+		int response = Spool_open_sector(log);
+		if (response != SPOOL_return_OK) return response;
+	}
+
+	uint8_t *p = log->scratch;
+	p[0] = SPOOL_FLAGS_PENDING;
+	p[1] = 0xFF;
+	Spool_put_32(p + 4, record->seq);
+	Spool_put_32(p + 8, (uint32_t)record->ts_us);
+	Spool_put_32(p + 12, (uint32_t)(record->ts_us >> 32));
+	memcpy(p + SPOOL_RECORD_HEADER, record->payload, SPOOL_PAYLOAD_BYTES);
+
+	uint16_t crc = Spool_crc16(p + 4, SPOOL_RECORD_BYTES - 4);
+	p[2] = (uint8_t)crc;
+	p[3] = (uint8_t)(crc >> 8);
+
+	uint32_t sector = log->head_sector;
+	uint32_t slot = log->head_record;
+
+	// The slot is used even if the write fails half-way; recovery treats it as torn
+	log->head_record++;
+
+	if (log->device->write(log->device->context, Spool_record_offset(sector, slot), p, SPOOL_RECORD_BYTES) != 0) return SPOOL_return_device;
+
+	log->sector_pending[sector]++;
+	log->pending++;
+
+	if (log->pending == 1) {
+		log->tail_sector = sector;
+		log->tail_record = slot;
+	}
+
+	return SPOOL_return_OK;
+}
+
+static int Spool_log_consume(Spool_log_type *log) {
+	if (!log || !log->device) return SPOOL_return_error;
+	if (log->pending == 0) return SPOOL_return_empty;
+
+	uint32_t sector = log->tail_sector;
+	uint32_t record = log->tail_record;
+
+	if (Spool_mark_consumed(log, sector, record) != SPOOL_return_OK) return SPOOL_return_device;
+
+	log->sector_pending[sector]--;
+	log->pending--;
+
+	Spool_seek_tail(log, sector, record + 1);
+
+	return SPOOL_return_OK;
+}
+
+// Oldest pending record, left in place until Spool_log_consume()
+static int Spool_log_peek(Spool_log_type *log, Spool_record_type *out) {
+	if (!log || !log->device || !out) return SPOOL_return_error;
+
+	while (log->pending > 0) {
+		if (Spool_read_record(log, log->tail_sector, log->tail_record)) {
+			const uint8_t *p = log->scratch;
+			out->seq = Spool_get_32(p + 4);
+			out->ts_us = (uint64_t)Spool_get_32(p + 8) | ((uint64_t)Spool_get_32(p + 12) << 32);
+			memcpy(out->payload, p + SPOOL_RECORD_HEADER, SPOOL_PAYLOAD_BYTES);
+			return SPOOL_return_OK;
+		}
+
+		// Went bad since mount: retire it and look further
+		log->corrupted++;
+		if (Spool_log_consume(log) != SPOOL_return_OK) return SPOOL_return_device;
+	}
+
+	return SPOOL_return_empty;
+}
+
+// Claim the sector after the head for an erase ahead of time. SPOOL_return_empty when there is
+// nothing to do (already erased or being erased); otherwise *offset is the region to erase, and
+// Spool_log_erase_end() must follow.
+static int Spool_log_erase_begin(Spool_log_type *log, uint32_t *offset) {
+	if (!log || !log->device || !offset) return SPOOL_return_error;
+
+	uint32_t next = Spool_next_sector(log, log->head_sector);
+	if (log->ahead_state != SPOOL_AHEAD_NONE && log->ahead_sector == next) return SPOOL_return_empty;
+
+	Spool_drop_sector(log, next);
+
+	log->ahead_sector = next;
+	log->ahead_state = SPOOL_AHEAD_ERASING;
+	*offset = Spool_sector_offset(next);
+
+	return SPOOL_return_OK;
+}
+
+// ok = the erase from Spool_log_erase_begin() succeeded
+static void Spool_log_erase_end(Spool_log_type *log, bool ok) {
+	if (!log || log->ahead_state != SPOOL_AHEAD_ERASING) return;
+
+	log->ahead_state = ok ? SPOOL_AHEAD_READY : SPOOL_AHEAD_NONE;
+}
+
+// Begin, erase and end in one call, for a single task owning the log
+static int Spool_log_erase_ahead(Spool_log_type *log) {
+	uint32_t offset;
+
+	int response = Spool_log_erase_begin(log, &offset);
+	if (response != SPOOL_return_OK) return response == SPOOL_return_empty ? SPOOL_return_OK : response;
+
+	bool ok = log->device->erase(log->device->context, offset, SPOOL_SECTOR_BYTES) == 0;
+	Spool_log_erase_end(log, ok);
+
+	return ok ? SPOOL_return_OK : SPOOL_return_device;
+}
+
+// true while the next sector still has to be erased when the head fills up
+static inline bool Spool_log_erase_needed(const Spool_log_type *log) {
+	return !(log->ahead_state != SPOOL_AHEAD_NONE && log->ahead_sector == Spool_next_sector(log, log->head_sector));
+}
+
+// true when the next append opens a sector
+static inline bool Spool_log_head_full(const Spool_log_type *log) {
+	return log->head_record >= SPOOL_RECORDS_PER_SECTOR;
+}
+
+static inline uint32_t Spool_log_pending(const Spool_log_type *log) {
+	return log->pending;
+}
+
+static inline uint32_t Spool_log_capacity(const Spool_log_type *log) {
+	return log->sectors * SPOOL_RECORDS_PER_SECTOR;
+}
+
+#endif
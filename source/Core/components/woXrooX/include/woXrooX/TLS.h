@@ -0,0 +1,159 @@
+#ifndef woXrooX_TLS_H
+#define woXrooX_TLS_H
+
+/*
+Shared TLS trust context for HTTPS (HTTP_client.h) and WSS (WebSocket_client.h).
+
+The trust anchors are set up once, on first use, and every TLS client points at the same store
+instead of parsing its own copy of the CA on each connect.
+
+Usage:
+	// Optional: pin a private CA instead of the IDF certificate bundle
+	// extern const uint8_t server_ca_pem_start[] asm("_binary_server_ca_pem_start");
+	// extern const uint8_t server_ca_pem_end[]   asm("_binary_server_ca_pem_end");
+	// TLS_trust_set_CA((const char *)server_ca_pem_start, server_ca_pem_end - server_ca_pem_start);
+
+	esp_http_client_config_t http_cfg = { .url = "https://..." };
+	TLS_HTTP_config_apply(&http_cfg);
+
+	esp_websocket_client_config_t ws_cfg = { .uri = "wss://..." };
+	TLS_WS_config_apply(&ws_cfg);
+
+Handshake cost:
+	TLS_stats() returns the number of full handshakes vs reused connections and the time spent
+	opening them, so the effect of connection reuse can be read off a running device.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+
+#include "esp_tls.h"
+#include "esp_crt_bundle.h"
+#include "esp_http_client.h"
+#include "esp_websocket_client.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+////////////// DEFINES
+
+#define TLS_return_OK 0
+#define TLS_return_error -1
+
+////////////// TYPES
+
+typedef struct {
+	// Connects that needed a full TCP + TLS handshake
+	uint32_t handshakes;
+
+	// Requests served on an already established connection
+	uint32_t reuses;
+
+	// Duration of the most recent full open (us)
+	uint32_t last_handshake_us;
+
+	// Sum over all full opens (us); divide by handshakes for the mean
+	uint64_t total_handshake_us;
+} TLS_stats_type;
+
+////////////// GLOBALS
+
+static const char *TLS_TAG = "woXrooX::TLS:";
+
+static portMUX_TYPE TLS_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// 0 = not yet set up, 1 = IDF cert bundle, 2 = global CA store
+static volatile int TLS_trust_mode = 0;
+
+static const char *TLS_CA_pem = NULL;
+static size_t TLS_CA_pem_length = 0;
+
+static TLS_stats_type TLS_statistics;
+
+////////////// Trust context
+
+// Pin a PEM CA (must stay valid for the lifetime of the program, e.g. EMBED_TXTFILES).
+// Call before the first TLS connect; otherwise the certificate bundle is used.
+static int TLS_trust_set_CA(const char *pem, size_t length) {
+	if (!pem || length == 0) return TLS_return_error;
+	if (TLS_trust_mode != 0) return TLS_return_error;
+
+	TLS_CA_pem = pem;
+	TLS_CA_pem_length = length;
+
+	return TLS_return_OK;
+}
+
+// Lazily initialise the shared trust context. Safe to call from several tasks.
+static int TLS_trust_init(void) {
+	if (TLS_trust_mode != 0) return TLS_return_OK;
+
+	// PEM length must include the terminating NUL for mbedTLS
+	if (TLS_CA_pem) {
+		if (esp_tls_init_global_ca_store() != ESP_OK) return TLS_return_error;
+		if (esp_tls_set_global_ca_store((const unsigned char *)TLS_CA_pem, (unsigned int)TLS_CA_pem_length) != ESP_OK) {
+			ESP_LOGE(TLS_TAG, "Failed to load CA into global store");
+			return TLS_return_error;
+		}
+	}
+
+	portENTER_CRITICAL(&TLS_lock);
+	if (TLS_trust_mode == 0) TLS_trust_mode = TLS_CA_pem ? 2 : 1;
+	portEXIT_CRITICAL(&TLS_lock);
+
+	ESP_LOGI(TLS_TAG, "Trust context ready (%s)", TLS_trust_mode == 2 ? "global CA store" : "certificate bundle");
+
+	return TLS_return_OK;
+}
+
+static int TLS_HTTP_config_apply(esp_http_client_config_t *cfg) {
+	if (TLS_trust_init() != TLS_return_OK) return TLS_return_error;
+
+	if (TLS_trust_mode == 2) cfg->use_global_ca_store = true;
+	else cfg->crt_bundle_attach = esp_crt_bundle_attach;
+
+	return TLS_return_OK;
+}
+
+static int TLS_WS_config_apply(esp_websocket_client_config_t *cfg) {
+	if (TLS_trust_init() != TLS_return_OK) return TLS_return_error;
+
+	if (TLS_trust_mode == 2) cfg->use_global_ca_store = true;
+	else cfg->crt_bundle_attach = esp_crt_bundle_attach;
+
+	return TLS_return_OK;
+}
+
+////////////// Handshake accounting
+
+static inline void TLS_record_handshake(uint64_t started_us) {
+	uint32_t dt = (uint32_t)(esp_timer_get_time() - started_us);
+
+	portENTER_CRITICAL(&TLS_lock);
+	TLS_statistics.handshakes++;
+	TLS_statistics.last_handshake_us = dt;
+	TLS_statistics.total_handshake_us += dt;
+	portEXIT_CRITICAL(&TLS_lock);
+
+	ESP_LOGD(TLS_TAG, "Full connect took %u us", (unsigned)dt);
+}
+
+static inline void TLS_record_reuse(void) {
+	portENTER_CRITICAL(&TLS_lock);
+	TLS_statistics.reuses++;
+	portEXIT_CRITICAL(&TLS_lock);
+}
+
+static TLS_stats_type TLS_stats(void) {
+	TLS_stats_type copy;
+
+	portENTER_CRITICAL(&TLS_lock);
+	copy = TLS_statistics;
+	portEXIT_CRITICAL(&TLS_lock);
+
+	return copy;
+}
+
+#endif
@@ -0,0 +1,129 @@
+/*
+Task placement: every woXrooX task's core, priority and stack in one table.
+
+Layout (defaults, menuconfig → woXrooX → Task layout):
+
+	MIC_RX          APP_CPU   20    I2S capture must never wait behind the network
+	WS_TX           PRO_CPU    6    next to Wi-Fi (23) and lwIP (18), below them
+	Button(s)       any        4
+	DLOG, Profiler  PRO_CPU    1    background
+	Spool_erase     PRO_CPU    1    background, off the WS_TX path
+	HTTP_stream     PRO_CPU    5    one per LAN stream client, below WS_TX
+
+Usage:
+#include "woXrooX/Tasks.h"
+
+if (Tasks_create(TASK_MIC_RX, mic_rx_task, NULL, &handle) != 0) { }
+
+// Log the table as configured
+Tasks_report();
+
+MIC.h measures I2S read jitter and missed DMA buffers (MIC_timing()), which is how a layout
+change is checked on a device.
+*/
+
+#ifndef woXrooX_Tasks_H
+#define woXrooX_Tasks_H
+
+#include <stdint.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "esp_log.h"
+
+////////////// DEFINES
+
+// Fallbacks when the Kconfig menu is not part of the build
+#ifndef CONFIG_WOXROOX_MIC_CORE
+#define CONFIG_WOXROOX_MIC_CORE 1
+#define CONFIG_WOXROOX_MIC_PRIORITY 20
+#define CONFIG_WOXROOX_MIC_STACK 4096
+#endif
+
+#ifndef CONFIG_WOXROOX_WS_CORE
+#define CONFIG_WOXROOX_WS_CORE 0
+#define CONFIG_WOXROOX_WS_PRIORITY 6
+#define CONFIG_WOXROOX_WS_STACK 4096
+#endif
+
+#ifndef CONFIG_WOXROOX_BUTTONS_CORE
+#define CONFIG_WOXROOX_BUTTONS_CORE -1
+#define CONFIG_WOXROOX_BUTTONS_PRIORITY 4
+#define CONFIG_WOXROOX_BUTTONS_STACK 2048
+#endif
+
+#ifndef CONFIG_WOXROOX_BACKGROUND_CORE
+#define CONFIG_WOXROOX_BACKGROUND_CORE 0
+#define CONFIG_WOXROOX_BACKGROUND_PRIORITY 1
+#define CONFIG_WOXROOX_BACKGROUND_STACK 3072
+#endif
+
+#ifndef CONFIG_WOXROOX_HTTP_STREAM_CORE
+#define CONFIG_WOXROOX_HTTP_STREAM_CORE 0
+#define CONFIG_WOXROOX_HTTP_STREAM_PRIORITY 5
+#define CONFIG_WOXROOX_HTTP_STREAM_STACK 3072
+#endif
+
+#define TASKS_CORE(core) ((core) < 0 || (core) >= portNUM_PROCESSORS ? tskNO_AFFINITY : (BaseType_t)(core))
+
+////////////// TYPES
+
+typedef enum {
+	TASK_MIC_RX = 0,
+	TASK_WS_TX,
+	TASK_BUTTON,
+	TASK_BUTTONS,
+	TASK_DLOG,
+	TASK_PROFILER,
+	TASK_HTTP_STREAM,
+	TASK_SPOOL_ERASE,
+	TASK_COUNT
+} Tasks_id_type;
+
+typedef struct {
+	const char *name;
+	BaseType_t core;
+	UBaseType_t priority;
+	uint32_t stack;
+} Tasks_placement_type;
+
+////////////// GLOBALS
+
+static const char *TASKS_TAG = "woXrooX::Tasks:";
+
+static const Tasks_placement_type Tasks_table[TASK_COUNT] = {
+	[TASK_MIC_RX] = { "MIC_RX", TASKS_CORE(CONFIG_WOXROOX_MIC_CORE), CONFIG_WOXROOX_MIC_PRIORITY, CONFIG_WOXROOX_MIC_STACK },
+	[TASK_WS_TX] = { "WS_TX", TASKS_CORE(CONFIG_WOXROOX_WS_CORE), CONFIG_WOXROOX_WS_PRIORITY, CONFIG_WOXROOX_WS_STACK },
+	[TASK_BUTTON] = { "Button_task", TASKS_CORE(CONFIG_WOXROOX_BUTTONS_CORE), CONFIG_WOXROOX_BUTTONS_PRIORITY, CONFIG_WOXROOX_BUTTONS_STACK },
+	[TASK_BUTTONS] = { "Buttons_task", TASKS_CORE(CONFIG_WOXROOX_BUTTONS_CORE), CONFIG_WOXROOX_BUTTONS_PRIORITY, CONFIG_WOXROOX_BUTTONS_STACK },
+	[TASK_DLOG] = { "DLOG", TASKS_CORE(CONFIG_WOXROOX_BACKGROUND_CORE), CONFIG_WOXROOX_BACKGROUND_PRIORITY, CONFIG_WOXROOX_BACKGROUND_STACK },
+	[TASK_PROFILER] = { "Profiler", TASKS_CORE(CONFIG_WOXROOX_BACKGROUND_CORE), CONFIG_WOXROOX_BACKGROUND_PRIORITY, CONFIG_WOXROOX_BACKGROUND_STACK },
+	[TASK_HTTP_STREAM] = { "HTTP_stream", TASKS_CORE(CONFIG_WOXROOX_HTTP_STREAM_CORE), CONFIG_WOXROOX_HTTP_STREAM_PRIORITY, CONFIG_WOXROOX_HTTP_STREAM_STACK },
+	[TASK_SPOOL_ERASE] = { "Spool_erase", TASKS_CORE(CONFIG_WOXROOX_BACKGROUND_CORE), CONFIG_WOXROOX_BACKGROUND_PRIORITY, CONFIG_WOXROOX_BACKGROUND_STACK },
+};
+
+////////////// API
+
+// Create a task with its placement from the table. Returns 0 on success.
+static int Tasks_create(Tasks_id_type id, TaskFunction_t function, void *arg, TaskHandle_t *out_handle) {
+	if (id >= TASK_COUNT) return -1;
+
+	const Tasks_placement_type *t = &Tasks_table[id];
+
+	if (xTaskCreatePinnedToCore(function, t->name, t->stack, arg, t->priority, out_handle, t->core) != pdPASS) {
+		ESP_LOGE(TASKS_TAG, "Could not create %s", t->name);
+		return -1;
+	}
+
+	return 0;
+}
+
+static void Tasks_report(void) {
+	for (int i = 0; i < TASK_COUNT; ++i) {
+		const Tasks_placement_type *t = &Tasks_table[i];
+		ESP_LOGI(TASKS_TAG, "%-12s core %2d  priority %2u  stack %5u", t->name, t->core == tskNO_AFFINITY ? -1 : (int)t->core, (unsigned)t->priority, (unsigned)t->stack);
+	}
+}
+
+#endif
@@ -0,0 +1,154 @@
+/*
+Wire format of the woXrooX.STT binary stream (little-endian), shared by the sender
+(WebSocket_client.h) and anything that needs to produce or parse it.
+
+Every device → server message starts with the same 16-byte header, told apart by `type`:
+
+	type u8 | sample rate kHz u8 | count u16 | seq u32 | ts_us u64
+
+	WS_TYPE_AUDIO     audio:  count = samples        | pcm count × i16
+	WS_TYPE_PTT       PTT:    count = sample offset  | kind u8 | 0 u8 | 0 u16       (ts_us = edge time)
+	WS_TYPE_SPOOLED   spooled audio (sent late, after an outage):
+	                          count = samples        | predictor i16 | step index u8 | 0 u8 | IMA ADPCM
+	WS_TYPE_FEATURES  log-mel (woXrooX.STT.logmel subprotocol, instead of audio):
+	                          count = hops           | bands u8 | 0 u8 | 0 u16 | hops × bands u8
+
+Sample rate and frame length can change at runtime, so every message carries its own. Metrics
+snapshots start with "WXM1" (Metrics.h), whose first byte is none of the types above.
+
+Server → device:
+
+	WS_TYPE_CONFIG    capture: type u8 | 0 u8 | frame ms u16 | sample rate u32 (Hz)
+
+Only <stdint.h>/<string.h>: no RTOS or IDF headers, so the packing and gating math build
+and run with a plain host compiler.
+*/
+
+#ifndef woXrooX_WS_protocol_H
+#define woXrooX_WS_protocol_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+////////////// DEFINES
+
+#define WS_TYPE_AUDIO 1
+#define WS_TYPE_PTT 2
+#define WS_TYPE_SPOOLED 3
+#define WS_TYPE_FEATURES 4
+
+#define WS_TYPE_CONFIG 0x10
+
+#define WS_HEADER_BYTES 16
+
+// 656 bytes for 320 samples (16 kHz, 20 ms)
+#define WS_AUDIO_BYTES(samples) (WS_HEADER_BYTES + (samples) * 2)
+
+// 20 bytes
+#define WS_PTT_MARKER_BYTES (WS_HEADER_BYTES + 4)
+#define WS_PTT_START 1
+#define WS_PTT_END 2
+
+// 180 bytes for 320 samples (4-bit ADPCM, low nibble first; decodes on its own)
+#define WS_SPOOLED_BYTES(samples) (WS_HEADER_BYTES + 4 + ((samples) + 1) / 2)
+
+// 100 bytes for 2 hops × 40 bands (one 20 ms frame), against 656 for PCM
+#define WS_FEATURES_BYTES(hops, bands) (WS_HEADER_BYTES + 4 + (hops) * (bands))
+
+#define WS_CONFIG_BYTES 8
+
+////////////// PACKING (little-endian)
+
+static inline void little_endian_32(uint8_t *p, uint32_t v) {
+	p[0] = (uint8_t)(v);
+	p[1] = (uint8_t)(v >> 8);
+	p[2] = (uint8_t)(v >> 16);
+	p[3] = (uint8_t)(v >> 24);
+}
+
+static inline void little_endian_64(uint8_t *p, uint64_t v) {
+	p[0] = (uint8_t)(v);
+	p[1] = (uint8_t)(v >> 8);
+	p[2] = (uint8_t)(v >> 16);
+	p[3] = (uint8_t)(v >> 24);
+	p[4] = (uint8_t)(v >> 32);
+	p[5] = (uint8_t)(v >> 40);
+	p[6] = (uint8_t)(v >> 48);
+	p[7] = (uint8_t)(v >> 56);
+}
+
+static inline void WS_pack_header(uint8_t *out, uint8_t type, uint32_t sample_rate, uint16_t count, uint32_t seq, uint64_t ts_us) {
+	out[0] = type;
+	out[1] = (uint8_t)(sample_rate / 1000);
+	out[2] = (uint8_t)(count);
+	out[3] = (uint8_t)(count >> 8);
+	little_endian_32(out + 4, seq);
+	little_endian_64(out + 8, ts_us);
+}
+
+// pcm is copied as-is: both ESP32 and the server side are little-endian. Returns the length.
+static inline size_t WS_pack_audio(uint8_t *out, uint32_t seq, uint64_t ts_us, uint32_t sample_rate, const int16_t *pcm, uint16_t samples) {
+	WS_pack_header(out, WS_TYPE_AUDIO, sample_rate, samples, seq, ts_us);
+	memcpy(out + WS_HEADER_BYTES, (const void *)pcm, (size_t)samples * sizeof(int16_t));
+
+	return WS_AUDIO_BYTES(samples);
+}
+
+static inline void WS_pack_PTT_marker(uint8_t *out, uint32_t seq, uint64_t edge_ts_us, uint32_t sample_rate, bool active, uint16_t offset) {
+	WS_pack_header(out, WS_TYPE_PTT, sample_rate, offset, seq, edge_ts_us);
+	out[16] = active ? WS_PTT_START : WS_PTT_END;
+	out[17] = 0;
+	out[18] = 0;
+	out[19] = 0;
+}
+
+static inline size_t WS_pack_spooled(uint8_t *out, uint32_t seq, uint64_t ts_us, uint32_t sample_rate, int16_t predictor, uint8_t index, const uint8_t *adpcm, uint16_t samples) {
+	WS_pack_header(out, WS_TYPE_SPOOLED, sample_rate, samples, seq, ts_us);
+	out[16] = (uint8_t)predictor;
+	out[17] = (uint8_t)((uint16_t)predictor >> 8);
+	out[18] = index;
+	out[19] = 0;
+	memcpy(out + 20, adpcm, ((size_t)samples + 1) / 2);
+
+	return WS_SPOOLED_BYTES(samples);
+}
+
+// features: hops vectors of bands bytes each, back to back
+static inline size_t WS_pack_features(uint8_t *out, uint32_t seq, uint64_t ts_us, uint32_t sample_rate, uint8_t hops, uint8_t bands, const uint8_t *features) {
+	WS_pack_header(out, WS_TYPE_FEATURES, sample_rate, hops, seq, ts_us);
+	out[16] = bands;
+	out[17] = 0;
+	out[18] = 0;
+	out[19] = 0;
+	memcpy(out + 20, features, (size_t)hops * bands);
+
+	return WS_FEATURES_BYTES(hops, bands);
+}
+
+////////////// PARSING
+
+// Server → device capture change; false if `in` is not a WS_TYPE_CONFIG message
+static inline bool WS_parse_config(const uint8_t *in, size_t length, uint32_t *sample_rate, uint16_t *frame_ms) {
+	if (length != WS_CONFIG_BYTES || in[0] != WS_TYPE_CONFIG) return false;
+
+	*frame_ms = (uint16_t)(in[2] | (in[3] << 8));
+	*sample_rate = (uint32_t)in[4] | ((uint32_t)in[5] << 8) | ((uint32_t)in[6] << 16) | ((uint32_t)in[7] << 24);
+
+	return true;
+}
+
+////////////// PTT gating
+
+// Sample index inside a frame of `samples` starting at frame_ts_us at which an edge happened
+static inline uint16_t WS_sample_offset(uint64_t frame_ts_us, uint64_t edge_ts_us, uint32_t sample_rate, uint32_t samples) {
+	if (edge_ts_us <= frame_ts_us) return 0;
+
+	uint64_t offset = (edge_ts_us - frame_ts_us) * sample_rate / 1000000ULL;
+	if (offset >= samples) offset = samples - 1;
+
+	return (uint16_t)offset;
+}
+
+#endif
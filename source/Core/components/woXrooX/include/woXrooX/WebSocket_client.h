@@ -0,0 +1,414 @@
+#ifndef woXrooX_WebSocket_client_H
+#define woXrooX_WebSocket_client_H
+
+/*
+WebSocket Audio Sender (minimal binary frames)
+Usage:
+
+// Bring your mic and PTT headers (for MIC_frame_type / PTT edges) before this header
+// #include "woXrooX/MIC.h"
+// #include "woXrooX/PTT.h"
+
+// Optional: keep PTT audio from outages on flash and send it after reconnect
+// #include "woXrooX/Spool.h"
+// Spool_init();
+
+// Optional: send log-mel features instead of PCM for live audio (subprotocol woXrooX.STT.logmel.v4)
+// #include "woXrooX/Log_mel.h"
+
+
+// Call once after Wi-Fi is up. Provide the mic queue (from listen_queue())
+MIC_listen_start();
+WS_start(MIC_listen_queue());
+
+Binary messages (little-endian, see WS_protocol.h), told apart by the first byte:
+	1  audio:  header (type | rate kHz | samples | seq | ts_us) | pcm × i16     656 bytes at 16 kHz / 20 ms
+	2  PTT:    header (count = sample offset, ts_us = edge) | kind u8 (1 = start, 2 = end) | 0 × 3
+	3  spooled audio: header | ADPCM state (4) | IMA ADPCM
+	4  log-mel (with Log_mel.h, replaces audio): header (count = hops) | bands u8 | 0 × 3 | hops × bands u8
+	'W'        metrics snapshot starting with "WXM1" (Metrics.h), every WS_METRICS_PERIOD_MS
+
+Inbound WS_TYPE_CONFIG (frame ms u16 | sample rate u32) changes the capture via MIC_configure();
+the new rate and frame length show up in the headers of the frames that follow.
+
+A PTT marker is sent right before the audio frame `seq` it refers to; gating starts/ends at
+`sample offset` inside that frame. Only frames overlapping an active PTT span are sent.
+
+With Spool.h, frames that cannot be sent (offline, or a failed send) are spooled together with
+their PTT edges (the last START and the last END in the frame, both sent in order), and drained after reconnect at up to SPOOL_DRAIN_BURST frames per live frame.
+Spooled frames arrive late and interleaved with live ones; order them by seq, then ts_us (a frame
+longer than SPOOL_FRAME_SAMPLES comes back as several spooled messages with the same seq).
+
+With Log_mel.h every frame from the queue also runs through the log-mel stage (so the window is
+warm at PTT start), and live frames go out as features: 100 instead of 656 bytes. Spooled frames
+stay ADPCM audio; the server computes features for those itself.
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/event_groups.h"
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_websocket_client.h"
+
+#include "WS_protocol.h"
+#include "Metrics.h"
+#include "DLOG.h"
+#include "Tasks.h"
+
+////////////// DEFINES
+
+// Fallbacks when the Kconfig menu is not part of the build (woXrooX → Network)
+#ifndef CONFIG_WOXROOX_WS_URL
+#define CONFIG_WOXROOX_WS_URL "ws://192.168.1.4:8080/stream"
+#define CONFIG_WOXROOX_WS_METRICS_PERIOD_MS 10000
+#endif
+
+#define WS_URL CONFIG_WOXROOX_WS_URL
+
+// Optional subprotocol for versioning on the server; tells it which live payload to expect
+#ifdef woXrooX_Log_mel_H
+#define WS_SUBPROTOCOL "woXrooX.STT.logmel.v4"
+#else
+#define WS_SUBPROTOCOL "woXrooX.STT.v4"
+#endif
+
+// If you use WSS (woXrooX → Features), point WS_URL at wss://. Trust anchors come from the shared
+// TLS context (TLS.h): the IDF cert bundle, or a CA pinned with TLS_trust_set_CA().
+#ifdef CONFIG_WOXROOX_WSS
+#define USE_WSS 1
+#else
+#define USE_WSS 0
+#endif
+
+// Push a Metrics.h snapshot this often while connected (0 = never)
+#define WS_METRICS_PERIOD_MS CONFIG_WOXROOX_WS_METRICS_PERIOD_MS
+
+// Send timeout while WiFi_link.h reports a degraded link (one 20 ms frame)
+#define WS_DEGRADED_SEND_TIMEOUT_MS 20
+
+#if USE_WSS
+#include "TLS.h"
+#endif
+
+////////////// GLOBALS
+
+static const char *WS_TAG = "woXrooX::WS:";
+
+static esp_websocket_client_handle_t WS_client = NULL;
+static volatile bool WS_ready = false;
+
+// WS_CONNECTED mirrors WS_ready so tasks can block on it instead of polling
+#define WS_CONNECTED (1 << 0)
+static EventGroupHandle_t WS_event_group = NULL;
+static StaticEventGroup_t WS_event_group_storage;
+
+static QueueHandle_t WS_source_queue = NULL;
+
+static uint8_t WS_buffer[WS_AUDIO_BYTES(MIC_FRAME_SAMPLES_MAX)];
+
+static uint8_t WS_metrics_buffer[METRICS_SNAPSHOT_MAX];
+
+#ifdef woXrooX_Log_mel_H
+// Hops per MIC frame: 2 at 20 ms, up to 4 at MIC_FRAME_MS_MAX
+#define WS_LOG_MEL_HOPS_MAX (MIC_FRAME_MS_MAX / LOG_MEL_HOP_MS)
+
+static Log_mel_state_type WS_log_mel;
+static uint8_t WS_features[WS_LOG_MEL_HOPS_MAX][LOG_MEL_BANDS];
+static size_t WS_features_hops = 0;
+#endif
+
+////////////// PACKING
+
+// Live payload for frame f; returns its length
+static inline int pack_frame(uint8_t *out, const MIC_frame_type *f) {
+	#ifdef woXrooX_Log_mel_H
+	return (int)WS_pack_features(out, f->seq, f->ts_us, f->sample_rate, (uint8_t)WS_features_hops, LOG_MEL_BANDS, &WS_features[0][0]);
+	#else
+	return (int)WS_pack_audio(out, f->seq, f->ts_us, f->sample_rate, f->pcm, f->samples);
+	#endif
+}
+
+////////////// EVENT HANDLER
+
+static void WS_event_handler(
+	void *handler_args,
+	esp_event_base_t base,
+	int32_t event_id,
+	void *event_data
+) {
+	(void)handler_args;
+	(void)base;
+
+	esp_websocket_event_data_t *data = (esp_websocket_event_data_t *)event_data;
+
+	switch (event_id) {
+		case WEBSOCKET_EVENT_CONNECTED:
+			WS_ready = true;
+			xEventGroupSetBits(WS_event_group, WS_CONNECTED);
+			DLOG_I(WS_TAG, "Connected");
+			break;
+
+		case WEBSOCKET_EVENT_DISCONNECTED:
+			WS_ready = false;
+			xEventGroupClearBits(WS_event_group, WS_CONNECTED);
+			DLOG_W(WS_TAG, "Disconnected");
+			break;
+
+		case WEBSOCKET_EVENT_DATA: {
+			uint32_t sample_rate = 0;
+			uint16_t frame_ms = 0;
+
+			// Only whole binary messages; anything else is ignored for now (auth can be added later)
+			bool whole = data->op_code == 2 && data->payload_offset == 0 && data->data_len == data->payload_len;
+
+			if (whole && WS_parse_config((const uint8_t *)data->data_ptr, (size_t)data->data_len, &sample_rate, &frame_ms)) {
+				MIC_config_type config = { .sample_rate = sample_rate, .frame_ms = frame_ms };
+				int rc = MIC_configure(&config);
+				DLOG_I(WS_TAG, "Capture config %u Hz, %u ms from server (%d)", sample_rate, frame_ms, rc);
+				break;
+			}
+
+			DLOG_D(WS_TAG, "rx %d bytes (bin=%d, opcode=0x%x)", data->data_len, data->op_code == 2, data->op_code);
+			break;
+		}
+
+		case WEBSOCKET_EVENT_ERROR:
+			WS_ready = false;
+			xEventGroupClearBits(WS_event_group, WS_CONNECTED);
+			DLOG_E(WS_TAG, "Error");
+			break;
+
+		default: break;
+	}
+}
+
+////////////// PTT gating
+
+// Sample index inside frame f at which an edge happened
+static inline uint16_t WS_PTT_offset(const MIC_frame_type *f, uint64_t edge_ts_us) {
+	return WS_sample_offset(f->ts_us, edge_ts_us, f->sample_rate, f->samples);
+}
+
+static inline int WS_send(const uint8_t *data, int length, TickType_t timeout) {
+	uint64_t started_us = (uint64_t)esp_timer_get_time();
+
+	int rc = esp_websocket_client_send_bin(WS_client, (const char *)data, length, timeout);
+
+	METRIC_OBSERVE(WS_send_us, (uint64_t)esp_timer_get_time() - started_us);
+	if (rc >= 0) METRIC_INC(WS_sent);
+	else METRIC_INC(WS_send_failed);
+
+	#ifdef woXrooX_WiFi_link_H
+	WiFi_link_report_TX((uint32_t)length, rc >= 0);
+	#endif
+
+	return rc;
+}
+
+// Frames that cannot be sent go to Spool.h instead of being dropped
+static inline bool WS_spooling(void) {
+	#ifdef woXrooX_Spool_H
+	return Spool_enabled();
+	#else
+	return false;
+	#endif
+}
+
+
+////////////// SPOOL
+
+#ifdef woXrooX_Spool_H
+static uint8_t WS_spool_buffer[WS_SPOOLED_BYTES(SPOOL_FRAME_SAMPLES)];
+
+// One PTT marker of a spooled frame, if it has an edge of that kind. Returns false if the send failed.
+static bool WS_spool_marker(const Spool_frame_type *spooled, bool active, TickType_t timeout) {
+	if (!(spooled->PTT.edges & (active ? SPOOL_PTT_START : SPOOL_PTT_END))) return true;
+
+	uint8_t marker[WS_PTT_MARKER_BYTES];
+	uint16_t offset = active ? spooled->PTT.start_offset : spooled->PTT.end_offset;
+	uint64_t edge_ts_us = spooled->ts_us + (uint64_t)offset * 1000000ULL / spooled->sample_rate;
+
+	WS_pack_PTT_marker(marker, spooled->seq, edge_ts_us, spooled->sample_rate, active, offset);
+
+	return WS_send(marker, WS_PTT_MARKER_BYTES, timeout) >= 0;
+}
+
+// Send up to SPOOL_DRAIN_BURST spooled frames with a short timeout so live audio keeps priority.
+// A frame is consumed only once it went out.
+static void WS_spool_drain(void) {
+	const TickType_t timeout = pdMS_TO_TICKS(SPOOL_DRAIN_TIMEOUT_MS);
+
+	Spool_frame_type spooled;
+
+	for (int i = 0; i < SPOOL_DRAIN_BURST; ++i) {
+		if (Spool_peek(&spooled) != SPOOL_return_OK) return;
+
+		// Both markers of a press and release inside one frame, in the order they happened
+		bool start_first = Spool_PTT_start_first(&spooled.PTT);
+		if (!WS_spool_marker(&spooled, start_first, timeout) || !WS_spool_marker(&spooled, !start_first, timeout)) return;
+
+		size_t length = WS_pack_spooled(WS_spool_buffer, spooled.seq, spooled.ts_us, spooled.sample_rate, spooled.state.predictor, spooled.state.index, spooled.adpcm, spooled.samples);
+		if (WS_send(WS_spool_buffer, (int)length, timeout) < 0) return;
+
+		Spool_consume();
+	}
+}
+#endif
+
+
+////////////// TX TASK
+
+static void WS_tx_task(void *param) {
+	(void)param;
+
+	// Static: up to MIC_FRAME_SAMPLES_MAX samples, too big for the task stack
+	static MIC_frame_type frame;
+	PTT_edge_type edge;
+	uint8_t marker[WS_PTT_MARKER_BYTES];
+
+	// Gate state as of the end of the last processed frame
+	bool gate = false;
+
+	uint64_t metrics_sent_us = 0;
+
+	while (1) {
+		// With a spool, frames keep flowing (and gating keeps running) while offline
+		if (!WS_ready && !WS_spooling()) {
+			xEventGroupWaitBits(WS_event_group, WS_CONNECTED, pdFALSE, pdTRUE, portMAX_DELAY);
+			continue;
+		}
+
+		if (xQueueReceive(WS_source_queue, &frame, portMAX_DELAY) != pdTRUE) continue;
+
+		#ifdef woXrooX_Log_mel_H
+		// Capture rate changed: rebuild the tables for the new rate
+		if (WS_log_mel.sample_rate != frame.sample_rate) Log_mel_init(&WS_log_mel, frame.sample_rate);
+		WS_features_hops = Log_mel_push(&WS_log_mel, frame.pcm, frame.samples, WS_features, WS_LOG_MEL_HOPS_MAX);
+		#endif
+
+		TickType_t timeout = pdMS_TO_TICKS(1000);
+
+		#ifdef woXrooX_WiFi_link_H
+		// On a bad link drop the frame after one frame period instead of stalling the queue for a second
+		if (WiFi_link_degraded()) timeout = pdMS_TO_TICKS(WS_DEGRADED_SEND_TIMEOUT_MS);
+		#endif
+
+		// Frame is sent if PTT was active at any point inside it
+		bool send = gate;
+
+		#ifdef woXrooX_Spool_H
+		// Edges inside this frame, kept with it if the frame ends up in the spool
+		Spool_PTT_type edges = { 0 };
+		#endif
+
+		// Apply every edge that happened before this frame ended, in order
+		while (PTT_edge_take(frame.ts_us + MIC_frame_us(&frame), &edge)) {
+			if (edge.active == gate) continue;
+
+			gate = edge.active;
+			send = true;
+
+			#ifdef woXrooX_WiFi_PS_H
+			WiFi_PS_streaming(gate);
+			#endif
+
+			METRIC_INC(WS_PTT_markers);
+			uint16_t edge_offset = WS_PTT_offset(&frame, edge.ts_us);
+
+			#ifdef woXrooX_Spool_H
+			Spool_PTT_add(&edges, edge.active, edge_offset);
+			#endif
+
+			if (!WS_ready) continue;
+
+			WS_pack_PTT_marker(marker, frame.seq, edge.ts_us, frame.sample_rate, edge.active, edge_offset);
+
+			if (WS_send(marker, WS_PTT_MARKER_BYTES, timeout) < 0) DLOG_W(WS_TAG, "PTT marker send failed, seq=%u", frame.seq);
+		}
+
+		// Frames outside PTT are dropped (keeps DMA happy, no back-pressure)
+		if (send) {
+			int rc = -1;
+
+			if (WS_ready) {
+				int length = pack_frame(WS_buffer, &frame);
+
+				// Send as binary WS frame
+				rc = WS_send(WS_buffer, length, timeout);
+
+				// Allow reconnect logic in the client to handle it; frames will continue when WS_ready is true again
+				if (rc < 0) DLOG_W(WS_TAG, "send_bin failed (%d), seq=%u", rc, frame.seq);
+			}
+
+			#ifdef woXrooX_Spool_H
+			// Offline, or the send failed: keep it for later
+			if (rc < 0) Spool_push(frame.seq, frame.ts_us, frame.sample_rate, frame.pcm, frame.samples, &edges);
+			#else
+			(void)rc;
+			#endif
+		}
+
+		if (!WS_ready) continue;
+
+		#ifdef woXrooX_Spool_H
+		// Backlog rides along with the live stream, a few frames per live frame
+		WS_spool_drain();
+		#endif
+
+		#if WS_METRICS_PERIOD_MS
+		uint64_t now_us = (uint64_t)esp_timer_get_time();
+
+		if (now_us - metrics_sent_us >= (uint64_t)WS_METRICS_PERIOD_MS * 1000) {
+			metrics_sent_us = now_us;
+
+			size_t n = Metrics_snapshot(WS_metrics_buffer, sizeof(WS_metrics_buffer));
+			if (n) WS_send(WS_metrics_buffer, (int)n, timeout);
+		}
+		#endif
+	}
+}
+
+////////////// API
+
+static void WS_start(QueueHandle_t source_queue) {
+	WS_source_queue = source_queue;
+
+	if (!WS_event_group) WS_event_group = xEventGroupCreateStatic(&WS_event_group_storage);
+
+	#ifdef woXrooX_Log_mel_H
+	Log_mel_init(&WS_log_mel, MIC_DEFAULT_SAMPLE_RATE);
+	METRIC_SET(Log_mel_hop_cycles, (int32_t)Log_mel_measure_cost(&WS_log_mel));
+	#endif
+
+	esp_websocket_client_config_t cfg = {
+		.uri = WS_URL,
+		.subprotocol = WS_SUBPROTOCOL,
+		.disable_auto_reconnect = false,
+		.network_timeout_ms = 5000,
+		.ping_interval_sec = 15
+	};
+
+	#if USE_WSS
+	// Shared with HTTPS; to pin your own CA, embed it with
+	// idf_component_register(... EMBED_TXTFILES certs/server_ca.pem)
+	// and call TLS_trust_set_CA() before WS_start().
+	if (TLS_WS_config_apply(&cfg) != TLS_return_OK) ESP_LOGE(WS_TAG, "TLS trust context unavailable");
+	#endif
+
+	WS_client = esp_websocket_client_init(&cfg);
+	assert(WS_client);
+
+	esp_websocket_register_events(WS_client, WEBSOCKET_EVENT_ANY, WS_event_handler, NULL);
+
+	ESP_ERROR_CHECK(esp_websocket_client_start(WS_client));
+
+	Tasks_create(TASK_WS_TX, WS_tx_task, NULL, NULL);
+}
+
+#endif
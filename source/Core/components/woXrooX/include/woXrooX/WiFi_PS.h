@@ -0,0 +1,371 @@
+#ifndef woXrooX_WiFi_PS_H
+#define woXrooX_WiFi_PS_H
+
+/*
+Wi-Fi power-save profiles.
+
+Modem sleep adds tens of ms of jitter to 20 ms audio frames, while keeping the radio
+awake burns battery when nothing is streamed. The profile follows the streaming state:
+
+	STREAMING → WIFI_PS_NONE        radio always on, lowest latency
+	BALANCED  → WIFI_PS_MIN_MODEM   wake every DTIM (default after streaming stops)
+	IDLE      → WIFI_PS_MAX_MODEM   wake every listen_interval beacons
+
+Usage (after WiFi_start()):
+
+	WiFi_PS_start();
+
+	// PTT press / release (WebSocket_client.h does this automatically)
+	WiFi_PS_streaming(true);
+	WiFi_PS_streaming(false);
+
+	// Pin a profile manually; WiFi_PS_auto() hands control back
+	WiFi_PS_profile_set(WIFI_PS_PROFILE_IDLE);
+
+After each switch a short ICMP probe to the gateway records RTT and jitter for the
+profile now active; read them with WiFi_PS_stats().
+
+PS mode applies at once. listen_interval is only read by the driver on association, and
+esp_wifi_set_config() must not run while associated, so a new listen_interval is kept pending
+and written from the WIFI_EVENT_STA_DISCONNECTED handler; the next association picks it up.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#include "esp_wifi.h"
+#include "esp_netif.h"
+#include "esp_event.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+#include "ping/ping_sock.h"
+
+#include "Wifi.h"
+
+////////////// DEFINES
+
+// Drop from BALANCED to IDLE after this long without streaming
+#define WIFI_PS_IDLE_AFTER_MS 30000
+
+// Pings per probe and spacing between them
+#define WIFI_PS_PROBE_COUNT 10
+#define WIFI_PS_PROBE_INTERVAL_MS 100
+
+////////////// TYPES
+
+typedef enum {
+	WIFI_PS_PROFILE_STREAMING = 0,
+	WIFI_PS_PROFILE_BALANCED,
+	WIFI_PS_PROFILE_IDLE,
+	WIFI_PS_PROFILE_COUNT
+} WiFi_PS_profile_type;
+
+typedef struct {
+	const char *name;
+	wifi_ps_type_t ps;
+
+	// Beacon intervals between wake-ups in MAX_MODEM
+	uint16_t listen_interval;
+} WiFi_PS_profile_config_type;
+
+typedef struct {
+	uint32_t samples;
+	uint32_t lost;
+
+	uint32_t RTT_mean_ms;
+	uint32_t RTT_max_ms;
+
+	// RFC 3550 interarrival jitter estimate
+	uint32_t jitter_ms;
+} WiFi_PS_stats_type;
+
+// What WiFi_PS_stats() is computed from
+typedef struct {
+	uint32_t samples;
+	uint32_t lost;
+
+	uint64_t RTT_sum_ms;
+	uint32_t RTT_max_ms;
+
+	// Jitter × 16 (RFC 3550 A.8), so the 1/16 gain needs no division
+	uint32_t jitter_q4;
+} WiFi_PS_accumulator_type;
+
+////////////// GLOBALS
+
+static const char *WiFi_PS_TAG = "woXrooX::WiFi_PS:";
+
+static const WiFi_PS_profile_config_type WiFi_PS_profiles[WIFI_PS_PROFILE_COUNT] = {
+	[WIFI_PS_PROFILE_STREAMING] = { .name = "streaming", .ps = WIFI_PS_NONE,      .listen_interval = 1 },
+	[WIFI_PS_PROFILE_BALANCED]  = { .name = "balanced",  .ps = WIFI_PS_MIN_MODEM, .listen_interval = 3 },
+	[WIFI_PS_PROFILE_IDLE]      = { .name = "idle",      .ps = WIFI_PS_MAX_MODEM, .listen_interval = 10 },
+};
+
+static volatile WiFi_PS_profile_type WiFi_PS_current = WIFI_PS_PROFILE_COUNT;
+
+// false while a profile is pinned with WiFi_PS_profile_set()
+static volatile bool WiFi_PS_automatic = true;
+
+static esp_timer_handle_t WiFi_PS_idle_timer = NULL;
+
+static WiFi_PS_accumulator_type WiFi_PS_statistics[WIFI_PS_PROFILE_COUNT];
+static portMUX_TYPE WiFi_PS_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Serialises WiFi_PS_apply(): the idle timer, PTT and manual pins can switch at the same time
+static SemaphoreHandle_t WiFi_PS_mutex = NULL;
+static StaticSemaphore_t WiFi_PS_mutex_storage;
+
+// listen_interval for the next association, 0 = nothing pending
+static volatile uint16_t WiFi_PS_listen_interval_pending = 0;
+
+static esp_ping_handle_t WiFi_PS_ping = NULL;
+
+// Previous RTT for the jitter estimate, -1 = none yet
+static int32_t WiFi_PS_last_RTT_ms = -1;
+
+////////////// Measurement
+
+// Feed one RTT sample into the stats of the active profile. Any RTT source may call this.
+static void WiFi_PS_record_RTT(uint32_t RTT_ms) {
+	WiFi_PS_profile_type p = WiFi_PS_current;
+	if (p >= WIFI_PS_PROFILE_COUNT) return;
+
+	portENTER_CRITICAL(&WiFi_PS_lock);
+
+	WiFi_PS_accumulator_type *s = &WiFi_PS_statistics[p];
+	s->samples++;
+	s->RTT_sum_ms += RTT_ms;
+	if (RTT_ms > s->RTT_max_ms) s->RTT_max_ms = RTT_ms;
+
+	// RFC 3550 A.8: J += (|D| - J) / 16, kept scaled by 16 and rounded
+	if (WiFi_PS_last_RTT_ms >= 0) {
+		int32_t d = (int32_t)RTT_ms - WiFi_PS_last_RTT_ms;
+		if (d < 0) d = -d;
+		s->jitter_q4 += (uint32_t)d - ((s->jitter_q4 + 8) >> 4);
+	}
+
+	WiFi_PS_last_RTT_ms = (int32_t)RTT_ms;
+
+	portEXIT_CRITICAL(&WiFi_PS_lock);
+}
+
+// Snapshot of one profile's probe results
+static WiFi_PS_stats_type WiFi_PS_stats(WiFi_PS_profile_type profile) {
+	WiFi_PS_stats_type stats = {0};
+	if (profile >= WIFI_PS_PROFILE_COUNT) return stats;
+
+	portENTER_CRITICAL(&WiFi_PS_lock);
+	WiFi_PS_accumulator_type s = WiFi_PS_statistics[profile];
+	portEXIT_CRITICAL(&WiFi_PS_lock);
+
+	stats.samples = s.samples;
+	stats.lost = s.lost;
+	stats.RTT_mean_ms = s.samples ? (uint32_t)(s.RTT_sum_ms / s.samples) : 0;
+	stats.RTT_max_ms = s.RTT_max_ms;
+	stats.jitter_ms = s.jitter_q4 >> 4;
+
+	return stats;
+}
+
+static void WiFi_PS_ping_success(esp_ping_handle_t hdl, void *args) {
+	(void)args;
+
+	uint32_t elapsed_ms = 0;
+	esp_ping_get_profile(hdl, ESP_PING_PROF_TIMEGAP, &elapsed_ms, sizeof(elapsed_ms));
+
+	WiFi_PS_record_RTT(elapsed_ms);
+}
+
+static void WiFi_PS_ping_timeout(esp_ping_handle_t hdl, void *args) {
+	(void)hdl;
+	(void)args;
+
+	WiFi_PS_profile_type p = WiFi_PS_current;
+	if (p >= WIFI_PS_PROFILE_COUNT) return;
+
+	portENTER_CRITICAL(&WiFi_PS_lock);
+	WiFi_PS_statistics[p].lost++;
+	portEXIT_CRITICAL(&WiFi_PS_lock);
+}
+
+static void WiFi_PS_ping_end(esp_ping_handle_t hdl, void *args) {
+	(void)args;
+
+	esp_ping_delete_session(hdl);
+	WiFi_PS_ping = NULL;
+
+	WiFi_PS_profile_type p = WiFi_PS_current;
+	if (p >= WIFI_PS_PROFILE_COUNT) return;
+
+	WiFi_PS_stats_type s = WiFi_PS_stats(p);
+	ESP_LOGI(WiFi_PS_TAG, "%s: RTT mean %u ms, max %u ms, jitter %u ms, lost %u/%u",
+		WiFi_PS_profiles[p].name,
+		(unsigned)s.RTT_mean_ms, (unsigned)s.RTT_max_ms, (unsigned)s.jitter_ms,
+		(unsigned)s.lost, (unsigned)(s.samples + s.lost)
+	);
+}
+
+// Short ping burst to the gateway under the current profile
+static void WiFi_PS_probe(void) {
+	if (WiFi_PS_ping || !WiFi_is_connected() || !WiFi_STA_netif) return;
+
+	esp_netif_ip_info_t ip_info;
+	if (esp_netif_get_ip_info(WiFi_STA_netif, &ip_info) != ESP_OK || ip_info.gw.addr == 0) return;
+
+	esp_ping_config_t config = ESP_PING_DEFAULT_CONFIG();
+	config.target_addr.type = IPADDR_TYPE_V4;
+	config.target_addr.u_addr.ip4.addr = ip_info.gw.addr;
+	config.count = WIFI_PS_PROBE_COUNT;
+	config.interval_ms = WIFI_PS_PROBE_INTERVAL_MS;
+
+	esp_ping_callbacks_t callbacks = {
+		.on_ping_success = WiFi_PS_ping_success,
+		.on_ping_timeout = WiFi_PS_ping_timeout,
+		.on_ping_end = WiFi_PS_ping_end,
+	};
+
+	WiFi_PS_last_RTT_ms = -1;
+
+	if (esp_ping_new_session(&config, &callbacks, &WiFi_PS_ping) != ESP_OK) {
+		WiFi_PS_ping = NULL;
+		return;
+	}
+
+	esp_ping_start(WiFi_PS_ping);
+}
+
+////////////// Switching
+
+// Called with WiFi_PS_mutex held
+static int WiFi_PS_apply_RAW(WiFi_PS_profile_type profile) {
+	// Only touch the driver when the winner actually changes
+	if (profile == WiFi_PS_current) return 0;
+
+	const WiFi_PS_profile_config_type *p = &WiFi_PS_profiles[profile];
+
+	if (esp_wifi_set_ps(p->ps) != ESP_OK) return -1;
+
+	// Picked up by the next association (see WiFi_PS_event_handler)
+	wifi_config_t wifi_config;
+	if (esp_wifi_get_config(WIFI_IF_STA, &wifi_config) == ESP_OK) {
+		WiFi_PS_listen_interval_pending = wifi_config.sta.listen_interval != p->listen_interval ? p->listen_interval : 0;
+	}
+
+	WiFi_PS_current = profile;
+	ESP_LOGI(WiFi_PS_TAG, "Profile: %s", p->name);
+
+	WiFi_PS_probe();
+
+	return 0;
+}
+
+static int WiFi_PS_apply(WiFi_PS_profile_type profile) {
+	if (profile >= WIFI_PS_PROFILE_COUNT || !WiFi_PS_mutex) return -1;
+
+	xSemaphoreTake(WiFi_PS_mutex, portMAX_DELAY);
+	int result = WiFi_PS_apply_RAW(profile);
+	xSemaphoreGive(WiFi_PS_mutex);
+
+	return result;
+}
+
+// Between associations: the only time the station config may be rewritten
+static void WiFi_PS_event_handler(
+	void* arg,
+	esp_event_base_t event_base,
+	int32_t event_id,
+	void* event_data
+) {
+	if (event_base != WIFI_EVENT || event_id != WIFI_EVENT_STA_DISCONNECTED) return;
+
+	xSemaphoreTake(WiFi_PS_mutex, portMAX_DELAY);
+
+	uint16_t listen_interval = WiFi_PS_listen_interval_pending;
+	WiFi_PS_listen_interval_pending = 0;
+
+	wifi_config_t wifi_config;
+	if (listen_interval && esp_wifi_get_config(WIFI_IF_STA, &wifi_config) == ESP_OK) {
+		wifi_config.sta.listen_interval = listen_interval;
+		esp_wifi_set_config(WIFI_IF_STA, &wifi_config);
+		ESP_LOGI(WiFi_PS_TAG, "listen_interval %u from the next association", (unsigned)listen_interval);
+	}
+
+	xSemaphoreGive(WiFi_PS_mutex);
+}
+
+static void WiFi_PS_idle_timer_callback(void *arg) {
+	(void)arg;
+
+	// esp_timer_stop() does not cancel a callback already running: decide under the mutex, where a
+	// STREAMING switch or a pinned profile that got in first is visible
+	xSemaphoreTake(WiFi_PS_mutex, portMAX_DELAY);
+	if (WiFi_PS_automatic && WiFi_PS_current == WIFI_PS_PROFILE_BALANCED) WiFi_PS_apply_RAW(WIFI_PS_PROFILE_IDLE);
+	xSemaphoreGive(WiFi_PS_mutex);
+}
+
+////////////// API
+
+static int WiFi_PS_start(void) {
+	if (WiFi_PS_idle_timer) return 0;
+
+	if (!WiFi_PS_mutex) WiFi_PS_mutex = xSemaphoreCreateMutexStatic(&WiFi_PS_mutex_storage);
+	if (!WiFi_PS_mutex) return -1;
+
+	if (esp_event_handler_instance_register(WIFI_EVENT, WIFI_EVENT_STA_DISCONNECTED, &WiFi_PS_event_handler, NULL, NULL) != ESP_OK) return -1;
+
+	const esp_timer_create_args_t timer_args = {
+		.callback = WiFi_PS_idle_timer_callback,
+		.name = "WiFi_PS_idle"
+	};
+	if (esp_timer_create(&timer_args, &WiFi_PS_idle_timer) != ESP_OK) return -1;
+
+	WiFi_PS_apply(WIFI_PS_PROFILE_BALANCED);
+	esp_timer_start_once(WiFi_PS_idle_timer, (uint64_t)WIFI_PS_IDLE_AFTER_MS * 1000);
+
+	return 0;
+}
+
+// Streaming state hook: true → STREAMING now, false → BALANCED, then IDLE after a while
+static void WiFi_PS_streaming(bool active) {
+	if (!WiFi_PS_idle_timer || !WiFi_PS_automatic) return;
+
+	esp_timer_stop(WiFi_PS_idle_timer);
+
+	if (active) {
+		WiFi_PS_apply(WIFI_PS_PROFILE_STREAMING);
+		return;
+	}
+
+	WiFi_PS_apply(WIFI_PS_PROFILE_BALANCED);
+	esp_timer_start_once(WiFi_PS_idle_timer, (uint64_t)WIFI_PS_IDLE_AFTER_MS * 1000);
+}
+
+// Pin a profile; automatic switching stays off until WiFi_PS_auto()
+static int WiFi_PS_profile_set(WiFi_PS_profile_type profile) {
+	if (profile >= WIFI_PS_PROFILE_COUNT || !WiFi_PS_mutex) return -1;
+
+	if (WiFi_PS_idle_timer) esp_timer_stop(WiFi_PS_idle_timer);
+
+	xSemaphoreTake(WiFi_PS_mutex, portMAX_DELAY);
+	WiFi_PS_automatic = false;
+	int result = WiFi_PS_apply_RAW(profile);
+	xSemaphoreGive(WiFi_PS_mutex);
+
+	return result;
+}
+
+static void WiFi_PS_auto(void) {
+	WiFi_PS_automatic = true;
+	WiFi_PS_streaming(false);
+}
+
+static WiFi_PS_profile_type WiFi_PS_profile(void) {
+	return WiFi_PS_current;
+}
+
+#endif
@@ -0,0 +1,206 @@
+#ifndef woXrooX_WiFi_link_H
+#define woXrooX_WiFi_link_H
+
+/*
+Wi-Fi link-quality monitor.
+
+Every WIFI_LINK_PERIOD_MS the monitor samples RSSI and the negotiated PHY mode and
+folds in the TX outcomes reported by the senders since the last sample. The result is
+published as a snapshot that any task can read without locks (sequence counter).
+
+There is no PHY rate in the snapshot: the IDF has no public API for the station's current
+TX rate (nor for the driver's retry counters). The negotiated mode (11b/g/n/ax) is
+sampled in its place, which at least shows a fall back to 11b. Throughput comes from the
+bytes the senders report (TX_bytes_per_s).
+
+Usage (after WiFi_start()):
+
+	WiFi_link_start();
+
+	// Senders report what happened to each transmission
+	WiFi_link_report_TX(bytes, ok);
+
+	// Read the latest snapshot
+	WiFi_link_snapshot_type link;
+	WiFi_link_snapshot(&link);
+
+	// Or block until the link turns bad / recovers
+	xEventGroupWaitBits(WiFi_link_event_group(), WIFI_LINK_DEGRADED, pdFALSE, pdTRUE, portMAX_DELAY);
+
+Degraded when RSSI < WIFI_LINK_RSSI_BAD or TX failure rate > WIFI_LINK_FAIL_BAD_PCT,
+good again only above the *_GOOD thresholds (hysteresis, so the state does not flap).
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+
+#include "esp_wifi.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+#include "Wifi.h"
+#include "Metrics.h"
+
+////////////// DEFINES
+
+#define WIFI_LINK_PERIOD_MS 1000
+
+// dBm
+#define WIFI_LINK_RSSI_BAD -78
+#define WIFI_LINK_RSSI_GOOD -72
+
+// Percent of failed transmissions in one period
+#define WIFI_LINK_FAIL_BAD_PCT 10
+#define WIFI_LINK_FAIL_GOOD_PCT 2
+
+// Event bits (exactly one is set once the monitor runs)
+#define WIFI_LINK_GOOD (1 << 0)
+#define WIFI_LINK_DEGRADED (1 << 1)
+
+////////////// TYPES
+
+typedef struct {
+	// Sample time (esp_timer us)
+	uint64_t ts_us;
+
+	bool connected;
+	int8_t RSSI;
+
+	// Negotiated 802.11 mode (WIFI_PHY_MODE_11B/11G/HT20/HT40/HE20), not a data rate
+	wifi_phy_mode_t phy_mode;
+
+	// Over the last period
+	uint32_t TX_ok;
+	uint32_t TX_failed;
+	uint32_t TX_bytes_per_s;
+
+	bool degraded;
+} WiFi_link_snapshot_type;
+
+////////////// GLOBALS
+
+static const char *WiFi_link_TAG = "woXrooX::WiFi_link:";
+
+static esp_timer_handle_t WiFi_link_timer = NULL;
+
+static EventGroupHandle_t WiFi_link_events = NULL;
+static StaticEventGroup_t WiFi_link_events_storage;
+
+// Published snapshot: odd sequence = write in progress
+static WiFi_link_snapshot_type WiFi_link_published;
+static volatile uint32_t WiFi_link_sequence = 0;
+
+// Accumulators fed by senders, drained by the sampler
+static volatile uint32_t WiFi_link_TX_ok = 0;
+static volatile uint32_t WiFi_link_TX_failed = 0;
+static volatile uint32_t WiFi_link_TX_bytes = 0;
+
+////////////// Sampler
+
+static void WiFi_link_publish(const WiFi_link_snapshot_type *snapshot) {
+	WiFi_link_sequence++;
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	WiFi_link_published = *snapshot;
+
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	WiFi_link_sequence++;
+}
+
+static void WiFi_link_sample(void *arg) {
+	(void)arg;
+
+	WiFi_link_snapshot_type s = {0};
+	s.ts_us = (uint64_t)esp_timer_get_time();
+	s.connected = WiFi_is_connected();
+
+	s.TX_ok = __atomic_exchange_n(&WiFi_link_TX_ok, 0, __ATOMIC_RELAXED);
+	s.TX_failed = __atomic_exchange_n(&WiFi_link_TX_failed, 0, __ATOMIC_RELAXED);
+	uint32_t bytes = __atomic_exchange_n(&WiFi_link_TX_bytes, 0, __ATOMIC_RELAXED);
+	s.TX_bytes_per_s = (uint32_t)((uint64_t)bytes * 1000 / WIFI_LINK_PERIOD_MS);
+
+	if (s.connected) {
+		int RSSI = 0;
+		if (esp_wifi_sta_get_rssi(&RSSI) == ESP_OK) s.RSSI = (int8_t)RSSI;
+
+		// The mode, not a rate: no public IDF call reports the current TX rate
+		esp_wifi_sta_get_negotiated_phymode(&s.phy_mode);
+	}
+
+	uint32_t total = s.TX_ok + s.TX_failed;
+	uint32_t fail_pct = total ? (s.TX_failed * 100 / total) : 0;
+
+	// Hysteresis: enter on the BAD thresholds, leave only past the GOOD ones
+	bool was_degraded = WiFi_link_published.degraded;
+
+	if (!s.connected) s.degraded = true;
+	else if (!was_degraded) s.degraded = (s.RSSI < WIFI_LINK_RSSI_BAD) || (fail_pct > WIFI_LINK_FAIL_BAD_PCT);
+	else s.degraded = !((s.RSSI > WIFI_LINK_RSSI_GOOD) && (fail_pct <= WIFI_LINK_FAIL_GOOD_PCT));
+
+	WiFi_link_publish(&s);
+
+	METRIC_SET(WiFi_RSSI, s.RSSI);
+	METRIC_SET(WiFi_link_degraded, s.degraded);
+
+	if (s.degraded != was_degraded || WiFi_link_sequence == 2) {
+		xEventGroupClearBits(WiFi_link_events, s.degraded ? WIFI_LINK_GOOD : WIFI_LINK_DEGRADED);
+		xEventGroupSetBits(WiFi_link_events, s.degraded ? WIFI_LINK_DEGRADED : WIFI_LINK_GOOD);
+
+		if (s.degraded) ESP_LOGW(WiFi_link_TAG, "Link degraded: RSSI %d dBm, TX fail %u%%", s.RSSI, (unsigned)fail_pct);
+		else ESP_LOGI(WiFi_link_TAG, "Link good: RSSI %d dBm", s.RSSI);
+	}
+}
+
+////////////// API
+
+static int WiFi_link_start(void) {
+	if (WiFi_link_timer) return 0;
+
+	WiFi_link_events = xEventGroupCreateStatic(&WiFi_link_events_storage);
+
+	const esp_timer_create_args_t timer_args = {
+		.callback = WiFi_link_sample,
+		.name = "WiFi_link"
+	};
+	if (esp_timer_create(&timer_args, &WiFi_link_timer) != ESP_OK) return -1;
+
+	return esp_timer_start_periodic(WiFi_link_timer, (uint64_t)WIFI_LINK_PERIOD_MS * 1000) == ESP_OK ? 0 : -1;
+}
+
+// Safe from any task. ok = the transmission completed in time.
+static inline void WiFi_link_report_TX(uint32_t bytes, bool ok) {
+	if (ok) {
+		__atomic_fetch_add(&WiFi_link_TX_ok, 1, __ATOMIC_RELAXED);
+		__atomic_fetch_add(&WiFi_link_TX_bytes, bytes, __ATOMIC_RELAXED);
+	}
+
+	else __atomic_fetch_add(&WiFi_link_TX_failed, 1, __ATOMIC_RELAXED);
+}
+
+// Copy of the latest snapshot; never blocks the sampler
+static void WiFi_link_snapshot(WiFi_link_snapshot_type *out) {
+	uint32_t before, after;
+
+	do {
+		before = WiFi_link_sequence;
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+		*out = WiFi_link_published;
+
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		after = WiFi_link_sequence;
+	} while ((before & 1) || before != after);
+}
+
+static inline bool WiFi_link_degraded(void) {
+	return WiFi_link_events && (xEventGroupGetBits(WiFi_link_events) & WIFI_LINK_DEGRADED);
+}
+
+static EventGroupHandle_t WiFi_link_event_group(void) {
+	return WiFi_link_events;
+}
+
+#endif
@@ -0,0 +1,519 @@
+#ifndef woXrooX_WiFi_H
+#define woXrooX_WiFi_H
+
+/*
+Usage:
+
+	// Non-blocking: returns as soon as the driver is started
+	if (WiFi_start() != 0) return;
+
+	// ... init LEDs / MIC while associating ...
+
+	// Any task can block on connectivity without polling
+	if (WiFi_wait_connected(pdMS_TO_TICKS(10000))) { }
+
+	// Or keep the old blocking behaviour
+	if (init_WiFi() != 0) return;
+
+The manager never gives up: after a disconnect it reconnects in the background
+with jittered exponential backoff (WIFI_BACKOFF_MIN_MS .. WIFI_BACKOFF_MAX_MS).
+WIFI_FAILURE is raised once WIFI_CONNECTION_MAX_RETRY attempts in a row failed,
+so callers that wait can give up while the manager keeps trying.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+// #include "freertos/task.h"
+#include "freertos/event_groups.h"
+
+// #include "esp_system.h"
+#include "esp_wifi.h"
+// #include "esp_event.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_netif.h"
+#include "esp_random.h"
+
+#include "nvs_flash.h"
+#include "nvs.h"
+
+#include "Metrics.h"
+
+//// DEFINES
+
+// Set while the station has an IP, cleared on disconnect
+#define WIFI_SUCCESS (1 << 0)
+
+// Set after WIFI_CONNECTION_MAX_RETRY consecutive failures, cleared on success
+#define WIFI_FAILURE (1 << 1)
+
+#define WIFI_CONNECTION_MAX_RETRY 10
+
+// Reconnect backoff: MIN << attempt, capped at MAX, with random jitter in [d/2, d]
+#define WIFI_BACKOFF_MIN_MS 250
+#define WIFI_BACKOFF_MAX_MS 60000
+
+// Fallbacks when the Kconfig menu is not part of the build (woXrooX → Network)
+#ifndef CONFIG_WOXROOX_WIFI_SSID
+#define CONFIG_WOXROOX_WIFI_SSID "My_WiFi"
+#define CONFIG_WOXROOX_WIFI_PASSWORD "My_Password"
+#endif
+
+#define WIFI_SSID CONFIG_WOXROOX_WIFI_SSID
+#define WIFI_PASS CONFIG_WOXROOX_WIFI_PASSWORD
+
+// Last good BSSID/channel/lease, so the next boot can skip the scan and DHCP
+#define WIFI_CACHE_NAMESPACE "woXrooX_WiFi"
+#define WIFI_CACHE_KEY "link"
+#define WIFI_CACHE_VERSION 1
+
+// Force a full scan every N fast boots so a moved channel or a better AP is picked up
+#define WIFI_FAST_PATH_MAX_BOOTS 8
+
+// A fast boot stays on the cached lease until the link drops or this long has passed, then hands
+// the address to DHCP. Starting DHCP clears the address, so it is not done right after the fast
+// path. The cache keeps no lease time: this is T1 of a 1 h lease, the shortest common default.
+#ifndef WIFI_LEASE_RENEW_MS
+#define WIFI_LEASE_RENEW_MS (30 * 60 * 1000)
+#endif
+
+//// TYPES
+
+typedef struct {
+	uint32_t version;
+
+	// Must match WIFI_SSID, otherwise the cache belongs to another network
+	char ssid[33];
+
+	uint8_t bssid[6];
+	uint8_t channel;
+
+	// Boots served from this cache since the last full scan + DHCP boot
+	uint8_t fast_boots;
+
+	esp_netif_ip_info_t ip_info;
+	esp_ip4_addr_t dns;
+} WiFi_cache_type;
+
+//// GLOBALS
+
+// event group to contain status information (lives for the whole program)
+static EventGroupHandle_t wifi_event_group = NULL;
+static StaticEventGroup_t wifi_event_group_storage;
+
+// One-shot timer that fires the next reconnect attempt
+static esp_timer_handle_t WiFi_reconnect_timer = NULL;
+
+static bool WiFi_started = false;
+
+// Retry tracker
+static int retry_count = 0;
+
+// Task tag
+static const char *WiFi_TAG = "woXrooX::WiFi:";
+
+static esp_netif_t *WiFi_STA_netif = NULL;
+
+static WiFi_cache_type WiFi_cache;
+
+// true while connecting with cached BSSID/channel + static lease
+static volatile bool WiFi_fast_path = false;
+
+// true from the fast-path IP until DHCP takes the address over (WIFI_LEASE_RENEW_MS or a disconnect)
+static volatile bool WiFi_static_lease = false;
+
+// true from the WIFI_LEASE_RENEW_MS handover until DHCP has confirmed (or replaced) the cached lease
+static volatile bool WiFi_DHCP_renewing = false;
+
+// One-shot timer that hands the cached lease to DHCP
+static esp_timer_handle_t WiFi_lease_timer = NULL;
+
+// Boot-to-IP measurement
+static uint64_t WiFi_boot_us = 0;
+static volatile int64_t WiFi_time_to_IP_us = -1;
+
+////////////// Link cache (NVS)
+
+static bool WiFi_cache_load(WiFi_cache_type *cache) {
+	nvs_handle_t nvs;
+	if (nvs_open(WIFI_CACHE_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) return false;
+
+	size_t length = sizeof(*cache);
+	esp_err_t err = nvs_get_blob(nvs, WIFI_CACHE_KEY, cache, &length);
+	nvs_close(nvs);
+
+	if (err != ESP_OK || length != sizeof(*cache)) return false;
+	if (cache->version != WIFI_CACHE_VERSION) return false;
+	if (strncmp(cache->ssid, WIFI_SSID, sizeof(cache->ssid)) != 0) return false;
+	if (cache->channel == 0 || cache->ip_info.ip.addr == 0) return false;
+
+	return true;
+}
+
+static void WiFi_cache_store(const WiFi_cache_type *cache) {
+	nvs_handle_t nvs;
+	if (nvs_open(WIFI_CACHE_NAMESPACE, NVS_READWRITE, &nvs) != ESP_OK) return;
+
+	if (nvs_set_blob(nvs, WIFI_CACHE_KEY, cache, sizeof(*cache)) == ESP_OK) nvs_commit(nvs);
+	nvs_close(nvs);
+}
+
+static void WiFi_cache_erase(void) {
+	nvs_handle_t nvs;
+	if (nvs_open(WIFI_CACHE_NAMESPACE, NVS_READWRITE, &nvs) != ESP_OK) return;
+
+	nvs_erase_key(nvs, WIFI_CACHE_KEY);
+	nvs_commit(nvs);
+	nvs_close(nvs);
+}
+
+// Refresh the cache from the current association and DHCP lease. A reconnect or background
+// renewal that got the same lease keeps the fast-boot count; a full scan + DHCP boot or a changed
+// lease resets it. Nothing is written to flash when nothing changed.
+static void WiFi_cache_update(const esp_netif_ip_info_t *ip_info, bool full_path) {
+	wifi_ap_record_t ap;
+	if (esp_wifi_sta_get_ap_info(&ap) != ESP_OK) return;
+
+	WiFi_cache_type cache = {0};
+	cache.version = WIFI_CACHE_VERSION;
+	strncpy(cache.ssid, WIFI_SSID, sizeof(cache.ssid) - 1);
+	memcpy(cache.bssid, ap.bssid, sizeof(cache.bssid));
+	cache.channel = ap.primary;
+	cache.ip_info = *ip_info;
+
+	esp_netif_dns_info_t dns;
+	if (esp_netif_get_dns_info(WiFi_STA_netif, ESP_NETIF_DNS_MAIN, &dns) == ESP_OK) cache.dns.addr = dns.ip.u_addr.ip4.addr;
+
+	bool same_lease = WiFi_cache.version == WIFI_CACHE_VERSION && memcmp(&WiFi_cache.ip_info, ip_info, sizeof(*ip_info)) == 0;
+	cache.fast_boots = (same_lease && !full_path) ? WiFi_cache.fast_boots : 0;
+
+	// Both sides start zeroed, so a byte compare is exact
+	if (memcmp(&cache, &WiFi_cache, sizeof(cache)) == 0) return;
+
+	WiFi_cache_store(&cache);
+	WiFi_cache = cache;
+}
+
+// Targeted connect: no scan, no DHCP round trips
+static void WiFi_fast_path_apply(wifi_config_t *wifi_config) {
+	wifi_config->sta.bssid_set = true;
+	memcpy(wifi_config->sta.bssid, WiFi_cache.bssid, sizeof(WiFi_cache.bssid));
+	wifi_config->sta.channel = WiFi_cache.channel;
+	wifi_config->sta.scan_method = WIFI_FAST_SCAN;
+
+	esp_netif_dhcpc_stop(WiFi_STA_netif);
+	esp_netif_set_ip_info(WiFi_STA_netif, &WiFi_cache.ip_info);
+
+	if (WiFi_cache.dns.addr) {
+		esp_netif_dns_info_t dns = {0};
+		dns.ip.type = ESP_IPADDR_TYPE_V4;
+		dns.ip.u_addr.ip4.addr = WiFi_cache.dns.addr;
+		esp_netif_set_dns_info(WiFi_STA_netif, ESP_NETIF_DNS_MAIN, &dns);
+	}
+}
+
+// Cached AP did not answer: forget it, go back to full scan + DHCP
+static void WiFi_fast_path_fallback(void) {
+	ESP_LOGW(WiFi_TAG, "Cached BSSID/channel failed, falling back to full scan");
+
+	WiFi_fast_path = false;
+	WiFi_cache_erase();
+
+	wifi_config_t wifi_config;
+	esp_wifi_get_config(WIFI_IF_STA, &wifi_config);
+	wifi_config.sta.bssid_set = false;
+	wifi_config.sta.channel = 0;
+	wifi_config.sta.scan_method = WIFI_ALL_CHANNEL_SCAN;
+	esp_wifi_set_config(WIFI_IF_STA, &wifi_config);
+
+	esp_netif_dhcpc_start(WiFi_STA_netif);
+}
+
+// Leave the cached lease for DHCP. Clears the address until the lease arrives.
+// Returns true if the station was on the cached lease.
+static bool WiFi_static_lease_end(void) {
+	if (!WiFi_static_lease) return false;
+
+	WiFi_static_lease = false;
+	esp_timer_stop(WiFi_lease_timer);
+	esp_netif_dhcpc_start(WiFi_STA_netif);
+
+	return true;
+}
+
+// Lease T1 on the cached lease: renew over the same link, without counting a new connection
+static void WiFi_lease_timer_callback(void *arg) {
+	(void)arg;
+
+	// Already handed over by a disconnect
+	if (!WiFi_static_lease) return;
+
+	ESP_LOGI(WiFi_TAG, "Renewing the cached lease with DHCP");
+
+	// No address until the lease arrives
+	WiFi_DHCP_renewing = true;
+	xEventGroupClearBits(wifi_event_group, WIFI_SUCCESS);
+	WiFi_static_lease_end();
+}
+
+// Microseconds from init_WiFi() to first IP, -1 if not connected yet
+static int64_t get_WiFi_time_to_IP_us(void) {
+	return WiFi_time_to_IP_us;
+}
+
+////////////// Reconnect
+
+// Jittered exponential backoff for the given attempt (0-based)
+static uint32_t WiFi_backoff_ms(int attempt) {
+	uint32_t d = WIFI_BACKOFF_MIN_MS;
+
+	for (int i = 0; i < attempt && d < WIFI_BACKOFF_MAX_MS; ++i) d <<= 1;
+	if (d > WIFI_BACKOFF_MAX_MS) d = WIFI_BACKOFF_MAX_MS;
+
+	// "Equal jitter": keeps a floor while spreading out a fleet reconnecting at once
+	return d / 2 + (esp_random() % (d / 2 + 1));
+}
+
+static void WiFi_reconnect_timer_callback(void *arg) {
+	(void)arg;
+	esp_wifi_connect();
+}
+
+static void WiFi_schedule_reconnect(void) {
+	uint32_t d = WiFi_backoff_ms(retry_count);
+
+	ESP_LOGI(WiFi_TAG, "Reconnect #%d in %u ms", retry_count + 1, (unsigned)d);
+
+	esp_timer_stop(WiFi_reconnect_timer);
+	esp_timer_start_once(WiFi_reconnect_timer, (uint64_t)d * 1000);
+}
+
+////////////// Events
+
+// Event handler for wifi events
+static void WiFi_event_handler(
+	void* arg,
+	esp_event_base_t event_base,
+	int32_t event_id,
+	void* event_data
+) {
+	if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_START) {
+		ESP_LOGI(WiFi_TAG, "Connecting to AP...");
+		esp_wifi_connect();
+	}
+
+	else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED) {
+		xEventGroupClearBits(wifi_event_group, WIFI_SUCCESS);
+		WiFi_DHCP_renewing = false;
+		METRIC_INC(WiFi_disconnects);
+
+		// The reconnect gets its address from DHCP
+		WiFi_static_lease_end();
+
+		// A failed fast path does not count as a retry
+		if (WiFi_fast_path) {
+			WiFi_fast_path_fallback();
+			esp_wifi_connect();
+			return;
+		}
+
+		WiFi_schedule_reconnect();
+		retry_count++;
+
+		if (retry_count >= WIFI_CONNECTION_MAX_RETRY) xEventGroupSetBits(wifi_event_group, WIFI_FAILURE);
+	}
+}
+
+// Event handler for ip events
+static void IP_event_handler(
+	void* arg,
+	esp_event_base_t event_base,
+	int32_t event_id,
+	void* event_data
+) {
+	if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
+		ip_event_got_ip_t* event = (ip_event_got_ip_t*) event_data;
+		ESP_LOGI(WiFi_TAG, "STA IP: " IPSTR, IP2STR(&event->ip_info.ip));
+
+		// DHCP taking over from the cached lease at T1: same link, not a new connection
+		bool renewal = WiFi_DHCP_renewing;
+		WiFi_DHCP_renewing = false;
+
+		bool first_IP = WiFi_time_to_IP_us < 0;
+
+		if (!renewal) {
+			retry_count = 0;
+			METRIC_INC(WiFi_connects);
+		}
+
+		if (first_IP) {
+			WiFi_time_to_IP_us = esp_timer_get_time() - (int64_t)WiFi_boot_us;
+			METRIC_OBSERVE(WiFi_time_to_IP_ms, WiFi_time_to_IP_us / 1000);
+			ESP_LOGI(WiFi_TAG, "Time to IP: %lld ms (%s)", (long long)(WiFi_time_to_IP_us / 1000), WiFi_fast_path ? "fast path" : "full scan + DHCP");
+		}
+
+		if (WiFi_fast_path) {
+			WiFi_fast_path = false;
+			WiFi_cache.fast_boots++;
+			WiFi_cache_store(&WiFi_cache);
+
+			// Online on the cached lease; DHCP takes over at T1 or after the next disconnect
+			WiFi_static_lease = true;
+			esp_timer_start_once(WiFi_lease_timer, (uint64_t)WIFI_LEASE_RENEW_MS * 1000);
+		}
+
+		else WiFi_cache_update(&event->ip_info, first_IP);
+
+		xEventGroupClearBits(wifi_event_group, WIFI_FAILURE);
+		xEventGroupSetBits(wifi_event_group, WIFI_SUCCESS);
+	}
+
+	else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_LOST_IP) {
+		ESP_LOGW(WiFi_TAG, "Lost IP");
+		xEventGroupClearBits(wifi_event_group, WIFI_SUCCESS);
+	}
+}
+
+////////////// Init
+
+// Wi-Fi/Netif initialisation. Does not wait for the connection.
+static int init_WiFi_STA(void) {
+	// Initialize the esp network interface
+	esp_netif_init();
+
+	// Initialize default esp event loop
+	esp_event_loop_create_default();
+
+	// Create wifi station in the wifi driver
+	WiFi_STA_netif = esp_netif_create_default_wifi_sta();
+
+	// Wi-Fi driver - setup wifi station with the default wifi configuration
+	wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
+	if (esp_wifi_init(&cfg) != ESP_OK) return WIFI_FAILURE;
+
+	const esp_timer_create_args_t timer_args = {
+		.callback = WiFi_reconnect_timer_callback,
+		.name = "WiFi_reconnect"
+	};
+	if (esp_timer_create(&timer_args, &WiFi_reconnect_timer) != ESP_OK) return WIFI_FAILURE;
+
+	const esp_timer_create_args_t lease_timer_args = {
+		.callback = WiFi_lease_timer_callback,
+		.name = "WiFi_lease"
+	};
+	if (esp_timer_create(&lease_timer_args, &WiFi_lease_timer) != ESP_OK) return WIFI_FAILURE;
+
+	// Handlers stay registered for the lifetime of the program
+	esp_event_handler_instance_register(WIFI_EVENT, ESP_EVENT_ANY_ID, &WiFi_event_handler, NULL, NULL);
+	esp_event_handler_instance_register(IP_EVENT, IP_EVENT_STA_GOT_IP, &IP_event_handler, NULL, NULL);
+	esp_event_handler_instance_register(IP_EVENT, IP_EVENT_STA_LOST_IP, &IP_event_handler, NULL, NULL);
+
+	wifi_config_t wifi_config = {
+		.sta = {
+			.ssid = WIFI_SSID,
+			.password = WIFI_PASS,
+			.threshold.authmode = WIFI_AUTH_WPA2_PSK,
+
+			// WPA2/WPA3 mixed
+			.sae_pwe_h2e = WPA3_SAE_PWE_BOTH,
+		},
+	};
+
+	// A failed load may have left part of a blob behind
+	if (!WiFi_cache_load(&WiFi_cache)) memset(&WiFi_cache, 0, sizeof(WiFi_cache));
+
+	else if (WiFi_cache.fast_boots < WIFI_FAST_PATH_MAX_BOOTS) {
+		ESP_LOGI(WiFi_TAG, "Fast path: ch %u, IP " IPSTR, WiFi_cache.channel, IP2STR(&WiFi_cache.ip_info.ip));
+		WiFi_fast_path = true;
+		WiFi_fast_path_apply(&wifi_config);
+	}
+
+	// Set the wifi controller to be a station
+	esp_wifi_set_mode(WIFI_MODE_STA);
+
+	// Set the wifi config
+	esp_wifi_set_config(WIFI_IF_STA, &wifi_config);
+
+	// Start the wifi driver (connect continues from WIFI_EVENT_STA_START)
+	if (esp_wifi_start() != ESP_OK) return WIFI_FAILURE;
+
+	ESP_LOGI(WiFi_TAG, "init_WiFi_STA(): finished.");
+
+	return WIFI_SUCCESS;
+}
+
+////////////// API
+
+// Start the connection manager and return immediately. 0 on success.
+static int WiFi_start(void) {
+	if (WiFi_started) return 0;
+
+	WiFi_boot_us = (uint64_t)esp_timer_get_time();
+	WiFi_time_to_IP_us = -1;
+
+	if (!wifi_event_group) wifi_event_group = xEventGroupCreateStatic(&wifi_event_group_storage);
+
+	// Initialize storage
+	// Sta­ble NVS (Wi-Fi stores credentials here)
+	esp_err_t ret = nvs_flash_init();
+	if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+		nvs_flash_erase();
+		ret = nvs_flash_init();
+	}
+
+	if (init_WiFi_STA() != WIFI_SUCCESS) {
+		ESP_LOGE(WiFi_TAG, "Wi-Fi driver init failed");
+		return 1;
+	}
+
+	WiFi_started = true;
+
+	return 0;
+}
+
+// Connectivity bits (WIFI_SUCCESS / WIFI_FAILURE) for xEventGroupWaitBits()
+static EventGroupHandle_t WiFi_event_group(void) {
+	return wifi_event_group;
+}
+
+static bool WiFi_is_connected(void) {
+	return wifi_event_group && (xEventGroupGetBits(wifi_event_group) & WIFI_SUCCESS);
+}
+
+// Block until the station has an IP or the timeout expires
+static bool WiFi_wait_connected(TickType_t timeout) {
+	if (!wifi_event_group) return false;
+
+	EventBits_t bits = xEventGroupWaitBits(wifi_event_group, WIFI_SUCCESS, pdFALSE, pdTRUE, timeout);
+
+	return (bits & WIFI_SUCCESS) != 0;
+}
+
+// Blocking start: waits until connected or WIFI_CONNECTION_MAX_RETRY attempts failed.
+// The manager keeps reconnecting in the background either way.
+static int init_WiFi(void) {
+	if (WiFi_start() != 0) return 1;
+
+	// Wait here until either connected or failed
+	EventBits_t bits = xEventGroupWaitBits(
+		wifi_event_group,
+		WIFI_SUCCESS | WIFI_FAILURE,
+		pdFALSE,
+		pdFALSE,
+		portMAX_DELAY
+	);
+
+	if (bits & WIFI_SUCCESS) {
+		ESP_LOGI(WiFi_TAG, "connected to ap SSID:%s", WIFI_SSID);
+		return 0;
+	}
+
+	ESP_LOGW(WiFi_TAG, "Failed to connect to SSID:%s, retrying in background", WIFI_SSID);
+
+	return 1;
+}
+
+#endif
@@ -0,0 +1,439 @@
+/*
+See Stand_in.h. Plain pthreads, not shim tasks: the server is not part of the device, so it takes
+nothing from the simulated heap and does not show up in uxTaskGetSystemState().
+*/
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/ssl.h>
+#include <openssl/x509v3.h>
+
+#include "Stand_in.h"
+
+////////////// DEFINES
+
+#define STAND_IN_CONNECTIONS_MAX 32
+#define STAND_IN_HEAD_MAX 2048
+#define STAND_IN_BODY_MAX 16384
+
+////////////// TYPES
+
+typedef struct {
+	int fd;
+	bool used;
+
+	// Waiting for the next request line
+	bool idle;
+} Stand_in_connection_type;
+
+struct Stand_in {
+	int listen_fd;
+	uint16_t port;
+	SSL_CTX *context;
+	char *CA_pem;
+	size_t CA_length;
+
+	pthread_t acceptor;
+	pthread_mutex_t lock;
+	Stand_in_connection_type connections[STAND_IN_CONNECTIONS_MAX];
+	int live;
+	bool stopping;
+	bool drop_next_post;
+
+	uint32_t accepted;
+	uint32_t requests;
+	uint32_t posts;
+};
+
+typedef struct {
+	Stand_in_type *server;
+	int slot;
+	int fd;
+	SSL *ssl;
+
+	char buffer[STAND_IN_HEAD_MAX];
+	size_t length;
+} Stand_in_session_type;
+
+////////////// Certificate
+
+static bool Stand_in_certificate(Stand_in_type *s) {
+	EVP_PKEY *key = EVP_EC_gen("P-256");
+	X509 *certificate = X509_new();
+	if (!key || !certificate) return false;
+
+	X509_set_version(certificate, 2);
+	ASN1_INTEGER_set(X509_get_serialNumber(certificate), 1);
+	X509_gmtime_adj(X509_getm_notBefore(certificate), -60);
+	X509_gmtime_adj(X509_getm_notAfter(certificate), 24 * 3600);
+	X509_set_pubkey(certificate, key);
+
+	X509_NAME *name = X509_get_subject_name(certificate);
+	X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, (const unsigned char *)"127.0.0.1", -1, -1, 0);
+	X509_set_issuer_name(certificate, name);
+
+	X509V3_CTX v3;
+	X509V3_set_ctx_nodb(&v3);
+	X509V3_set_ctx(&v3, certificate, certificate, NULL, NULL, 0);
+
+	X509_EXTENSION *extension = X509V3_EXT_conf_nid(NULL, &v3, NID_subject_alt_name, "IP:127.0.0.1");
+	X509_add_ext(certificate, extension, -1);
+	X509_EXTENSION_free(extension);
+
+	extension = X509V3_EXT_conf_nid(NULL, &v3, NID_basic_constraints, "critical,CA:TRUE");
+	X509_add_ext(certificate, extension, -1);
+	X509_EXTENSION_free(extension);
+
+	X509_sign(certificate, key, EVP_sha256());
+
+	s->context = SSL_CTX_new(TLS_server_method());
+	bool ok = s->context
+		&& SSL_CTX_use_certificate(s->context, certificate) == 1
+		&& SSL_CTX_use_PrivateKey(s->context, key) == 1;
+
+	BIO *bio = BIO_new(BIO_s_mem());
+	PEM_write_bio_X509(bio, certificate);
+
+	char *pem = NULL;
+	long length = BIO_get_mem_data(bio, &pem);
+
+	s->CA_pem = malloc((size_t)length + 1);
+	memcpy(s->CA_pem, pem, (size_t)length);
+	s->CA_pem[length] = '\0';
+	s->CA_length = (size_t)length + 1;
+
+	BIO_free(bio);
+	X509_free(certificate);
+	EVP_PKEY_free(key);
+
+	return ok;
+}
+
+////////////// Session
+
+static int Stand_in_read(Stand_in_session_type *t, char *out, size_t cap) {
+	if (t->ssl) {
+		int n = SSL_read(t->ssl, out, (int)cap);
+		return n > 0 ? n : 0;
+	}
+
+	ssize_t n = recv(t->fd, out, cap, 0);
+	return n > 0 ? (int)n : 0;
+}
+
+static bool Stand_in_write(Stand_in_session_type *t, const char *data, size_t length) {
+	if (t->ssl) return SSL_write(t->ssl, data, (int)length) == (int)length;
+
+	return send(t->fd, data, length, MSG_NOSIGNAL) == (ssize_t)length;
+}
+
+static void Stand_in_set_idle(Stand_in_session_type *t, bool idle) {
+	pthread_mutex_lock(&t->server->lock);
+	t->server->connections[t->slot].idle = idle;
+	pthread_mutex_unlock(&t->server->lock);
+}
+
+// One request: head, body, reply. false when the connection is done.
+static bool Stand_in_serve_one(Stand_in_session_type *t) {
+	Stand_in_type *s = t->server;
+	char *end;
+
+	// Head (pipelined bytes after it stay in the buffer)
+	while (!(end = memmem(t->buffer, t->length, "\r\n\r\n", 4))) {
+		if (t->length == sizeof(t->buffer)) return false;
+
+		int n = Stand_in_read(t, t->buffer + t->length, sizeof(t->buffer) - t->length);
+		if (n == 0) return false;
+
+		if (t->length == 0) Stand_in_set_idle(t, false);
+		t->length += (size_t)n;
+	}
+
+	size_t head_length = (size_t)(end - t->buffer) + 4;
+
+	char method[8] = { 0 };
+	char path[128] = { 0 };
+	sscanf(t->buffer, "%7s %127s", method, path);
+
+	size_t content_length = 0;
+	for (char *line = strstr(t->buffer, "\r\n"); line && line < end; line = strstr(line + 2, "\r\n")) {
+		if (strncasecmp(line + 2, "Content-Length:", 15) == 0) content_length = strtoul(line + 17, NULL, 10);
+	}
+
+	if (content_length > STAND_IN_BODY_MAX) return false;
+
+	// Body
+	static __thread char body[STAND_IN_BODY_MAX];
+	size_t have = t->length - head_length;
+	if (have > content_length) have = content_length;
+	memcpy(body, t->buffer + head_length, have);
+
+	while (have < content_length) {
+		int n = Stand_in_read(t, body + have, content_length - have);
+		if (n == 0) return false;
+		have += (size_t)n;
+	}
+
+	size_t consumed = head_length + (t->length - head_length < content_length ? t->length - head_length : content_length);
+	memmove(t->buffer, t->buffer + consumed, t->length - consumed);
+	t->length -= consumed;
+
+	bool POST = strcmp(method, "POST") == 0;
+
+	pthread_mutex_lock(&s->lock);
+	s->requests++;
+	if (POST) s->posts++;
+	bool drop = POST && s->drop_next_post;
+	if (drop) s->drop_next_post = false;
+	pthread_mutex_unlock(&s->lock);
+
+	if (drop) return false;
+
+	// Idle from here on (unless more is pipelined): a client that has the reply can count on it
+	if (t->length == 0) Stand_in_set_idle(t, true);
+
+	char head[256];
+	bool ok;
+
+	if (strcmp(path, "/chunked") == 0) {
+		static const char reply[] = "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\nConnection: keep-alive\r\n\r\n5\r\nhello\r\n6\r\n world\r\n0\r\n\r\n";
+		ok = Stand_in_write(t, reply, sizeof(reply) - 1);
+	}
+
+	// n bytes of 'x', chunked or with a Content-Length
+	else if (strncmp(path, "/chunked/", 9) == 0 || strncmp(path, "/sized/", 7) == 0) {
+		bool chunked = path[1] == 'c';
+		size_t size = strtoul(strchr(path + 1, '/') + 1, NULL, 10);
+
+		static const char x[1024] = { [0 ... 1023] = 'x' };
+
+		int n = chunked
+			? snprintf(head, sizeof(head), "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\nConnection: keep-alive\r\n\r\n")
+			: snprintf(head, sizeof(head), "HTTP/1.1 200 OK\r\nContent-Length: %zu\r\nConnection: keep-alive\r\n\r\n", size);
+		ok = Stand_in_write(t, head, (size_t)n);
+
+		for (size_t sent = 0; ok && sent < size; ) {
+			size_t chunk = size - sent < sizeof(x) ? size - sent : sizeof(x);
+
+			if (chunked) {
+				n = snprintf(head, sizeof(head), "%zx\r\n", chunk);
+				ok = Stand_in_write(t, head, (size_t)n);
+			}
+
+			ok = ok && Stand_in_write(t, x, chunk) && (!chunked || Stand_in_write(t, "\r\n", 2));
+			sent += chunk;
+		}
+
+		if (ok && chunked) ok = Stand_in_write(t, "0\r\n\r\n", 5);
+	}
+
+	else {
+		const char *reply = POST ? body : "ok";
+		size_t reply_length = POST ? content_length : 2;
+
+		int n = snprintf(head, sizeof(head), "HTTP/1.1 200 OK\r\nContent-Type: %s\r\nContent-Length: %zu\r\nConnection: keep-alive\r\n\r\n", POST ? "application/json" : "text/plain", reply_length);
+		ok = Stand_in_write(t, head, (size_t)n) && (reply_length == 0 || Stand_in_write(t, reply, reply_length));
+	}
+
+	return ok;
+}
+
+static void *Stand_in_session(void *arg) {
+	Stand_in_session_type *t = arg;
+	Stand_in_type *s = t->server;
+
+	bool ready = true;
+
+	if (s->context) {
+		t->ssl = SSL_new(s->context);
+		SSL_set_fd(t->ssl, t->fd);
+		ready = SSL_accept(t->ssl) == 1;
+	}
+
+	while (ready && Stand_in_serve_one(t)) { }
+
+	if (t->ssl) SSL_free(t->ssl);
+	ERR_clear_error();
+
+	pthread_mutex_lock(&s->lock);
+	close(t->fd);
+	s->connections[t->slot].used = false;
+	s->live--;
+	pthread_mutex_unlock(&s->lock);
+
+	free(t);
+
+	return NULL;
+}
+
+static void *Stand_in_accept(void *arg) {
+	Stand_in_type *s = arg;
+
+	for (;;) {
+		int fd = accept(s->listen_fd, NULL, NULL);
+
+		pthread_mutex_lock(&s->lock);
+
+		if (s->stopping) {
+			pthread_mutex_unlock(&s->lock);
+			if (fd >= 0) close(fd);
+			return NULL;
+		}
+
+		if (fd < 0) {
+			pthread_mutex_unlock(&s->lock);
+			continue;
+		}
+
+		int slot = -1;
+		for (int i = 0; i < STAND_IN_CONNECTIONS_MAX && slot < 0; ++i) if (!s->connections[i].used) slot = i;
+
+		if (slot < 0) {
+			pthread_mutex_unlock(&s->lock);
+			close(fd);
+			continue;
+		}
+
+		s->connections[slot] = (Stand_in_connection_type){ .fd = fd, .used = true, .idle = true };
+		s->accepted++;
+		s->live++;
+
+		pthread_mutex_unlock(&s->lock);
+
+		int one = 1;
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+		Stand_in_session_type *t = calloc(1, sizeof(*t));
+		t->server = s;
+		t->slot = slot;
+		t->fd = fd;
+
+		pthread_t thread;
+		pthread_create(&thread, NULL, Stand_in_session, t);
+		pthread_detach(thread);
+	}
+}
+
+////////////// API
+
+Stand_in_type *Stand_in_start(bool TLS) {
+	Stand_in_type *s = calloc(1, sizeof(*s));
+	if (!s) return NULL;
+
+	pthread_mutex_init(&s->lock, NULL);
+
+	if (TLS && !Stand_in_certificate(s)) {
+		Stand_in_stop(s);
+		return NULL;
+	}
+
+	s->listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+
+	int one = 1;
+	setsockopt(s->listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+	struct sockaddr_in address = { .sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK) };
+	socklen_t length = sizeof(address);
+
+	if (bind(s->listen_fd, (struct sockaddr *)&address, sizeof(address)) != 0
+		|| listen(s->listen_fd, 64) != 0
+		|| getsockname(s->listen_fd, (struct sockaddr *)&address, &length) != 0) {
+		close(s->listen_fd);
+		free(s->CA_pem);
+		if (s->context) SSL_CTX_free(s->context);
+		free(s);
+		return NULL;
+	}
+
+	s->port = ntohs(address.sin_port);
+	pthread_create(&s->acceptor, NULL, Stand_in_accept, s);
+
+	return s;
+}
+
+void Stand_in_stop(Stand_in_type *s) {
+	if (!s) return;
+
+	if (s->acceptor) {
+		pthread_mutex_lock(&s->lock);
+		s->stopping = true;
+		for (int i = 0; i < STAND_IN_CONNECTIONS_MAX; ++i) if (s->connections[i].used) shutdown(s->connections[i].fd, SHUT_RDWR);
+		pthread_mutex_unlock(&s->lock);
+
+		shutdown(s->listen_fd, SHUT_RDWR);
+		pthread_join(s->acceptor, NULL);
+		close(s->listen_fd);
+
+		// Sessions notice the shutdown and leave
+		for (;;) {
+			pthread_mutex_lock(&s->lock);
+			int live = s->live;
+			pthread_mutex_unlock(&s->lock);
+			if (live == 0) break;
+			usleep(1000);
+		}
+	}
+
+	if (s->context) SSL_CTX_free(s->context);
+	free(s->CA_pem);
+	pthread_mutex_destroy(&s->lock);
+	free(s);
+}
+
+uint16_t Stand_in_port(const Stand_in_type *s) { return s->port; }
+const char *Stand_in_CA_pem(const Stand_in_type *s) { return s->CA_pem; }
+size_t Stand_in_CA_length(const Stand_in_type *s) { return s->CA_length; }
+
+static uint32_t Stand_in_read_counter(Stand_in_type *s, const uint32_t *counter) {
+	pthread_mutex_lock(&s->lock);
+	uint32_t value = *counter;
+	pthread_mutex_unlock(&s->lock);
+
+	return value;
+}
+
+uint32_t Stand_in_connections(Stand_in_type *s) { return Stand_in_read_counter(s, &s->accepted); }
+uint32_t Stand_in_requests(Stand_in_type *s) { return Stand_in_read_counter(s, &s->requests); }
+uint32_t Stand_in_posts(Stand_in_type *s) { return Stand_in_read_counter(s, &s->posts); }
+
+void Stand_in_close_idle(Stand_in_type *s) {
+	pthread_mutex_lock(&s->lock);
+
+	int closing = 0;
+	for (int i = 0; i < STAND_IN_CONNECTIONS_MAX; ++i) {
+		if (s->connections[i].used && s->connections[i].idle) {
+			shutdown(s->connections[i].fd, SHUT_RDWR);
+			closing++;
+		}
+	}
+
+	int target = s->live - closing;
+	pthread_mutex_unlock(&s->lock);
+
+	// Until the sessions are gone, so the FIN is on its way before the client sends again
+	for (int i = 0; i < 1000; ++i) {
+		pthread_mutex_lock(&s->lock);
+		int live = s->live;
+		pthread_mutex_unlock(&s->lock);
+		if (live <= target) break;
+		usleep(1000);
+	}
+}
+
+void Stand_in_drop_next_post(Stand_in_type *s) {
+	pthread_mutex_lock(&s->lock);
+	s->drop_next_post = true;
+	pthread_mutex_unlock(&s->lock);
+}
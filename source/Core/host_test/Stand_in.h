@@ -0,0 +1,52 @@
+/*
+A local HTTP/1.1 server standing in for the real backend in host tests and the bench: keep-alive,
+optional TLS with a throwaway self-signed P-256 certificate for 127.0.0.1, and switches for the
+failures a client has to survive (an idle connection closed under it, a request that never gets
+a reply).
+
+Usage:
+
+	Stand_in_type *server = Stand_in_start(true);
+	TLS_trust_set_CA(Stand_in_CA_pem(server), Stand_in_CA_length(server));
+
+	char URL[64];
+	snprintf(URL, sizeof(URL), "https://127.0.0.1:%u/", Stand_in_port(server));
+
+	...
+	Stand_in_stop(server);
+
+Replies: GET / → "ok", GET /chunked → "hello world" in two chunks, GET /chunked/<n> and
+GET /sized/<n> → n bytes of 'x' (chunked, or with a Content-Length), POST → the request body.
+*/
+
+#ifndef woXrooX_host_Stand_in_H
+#define woXrooX_host_Stand_in_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct Stand_in Stand_in_type;
+
+// Listens on 127.0.0.1, ephemeral port; NULL on failure
+Stand_in_type *Stand_in_start(bool TLS);
+void Stand_in_stop(Stand_in_type *server);
+
+uint16_t Stand_in_port(const Stand_in_type *server);
+
+// The certificate as PEM; the length includes the NUL, as TLS_trust_set_CA() wants it
+const char *Stand_in_CA_pem(const Stand_in_type *server);
+size_t Stand_in_CA_length(const Stand_in_type *server);
+
+// Connections accepted, requests answered or dropped, and how many of those were POSTs
+uint32_t Stand_in_connections(Stand_in_type *server);
+uint32_t Stand_in_requests(Stand_in_type *server);
+uint32_t Stand_in_posts(Stand_in_type *server);
+
+// Close every connection that is waiting for its next request, like a server's idle timeout
+void Stand_in_close_idle(Stand_in_type *server);
+
+// Read the next POST in full, then close the connection without replying
+void Stand_in_drop_next_post(Stand_in_type *server);
+
+#endif
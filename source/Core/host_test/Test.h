@@ -0,0 +1,65 @@
+/*
+Minimal test harness for the host tests: CHECK() records a failure and carries on, so one run
+reports every broken expectation; the process exit code is what ctest looks at.
+
+Usage:
+
+	static void test_something(void) {
+		CHECK(x == 1);
+		CHECK_EQ(n, 320);
+		CHECK_NEAR(gain, 1.0, 0.01);
+	}
+
+	int main(void) {
+		TEST(test_something);
+		return TEST_END();
+	}
+*/
+
+#ifndef woXrooX_host_Test_H
+#define woXrooX_host_Test_H
+
+#include <math.h>
+#include <stdio.h>
+
+static int Test_failures = 0;
+static int Test_checks = 0;
+
+#define CHECK(condition) do { \
+	Test_checks++; \
+	if (!(condition)) { \
+		Test_failures++; \
+		fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+	} \
+} while (0)
+
+#define CHECK_EQ(actual, expected) do { \
+	long long Test_a_ = (long long)(actual); \
+	long long Test_e_ = (long long)(expected); \
+	Test_checks++; \
+	if (Test_a_ != Test_e_) { \
+		Test_failures++; \
+		fprintf(stderr, "%s:%d: %s == %lld, expected %s == %lld\n", __FILE__, __LINE__, #actual, Test_a_, #expected, Test_e_); \
+	} \
+} while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance) do { \
+	double Test_a_ = (double)(actual); \
+	double Test_e_ = (double)(expected); \
+	Test_checks++; \
+	if (!(fabs(Test_a_ - Test_e_) <= (double)(tolerance))) { \
+		Test_failures++; \
+		fprintf(stderr, "%s:%d: %s == %g, expected %g ± %g\n", __FILE__, __LINE__, #actual, Test_a_, Test_e_, (double)(tolerance)); \
+	} \
+} while (0)
+
+#define TEST(function) do { \
+	int Test_before_ = Test_failures; \
+	function(); \
+	printf("%-40s %s\n", #function, Test_failures == Test_before_ ? "ok" : "FAILED"); \
+	fflush(stdout); \
+} while (0)
+
+#define TEST_END() (printf("%d checks, %d failed\n", Test_checks, Test_failures), Test_failures ? 1 : 0)
+
+#endif
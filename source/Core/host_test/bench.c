@@ -0,0 +1,223 @@
+/*
+Host benchmark: pipeline throughput, copies per frame, cost per stage, heap per module and HTTPS
+handshake time against a local TLS stand-in (Stand_in.h).
+
+	cmake --build <build dir> --target bench
+
+Cycles are host TSC cycles: good for comparing two versions of the code on one machine, not for
+predicting ESP32 numbers (Log_mel_measure_cost() and Metrics_measure_cost() log those on the device).
+Heap figures come from the shim's accounting (esp_heap_caps.h): what each module's start takes
+from the device heap in task stacks, queues and driver buffers.
+*/
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host.h"
+#include "Stand_in.h"
+
+#include "woXrooX/ADPCM.h"
+#include "woXrooX/Frame_ring.h"
+#include "woXrooX/Log_mel.h"
+#include "woXrooX/WS_protocol.h"
+#include "woXrooX/DLOG.h"
+#include "woXrooX/Profiler.h"
+#include "woXrooX/MIC.h"
+#include "woXrooX/HTTP_client.h"
+
+////////////// DEFINES
+
+#define BENCH_PIPELINE_MS 2000
+#define BENCH_ROUNDS 1000
+#define BENCH_HANDSHAKES 20
+#define BENCH_REQUESTS 200
+
+////////////// Helpers
+
+static void bench_line(const char *what, double value, const char *unit) {
+	printf("  %-44s %12.1f %s\n", what, value, unit);
+}
+
+// Heap the call takes from the simulated device heap
+#define BENCH_HEAP(label, call) do { \
+	size_t before = host_heap_used(); \
+	call; \
+	bench_line(label, (double)(host_heap_used() - before), "bytes"); \
+} while (0)
+
+static int bench_quiet(const char *format, va_list args) {
+	return 0;
+}
+
+static int16_t bench_pcm[MIC_FRAME_SAMPLES_MAX];
+
+static void bench_tone(void) {
+	for (int i = 0; i < MIC_FRAME_SAMPLES_MAX; ++i) bench_pcm[i] = (int16_t)(8000.0 * sin(2.0 * M_PI * 440.0 * i / 16000.0));
+}
+
+////////////// Stages
+
+static void bench_stages(void) {
+	printf("Cost per stage (host cycles)\n");
+
+	static Decimator_type decimator;
+	Decimator_init(&decimator, MIC_I2S_RATE, 16000);
+
+	int16_t y;
+	uint32_t t0 = esp_cpu_get_cycle_count();
+	for (int r = 0; r < BENCH_ROUNDS; ++r) {
+		for (int i = 0; i < 960; ++i) Decimator_push(&decimator, bench_pcm[i % 320], &y);
+	}
+	bench_line("Decimator 48 -> 16 kHz, per 20 ms frame", (double)(esp_cpu_get_cycle_count() - t0) / BENCH_ROUNDS, "cycles");
+
+	ADPCM_state_type state = { 0 };
+	uint8_t adpcm[ADPCM_BYTES(320)];
+	t0 = esp_cpu_get_cycle_count();
+	for (int r = 0; r < BENCH_ROUNDS; ++r) ADPCM_encode(&state, bench_pcm, 320, adpcm);
+	bench_line("ADPCM encode, per 320 samples", (double)(esp_cpu_get_cycle_count() - t0) / BENCH_ROUNDS, "cycles");
+
+	static uint8_t packet[WS_AUDIO_BYTES(MIC_FRAME_SAMPLES_MAX)];
+	t0 = esp_cpu_get_cycle_count();
+	for (int r = 0; r < BENCH_ROUNDS; ++r) WS_pack_audio(packet, (uint32_t)r, 0, 16000, bench_pcm, 320);
+	bench_line("WS_pack_audio, per 320 samples", (double)(esp_cpu_get_cycle_count() - t0) / BENCH_ROUNDS, "cycles");
+
+	static Frame_ring_type ring;
+	t0 = esp_cpu_get_cycle_count();
+	for (int r = 0; r < BENCH_ROUNDS; ++r) Frame_ring_publish(&ring, (uint32_t)r, 0, 16000, bench_pcm, 320);
+	bench_line("Frame_ring_publish, per 320 samples", (double)(esp_cpu_get_cycle_count() - t0) / BENCH_ROUNDS, "cycles");
+
+	static Log_mel_state_type mel;
+	Log_mel_init(&mel, 16000);
+	uint8_t features[4][LOG_MEL_BANDS];
+	Log_mel_push(&mel, bench_pcm, 320, features, 4);
+	bench_line("Log_mel hop (Log_mel_measure_cost)", (double)Log_mel_measure_cost(&mel), "cycles");
+
+	bench_line("METRIC_INC (Metrics_measure_cost)", (double)Metrics_measure_cost(), "cycles");
+}
+
+////////////// Heap per module
+
+static void bench_heap(void) {
+	printf("Heap taken at start, per module\n");
+
+	BENCH_HEAP("DLOG_start", DLOG_start());
+	BENCH_HEAP("Profiler_start", Profiler_start());
+	BENCH_HEAP("MIC_listen_start (queue, MIC_RX, DMA)", MIC_listen_start());
+
+	bench_line("total", (double)host_heap_used(), "bytes");
+}
+
+////////////// Pipeline
+
+static void bench_pipeline(void) {
+	printf("Capture pipeline, I2S unpaced, %d ms\n", BENCH_PIPELINE_MS);
+
+	static MIC_frame_type frame;
+	QueueHandle_t queue = MIC_listen_queue();
+
+	// Drain what piled up during start, then count
+	while (xQueueReceive(queue, &frame, 0) == pdTRUE) { }
+
+	uint64_t copies = 0;
+	uint64_t bytes = 0;
+	uint32_t frames = 0;
+	uint32_t dropped = Metrics_counter(METRIC_COUNTER_MIC_dropped);
+	uint64_t main_cpu = host_task_cpu_us(xTaskGetCurrentTaskHandle());
+
+	host_queue_stats_reset();
+	uint64_t start = host_now_us();
+
+	while (host_now_us() - start < BENCH_PIPELINE_MS * 1000ULL) {
+		if (xQueueReceive(queue, &frame, pdMS_TO_TICKS(10)) == pdTRUE) frames++;
+	}
+
+	uint64_t elapsed = host_now_us() - start;
+	host_queue_stats(&copies, &bytes);
+	dropped = Metrics_counter(METRIC_COUNTER_MIC_dropped) - dropped;
+
+	TaskHandle_t MIC_RX = host_task_find("MIC_RX");
+
+	bench_line("frames delivered per second", (double)frames * 1e6 / (double)elapsed, "frames/s");
+	bench_line("real-time factor (20 ms frames)", (double)frames * 20000.0 / (double)elapsed, "x");
+	bench_line("frames dropped (queue full)", (double)dropped, "frames");
+	bench_line("queue copies per delivered frame", frames ? (double)copies / frames : 0.0, "copies");
+	bench_line("bytes copied per delivered frame", frames ? (double)bytes / frames : 0.0, "bytes");
+	bench_line("MIC_RX CPU per frame", MIC_RX && frames ? (double)host_task_cpu_us(MIC_RX) / (frames + dropped) : 0.0, "us");
+	bench_line("consumer CPU per frame", frames ? (double)(host_task_cpu_us(xTaskGetCurrentTaskHandle()) - main_cpu) / frames : 0.0, "us");
+}
+
+////////////// HTTPS
+
+// Mean wall time of `rounds` GETs; fresh = drop the cached connection before each one
+static double bench_GET_us(const char *URL, int rounds, bool fresh) {
+	uint64_t total = 0;
+
+	for (int i = 0; i < rounds; ++i) {
+		if (fresh) HTTP_close_all();
+
+		char *body = NULL;
+		int status = 0;
+		uint64_t t0 = host_now_us();
+
+		if (HTTP_GET(URL, &body, &status) != 0) return -1.0;
+
+		total += host_now_us() - t0;
+		free(body);
+	}
+
+	return (double)total / rounds;
+}
+
+static void bench_HTTPS(void) {
+	printf("HTTP client against a local stand-in (OpenSSL, P-256, loopback)\n");
+
+	Stand_in_type *plain = Stand_in_start(false);
+	Stand_in_type *secure = Stand_in_start(true);
+	if (!plain || !secure) return;
+
+	char plain_URL[64];
+	char secure_URL[64];
+	snprintf(plain_URL, sizeof(plain_URL), "http://127.0.0.1:%u/", Stand_in_port(plain));
+	snprintf(secure_URL, sizeof(secure_URL), "https://127.0.0.1:%u/", Stand_in_port(secure));
+	TLS_trust_set_CA(Stand_in_CA_pem(secure), Stand_in_CA_length(secure));
+
+	bench_line("http:// GET, new connection", bench_GET_us(plain_URL, BENCH_HANDSHAKES, true), "us");
+	bench_line("http:// GET, reused connection", bench_GET_us(plain_URL, BENCH_REQUESTS, false), "us");
+	HTTP_close_all();
+
+	bench_line("https:// GET, new connection", bench_GET_us(secure_URL, BENCH_HANDSHAKES, true), "us");
+
+	TLS_stats_type stats = TLS_stats();
+	bench_line("  of which open + TLS handshake (TLS_stats)", stats.handshakes ? (double)stats.total_handshake_us / stats.handshakes : 0.0, "us");
+
+	HTTP_close_all();
+	size_t before = host_heap_used();
+	bench_line("https:// GET, reused connection", bench_GET_us(secure_URL, BENCH_REQUESTS, false), "us");
+	bench_line("heap held by one cached https:// connection", (double)(host_heap_used() - before), "bytes");
+
+	stats = TLS_stats();
+	bench_line("TLS handshakes", (double)stats.handshakes, "");
+	bench_line("TLS reuses", (double)stats.reuses, "");
+
+	HTTP_close_all();
+	Stand_in_stop(plain);
+	Stand_in_stop(secure);
+}
+
+int main(void) {
+	// Only the table on stdout
+	esp_log_set_vprintf(bench_quiet);
+	host_heap_reset(HOST_HEAP_TOTAL);
+	host_i2s_free_run(true);
+	bench_tone();
+
+	bench_heap();
+	bench_stages();
+	bench_pipeline();
+	bench_HTTPS();
+
+	return 0;
+}
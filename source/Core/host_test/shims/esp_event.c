@@ -0,0 +1,179 @@
+/*
+The default event loop on the host: one "sys_evt" task delivers posted events in order to every
+matching handler, like the IDF's default loop. Bases compare by pointer, as on the device.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_event.h"
+
+#include "host.h"
+#include "host_internal.h"
+
+////////////// DEFINES
+
+#define HOST_EVENT_HANDLERS_MAX 32
+
+////////////// TYPES
+
+typedef struct {
+	esp_event_base_t base;
+	int32_t id;
+	esp_event_handler_t handler;
+	void *arg;
+	bool used;
+} host_event_handler_type;
+
+typedef struct host_event {
+	esp_event_base_t base;
+	int32_t id;
+	void *data;
+	struct host_event *next;
+} host_event_type;
+
+////////////// GLOBALS
+
+static pthread_mutex_t host_events_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t host_events_posted;
+static bool host_events_loop = false;
+
+static host_event_handler_type host_event_handlers[HOST_EVENT_HANDLERS_MAX];
+static host_event_type *host_events_head = NULL;
+static host_event_type *host_events_tail = NULL;
+
+////////////// Loop
+
+static void host_event_task(void *arg) {
+	(void)arg;
+
+	pthread_mutex_lock(&host_events_lock);
+
+	for (;;) {
+		while (!host_events_head) host_cond_wait(&host_events_posted, &host_events_lock, NULL);
+
+		host_event_type *e = host_events_head;
+		host_events_head = e->next;
+		if (!host_events_head) host_events_tail = NULL;
+
+		// Snapshot, so a handler may (un)register without deadlocking the loop
+		host_event_handler_type handlers[HOST_EVENT_HANDLERS_MAX];
+		memcpy(handlers, host_event_handlers, sizeof(handlers));
+
+		pthread_mutex_unlock(&host_events_lock);
+
+		for (int i = 0; i < HOST_EVENT_HANDLERS_MAX; ++i) {
+			host_event_handler_type *h = &handlers[i];
+			if (!h->used) continue;
+			if (h->base != ESP_EVENT_ANY_BASE && h->base != e->base) continue;
+			if (h->id != ESP_EVENT_ANY_ID && h->id != e->id) continue;
+
+			h->handler(h->arg, e->base, e->id, e->data);
+		}
+
+		free(e->data);
+		free(e);
+
+		pthread_mutex_lock(&host_events_lock);
+	}
+}
+
+esp_err_t esp_event_loop_create_default(void) {
+	pthread_mutex_lock(&host_events_lock);
+
+	if (host_events_loop) {
+		pthread_mutex_unlock(&host_events_lock);
+		return ESP_ERR_INVALID_STATE;
+	}
+
+	host_events_loop = true;
+	host_cond_init(&host_events_posted);
+
+	pthread_mutex_unlock(&host_events_lock);
+
+	host_service_task("sys_evt", 20, 0, 2304, host_event_task, NULL);
+
+	return ESP_OK;
+}
+
+////////////// Handlers
+
+esp_err_t esp_event_handler_instance_register(esp_event_base_t event_base, int32_t event_id, esp_event_handler_t event_handler, void *event_handler_arg, esp_event_handler_instance_t *instance) {
+	if (!event_handler) return ESP_ERR_INVALID_ARG;
+
+	pthread_mutex_lock(&host_events_lock);
+
+	int slot = -1;
+	for (int i = 0; i < HOST_EVENT_HANDLERS_MAX && slot < 0; ++i) if (!host_event_handlers[i].used) slot = i;
+
+	if (slot >= 0) host_event_handlers[slot] = (host_event_handler_type){ event_base, event_id, event_handler, event_handler_arg, true };
+
+	pthread_mutex_unlock(&host_events_lock);
+
+	if (slot < 0) return ESP_ERR_NO_MEM;
+	if (instance) *instance = &host_event_handlers[slot];
+
+	return ESP_OK;
+}
+
+esp_err_t esp_event_handler_register(esp_event_base_t event_base, int32_t event_id, esp_event_handler_t event_handler, void *event_handler_arg) {
+	return esp_event_handler_instance_register(event_base, event_id, event_handler, event_handler_arg, NULL);
+}
+
+esp_err_t esp_event_handler_instance_unregister(esp_event_base_t event_base, int32_t event_id, esp_event_handler_instance_t instance) {
+	if (!instance) return ESP_ERR_INVALID_ARG;
+
+	pthread_mutex_lock(&host_events_lock);
+	((host_event_handler_type *)instance)->used = false;
+	pthread_mutex_unlock(&host_events_lock);
+
+	return ESP_OK;
+}
+
+esp_err_t esp_event_handler_unregister(esp_event_base_t event_base, int32_t event_id, esp_event_handler_t event_handler) {
+	pthread_mutex_lock(&host_events_lock);
+
+	for (int i = 0; i < HOST_EVENT_HANDLERS_MAX; ++i) {
+		host_event_handler_type *h = &host_event_handlers[i];
+		if (h->used && h->base == event_base && h->id == event_id && h->handler == event_handler) h->used = false;
+	}
+
+	pthread_mutex_unlock(&host_events_lock);
+
+	return ESP_OK;
+}
+
+////////////// Post
+
+esp_err_t esp_event_post(esp_event_base_t event_base, int32_t event_id, const void *event_data, size_t event_data_size, TickType_t ticks_to_wait) {
+	(void)ticks_to_wait;
+
+	host_event_type *e = calloc(1, sizeof(*e));
+	if (!e) return ESP_ERR_NO_MEM;
+
+	e->base = event_base;
+	e->id = event_id;
+
+	if (event_data && event_data_size) {
+		e->data = malloc(event_data_size);
+		memcpy(e->data, event_data, event_data_size);
+	}
+
+	pthread_mutex_lock(&host_events_lock);
+
+	if (!host_events_loop) {
+		pthread_mutex_unlock(&host_events_lock);
+		free(e->data);
+		free(e);
+		return ESP_ERR_INVALID_STATE;
+	}
+
+	if (host_events_tail) host_events_tail->next = e;
+	else host_events_head = e;
+	host_events_tail = e;
+
+	pthread_cond_signal(&host_events_posted);
+	pthread_mutex_unlock(&host_events_lock);
+
+	return ESP_OK;
+}
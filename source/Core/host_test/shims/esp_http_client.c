@@ -0,0 +1,605 @@
+/*
+esp_http_client, esp_tls's global CA store and esp_crt_bundle on the host: HTTP/1.1 over a real
+socket, OpenSSL for https://, keep-alive between requests. Enough of the IDF client for
+HTTP_client.h to run unchanged against a local server (Stand_in.h), including what a server-side
+close of an idle keep-alive connection looks like from the client.
+*/
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <openssl/err.h>
+#include <openssl/pem.h>
+#include <openssl/ssl.h>
+#include <openssl/x509v3.h>
+
+#include "esp_crt_bundle.h"
+#include "esp_http_client.h"
+#include "esp_tls.h"
+
+#include "host.h"
+#include "host_internal.h"
+
+////////////// DEFINES
+
+// esp_http_client_init(): the handle plus the default 512-byte RX and TX buffers
+#define HOST_HTTP_CLIENT_BYTES 1536
+
+// One mbedTLS session on the device: 16 KB in / 4 KB out record buffers plus handshake state
+#define HOST_TLS_SESSION_BYTES (24 * 1024)
+
+#define HOST_HTTP_HEADERS_MAX 8
+
+////////////// TYPES
+
+struct host_http_client {
+	// Request
+	char host[64];
+	char path[192];
+	uint16_t port;
+	bool https;
+	esp_http_client_method_t method;
+	int timeout_ms;
+	bool keep_alive;
+	bool global_CA;
+	bool bundle;
+
+	struct {
+		char key[32];
+		char value[96];
+	} headers[HOST_HTTP_HEADERS_MAX];
+
+	// Connection (kept between requests)
+	int fd;
+	SSL_CTX *context;
+	SSL *ssl;
+	char connected_host[64];
+	uint16_t connected_port;
+	bool connected_https;
+	bool server_close;
+
+	// Response
+	int status;
+	int64_t content_length;
+	int64_t body_left;
+	bool chunked;
+	bool until_close;
+	bool body_done;
+
+	char rx[2048];
+	size_t rx_position;
+	size_t rx_length;
+};
+
+////////////// GLOBALS
+
+static pthread_mutex_t host_tls_lock = PTHREAD_MUTEX_INITIALIZER;
+static char *host_tls_CA_pem = NULL;
+static bool host_tls_CA_ready = false;
+
+////////////// esp_tls / esp_crt_bundle
+
+esp_err_t esp_tls_init_global_ca_store(void) {
+	pthread_mutex_lock(&host_tls_lock);
+	host_tls_CA_ready = true;
+	pthread_mutex_unlock(&host_tls_lock);
+
+	return ESP_OK;
+}
+
+esp_err_t esp_tls_set_global_ca_store(const unsigned char *cacert_pem_buf, const unsigned int cacert_pem_bytes) {
+	if (!cacert_pem_buf || cacert_pem_bytes == 0) return ESP_ERR_INVALID_ARG;
+
+	// mbedTLS wants the NUL counted in the length; refuse what it would refuse
+	if (cacert_pem_buf[cacert_pem_bytes - 1] != '\0') return ESP_ERR_INVALID_ARG;
+
+	pthread_mutex_lock(&host_tls_lock);
+
+	if (!host_tls_CA_ready) {
+		pthread_mutex_unlock(&host_tls_lock);
+		return ESP_ERR_INVALID_STATE;
+	}
+
+	free(host_tls_CA_pem);
+	host_tls_CA_pem = strdup((const char *)cacert_pem_buf);
+
+	pthread_mutex_unlock(&host_tls_lock);
+
+	return host_tls_CA_pem ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+void esp_tls_free_global_ca_store(void) {
+	pthread_mutex_lock(&host_tls_lock);
+	free(host_tls_CA_pem);
+	host_tls_CA_pem = NULL;
+	host_tls_CA_ready = false;
+	pthread_mutex_unlock(&host_tls_lock);
+}
+
+esp_err_t esp_crt_bundle_attach(void *conf) {
+	(void)conf;
+	return ESP_OK;
+}
+
+////////////// URL
+
+static esp_err_t host_http_parse_url(struct host_http_client *c, const char *url) {
+	if (!url) return ESP_ERR_INVALID_ARG;
+
+	const char *p;
+	if (strncmp(url, "http://", 7) == 0) { c->https = false; p = url + 7; }
+	else if (strncmp(url, "https://", 8) == 0) { c->https = true; p = url + 8; }
+	else return ESP_ERR_INVALID_ARG;
+
+	size_t host_length = strcspn(p, ":/?#");
+	if (host_length == 0 || host_length >= sizeof(c->host)) return ESP_ERR_INVALID_ARG;
+
+	memcpy(c->host, p, host_length);
+	c->host[host_length] = '\0';
+	p += host_length;
+
+	c->port = c->https ? 443 : 80;
+	if (*p == ':') {
+		c->port = (uint16_t)strtoul(p + 1, (char **)&p, 10);
+		if (c->port == 0) return ESP_ERR_INVALID_ARG;
+	}
+
+	const char *path = (*p == '/') ? p : "/";
+	if (strlen(path) >= sizeof(c->path)) return ESP_ERR_INVALID_ARG;
+	strcpy(c->path, path);
+
+	return ESP_OK;
+}
+
+////////////// Socket
+
+static int host_http_send(struct host_http_client *c, const char *data, size_t length) {
+	size_t sent = 0;
+
+	while (sent < length) {
+		int n = c->ssl
+			? SSL_write(c->ssl, data + sent, (int)(length - sent))
+			: (int)send(c->fd, data + sent, length - sent, MSG_NOSIGNAL);
+		if (n <= 0) return -1;
+		sent += (size_t)n;
+	}
+
+	return (int)sent;
+}
+
+// Refill the receive buffer; returns bytes available, 0 on EOF, -1 on error or timeout
+static int host_http_fill(struct host_http_client *c) {
+	if (c->rx_position < c->rx_length) return (int)(c->rx_length - c->rx_position);
+
+	int n;
+
+	if (c->ssl) {
+		n = SSL_read(c->ssl, c->rx, sizeof(c->rx));
+		if (n <= 0) n = (SSL_get_error(c->ssl, n) == SSL_ERROR_ZERO_RETURN) ? 0 : -1;
+	}
+	else n = (int)recv(c->fd, c->rx, sizeof(c->rx), 0);
+
+	if (n <= 0) return n < 0 ? -1 : 0;
+
+	c->rx_position = 0;
+	c->rx_length = (size_t)n;
+
+	return n;
+}
+
+// One CRLF-terminated line without the CRLF; false on EOF, error or overlong line
+static bool host_http_line(struct host_http_client *c, char *out, size_t cap) {
+	size_t length = 0;
+
+	for (;;) {
+		if (host_http_fill(c) <= 0) return false;
+
+		char ch = c->rx[c->rx_position++];
+		if (ch == '\n') break;
+		if (length + 1 >= cap) return false;
+		out[length++] = ch;
+	}
+
+	if (length && out[length - 1] == '\r') length--;
+	out[length] = '\0';
+
+	return true;
+}
+
+static void host_http_disconnect(struct host_http_client *c) {
+	if (c->ssl) {
+		SSL_free(c->ssl);
+		c->ssl = NULL;
+	}
+
+	if (c->context) {
+		SSL_CTX_free(c->context);
+		c->context = NULL;
+		host_heap_give(HOST_TLS_SESSION_BYTES);
+	}
+
+	if (c->fd >= 0) {
+		close(c->fd);
+		c->fd = -1;
+	}
+
+	c->rx_position = c->rx_length = 0;
+	c->server_close = false;
+}
+
+static bool host_tls_load_CA(SSL_CTX *context) {
+	pthread_mutex_lock(&host_tls_lock);
+
+	bool ok = false;
+	BIO *bio = host_tls_CA_pem ? BIO_new_mem_buf(host_tls_CA_pem, -1) : NULL;
+
+	if (bio) {
+		X509_STORE *store = SSL_CTX_get_cert_store(context);
+		X509 *certificate;
+
+		while ((certificate = PEM_read_bio_X509(bio, NULL, NULL, NULL)) != NULL) {
+			ok = X509_STORE_add_cert(store, certificate) == 1 || ok;
+			X509_free(certificate);
+		}
+
+		ERR_clear_error();
+		BIO_free(bio);
+	}
+
+	pthread_mutex_unlock(&host_tls_lock);
+
+	return ok;
+}
+
+static esp_err_t host_tls_connect(struct host_http_client *c) {
+	// Like esp-tls: no verification option set is a configuration error, not "trust anything"
+	if (!c->global_CA && !c->bundle) return ESP_FAIL;
+
+	if (!host_heap_take(HOST_TLS_SESSION_BYTES)) return ESP_ERR_NO_MEM;
+
+	c->context = SSL_CTX_new(TLS_client_method());
+	if (!c->context) {
+		host_heap_give(HOST_TLS_SESSION_BYTES);
+		return ESP_FAIL;
+	}
+
+	if (c->global_CA) {
+		if (!host_tls_load_CA(c->context)) return ESP_FAIL;
+	}
+	else SSL_CTX_set_default_verify_paths(c->context);
+
+	SSL_CTX_set_verify(c->context, SSL_VERIFY_PEER, NULL);
+
+	// A peer closing without close_notify reads as EOF, as it does through esp-tls
+	SSL_CTX_set_options(c->context, SSL_OP_IGNORE_UNEXPECTED_EOF);
+
+	c->ssl = SSL_new(c->context);
+	if (!c->ssl) return ESP_FAIL;
+
+	SSL_set_fd(c->ssl, c->fd);
+
+	X509_VERIFY_PARAM *parameters = SSL_get0_param(c->ssl);
+	struct in_addr address;
+
+	if (inet_pton(AF_INET, c->host, &address) == 1) X509_VERIFY_PARAM_set1_ip_asc(parameters, c->host);
+	else {
+		SSL_set_tlsext_host_name(c->ssl, c->host);
+		X509_VERIFY_PARAM_set1_host(parameters, c->host, 0);
+	}
+
+	if (SSL_connect(c->ssl) != 1) {
+		ERR_clear_error();
+		return ESP_FAIL;
+	}
+
+	return ESP_OK;
+}
+
+static esp_err_t host_http_connect(struct host_http_client *c) {
+	char port[8];
+	snprintf(port, sizeof(port), "%u", c->port);
+
+	struct addrinfo hints = { .ai_family = AF_INET, .ai_socktype = SOCK_STREAM };
+	struct addrinfo *address = NULL;
+	if (getaddrinfo(c->host, port, &hints, &address) != 0) return ESP_FAIL;
+
+	c->fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (c->fd < 0) {
+		freeaddrinfo(address);
+		return ESP_FAIL;
+	}
+
+	struct timeval timeout = { .tv_sec = c->timeout_ms / 1000, .tv_usec = (c->timeout_ms % 1000) * 1000 };
+	setsockopt(c->fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+	setsockopt(c->fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+	int one = 1;
+	setsockopt(c->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+	int rc = connect(c->fd, address->ai_addr, address->ai_addrlen);
+	freeaddrinfo(address);
+
+	esp_err_t err = (rc == 0) ? ESP_OK : ESP_FAIL;
+	if (err == ESP_OK && c->https) err = host_tls_connect(c);
+
+	if (err != ESP_OK) {
+		host_http_disconnect(c);
+		return err;
+	}
+
+	strcpy(c->connected_host, c->host);
+	c->connected_port = c->port;
+	c->connected_https = c->https;
+
+	return ESP_OK;
+}
+
+////////////// Client
+
+esp_http_client_handle_t esp_http_client_init(const esp_http_client_config_t *config) {
+	if (!config || !config->url) return NULL;
+	if (!host_heap_take(HOST_HTTP_CLIENT_BYTES)) return NULL;
+
+	struct host_http_client *c = calloc(1, sizeof(*c));
+	if (!c) {
+		host_heap_give(HOST_HTTP_CLIENT_BYTES);
+		return NULL;
+	}
+
+	c->fd = -1;
+	c->method = config->method;
+	c->timeout_ms = config->timeout_ms > 0 ? config->timeout_ms : 5000;
+	c->keep_alive = config->keep_alive_enable;
+	c->global_CA = config->use_global_ca_store;
+	c->bundle = config->crt_bundle_attach != NULL;
+
+	if (host_http_parse_url(c, config->url) != ESP_OK) {
+		free(c);
+		host_heap_give(HOST_HTTP_CLIENT_BYTES);
+		return NULL;
+	}
+
+	return c;
+}
+
+esp_err_t esp_http_client_close(esp_http_client_handle_t c) {
+	if (!c) return ESP_ERR_INVALID_ARG;
+	host_http_disconnect(c);
+
+	return ESP_OK;
+}
+
+esp_err_t esp_http_client_cleanup(esp_http_client_handle_t c) {
+	if (!c) return ESP_FAIL;
+
+	host_http_disconnect(c);
+	free(c);
+	host_heap_give(HOST_HTTP_CLIENT_BYTES);
+
+	return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_url(esp_http_client_handle_t c, const char *url) {
+	if (!c) return ESP_ERR_INVALID_ARG;
+	return host_http_parse_url(c, url);
+}
+
+esp_err_t esp_http_client_set_method(esp_http_client_handle_t c, esp_http_client_method_t method) {
+	if (!c) return ESP_ERR_INVALID_ARG;
+	c->method = method;
+
+	return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_header(esp_http_client_handle_t c, const char *key, const char *value) {
+	if (!c || !key || !value) return ESP_ERR_INVALID_ARG;
+
+	int free_slot = -1;
+	for (int i = 0; i < HOST_HTTP_HEADERS_MAX; ++i) {
+		if (c->headers[i].key[0] && strcasecmp(c->headers[i].key, key) == 0) { free_slot = i; break; }
+		if (!c->headers[i].key[0] && free_slot < 0) free_slot = i;
+	}
+
+	if (free_slot < 0 || strlen(key) >= sizeof(c->headers[0].key) || strlen(value) >= sizeof(c->headers[0].value)) return ESP_ERR_NO_MEM;
+
+	strcpy(c->headers[free_slot].key, key);
+	strcpy(c->headers[free_slot].value, value);
+
+	return ESP_OK;
+}
+
+esp_err_t esp_http_client_delete_header(esp_http_client_handle_t c, const char *key) {
+	if (!c || !key) return ESP_ERR_INVALID_ARG;
+
+	for (int i = 0; i < HOST_HTTP_HEADERS_MAX; ++i) {
+		if (strcasecmp(c->headers[i].key, key) == 0) c->headers[i].key[0] = '\0';
+	}
+
+	return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_timeout_ms(esp_http_client_handle_t c, int timeout_ms) {
+	if (!c) return ESP_ERR_INVALID_ARG;
+	c->timeout_ms = timeout_ms;
+
+	return ESP_OK;
+}
+
+// Connects if needed and sends the request line and headers; the body follows with write()
+esp_err_t esp_http_client_open(esp_http_client_handle_t c, int write_len) {
+	if (!c) return ESP_ERR_INVALID_ARG;
+
+	c->status = 0;
+	c->content_length = 0;
+	c->body_left = 0;
+	c->chunked = false;
+	c->until_close = false;
+	c->body_done = false;
+
+	bool same_origin = c->fd >= 0 && c->connected_port == c->port && c->connected_https == c->https && strcmp(c->connected_host, c->host) == 0;
+	if (c->fd >= 0 && (!same_origin || c->server_close)) host_http_disconnect(c);
+
+	if (c->fd < 0) {
+		esp_err_t err = host_http_connect(c);
+		if (err != ESP_OK) return err;
+	}
+
+	static const char *const methods[] = { "GET", "POST", "PUT", "DELETE", "HEAD" };
+
+	char request[1024];
+	int n = snprintf(request, sizeof(request), "%s %s HTTP/1.1\r\nHost: %s:%u\r\nUser-Agent: ESP32 HTTP Client/1.0\r\n", methods[c->method < HTTP_METHOD_MAX ? c->method : 0], c->path, c->host, c->port);
+
+	for (int i = 0; i < HOST_HTTP_HEADERS_MAX; ++i) {
+		if (c->headers[i].key[0]) n += snprintf(request + n, sizeof(request) - n, "%s: %s\r\n", c->headers[i].key, c->headers[i].value);
+	}
+
+	if (write_len > 0 || c->method == HTTP_METHOD_POST || c->method == HTTP_METHOD_PUT) n += snprintf(request + n, sizeof(request) - n, "Content-Length: %d\r\n", write_len > 0 ? write_len : 0);
+	if (!c->keep_alive) n += snprintf(request + n, sizeof(request) - n, "Connection: close\r\n");
+	n += snprintf(request + n, sizeof(request) - n, "\r\n");
+
+	if (host_http_send(c, request, (size_t)n) < 0) {
+		host_http_disconnect(c);
+		return ESP_FAIL;
+	}
+
+	return ESP_OK;
+}
+
+int esp_http_client_write(esp_http_client_handle_t c, const char *buffer, int len) {
+	if (!c || c->fd < 0 || len < 0) return -1;
+
+	return host_http_send(c, buffer, (size_t)len);
+}
+
+int64_t esp_http_client_fetch_headers(esp_http_client_handle_t c) {
+	if (!c || c->fd < 0) return ESP_FAIL;
+
+	char line[512];
+	int minor = 0;
+
+	if (!host_http_line(c, line, sizeof(line)) || sscanf(line, "HTTP/1.%d %d", &minor, &c->status) != 2) {
+		host_http_disconnect(c);
+		return ESP_FAIL;
+	}
+
+	bool has_length = false;
+	c->server_close = minor == 0;
+
+	for (;;) {
+		if (!host_http_line(c, line, sizeof(line))) {
+			host_http_disconnect(c);
+			return ESP_FAIL;
+		}
+
+		if (line[0] == '\0') break;
+
+		char *value = strchr(line, ':');
+		if (!value) continue;
+		*value++ = '\0';
+		while (*value == ' ') value++;
+
+		if (strcasecmp(line, "Content-Length") == 0) {
+			c->content_length = strtoll(value, NULL, 10);
+			has_length = true;
+		}
+
+		else if (strcasecmp(line, "Transfer-Encoding") == 0 && strcasecmp(value, "chunked") == 0) c->chunked = true;
+		else if (strcasecmp(line, "Connection") == 0) c->server_close = strcasecmp(value, "close") == 0;
+	}
+
+	if (c->chunked) {
+		c->content_length = 0;
+		c->body_left = 0;
+	}
+
+	else if (has_length) {
+		c->body_left = c->content_length;
+		c->body_done = c->content_length == 0;
+	}
+
+	// No length and not chunked: the body runs to the end of the connection
+	else c->until_close = true;
+
+	return c->content_length;
+}
+
+int esp_http_client_read(esp_http_client_handle_t c, char *buffer, int len) {
+	if (!c || len < 0) return -1;
+	if (c->body_done || len == 0) return 0;
+	if (c->fd < 0) return -1;
+
+	if (c->chunked && c->body_left == 0) {
+		char line[64];
+		if (!host_http_line(c, line, sizeof(line))) return -1;
+
+		c->body_left = strtoll(line, NULL, 16);
+
+		if (c->body_left == 0) {
+			// Trailers up to the empty line
+			do {
+				if (!host_http_line(c, line, sizeof(line))) return -1;
+			} while (line[0] != '\0');
+
+			c->body_done = true;
+			if (c->server_close) host_http_disconnect(c);
+
+			return 0;
+		}
+	}
+
+	int available = host_http_fill(c);
+	if (available < 0) return -1;
+
+	if (available == 0) {
+		if (!c->until_close) return -1;
+
+		c->body_done = true;
+		host_http_disconnect(c);
+
+		return 0;
+	}
+
+	size_t n = (size_t)available < (size_t)len ? (size_t)available : (size_t)len;
+	if (!c->until_close && (int64_t)n > c->body_left) n = (size_t)c->body_left;
+
+	memcpy(buffer, c->rx + c->rx_position, n);
+	c->rx_position += n;
+
+	if (!c->until_close) {
+		c->body_left -= (int64_t)n;
+
+		if (c->chunked && c->body_left == 0) {
+			char crlf[4];
+			if (!host_http_line(c, crlf, sizeof(crlf))) return -1;
+		}
+
+		else if (!c->chunked && c->body_left == 0) {
+			c->body_done = true;
+			if (c->server_close) host_http_disconnect(c);
+		}
+	}
+
+	return (int)n;
+}
+
+int esp_http_client_get_status_code(esp_http_client_handle_t c) {
+	return c ? c->status : -1;
+}
+
+bool esp_http_client_is_chunked_response(esp_http_client_handle_t c) {
+	return c && c->chunked;
+}
+
+bool esp_http_client_is_complete_data_received(esp_http_client_handle_t c) {
+	return c && c->body_done;
+}
@@ -0,0 +1,544 @@
+/*
+esp_http_server on the host: HTTP/1.1 over real loopback sockets, served by one "httpd" task the
+way the IDF server does it (poll every idle session, run the handler on the server task), with
+async handlers, chunked responses, the max_open_sockets limit and the LRU purge. Enough for
+HTTP_server.h to run unchanged against real concurrent clients (see esp_http_server.h).
+*/
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "esp_http_server.h"
+
+#include "host.h"
+#include "host_internal.h"
+
+////////////// DEFINES
+
+#define HOST_HTTPD_URIS_MAX 16
+#define HOST_HTTPD_HEADERS_MAX 16
+#define HOST_HTTPD_REQUEST_MAX 2048
+
+// How often the server task looks at sessions other tasks flagged for closing
+#define HOST_HTTPD_POLL_MS 10
+
+////////////// TYPES
+
+typedef struct {
+	int fd;
+	bool used;
+
+	// Owned by an async handler: not polled, closed (if at all) when it completes
+	bool async;
+	bool close_pending;
+
+	uint64_t last_us;
+} host_httpd_session_type;
+
+typedef struct host_httpd {
+	httpd_config_t config;
+	int listen_fd;
+	uint16_t port;
+
+	pthread_mutex_t lock;
+	httpd_uri_t uris[HOST_HTTPD_URIS_MAX];
+	int uri_count;
+
+	host_httpd_session_type *sessions;
+
+	host_httpd_stats_type stats;
+
+	volatile bool stop;
+	volatile bool stopped;
+} host_httpd_type;
+
+// Response state behind httpd_req_t.aux
+typedef struct {
+	host_httpd_type *server;
+	int fd;
+
+	char status[48];
+	char type[64];
+	const char *fields[HOST_HTTPD_HEADERS_MAX];
+	const char *values[HOST_HTTPD_HEADERS_MAX];
+	int headers;
+
+	bool headers_sent;
+	bool chunked;
+} host_httpd_aux_type;
+
+////////////// Sessions (under server->lock)
+
+static host_httpd_session_type *host_httpd_session_of(host_httpd_type *server, int fd) {
+	for (int i = 0; i < server->config.max_open_sockets; ++i) {
+		if (server->sessions[i].used && server->sessions[i].fd == fd) return &server->sessions[i];
+	}
+
+	return NULL;
+}
+
+static void host_httpd_session_close(host_httpd_type *server, host_httpd_session_type *session) {
+	close(session->fd);
+	memset(session, 0, sizeof(*session));
+	session->fd = -1;
+	server->stats.closed++;
+}
+
+// A new connection: a free slot, or (LRU purge) the least recently used one, or none
+static void host_httpd_accept(host_httpd_type *server) {
+	int fd = accept(server->listen_fd, NULL, NULL);
+	if (fd < 0) return;
+
+	struct timeval timeout = { .tv_sec = server->config.recv_wait_timeout };
+	setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+	timeout.tv_sec = server->config.send_wait_timeout;
+	setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+	pthread_mutex_lock(&server->lock);
+
+	host_httpd_session_type *slot = NULL;
+	host_httpd_session_type *oldest = NULL;
+
+	for (int i = 0; i < server->config.max_open_sockets && !slot; ++i) {
+		host_httpd_session_type *s = &server->sessions[i];
+
+		if (!s->used) slot = s;
+		else if (!oldest || s->last_us < oldest->last_us) oldest = s;
+	}
+
+	if (!slot && server->config.lru_purge_enable && oldest) {
+		server->stats.purged++;
+
+		// An async handler may still be writing: cut the connection now, close the fd when it completes
+		if (oldest->async) {
+			shutdown(oldest->fd, SHUT_RDWR);
+			memset(oldest, 0, sizeof(*oldest));
+			oldest->fd = -1;
+		}
+
+		else host_httpd_session_close(server, oldest);
+
+		slot = oldest;
+	}
+
+	if (!slot) {
+		server->stats.refused++;
+		pthread_mutex_unlock(&server->lock);
+		close(fd);
+		return;
+	}
+
+	slot->fd = fd;
+	slot->used = true;
+	slot->last_us = host_now_us();
+	server->stats.accepted++;
+
+	pthread_mutex_unlock(&server->lock);
+}
+
+////////////// Responses
+
+static esp_err_t host_httpd_send_all(int fd, const char *data, size_t length) {
+	while (length > 0) {
+		ssize_t n = send(fd, data, length, MSG_NOSIGNAL);
+		if (n <= 0) return ESP_ERR_HTTPD_RESP_SEND;
+
+		data += n;
+		length -= (size_t)n;
+	}
+
+	return ESP_OK;
+}
+
+static esp_err_t host_httpd_send_headers(httpd_req_t *r, ssize_t content_length) {
+	host_httpd_aux_type *aux = r->aux;
+	char head[1024];
+
+	int n = snprintf(head, sizeof(head), "HTTP/1.1 %s\r\nContent-Type: %s\r\n", aux->status[0] ? aux->status : "200 OK", aux->type[0] ? aux->type : "text/html");
+
+	for (int i = 0; i < aux->headers && n < (int)sizeof(head); ++i) n += snprintf(head + n, sizeof(head) - n, "%s: %s\r\n", aux->fields[i], aux->values[i]);
+
+	if (n < (int)sizeof(head)) {
+		if (content_length >= 0) n += snprintf(head + n, sizeof(head) - n, "Content-Length: %zd\r\n\r\n", content_length);
+		else n += snprintf(head + n, sizeof(head) - n, "Transfer-Encoding: chunked\r\n\r\n");
+	}
+
+	if (n >= (int)sizeof(head)) return ESP_ERR_HTTPD_RESP_HDR;
+
+	aux->headers_sent = true;
+	aux->chunked = content_length < 0;
+
+	return host_httpd_send_all(aux->fd, head, (size_t)n);
+}
+
+esp_err_t httpd_resp_set_status(httpd_req_t *r, const char *status) {
+	if (!r || !status) return ESP_ERR_INVALID_ARG;
+
+	host_httpd_aux_type *aux = r->aux;
+	snprintf(aux->status, sizeof(aux->status), "%s", status);
+
+	return ESP_OK;
+}
+
+esp_err_t httpd_resp_set_type(httpd_req_t *r, const char *type) {
+	if (!r || !type) return ESP_ERR_INVALID_ARG;
+
+	host_httpd_aux_type *aux = r->aux;
+	snprintf(aux->type, sizeof(aux->type), "%s", type);
+
+	return ESP_OK;
+}
+
+esp_err_t httpd_resp_set_hdr(httpd_req_t *r, const char *field, const char *value) {
+	if (!r || !field || !value) return ESP_ERR_INVALID_ARG;
+
+	host_httpd_aux_type *aux = r->aux;
+	if (aux->headers >= aux->server->config.max_resp_headers || aux->headers >= HOST_HTTPD_HEADERS_MAX) return ESP_ERR_HTTPD_RESP_HDR;
+
+	// Pointers are kept, as in the IDF: the strings must outlive the response
+	aux->fields[aux->headers] = field;
+	aux->values[aux->headers] = value;
+	aux->headers++;
+
+	return ESP_OK;
+}
+
+esp_err_t httpd_resp_send(httpd_req_t *r, const char *buf, ssize_t buf_len) {
+	if (!r) return ESP_ERR_INVALID_ARG;
+
+	host_httpd_aux_type *aux = r->aux;
+	if (buf_len == HTTPD_RESP_USE_STRLEN) buf_len = buf ? (ssize_t)strlen(buf) : 0;
+
+	esp_err_t err = host_httpd_send_headers(r, buf_len);
+	if (err == ESP_OK && buf_len > 0) err = host_httpd_send_all(aux->fd, buf, (size_t)buf_len);
+
+	return err;
+}
+
+esp_err_t httpd_resp_send_chunk(httpd_req_t *r, const char *buf, ssize_t buf_len) {
+	if (!r) return ESP_ERR_INVALID_ARG;
+
+	host_httpd_aux_type *aux = r->aux;
+	if (buf_len == HTTPD_RESP_USE_STRLEN) buf_len = buf ? (ssize_t)strlen(buf) : 0;
+
+	if (!aux->headers_sent) {
+		esp_err_t err = host_httpd_send_headers(r, -1);
+		if (err != ESP_OK) return err;
+	}
+
+	char size[16];
+	int n = snprintf(size, sizeof(size), "%zx\r\n", buf && buf_len > 0 ? buf_len : 0);
+
+	if (host_httpd_send_all(aux->fd, size, (size_t)n) != ESP_OK) return ESP_ERR_HTTPD_RESP_SEND;
+	if (buf && buf_len > 0 && host_httpd_send_all(aux->fd, buf, (size_t)buf_len) != ESP_OK) return ESP_ERR_HTTPD_RESP_SEND;
+
+	return host_httpd_send_all(aux->fd, "\r\n", 2);
+}
+
+esp_err_t httpd_resp_send_500(httpd_req_t *r) {
+	httpd_resp_set_status(r, "500 Internal Server Error");
+	httpd_resp_set_type(r, "text/plain");
+
+	return httpd_resp_send(r, "Internal Server Error", HTTPD_RESP_USE_STRLEN);
+}
+
+////////////// Async
+
+esp_err_t httpd_req_async_handler_begin(httpd_req_t *r, httpd_req_t **out) {
+	if (!r || !out) return ESP_ERR_INVALID_ARG;
+
+	host_httpd_aux_type *aux = r->aux;
+	host_httpd_type *server = aux->server;
+
+	httpd_req_t *copy = malloc(sizeof(*copy));
+	host_httpd_aux_type *copy_aux = malloc(sizeof(*copy_aux));
+
+	if (!copy || !copy_aux) {
+		free(copy);
+		free(copy_aux);
+		return ESP_ERR_HTTPD_ALLOC_MEM;
+	}
+
+	*copy = *r;
+	*copy_aux = *aux;
+	copy->aux = copy_aux;
+
+	pthread_mutex_lock(&server->lock);
+	host_httpd_session_type *session = host_httpd_session_of(server, aux->fd);
+	if (session) session->async = true;
+	pthread_mutex_unlock(&server->lock);
+
+	*out = copy;
+
+	return ESP_OK;
+}
+
+esp_err_t httpd_req_async_handler_complete(httpd_req_t *r) {
+	if (!r) return ESP_ERR_INVALID_ARG;
+
+	host_httpd_aux_type *aux = r->aux;
+	host_httpd_type *server = aux->server;
+
+	pthread_mutex_lock(&server->lock);
+
+	host_httpd_session_type *session = host_httpd_session_of(server, aux->fd);
+
+	// Purged meanwhile: the slot is gone, only the fd is left
+	if (!session) close(aux->fd);
+	else if (session->close_pending) host_httpd_session_close(server, session);
+	else {
+		session->async = false;
+		session->last_us = host_now_us();
+	}
+
+	pthread_mutex_unlock(&server->lock);
+
+	free(aux);
+	free(r);
+
+	return ESP_OK;
+}
+
+int httpd_req_to_sockfd(httpd_req_t *r) {
+	return r ? ((host_httpd_aux_type *)r->aux)->fd : -1;
+}
+
+esp_err_t httpd_sess_trigger_close(httpd_handle_t handle, int sockfd) {
+	host_httpd_type *server = handle;
+	if (!server) return ESP_ERR_INVALID_ARG;
+
+	pthread_mutex_lock(&server->lock);
+	host_httpd_session_type *session = host_httpd_session_of(server, sockfd);
+	if (session) session->close_pending = true;
+	pthread_mutex_unlock(&server->lock);
+
+	return session ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
+
+////////////// Requests
+
+// Read one request head; false when the client went away or sent garbage
+static bool host_httpd_read_request(int fd, char *method, size_t method_size, char *uri, size_t uri_size) {
+	char buffer[HOST_HTTPD_REQUEST_MAX + 1];
+	size_t length = 0;
+
+	while (length < HOST_HTTPD_REQUEST_MAX) {
+		ssize_t n = recv(fd, buffer + length, HOST_HTTPD_REQUEST_MAX - length, 0);
+		if (n <= 0) return false;
+
+		length += (size_t)n;
+		buffer[length] = '\0';
+
+		if (strstr(buffer, "\r\n\r\n")) break;
+	}
+
+	char format[32];
+	snprintf(format, sizeof(format), "%%%zus %%%zus", method_size - 1, uri_size - 1);
+	if (sscanf(buffer, format, method, uri) != 2) return false;
+
+	// Handlers match on the path only
+	char *query = strchr(uri, '?');
+	if (query) *query = '\0';
+
+	return true;
+}
+
+static void host_httpd_serve(host_httpd_type *server, int fd) {
+	char method[8];
+	char uri[HTTPD_MAX_URI_LEN + 1];
+
+	bool ok = host_httpd_read_request(fd, method, sizeof(method), uri, sizeof(uri));
+
+	pthread_mutex_lock(&server->lock);
+	host_httpd_session_type *session = host_httpd_session_of(server, fd);
+
+	if (!ok) {
+		if (session) host_httpd_session_close(server, session);
+		pthread_mutex_unlock(&server->lock);
+		return;
+	}
+
+	session->last_us = host_now_us();
+	server->stats.requests++;
+
+	const httpd_uri_t *handler = NULL;
+	int method_id = strcmp(method, "GET") == 0 ? HTTP_GET : strcmp(method, "POST") == 0 ? HTTP_POST : strcmp(method, "HEAD") == 0 ? HTTP_HEAD : -1;
+
+	for (int i = 0; i < server->uri_count && !handler; ++i) {
+		if ((int)server->uris[i].method == method_id && strcmp(server->uris[i].uri, uri) == 0) handler = &server->uris[i];
+	}
+
+	pthread_mutex_unlock(&server->lock);
+
+	host_httpd_aux_type aux = { .server = server, .fd = fd };
+	httpd_req_t req = { .handle = server, .method = method_id, .aux = &aux };
+	snprintf(req.uri, sizeof(req.uri), "%s", uri);
+
+	esp_err_t err;
+
+	if (handler) {
+		req.user_ctx = handler->user_ctx;
+		err = handler->handler(&req);
+	}
+
+	else {
+		httpd_resp_set_status(&req, "404 Not Found");
+		err = httpd_resp_send(&req, "This URI does not exist", HTTPD_RESP_USE_STRLEN);
+	}
+
+	pthread_mutex_lock(&server->lock);
+	session = host_httpd_session_of(server, fd);
+
+	// A failed handler ends the session, as does a close asked for meanwhile; async ones close on completion
+	if (session && !session->async && (err != ESP_OK || session->close_pending)) host_httpd_session_close(server, session);
+
+	pthread_mutex_unlock(&server->lock);
+}
+
+////////////// Task
+
+static void host_httpd_task(void *arg) {
+	host_httpd_type *server = arg;
+	int max = server->config.max_open_sockets;
+
+	struct pollfd *fds = calloc((size_t)max + 1, sizeof(*fds));
+	if (!fds) abort();
+
+	while (!server->stop) {
+		int count = 0;
+
+		fds[count++] = (struct pollfd){ .fd = server->listen_fd, .events = POLLIN };
+
+		pthread_mutex_lock(&server->lock);
+
+		for (int i = 0; i < max; ++i) {
+			host_httpd_session_type *s = &server->sessions[i];
+			if (!s->used || s->async) continue;
+
+			// Closed from another task while idle
+			if (s->close_pending) {
+				host_httpd_session_close(server, s);
+				continue;
+			}
+
+			fds[count++] = (struct pollfd){ .fd = s->fd, .events = POLLIN };
+		}
+
+		pthread_mutex_unlock(&server->lock);
+
+		if (poll(fds, (nfds_t)count, HOST_HTTPD_POLL_MS) <= 0) continue;
+
+		for (int i = 1; i < count; ++i) {
+			if (fds[i].revents) host_httpd_serve(server, fds[i].fd);
+		}
+
+		if (fds[0].revents & POLLIN) host_httpd_accept(server);
+	}
+
+	free(fds);
+	server->stopped = true;
+
+	vTaskDelete(NULL);
+}
+
+////////////// API
+
+esp_err_t httpd_start(httpd_handle_t *handle, const httpd_config_t *config) {
+	if (!handle || !config || config->max_open_sockets == 0) return ESP_ERR_INVALID_ARG;
+
+	host_httpd_type *server = calloc(1, sizeof(*server));
+	if (!server) return ESP_ERR_HTTPD_ALLOC_MEM;
+
+	server->config = *config;
+	server->sessions = calloc(config->max_open_sockets, sizeof(*server->sessions));
+	pthread_mutex_init(&server->lock, NULL);
+
+	for (int i = 0; i < config->max_open_sockets && server->sessions; ++i) server->sessions[i].fd = -1;
+
+	server->listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+
+	struct sockaddr_in address = { .sin_family = AF_INET, .sin_port = htons(config->server_port), .sin_addr.s_addr = htonl(INADDR_LOOPBACK) };
+	socklen_t address_length = sizeof(address);
+	int one = 1;
+
+	if (!server->sessions || server->listen_fd < 0
+		|| setsockopt(server->listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) != 0
+		|| bind(server->listen_fd, (struct sockaddr *)&address, sizeof(address)) != 0
+		|| listen(server->listen_fd, config->backlog_conn) != 0
+		|| getsockname(server->listen_fd, (struct sockaddr *)&address, &address_length) != 0) {
+		if (server->listen_fd >= 0) close(server->listen_fd);
+		free(server->sessions);
+		free(server);
+		return ESP_ERR_HTTPD_TASK;
+	}
+
+	server->port = ntohs(address.sin_port);
+
+	host_service_task("httpd", config->task_priority, config->core_id, (uint32_t)config->stack_size, host_httpd_task, server);
+
+	*handle = server;
+
+	return ESP_OK;
+}
+
+esp_err_t httpd_stop(httpd_handle_t handle) {
+	host_httpd_type *server = handle;
+	if (!server) return ESP_ERR_INVALID_ARG;
+
+	server->stop = true;
+	while (!server->stopped) host_sleep_ms(1);
+
+	pthread_mutex_lock(&server->lock);
+	for (int i = 0; i < server->config.max_open_sockets; ++i) {
+		if (server->sessions[i].used && !server->sessions[i].async) host_httpd_session_close(server, &server->sessions[i]);
+	}
+	pthread_mutex_unlock(&server->lock);
+
+	close(server->listen_fd);
+
+	// Async requests still running keep the server struct; it is not freed
+	return ESP_OK;
+}
+
+esp_err_t httpd_register_uri_handler(httpd_handle_t handle, const httpd_uri_t *uri_handler) {
+	host_httpd_type *server = handle;
+	if (!server || !uri_handler || !uri_handler->uri || !uri_handler->handler) return ESP_ERR_INVALID_ARG;
+
+	esp_err_t err = ESP_OK;
+
+	pthread_mutex_lock(&server->lock);
+
+	for (int i = 0; i < server->uri_count && err == ESP_OK; ++i) {
+		if (server->uris[i].method == uri_handler->method && strcmp(server->uris[i].uri, uri_handler->uri) == 0) err = ESP_ERR_HTTPD_HANDLER_EXISTS;
+	}
+
+	if (err == ESP_OK && (server->uri_count >= server->config.max_uri_handlers || server->uri_count >= HOST_HTTPD_URIS_MAX)) err = ESP_ERR_HTTPD_HANDLERS_FULL;
+	if (err == ESP_OK) server->uris[server->uri_count++] = *uri_handler;
+
+	pthread_mutex_unlock(&server->lock);
+
+	return err;
+}
+
+////////////// Controls
+
+uint16_t host_httpd_port(void *handle) {
+	return handle ? ((host_httpd_type *)handle)->port : 0;
+}
+
+void host_httpd_stats(void *handle, host_httpd_stats_type *out) {
+	host_httpd_type *server = handle;
+
+	pthread_mutex_lock(&server->lock);
+	*out = server->stats;
+	pthread_mutex_unlock(&server->lock);
+}
@@ -0,0 +1,54 @@
+/*
+esp_log on the host: every write goes to stdout (or to the function from esp_log_set_vprintf)
+under one lock, so lines from different tasks never interleave mid-write.
+*/
+
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+
+#include "esp_log.h"
+
+#include "host.h"
+
+////////////// GLOBALS
+
+static pthread_mutex_t host_log_lock = PTHREAD_MUTEX_INITIALIZER;
+static vprintf_like_t host_log_vprintf = vprintf;
+
+////////////// API
+
+vprintf_like_t esp_log_set_vprintf(vprintf_like_t function) {
+	pthread_mutex_lock(&host_log_lock);
+	vprintf_like_t previous = host_log_vprintf;
+	host_log_vprintf = function ? function : vprintf;
+	pthread_mutex_unlock(&host_log_lock);
+
+	return previous;
+}
+
+void esp_log_writev(esp_log_level_t level, const char *tag, const char *format, va_list args) {
+	(void)level;
+	(void)tag;
+
+	pthread_mutex_lock(&host_log_lock);
+	host_log_vprintf(format, args);
+	if (host_log_vprintf == vprintf) fflush(stdout);
+	pthread_mutex_unlock(&host_log_lock);
+}
+
+void esp_log_write(esp_log_level_t level, const char *tag, const char *format, ...) {
+	va_list args;
+	va_start(args, format);
+	esp_log_writev(level, tag, format, args);
+	va_end(args);
+}
+
+uint32_t esp_log_timestamp(void) {
+	return (uint32_t)(host_now_us() / 1000ULL);
+}
+
+void esp_log_level_set(const char *tag, esp_log_level_t level) {
+	(void)tag;
+	(void)level;
+}
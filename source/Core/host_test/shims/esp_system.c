@@ -0,0 +1,193 @@
+/*
+Heap accounting, esp_err names, esp_random and esp_cpu for the host build.
+*/
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "esp_err.h"
+#include "esp_cpu.h"
+#include "esp_heap_caps.h"
+#include "esp_random.h"
+
+#include "host.h"
+#include "host_internal.h"
+
+////////////// GLOBALS
+
+static pthread_mutex_t host_heap_lock = PTHREAD_MUTEX_INITIALIZER;
+static size_t host_heap_total = HOST_HEAP_TOTAL;
+static size_t host_heap_in_use = 0;
+static size_t host_heap_peak = 0;
+
+// heap_caps_malloc() blocks carry their size in front
+typedef struct {
+	size_t size;
+	size_t pad;
+} host_block_type;
+
+////////////// Heap
+
+bool host_heap_take(size_t bytes) {
+	pthread_mutex_lock(&host_heap_lock);
+
+	bool ok = host_heap_in_use + bytes <= host_heap_total;
+	if (ok) {
+		host_heap_in_use += bytes;
+		if (host_heap_in_use > host_heap_peak) host_heap_peak = host_heap_in_use;
+	}
+
+	pthread_mutex_unlock(&host_heap_lock);
+
+	return ok;
+}
+
+void host_heap_give(size_t bytes) {
+	pthread_mutex_lock(&host_heap_lock);
+	host_heap_in_use = bytes > host_heap_in_use ? 0 : host_heap_in_use - bytes;
+	pthread_mutex_unlock(&host_heap_lock);
+}
+
+void host_heap_reset(size_t total) {
+	pthread_mutex_lock(&host_heap_lock);
+	host_heap_total = total;
+	host_heap_in_use = 0;
+	host_heap_peak = 0;
+	pthread_mutex_unlock(&host_heap_lock);
+}
+
+size_t host_heap_used(void) {
+	pthread_mutex_lock(&host_heap_lock);
+	size_t used = host_heap_in_use;
+	pthread_mutex_unlock(&host_heap_lock);
+
+	return used;
+}
+
+size_t heap_caps_get_free_size(uint32_t caps) {
+	(void)caps;
+
+	pthread_mutex_lock(&host_heap_lock);
+	size_t free_bytes = host_heap_total - host_heap_in_use;
+	pthread_mutex_unlock(&host_heap_lock);
+
+	return free_bytes;
+}
+
+size_t heap_caps_get_minimum_free_size(uint32_t caps) {
+	(void)caps;
+
+	pthread_mutex_lock(&host_heap_lock);
+	size_t free_bytes = host_heap_total - host_heap_peak;
+	pthread_mutex_unlock(&host_heap_lock);
+
+	return free_bytes;
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps) {
+	return heap_caps_get_free_size(caps);
+}
+
+size_t heap_caps_get_total_size(uint32_t caps) {
+	(void)caps;
+	return host_heap_total;
+}
+
+void *heap_caps_malloc(size_t size, uint32_t caps) {
+	(void)caps;
+	if (!host_heap_take(size)) return NULL;
+
+	host_block_type *block = malloc(sizeof(*block) + size);
+	if (!block) {
+		host_heap_give(size);
+		return NULL;
+	}
+
+	block->size = size;
+
+	return block + 1;
+}
+
+void *heap_caps_calloc(size_t n, size_t size, uint32_t caps) {
+	void *p = heap_caps_malloc(n * size, caps);
+	if (p) memset(p, 0, n * size);
+
+	return p;
+}
+
+void heap_caps_free(void *pointer) {
+	if (!pointer) return;
+
+	host_block_type *block = (host_block_type *)pointer - 1;
+	host_heap_give(block->size);
+	free(block);
+}
+
+size_t esp_get_free_heap_size(void) {
+	return heap_caps_get_free_size(MALLOC_CAP_DEFAULT);
+}
+
+size_t esp_get_minimum_free_heap_size(void) {
+	return heap_caps_get_minimum_free_size(MALLOC_CAP_DEFAULT);
+}
+
+////////////// esp_err
+
+const char *esp_err_to_name(esp_err_t code) {
+	switch (code) {
+		case ESP_OK: return "ESP_OK";
+		case ESP_FAIL: return "ESP_FAIL";
+		case ESP_ERR_NO_MEM: return "ESP_ERR_NO_MEM";
+		case ESP_ERR_INVALID_ARG: return "ESP_ERR_INVALID_ARG";
+		case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+		case ESP_ERR_INVALID_SIZE: return "ESP_ERR_INVALID_SIZE";
+		case ESP_ERR_NOT_FOUND: return "ESP_ERR_NOT_FOUND";
+		case ESP_ERR_NOT_SUPPORTED: return "ESP_ERR_NOT_SUPPORTED";
+		case ESP_ERR_TIMEOUT: return "ESP_ERR_TIMEOUT";
+		case ESP_ERR_INVALID_RESPONSE: return "ESP_ERR_INVALID_RESPONSE";
+		case ESP_ERR_INVALID_CRC: return "ESP_ERR_INVALID_CRC";
+		case ESP_ERR_INVALID_VERSION: return "ESP_ERR_INVALID_VERSION";
+		case ESP_ERR_NOT_FINISHED: return "ESP_ERR_NOT_FINISHED";
+		case ESP_ERR_NOT_ALLOWED: return "ESP_ERR_NOT_ALLOWED";
+		default: return "UNKNOWN ERROR";
+	}
+}
+
+////////////// esp_random
+
+uint32_t esp_random(void) {
+	static uint64_t state = 0x9E3779B97F4A7C15ULL;
+
+	// splitmix64: deterministic per run, which is what a test wants
+	uint64_t z = __atomic_add_fetch(&state, 0x9E3779B97F4A7C15ULL, __ATOMIC_RELAXED);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+
+	return (uint32_t)(z ^ (z >> 31));
+}
+
+void esp_fill_random(void *buffer, size_t length) {
+	uint8_t *p = buffer;
+
+	while (length) {
+		uint32_t r = esp_random();
+		size_t n = length < 4 ? length : 4;
+		memcpy(p, &r, n);
+		p += n;
+		length -= n;
+	}
+}
+
+////////////// esp_cpu
+
+esp_cpu_cycle_count_t esp_cpu_get_cycle_count(void) {
+	#if defined(__x86_64__) || defined(__i386__)
+	return (esp_cpu_cycle_count_t)__builtin_ia32_rdtsc();
+	#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (esp_cpu_cycle_count_t)((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+	#endif
+}
@@ -0,0 +1,202 @@
+/*
+esp_timer on the host: one "esp_timer" task fires callbacks in expiry order, one at a time,
+with the IDF's error codes for starting an armed timer or stopping an idle one.
+*/
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_timer.h"
+
+#include "host.h"
+#include "host_internal.h"
+
+////////////// DEFINES
+
+// esp_timer_create() allocates about this much on the device
+#define HOST_ESP_TIMER_BYTES 48
+
+////////////// TYPES
+
+struct host_esp_timer {
+	esp_timer_cb_t callback;
+	void *arg;
+	const char *name;
+
+	bool armed;
+	bool deleted;
+	uint64_t expiry_us;
+	uint64_t period_us;
+
+	struct host_esp_timer *next;
+};
+
+////////////// GLOBALS
+
+static pthread_mutex_t host_esp_timers_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t host_esp_timers_changed;
+static struct host_esp_timer *host_esp_timers = NULL;
+static pthread_once_t host_esp_timers_once = PTHREAD_ONCE_INIT;
+static int host_esp_timers_live = 0;
+
+////////////// Dispatcher
+
+static void host_esp_timer_task(void *arg) {
+	(void)arg;
+
+	pthread_mutex_lock(&host_esp_timers_lock);
+
+	for (;;) {
+		struct host_esp_timer *next = NULL;
+		for (struct host_esp_timer *t = host_esp_timers; t; t = t->next) {
+			if (t->armed && (!next || t->expiry_us < next->expiry_us)) next = t;
+		}
+
+		uint64_t now = host_now_us();
+
+		if (next && next->expiry_us <= now) {
+			if (next->period_us) {
+				next->expiry_us += next->period_us;
+				if (next->expiry_us <= now) next->expiry_us = now + next->period_us;
+			}
+			else next->armed = false;
+
+			esp_timer_cb_t callback = next->callback;
+			void *callback_arg = next->arg;
+
+			pthread_mutex_unlock(&host_esp_timers_lock);
+			callback(callback_arg);
+			pthread_mutex_lock(&host_esp_timers_lock);
+			continue;
+		}
+
+		struct timespec deadline;
+		if (next) host_deadline_at_us(next->expiry_us, &deadline);
+		host_cond_wait(&host_esp_timers_changed, &host_esp_timers_lock, next ? &deadline : NULL);
+	}
+}
+
+static void host_esp_timer_start_task(void) {
+	host_cond_init(&host_esp_timers_changed);
+	host_service_task("esp_timer", 22, 0, 3584, host_esp_timer_task, NULL);
+}
+
+////////////// API
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *out_handle) {
+	if (!args || !args->callback || !out_handle) return ESP_ERR_INVALID_ARG;
+	if (!host_heap_take(HOST_ESP_TIMER_BYTES)) return ESP_ERR_NO_MEM;
+
+	pthread_once(&host_esp_timers_once, host_esp_timer_start_task);
+
+	struct host_esp_timer *t = calloc(1, sizeof(*t));
+	if (!t) abort();
+
+	t->callback = args->callback;
+	t->arg = args->arg;
+	t->name = args->name;
+
+	pthread_mutex_lock(&host_esp_timers_lock);
+	t->next = host_esp_timers;
+	host_esp_timers = t;
+	host_esp_timers_live++;
+	pthread_mutex_unlock(&host_esp_timers_lock);
+
+	*out_handle = t;
+
+	return ESP_OK;
+}
+
+static esp_err_t host_esp_timer_arm(esp_timer_handle_t timer, uint64_t timeout_us, uint64_t period_us, bool restart) {
+	if (!timer) return ESP_ERR_INVALID_ARG;
+
+	pthread_mutex_lock(&host_esp_timers_lock);
+
+	if (timer->deleted || timer->armed != restart) {
+		pthread_mutex_unlock(&host_esp_timers_lock);
+		return ESP_ERR_INVALID_STATE;
+	}
+
+	timer->armed = true;
+	timer->expiry_us = host_now_us() + timeout_us;
+	if (!restart || timer->period_us) timer->period_us = period_us;
+
+	pthread_cond_broadcast(&host_esp_timers_changed);
+	pthread_mutex_unlock(&host_esp_timers_lock);
+
+	return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us) {
+	return host_esp_timer_arm(timer, timeout_us, 0, false);
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period_us) {
+	return host_esp_timer_arm(timer, period_us, period_us, false);
+}
+
+esp_err_t esp_timer_restart(esp_timer_handle_t timer, uint64_t timeout_us) {
+	return host_esp_timer_arm(timer, timeout_us, timeout_us, true);
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+	if (!timer) return ESP_ERR_INVALID_ARG;
+
+	pthread_mutex_lock(&host_esp_timers_lock);
+
+	esp_err_t rc = timer->armed ? ESP_OK : ESP_ERR_INVALID_STATE;
+	timer->armed = false;
+
+	pthread_mutex_unlock(&host_esp_timers_lock);
+
+	return rc;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer) {
+	if (!timer) return ESP_ERR_INVALID_ARG;
+
+	pthread_mutex_lock(&host_esp_timers_lock);
+
+	if (timer->armed || timer->deleted) {
+		pthread_mutex_unlock(&host_esp_timers_lock);
+		return ESP_ERR_INVALID_STATE;
+	}
+
+	// Unlinked, but the memory stays (a stale handle then fails instead of crashing)
+	for (struct host_esp_timer **p = &host_esp_timers; *p; p = &(*p)->next) {
+		if (*p == timer) {
+			*p = timer->next;
+			break;
+		}
+	}
+
+	timer->deleted = true;
+	host_esp_timers_live--;
+
+	pthread_mutex_unlock(&host_esp_timers_lock);
+
+	host_heap_give(HOST_ESP_TIMER_BYTES);
+
+	return ESP_OK;
+}
+
+bool esp_timer_is_active(esp_timer_handle_t timer) {
+	pthread_mutex_lock(&host_esp_timers_lock);
+	bool armed = timer && timer->armed;
+	pthread_mutex_unlock(&host_esp_timers_lock);
+
+	return armed;
+}
+
+int64_t esp_timer_get_time(void) {
+	return (int64_t)host_now_us();
+}
+
+int host_esp_timer_count(void) {
+	pthread_mutex_lock(&host_esp_timers_lock);
+	int n = host_esp_timers_live;
+	pthread_mutex_unlock(&host_esp_timers_lock);
+
+	return n;
+}
@@ -0,0 +1,1126 @@
+/*
+FreeRTOS tasks, queues, semaphores, event groups and software timers on POSIX threads.
+
+Every task runs on its own mmap'd stack (guard page below, painted with HOST_STACK_PAINT) so the
+high-water mark is measured the same way FreeRTOS does it. Host code needs more stack than the
+Xtensa build, so each stack gets HOST_STACK_EXTRA on top of what was asked for; the mark
+reported is "requested − host bytes used", floored at 0, i.e. pessimistic.
+*/
+
+#include <errno.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+#include "freertos/timers.h"
+
+#include "esp_cpu.h"
+
+#include "host.h"
+#include "host_internal.h"
+
+////////////// DEFINES
+
+#define HOST_TASKS_MAX 96
+
+#define HOST_STACK_EXTRA (256 * 1024)
+#define HOST_STACK_PAINT 0xA5
+
+// What the device takes from the heap per object, on top of the payload (IDF 5.x, ESP32, approximate)
+#define HOST_TCB_BYTES 352
+#define HOST_QUEUE_BYTES 84
+#define HOST_EVENT_GROUP_BYTES 32
+#define HOST_TIMER_BYTES 44
+
+#define HOST_TIMER_QUEUE_LENGTH 10
+
+////////////// TYPES
+
+struct host_task {
+	char name[configMAX_TASK_NAME_LEN];
+	TaskFunction_t function;
+	void *arg;
+	UBaseType_t priority;
+	BaseType_t core;
+	uint32_t stack_bytes;
+	UBaseType_t number;
+
+	bool has_thread;
+	pthread_t thread;
+
+	// Painted stack (NULL for adopted threads and placeholders)
+	uint8_t *stack_low;
+	volatile uintptr_t stack_entry;
+
+	// Placeholder IDLE task of this core, -1 otherwise
+	int idle_core;
+
+	size_t charged;
+
+	pthread_mutex_t notify_lock;
+	pthread_cond_t notify_cond;
+	uint32_t notify_value;
+	bool notify_pending;
+};
+
+struct host_queue {
+	pthread_mutex_t lock;
+	pthread_cond_t not_empty;
+	pthread_cond_t not_full;
+
+	UBaseType_t length;
+	UBaseType_t item_size;
+	UBaseType_t count;
+	UBaseType_t head;
+	uint8_t *storage;
+
+	size_t charged;
+};
+
+struct host_event_group {
+	pthread_mutex_t lock;
+	pthread_cond_t changed;
+	EventBits_t bits;
+	size_t charged;
+};
+
+struct host_timer {
+	char name[configMAX_TASK_NAME_LEN];
+	TickType_t period;
+	bool auto_reload;
+	void *id;
+	TimerCallbackFunction_t callback;
+
+	bool active;
+	bool deleted;
+	uint64_t expiry_us;
+	size_t charged;
+
+	struct host_timer *next;
+};
+
+////////////// GLOBALS
+
+static uint64_t host_start_us = 0;
+static long host_page = 4096;
+
+static pthread_mutex_t host_tasks_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct host_task *host_tasks[HOST_TASKS_MAX];
+static int host_tasks_count = 0;
+static UBaseType_t host_task_numbers = 0;
+
+static __thread struct host_task *host_self = NULL;
+
+static uint64_t host_copies = 0;
+static uint64_t host_copied_bytes = 0;
+
+static pthread_mutex_t host_timers_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t host_timers_changed;
+static struct host_timer *host_timers = NULL;
+static pthread_once_t host_timers_once = PTHREAD_ONCE_INIT;
+
+static struct {
+	PendedFunction_t function;
+	void *parameter1;
+	uint32_t parameter2;
+} host_pended[HOST_TIMER_QUEUE_LENGTH];
+static int host_pended_head = 0;
+static int host_pended_count = 0;
+
+////////////// Time and waiting
+
+static uint64_t host_monotonic_us(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL;
+}
+
+uint64_t host_now_us(void) {
+	return host_monotonic_us() - host_start_us;
+}
+
+void host_deadline_at_us(uint64_t at_us, struct timespec *out) {
+	uint64_t absolute = at_us + host_start_us;
+	out->tv_sec = (time_t)(absolute / 1000000ULL);
+	out->tv_nsec = (long)(absolute % 1000000ULL) * 1000L;
+}
+
+bool host_deadline_ticks(TickType_t ticks, struct timespec *out) {
+	if (ticks == portMAX_DELAY) return false;
+	host_deadline_at_us(host_now_us() + (uint64_t)ticks * (1000000ULL / configTICK_RATE_HZ), out);
+	return true;
+}
+
+static void host_sleep_until_us(uint64_t at_us) {
+	struct timespec ts;
+	host_deadline_at_us(at_us, &ts);
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) { }
+}
+
+void host_sleep_ms(uint32_t ms) {
+	host_sleep_until_us(host_now_us() + (uint64_t)ms * 1000ULL);
+}
+
+void host_cond_init(pthread_cond_t *cond) {
+	pthread_condattr_t attr;
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(cond, &attr);
+	pthread_condattr_destroy(&attr);
+}
+
+static void host_unlock(void *mutex) {
+	pthread_mutex_unlock((pthread_mutex_t *)mutex);
+}
+
+int host_cond_wait(pthread_cond_t *cond, pthread_mutex_t *mutex, const struct timespec *deadline) {
+	int rc;
+
+	pthread_cleanup_push(host_unlock, mutex);
+	rc = deadline ? pthread_cond_timedwait(cond, mutex, deadline) : pthread_cond_wait(cond, mutex);
+	pthread_cleanup_pop(0);
+
+	return rc;
+}
+
+void host_critical_enter(portMUX_TYPE *mux) {
+	pthread_mutex_lock(mux);
+}
+
+void host_critical_exit(portMUX_TYPE *mux) {
+	pthread_mutex_unlock(mux);
+}
+
+////////////// Task registry
+
+static struct host_task *host_task_new(const char *name, UBaseType_t priority, BaseType_t core, uint32_t stack_bytes) {
+	struct host_task *t = calloc(1, sizeof(*t));
+	if (!t) abort();
+
+	snprintf(t->name, sizeof(t->name), "%s", name ? name : "");
+	t->priority = priority;
+	t->core = core;
+	t->stack_bytes = stack_bytes;
+	t->idle_core = -1;
+
+	pthread_mutex_init(&t->notify_lock, NULL);
+	host_cond_init(&t->notify_cond);
+
+	return t;
+}
+
+// Caller holds host_tasks_lock
+static void host_task_register(struct host_task *t) {
+	if (host_tasks_count == HOST_TASKS_MAX) {
+		fprintf(stderr, "host: more than %d tasks\n", HOST_TASKS_MAX);
+		abort();
+	}
+
+	t->number = ++host_task_numbers;
+	host_tasks[host_tasks_count++] = t;
+}
+
+static bool host_task_unregister(struct host_task *t) {
+	pthread_mutex_lock(&host_tasks_lock);
+
+	bool found = false;
+	for (int i = 0; i < host_tasks_count; ++i) {
+		if (host_tasks[i] == t) {
+			host_tasks[i] = host_tasks[--host_tasks_count];
+			found = true;
+			break;
+		}
+	}
+
+	pthread_mutex_unlock(&host_tasks_lock);
+
+	return found;
+}
+
+// The calling thread as a task; threads the shims did not create are adopted on first use
+static struct host_task *host_task_self(void) {
+	if (host_self) return host_self;
+
+	bool main_thread = syscall(SYS_gettid) == getpid();
+	struct host_task *t = host_task_new(main_thread ? "main" : "pthread", 1, main_thread ? 0 : tskNO_AFFINITY, main_thread ? 3584 : 4096);
+
+	t->has_thread = true;
+	t->thread = pthread_self();
+
+	pthread_mutex_lock(&host_tasks_lock);
+	host_task_register(t);
+	pthread_mutex_unlock(&host_tasks_lock);
+
+	host_self = t;
+
+	return t;
+}
+
+static void *host_task_entry(void *p) {
+	struct host_task *t = (struct host_task *)p;
+	volatile uint8_t marker = 0;
+
+	host_self = t;
+	t->stack_entry = (uintptr_t)&marker;
+
+	t->function(t->arg);
+
+	// Same as the IDF port: returning from a task function is a bug
+	fprintf(stderr, "host: task %s returned from its function\n", t->name);
+	abort();
+
+	return NULL;
+}
+
+static BaseType_t host_task_spawn(struct host_task *t, TaskFunction_t function, void *arg, TaskHandle_t *out_handle) {
+	t->function = function;
+	t->arg = arg;
+
+	size_t bytes = ((size_t)t->stack_bytes + HOST_STACK_EXTRA + (size_t)host_page - 1) / (size_t)host_page * (size_t)host_page;
+	uint8_t *map = mmap(NULL, bytes + (size_t)host_page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+	if (map == MAP_FAILED) return errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY;
+
+	mprotect(map, (size_t)host_page, PROT_NONE);
+	t->stack_low = map + host_page;
+	memset(t->stack_low, HOST_STACK_PAINT, bytes);
+
+	pthread_attr_t attr;
+	pthread_attr_init(&attr);
+	pthread_attr_setstack(&attr, t->stack_low, bytes);
+	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+	// Handle is out before the task runs, as with FreeRTOS
+	if (out_handle) *out_handle = t;
+
+	// Registered under the lock so a task deleting itself at once cannot race its own registration
+	pthread_mutex_lock(&host_tasks_lock);
+	int rc = pthread_create(&t->thread, &attr, host_task_entry, t);
+	if (rc == 0) {
+		t->has_thread = true;
+		host_task_register(t);
+	}
+	pthread_mutex_unlock(&host_tasks_lock);
+
+	pthread_attr_destroy(&attr);
+
+	if (rc != 0) {
+		if (out_handle) *out_handle = NULL;
+		return errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY;
+	}
+
+	return pdPASS;
+}
+
+TaskHandle_t host_service_task(const char *name, UBaseType_t priority, BaseType_t core, uint32_t stack_bytes, TaskFunction_t function, void *arg) {
+	struct host_task *t = host_task_new(name, priority, core, stack_bytes);
+	TaskHandle_t handle = NULL;
+
+	if (host_task_spawn(t, function, arg, &handle) != pdPASS) abort();
+
+	return handle;
+}
+
+TaskHandle_t host_task_placeholder(const char *name, UBaseType_t priority, BaseType_t core, uint32_t stack_bytes) {
+	struct host_task *t = host_task_new(name, priority, core, stack_bytes);
+
+	if (strncmp(name, "IDLE", 4) == 0 && core >= 0 && core < portNUM_PROCESSORS) t->idle_core = (int)core;
+
+	pthread_mutex_lock(&host_tasks_lock);
+	host_task_register(t);
+	pthread_mutex_unlock(&host_tasks_lock);
+
+	return t;
+}
+
+TaskHandle_t host_task_find(const char *name) {
+	TaskHandle_t found = NULL;
+
+	pthread_mutex_lock(&host_tasks_lock);
+	for (int i = 0; i < host_tasks_count && !found; ++i) {
+		if (strcmp(host_tasks[i]->name, name) == 0) found = host_tasks[i];
+	}
+	pthread_mutex_unlock(&host_tasks_lock);
+
+	return found;
+}
+
+// Caller holds host_tasks_lock (the thread is still alive while it is registered)
+static uint64_t host_thread_cpu_us(const struct host_task *t) {
+	if (!t->has_thread) return 0;
+
+	clockid_t clock;
+	struct timespec ts;
+
+	if (pthread_getcpuclockid(t->thread, &clock) != 0 || clock_gettime(clock, &ts) != 0) return 0;
+
+	return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL;
+}
+
+uint64_t host_task_cpu_us(TaskHandle_t task) {
+	pthread_mutex_lock(&host_tasks_lock);
+	uint64_t us = host_thread_cpu_us(task);
+	pthread_mutex_unlock(&host_tasks_lock);
+
+	return us;
+}
+
+static uint32_t host_stack_high_water(const struct host_task *t) {
+	if (!t->stack_low || !t->stack_entry) return t->stack_bytes;
+
+	const volatile uint8_t *p = t->stack_low;
+	const volatile uint8_t *entry = (const volatile uint8_t *)t->stack_entry;
+
+	while (p < entry && *p == HOST_STACK_PAINT) p++;
+
+	uint32_t used = (uint32_t)(entry - p);
+
+	return used < t->stack_bytes ? t->stack_bytes - used : 0;
+}
+
+__attribute__((constructor)) static void host_boot(void) {
+	host_start_us = host_monotonic_us();
+	host_page = sysconf(_SC_PAGESIZE);
+	host_cond_init(&host_timers_changed);
+
+	// lwIP reports a write to a closed socket as an error, never as a signal
+	signal(SIGPIPE, SIG_IGN);
+
+	// Tasks every ESP32 app has before app_main runs
+	host_task_placeholder("IDLE0", 0, 0, 1536);
+	host_task_placeholder("IDLE1", 0, 1, 1536);
+	host_task_placeholder("ipc0", 24, 0, 1024);
+	host_task_placeholder("ipc1", 24, 1, 1024);
+	host_task_self();
+}
+
+////////////// Tasks
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char *name, uint32_t stack_bytes, void *arg, UBaseType_t priority, TaskHandle_t *out_handle, BaseType_t core) {
+	size_t cost = (size_t)stack_bytes + HOST_TCB_BYTES;
+	if (!host_heap_take(cost)) return errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY;
+
+	struct host_task *t = host_task_new(name, priority, core, stack_bytes);
+	t->charged = cost;
+
+	BaseType_t rc = host_task_spawn(t, function, arg, out_handle);
+	if (rc != pdPASS) host_heap_give(cost);
+
+	return rc;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t function, const char *name, uint32_t stack_bytes, void *arg, UBaseType_t priority, TaskHandle_t *out_handle) {
+	return xTaskCreatePinnedToCore(function, name, stack_bytes, arg, priority, out_handle, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+	struct host_task *t = task ? task : host_task_self();
+
+	if (host_task_unregister(t)) {
+		host_heap_give(t->charged);
+		t->charged = 0;
+	}
+
+	if (t == host_self) pthread_exit(NULL);
+	if (t->has_thread) pthread_cancel(t->thread);
+}
+
+void vTaskDelay(TickType_t ticks) {
+	if (ticks == 0) {
+		sched_yield();
+		return;
+	}
+
+	host_sleep_until_us(host_now_us() + (uint64_t)ticks * (1000000ULL / configTICK_RATE_HZ));
+}
+
+BaseType_t xTaskDelayUntil(TickType_t *previous_wake, TickType_t increment) {
+	TickType_t wake = *previous_wake + increment;
+	TickType_t now = xTaskGetTickCount();
+
+	*previous_wake = wake;
+
+	if ((int32_t)(wake - now) <= 0) return pdFALSE;
+
+	host_sleep_until_us((uint64_t)wake * (1000000ULL / configTICK_RATE_HZ));
+
+	return pdTRUE;
+}
+
+TickType_t xTaskGetTickCount(void) {
+	return (TickType_t)(host_now_us() / (1000000ULL / configTICK_RATE_HZ));
+}
+
+TickType_t xTaskGetTickCountFromISR(void) {
+	return xTaskGetTickCount();
+}
+
+int esp_cpu_get_core_id(void) {
+	const struct host_task *t = host_self;
+	return (t && t->core >= 0 && t->core < portNUM_PROCESSORS) ? (int)t->core : 0;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+	return host_task_self();
+}
+
+char *pcTaskGetName(TaskHandle_t task) {
+	return (task ? task : host_task_self())->name;
+}
+
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task) {
+	return (task ? task : host_task_self())->priority;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+	return host_stack_high_water(task ? task : host_task_self());
+}
+
+UBaseType_t uxTaskGetNumberOfTasks(void) {
+	pthread_mutex_lock(&host_tasks_lock);
+	UBaseType_t n = (UBaseType_t)host_tasks_count;
+	pthread_mutex_unlock(&host_tasks_lock);
+
+	return n;
+}
+
+UBaseType_t uxTaskGetSystemState(TaskStatus_t *array, UBaseType_t array_size, configRUN_TIME_COUNTER_TYPE *total_run_time) {
+	pthread_mutex_lock(&host_tasks_lock);
+
+	UBaseType_t n = (UBaseType_t)host_tasks_count;
+	if (array_size < n) {
+		pthread_mutex_unlock(&host_tasks_lock);
+		return 0;
+	}
+
+	uint64_t now = host_now_us();
+	uint64_t busy[portNUM_PROCESSORS] = { 0 };
+
+	for (UBaseType_t i = 0; i < n; ++i) {
+		const struct host_task *t = host_tasks[i];
+		uint64_t cpu = host_thread_cpu_us(t);
+
+		array[i] = (TaskStatus_t){
+			.xHandle = (TaskHandle_t)t,
+			.pcTaskName = t->name,
+			.xTaskNumber = t->number,
+			.eCurrentState = t == host_self ? eRunning : eBlocked,
+			.uxCurrentPriority = t->priority,
+			.uxBasePriority = t->priority,
+			.ulRunTimeCounter = (configRUN_TIME_COUNTER_TYPE)cpu,
+			.pxStackBase = (StackType_t *)t->stack_low,
+			.usStackHighWaterMark = host_stack_high_water(t),
+			.xCoreID = t->core
+		};
+
+		// Unpinned work is split between the cores
+		if (t->core >= 0 && t->core < portNUM_PROCESSORS) busy[t->core] += cpu;
+		else for (int core = 0; core < portNUM_PROCESSORS; ++core) busy[core] += cpu / portNUM_PROCESSORS;
+	}
+
+	// Idle time is whatever the simulated tasks left of each core
+	for (UBaseType_t i = 0; i < n; ++i) {
+		int core = host_tasks[i]->idle_core;
+		if (core >= 0) array[i].ulRunTimeCounter = (configRUN_TIME_COUNTER_TYPE)(now > busy[core] ? now - busy[core] : 0);
+	}
+
+	pthread_mutex_unlock(&host_tasks_lock);
+
+	if (total_run_time) *total_run_time = (configRUN_TIME_COUNTER_TYPE)now;
+
+	return n;
+}
+
+////////////// Notifications
+
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action) {
+	struct host_task *t = task;
+	BaseType_t rc = pdPASS;
+
+	pthread_mutex_lock(&t->notify_lock);
+
+	switch (action) {
+		case eSetBits: t->notify_value |= value; break;
+		case eIncrement: t->notify_value++; break;
+		case eSetValueWithOverwrite: t->notify_value = value; break;
+		case eSetValueWithoutOverwrite:
+			if (t->notify_pending) rc = pdFAIL;
+			else t->notify_value = value;
+			break;
+		case eNoAction: break;
+	}
+
+	t->notify_pending = true;
+	pthread_cond_broadcast(&t->notify_cond);
+	pthread_mutex_unlock(&t->notify_lock);
+
+	return rc;
+}
+
+BaseType_t xTaskNotifyFromISR(TaskHandle_t task, uint32_t value, eNotifyAction action, BaseType_t *higher_priority_woken) {
+	if (higher_priority_woken) *higher_priority_woken = pdFALSE;
+	return xTaskNotify(task, value, action);
+}
+
+BaseType_t xTaskNotifyWait(uint32_t clear_on_entry, uint32_t clear_on_exit, uint32_t *value, TickType_t ticks) {
+	struct host_task *t = host_task_self();
+	struct timespec deadline;
+	bool timed = host_deadline_ticks(ticks, &deadline);
+	BaseType_t rc = pdFALSE;
+
+	pthread_mutex_lock(&t->notify_lock);
+
+	if (!t->notify_pending) t->notify_value &= ~clear_on_entry;
+
+	while (!t->notify_pending && ticks != 0) {
+		if (host_cond_wait(&t->notify_cond, &t->notify_lock, timed ? &deadline : NULL) == ETIMEDOUT) break;
+	}
+
+	if (value) *value = t->notify_value;
+
+	if (t->notify_pending) {
+		t->notify_value &= ~clear_on_exit;
+		t->notify_pending = false;
+		rc = pdTRUE;
+	}
+
+	pthread_mutex_unlock(&t->notify_lock);
+
+	return rc;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks) {
+	struct host_task *t = host_task_self();
+	struct timespec deadline;
+	bool timed = host_deadline_ticks(ticks, &deadline);
+
+	pthread_mutex_lock(&t->notify_lock);
+
+	while (t->notify_value == 0 && ticks != 0) {
+		if (host_cond_wait(&t->notify_cond, &t->notify_lock, timed ? &deadline : NULL) == ETIMEDOUT) break;
+	}
+
+	uint32_t value = t->notify_value;
+	if (value) t->notify_value = clear_on_exit ? 0 : value - 1;
+	t->notify_pending = false;
+
+	pthread_mutex_unlock(&t->notify_lock);
+
+	return value;
+}
+
+////////////// Queues and semaphores
+
+void host_queue_stats(uint64_t *copies, uint64_t *bytes) {
+	if (copies) *copies = __atomic_load_n(&host_copies, __ATOMIC_RELAXED);
+	if (bytes) *bytes = __atomic_load_n(&host_copied_bytes, __ATOMIC_RELAXED);
+}
+
+void host_queue_stats_reset(void) {
+	__atomic_store_n(&host_copies, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&host_copied_bytes, 0, __ATOMIC_RELAXED);
+}
+
+static void host_count_copy(UBaseType_t bytes) {
+	if (!bytes) return;
+
+	__atomic_fetch_add(&host_copies, 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&host_copied_bytes, bytes, __ATOMIC_RELAXED);
+}
+
+static struct host_queue *host_queue_new(UBaseType_t length, UBaseType_t item_size, UBaseType_t initial, bool charge) {
+	size_t cost = charge ? HOST_QUEUE_BYTES + (size_t)length * item_size : 0;
+	if (cost && !host_heap_take(cost)) return NULL;
+
+	struct host_queue *q = calloc(1, sizeof(*q));
+	if (!q) abort();
+
+	pthread_mutex_init(&q->lock, NULL);
+	host_cond_init(&q->not_empty);
+	host_cond_init(&q->not_full);
+
+	q->length = length;
+	q->item_size = item_size;
+	q->count = initial;
+	q->charged = cost;
+
+	if (item_size) {
+		q->storage = calloc(length, item_size);
+		if (!q->storage) abort();
+	}
+
+	return q;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size) {
+	if (length == 0) return NULL;
+	return host_queue_new(length, item_size, 0, true);
+}
+
+QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t item_size, uint8_t *storage, StaticQueue_t *buffer) {
+	(void)storage;
+	if (length == 0 || !buffer) return NULL;
+
+	struct host_queue *q = host_queue_new(length, item_size, 0, false);
+	buffer->host = q;
+
+	return q;
+}
+
+void vQueueDelete(QueueHandle_t queue) {
+	if (!queue) return;
+
+	// The memory stays: a task still blocked on it would otherwise touch freed memory
+	host_heap_give(queue->charged);
+	queue->charged = 0;
+}
+
+static BaseType_t host_queue_put(struct host_queue *q, const void *item, TickType_t ticks, int where) {
+	struct timespec deadline;
+	bool timed = host_deadline_ticks(ticks, &deadline);
+
+	pthread_mutex_lock(&q->lock);
+
+	// where: 0 back, 1 front, 2 overwrite (length 1)
+	while (q->count == q->length && where != 2) {
+		if (ticks == 0 || host_cond_wait(&q->not_full, &q->lock, timed ? &deadline : NULL) == ETIMEDOUT) {
+			pthread_mutex_unlock(&q->lock);
+			return errQUEUE_FULL;
+		}
+	}
+
+	if (q->item_size) {
+		UBaseType_t slot;
+
+		if (where == 2 && q->count == q->length) slot = q->head;
+		else if (where == 1) {
+			q->head = (q->head + q->length - 1) % q->length;
+			slot = q->head;
+		}
+		else slot = (q->head + q->count) % q->length;
+
+		memcpy(q->storage + (size_t)slot * q->item_size, item, q->item_size);
+		host_count_copy(q->item_size);
+	}
+
+	if (q->count < q->length) q->count++;
+
+	pthread_cond_signal(&q->not_empty);
+	pthread_mutex_unlock(&q->lock);
+
+	return pdPASS;
+}
+
+static BaseType_t host_queue_get(struct host_queue *q, void *item, TickType_t ticks, bool peek) {
+	struct timespec deadline;
+	bool timed = host_deadline_ticks(ticks, &deadline);
+
+	pthread_mutex_lock(&q->lock);
+
+	while (q->count == 0) {
+		if (ticks == 0 || host_cond_wait(&q->not_empty, &q->lock, timed ? &deadline : NULL) == ETIMEDOUT) {
+			pthread_mutex_unlock(&q->lock);
+			return errQUEUE_EMPTY;
+		}
+	}
+
+	if (q->item_size) {
+		if (item) memcpy(item, q->storage + (size_t)q->head * q->item_size, q->item_size);
+		host_count_copy(q->item_size);
+	}
+
+	if (!peek) {
+		if (q->item_size) q->head = (q->head + 1) % q->length;
+		q->count--;
+		pthread_cond_signal(&q->not_full);
+	}
+
+	pthread_mutex_unlock(&q->lock);
+
+	return pdPASS;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks) {
+	return host_queue_put(queue, item, ticks, 0);
+}
+
+BaseType_t xQueueSendToFront(QueueHandle_t queue, const void *item, TickType_t ticks) {
+	return host_queue_put(queue, item, ticks, 1);
+}
+
+BaseType_t xQueueOverwrite(QueueHandle_t queue, const void *item) {
+	return host_queue_put(queue, item, 0, 2);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks) {
+	return host_queue_get(queue, item, ticks, false);
+}
+
+BaseType_t xQueuePeek(QueueHandle_t queue, void *item, TickType_t ticks) {
+	return host_queue_get(queue, item, ticks, true);
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue) {
+	pthread_mutex_lock(&queue->lock);
+	queue->count = 0;
+	queue->head = 0;
+	pthread_cond_broadcast(&queue->not_full);
+	pthread_mutex_unlock(&queue->lock);
+
+	return pdPASS;
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void *item, BaseType_t *higher_priority_woken) {
+	if (higher_priority_woken) *higher_priority_woken = pdFALSE;
+	return host_queue_put(queue, item, 0, 0);
+}
+
+BaseType_t xQueueReceiveFromISR(QueueHandle_t queue, void *item, BaseType_t *higher_priority_woken) {
+	if (higher_priority_woken) *higher_priority_woken = pdFALSE;
+	return host_queue_get(queue, item, 0, false);
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+	pthread_mutex_lock(&queue->lock);
+	UBaseType_t n = queue->count;
+	pthread_mutex_unlock(&queue->lock);
+
+	return n;
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue) {
+	pthread_mutex_lock(&queue->lock);
+	UBaseType_t n = queue->length - queue->count;
+	pthread_mutex_unlock(&queue->lock);
+
+	return n;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+	return host_queue_new(1, 0, 1, true);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t *buffer) {
+	struct host_queue *q = host_queue_new(1, 0, 1, false);
+	buffer->host = q;
+
+	return q;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void) {
+	return host_queue_new(1, 0, 0, true);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinaryStatic(StaticSemaphore_t *buffer) {
+	struct host_queue *q = host_queue_new(1, 0, 0, false);
+	buffer->host = q;
+
+	return q;
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max, UBaseType_t initial) {
+	return host_queue_new(max, 0, initial, true);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks) {
+	return host_queue_get(semaphore, NULL, ticks, false);
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+	return host_queue_put(semaphore, NULL, 0, 0);
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t semaphore, BaseType_t *higher_priority_woken) {
+	return xQueueSendFromISR(semaphore, NULL, higher_priority_woken);
+}
+
+BaseType_t xSemaphoreTakeFromISR(SemaphoreHandle_t semaphore, BaseType_t *higher_priority_woken) {
+	return xQueueReceiveFromISR(semaphore, NULL, higher_priority_woken);
+}
+
+////////////// Event groups
+
+static struct host_event_group *host_event_group_new(bool charge) {
+	if (charge && !host_heap_take(HOST_EVENT_GROUP_BYTES)) return NULL;
+
+	struct host_event_group *g = calloc(1, sizeof(*g));
+	if (!g) abort();
+
+	pthread_mutex_init(&g->lock, NULL);
+	host_cond_init(&g->changed);
+	g->charged = charge ? HOST_EVENT_GROUP_BYTES : 0;
+
+	return g;
+}
+
+EventGroupHandle_t xEventGroupCreate(void) {
+	return host_event_group_new(true);
+}
+
+EventGroupHandle_t xEventGroupCreateStatic(StaticEventGroup_t *buffer) {
+	struct host_event_group *g = host_event_group_new(false);
+	buffer->host = g;
+
+	return g;
+}
+
+void vEventGroupDelete(EventGroupHandle_t group) {
+	if (!group) return;
+
+	host_heap_give(group->charged);
+	group->charged = 0;
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits) {
+	pthread_mutex_lock(&group->lock);
+	group->bits |= bits;
+	EventBits_t now = group->bits;
+	pthread_cond_broadcast(&group->changed);
+	pthread_mutex_unlock(&group->lock);
+
+	return now;
+}
+
+BaseType_t xEventGroupSetBitsFromISR(EventGroupHandle_t group, EventBits_t bits, BaseType_t *higher_priority_woken) {
+	if (higher_priority_woken) *higher_priority_woken = pdFALSE;
+	xEventGroupSetBits(group, bits);
+
+	return pdPASS;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits) {
+	pthread_mutex_lock(&group->lock);
+	EventBits_t before = group->bits;
+	group->bits &= ~bits;
+	pthread_mutex_unlock(&group->lock);
+
+	return before;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group) {
+	pthread_mutex_lock(&group->lock);
+	EventBits_t bits = group->bits;
+	pthread_mutex_unlock(&group->lock);
+
+	return bits;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clear_on_exit, BaseType_t wait_for_all, TickType_t ticks) {
+	struct timespec deadline;
+	bool timed = host_deadline_ticks(ticks, &deadline);
+
+	pthread_mutex_lock(&group->lock);
+
+	for (;;) {
+		EventBits_t have = group->bits & bits;
+		bool satisfied = wait_for_all ? have == bits : have != 0;
+
+		if (satisfied) {
+			EventBits_t result = group->bits;
+			if (clear_on_exit) group->bits &= ~bits;
+			pthread_mutex_unlock(&group->lock);
+			return result;
+		}
+
+		if (ticks == 0 || host_cond_wait(&group->changed, &group->lock, timed ? &deadline : NULL) == ETIMEDOUT) break;
+	}
+
+	EventBits_t result = group->bits;
+	pthread_mutex_unlock(&group->lock);
+
+	return result;
+}
+
+////////////// Software timers (one daemon task, like "Tmr Svc")
+
+static void host_timer_daemon(void *arg) {
+	(void)arg;
+
+	pthread_mutex_lock(&host_timers_lock);
+
+	for (;;) {
+		if (host_pended_count) {
+			PendedFunction_t function = host_pended[host_pended_head].function;
+			void *parameter1 = host_pended[host_pended_head].parameter1;
+			uint32_t parameter2 = host_pended[host_pended_head].parameter2;
+
+			host_pended_head = (host_pended_head + 1) % HOST_TIMER_QUEUE_LENGTH;
+			host_pended_count--;
+
+			pthread_mutex_unlock(&host_timers_lock);
+			function(parameter1, parameter2);
+			pthread_mutex_lock(&host_timers_lock);
+			continue;
+		}
+
+		struct host_timer *next = NULL;
+		for (struct host_timer *t = host_timers; t; t = t->next) {
+			if (t->active && (!next || t->expiry_us < next->expiry_us)) next = t;
+		}
+
+		uint64_t now = host_now_us();
+
+		if (next && next->expiry_us <= now) {
+			uint64_t period_us = (uint64_t)next->period * (1000000ULL / configTICK_RATE_HZ);
+
+			if (next->auto_reload) {
+				next->expiry_us += period_us;
+				if (next->expiry_us <= now) next->expiry_us = now + period_us;
+			}
+			else next->active = false;
+
+			TimerCallbackFunction_t callback = next->callback;
+
+			pthread_mutex_unlock(&host_timers_lock);
+			callback(next);
+			pthread_mutex_lock(&host_timers_lock);
+			continue;
+		}
+
+		struct timespec deadline;
+		if (next) host_deadline_at_us(next->expiry_us, &deadline);
+		host_cond_wait(&host_timers_changed, &host_timers_lock, next ? &deadline : NULL);
+	}
+}
+
+static void host_timer_daemon_start(void) {
+	host_service_task("Tmr Svc", 1, 0, 2048, host_timer_daemon, NULL);
+}
+
+static struct host_timer *host_timer_new(const char *name, TickType_t period, UBaseType_t auto_reload, void *id, TimerCallbackFunction_t callback, bool charge) {
+	if (period == 0 || !callback) return NULL;
+	if (charge && !host_heap_take(HOST_TIMER_BYTES)) return NULL;
+
+	pthread_once(&host_timers_once, host_timer_daemon_start);
+
+	struct host_timer *t = calloc(1, sizeof(*t));
+	if (!t) abort();
+
+	snprintf(t->name, sizeof(t->name), "%s", name ? name : "");
+	t->period = period;
+	t->auto_reload = auto_reload != pdFALSE;
+	t->id = id;
+	t->callback = callback;
+	t->charged = charge ? HOST_TIMER_BYTES : 0;
+
+	pthread_mutex_lock(&host_timers_lock);
+	t->next = host_timers;
+	host_timers = t;
+	pthread_mutex_unlock(&host_timers_lock);
+
+	return t;
+}
+
+TimerHandle_t xTimerCreate(const char *name, TickType_t period, UBaseType_t auto_reload, void *id, TimerCallbackFunction_t callback) {
+	return host_timer_new(name, period, auto_reload, id, callback, true);
+}
+
+TimerHandle_t xTimerCreateStatic(const char *name, TickType_t period, UBaseType_t auto_reload, void *id, TimerCallbackFunction_t callback, StaticTimer_t *buffer) {
+	struct host_timer *t = host_timer_new(name, period, auto_reload, id, callback, false);
+	if (buffer) buffer->host = t;
+
+	return t;
+}
+
+static BaseType_t host_timer_arm(struct host_timer *t, TickType_t period, bool active) {
+	pthread_mutex_lock(&host_timers_lock);
+
+	if (t->deleted) {
+		pthread_mutex_unlock(&host_timers_lock);
+		return pdFAIL;
+	}
+
+	if (period) t->period = period;
+	t->active = active;
+	if (active) t->expiry_us = host_now_us() + (uint64_t)t->period * (1000000ULL / configTICK_RATE_HZ);
+
+	pthread_cond_broadcast(&host_timers_changed);
+	pthread_mutex_unlock(&host_timers_lock);
+
+	return pdPASS;
+}
+
+BaseType_t xTimerStart(TimerHandle_t timer, TickType_t ticks) {
+	(void)ticks;
+	return host_timer_arm(timer, 0, true);
+}
+
+BaseType_t xTimerReset(TimerHandle_t timer, TickType_t ticks) {
+	(void)ticks;
+	return host_timer_arm(timer, 0, true);
+}
+
+BaseType_t xTimerStop(TimerHandle_t timer, TickType_t ticks) {
+	(void)ticks;
+	return host_timer_arm(timer, 0, false);
+}
+
+// Starts a dormant timer too, as in FreeRTOS
+BaseType_t xTimerChangePeriod(TimerHandle_t timer, TickType_t period, TickType_t ticks) {
+	(void)ticks;
+	if (period == 0) return pdFAIL;
+
+	return host_timer_arm(timer, period, true);
+}
+
+BaseType_t xTimerDelete(TimerHandle_t timer, TickType_t ticks) {
+	(void)ticks;
+
+	pthread_mutex_lock(&host_timers_lock);
+	timer->active = false;
+	timer->deleted = true;
+	host_heap_give(timer->charged);
+	timer->charged = 0;
+	pthread_mutex_unlock(&host_timers_lock);
+
+	return pdPASS;
+}
+
+BaseType_t xTimerIsTimerActive(TimerHandle_t timer) {
+	pthread_mutex_lock(&host_timers_lock);
+	BaseType_t active = timer->active ? pdTRUE : pdFALSE;
+	pthread_mutex_unlock(&host_timers_lock);
+
+	return active;
+}
+
+void *pvTimerGetTimerID(TimerHandle_t timer) {
+	return timer->id;
+}
+
+BaseType_t xTimerPendFunctionCall(PendedFunction_t function, void *parameter1, uint32_t parameter2, TickType_t ticks) {
+	(void)ticks;
+
+	pthread_once(&host_timers_once, host_timer_daemon_start);
+	pthread_mutex_lock(&host_timers_lock);
+
+	if (host_pended_count == HOST_TIMER_QUEUE_LENGTH) {
+		pthread_mutex_unlock(&host_timers_lock);
+		return pdFAIL;
+	}
+
+	int slot = (host_pended_head + host_pended_count) % HOST_TIMER_QUEUE_LENGTH;
+	host_pended[slot].function = function;
+	host_pended[slot].parameter1 = parameter1;
+	host_pended[slot].parameter2 = parameter2;
+	host_pended_count++;
+
+	pthread_cond_broadcast(&host_timers_changed);
+	pthread_mutex_unlock(&host_timers_lock);
+
+	return pdPASS;
+}
+
+BaseType_t xTimerPendFunctionCallFromISR(PendedFunction_t function, void *parameter1, uint32_t parameter2, BaseType_t *higher_priority_woken) {
+	if (higher_priority_woken) *higher_priority_woken = pdFALSE;
+	return xTimerPendFunctionCall(function, parameter1, parameter2, 0);
+}
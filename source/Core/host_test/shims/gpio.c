@@ -0,0 +1,477 @@
+/*
+GPIO and LEDC on the host (see driver/gpio.h and driver/ledc.h for the model).
+*/
+
+#include <pthread.h>
+#include <string.h>
+
+#include "driver/gpio.h"
+#include "driver/ledc.h"
+#include "soc/gpio_reg.h"
+#include "soc/soc.h"
+
+#include "host.h"
+#include "host_internal.h"
+
+////////////// TYPES
+
+typedef struct {
+	gpio_mode_t mode;
+	bool pull_up;
+	bool pull_down;
+	gpio_int_type_t intr_type;
+
+	// Written by gpio_set_level(); read back by outputs
+	uint8_t output;
+
+	// -1 = not driven from outside: the pull decides
+	int8_t driven;
+
+	gpio_isr_t handler;
+	void *handler_arg;
+} host_gpio_pad_type;
+
+typedef struct {
+	bool configured;
+	uint32_t duty;
+
+	// Fade in progress: from → to over [start_us, end_us]
+	bool fading;
+	uint32_t fade_from;
+	uint32_t fade_to;
+	uint64_t fade_start_us;
+	uint64_t fade_end_us;
+
+	// Set by ledc_set_fade_with_time(), run by ledc_fade_start()
+	uint32_t fade_target;
+	uint32_t fade_ms;
+} host_ledc_channel_type;
+
+////////////// GLOBALS
+
+static pthread_mutex_t host_gpio_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static host_gpio_pad_type host_gpio_pads[GPIO_NUM_MAX];
+static bool host_gpio_ISR_service = false;
+
+// Pin whose next gpio_isr_handler_add() fails; GPIO_NUM_NC = none
+static gpio_num_t host_gpio_ISR_add_failure = GPIO_NUM_NC;
+
+static host_ledc_channel_type host_ledc_channels[LEDC_CHANNEL_MAX];
+static bool host_ledc_fade_installed = false;
+static host_ledc_stats_type host_ledc_statistics;
+
+////////////// GPIO
+
+static bool host_gpio_valid(gpio_num_t pin) {
+	return GPIO_IS_VALID_GPIO(pin);
+}
+
+// Called with the lock held
+static int host_gpio_level(const host_gpio_pad_type *pad) {
+	if (pad->mode & GPIO_MODE_OUTPUT) return pad->output;
+	if (pad->driven >= 0) return pad->driven;
+
+	return pad->pull_up ? 1 : 0;
+}
+
+static void host_gpio_pads_init(void) {
+	static bool done = false;
+	if (done) return;
+
+	for (int i = 0; i < GPIO_NUM_MAX; ++i) host_gpio_pads[i].driven = -1;
+	done = true;
+}
+
+esp_err_t gpio_config(const gpio_config_t *config) {
+	if (!config || config->pin_bit_mask == 0 || config->intr_type >= GPIO_INTR_MAX) return ESP_ERR_INVALID_ARG;
+
+	for (int i = 0; i < GPIO_NUM_MAX; ++i) {
+		if ((config->pin_bit_mask & BIT64(i)) && !host_gpio_valid((gpio_num_t)i)) return ESP_ERR_INVALID_ARG;
+		if ((config->pin_bit_mask & BIT64(i)) && (config->mode & GPIO_MODE_OUTPUT) && !GPIO_IS_VALID_OUTPUT_GPIO(i)) return ESP_ERR_INVALID_ARG;
+	}
+
+	pthread_mutex_lock(&host_gpio_lock);
+	host_gpio_pads_init();
+
+	for (int i = 0; i < GPIO_NUM_MAX; ++i) {
+		if (!(config->pin_bit_mask & BIT64(i))) continue;
+
+		host_gpio_pad_type *pad = &host_gpio_pads[i];
+		pad->mode = config->mode;
+		pad->pull_up = config->pull_up_en == GPIO_PULLUP_ENABLE;
+		pad->pull_down = config->pull_down_en == GPIO_PULLDOWN_ENABLE;
+		pad->intr_type = config->intr_type;
+	}
+
+	pthread_mutex_unlock(&host_gpio_lock);
+
+	return ESP_OK;
+}
+
+esp_err_t gpio_reset_pin(gpio_num_t gpio_num) {
+	if (!host_gpio_valid(gpio_num)) return ESP_ERR_INVALID_ARG;
+
+	pthread_mutex_lock(&host_gpio_lock);
+	host_gpio_pads_init();
+
+	// The driver's reset state: input with pull-up, no interrupt
+	host_gpio_pad_type *pad = &host_gpio_pads[gpio_num];
+	pad->mode = GPIO_MODE_INPUT;
+	pad->pull_up = true;
+	pad->pull_down = false;
+	pad->intr_type = GPIO_INTR_DISABLE;
+
+	pthread_mutex_unlock(&host_gpio_lock);
+
+	return ESP_OK;
+}
+
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level) {
+	if (!GPIO_IS_VALID_OUTPUT_GPIO(gpio_num)) return ESP_ERR_INVALID_ARG;
+
+	pthread_mutex_lock(&host_gpio_lock);
+	host_gpio_pads[gpio_num].output = level ? 1 : 0;
+	pthread_mutex_unlock(&host_gpio_lock);
+
+	return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t gpio_num) {
+	if (!host_gpio_valid(gpio_num)) return 0;
+
+	pthread_mutex_lock(&host_gpio_lock);
+	host_gpio_pads_init();
+	int level = host_gpio_level(&host_gpio_pads[gpio_num]);
+	pthread_mutex_unlock(&host_gpio_lock);
+
+	return level;
+}
+
+esp_err_t gpio_set_intr_type(gpio_num_t gpio_num, gpio_int_type_t intr_type) {
+	if (!host_gpio_valid(gpio_num) || intr_type >= GPIO_INTR_MAX) return ESP_ERR_INVALID_ARG;
+
+	pthread_mutex_lock(&host_gpio_lock);
+	host_gpio_pads[gpio_num].intr_type = intr_type;
+	pthread_mutex_unlock(&host_gpio_lock);
+
+	return ESP_OK;
+}
+
+esp_err_t gpio_install_isr_service(int intr_alloc_flags) {
+	pthread_mutex_lock(&host_gpio_lock);
+
+	esp_err_t err = host_gpio_ISR_service ? ESP_ERR_INVALID_STATE : ESP_OK;
+	host_gpio_ISR_service = true;
+
+	pthread_mutex_unlock(&host_gpio_lock);
+
+	return err;
+}
+
+void gpio_uninstall_isr_service(void) {
+	pthread_mutex_lock(&host_gpio_lock);
+
+	host_gpio_ISR_service = false;
+	for (int i = 0; i < GPIO_NUM_MAX; ++i) host_gpio_pads[i].handler = NULL;
+
+	pthread_mutex_unlock(&host_gpio_lock);
+}
+
+esp_err_t gpio_isr_handler_add(gpio_num_t gpio_num, gpio_isr_t isr_handler, void *args) {
+	if (!host_gpio_valid(gpio_num)) return ESP_ERR_INVALID_ARG;
+
+	pthread_mutex_lock(&host_gpio_lock);
+
+	esp_err_t err = host_gpio_ISR_service ? ESP_OK : ESP_ERR_INVALID_STATE;
+
+	if (err == ESP_OK && gpio_num == host_gpio_ISR_add_failure) {
+		host_gpio_ISR_add_failure = GPIO_NUM_NC;
+		err = ESP_ERR_NO_MEM;
+	}
+
+	if (err == ESP_OK) {
+		host_gpio_pads[gpio_num].handler = isr_handler;
+		host_gpio_pads[gpio_num].handler_arg = args;
+	}
+
+	pthread_mutex_unlock(&host_gpio_lock);
+
+	return err;
+}
+
+esp_err_t gpio_isr_handler_remove(gpio_num_t gpio_num) {
+	if (!host_gpio_valid(gpio_num)) return ESP_ERR_INVALID_ARG;
+
+	pthread_mutex_lock(&host_gpio_lock);
+
+	esp_err_t err = host_gpio_ISR_service ? ESP_OK : ESP_ERR_INVALID_STATE;
+	host_gpio_pads[gpio_num].handler = NULL;
+
+	pthread_mutex_unlock(&host_gpio_lock);
+
+	return err;
+}
+
+uint32_t host_reg_read(uint32_t address) {
+	int first;
+
+	if (address == GPIO_IN_REG) first = 0;
+	else if (address == GPIO_IN1_REG) first = 32;
+	else return 0;
+
+	uint32_t value = 0;
+
+	pthread_mutex_lock(&host_gpio_lock);
+	host_gpio_pads_init();
+
+	for (int i = first; i < first + 32 && i < GPIO_NUM_MAX; ++i) {
+		if (host_gpio_valid((gpio_num_t)i) && host_gpio_level(&host_gpio_pads[i])) value |= 1U << (i - first);
+	}
+
+	pthread_mutex_unlock(&host_gpio_lock);
+
+	return value;
+}
+
+////////////// GPIO controls
+
+static void host_gpio_drive(gpio_num_t pin, int8_t driven) {
+	if (!host_gpio_valid(pin)) return;
+
+	pthread_mutex_lock(&host_gpio_lock);
+	host_gpio_pads_init();
+
+	host_gpio_pad_type *pad = &host_gpio_pads[pin];
+	int before = host_gpio_level(pad);
+	pad->driven = driven;
+	int after = host_gpio_level(pad);
+
+	bool fire = false;
+	if (before != after && pad->handler && host_gpio_ISR_service) {
+		switch (pad->intr_type) {
+			case GPIO_INTR_ANYEDGE: fire = true; break;
+			case GPIO_INTR_POSEDGE: fire = after == 1; break;
+			case GPIO_INTR_NEGEDGE: fire = after == 0; break;
+			case GPIO_INTR_LOW_LEVEL: fire = after == 0; break;
+			case GPIO_INTR_HIGH_LEVEL: fire = after == 1; break;
+			default: break;
+		}
+	}
+
+	gpio_isr_t handler = pad->handler;
+	void *arg = pad->handler_arg;
+
+	pthread_mutex_unlock(&host_gpio_lock);
+
+	if (fire) handler(arg);
+}
+
+void host_gpio_input(gpio_num_t pin, int level) {
+	host_gpio_drive(pin, level ? 1 : 0);
+}
+
+void host_gpio_release(gpio_num_t pin) {
+	host_gpio_drive(pin, -1);
+}
+
+int host_gpio_output(gpio_num_t pin) {
+	if (!host_gpio_valid(pin)) return 0;
+
+	pthread_mutex_lock(&host_gpio_lock);
+	int level = host_gpio_pads[pin].output;
+	pthread_mutex_unlock(&host_gpio_lock);
+
+	return level;
+}
+
+bool host_gpio_has_ISR(gpio_num_t pin) {
+	if (!host_gpio_valid(pin)) return false;
+
+	pthread_mutex_lock(&host_gpio_lock);
+	bool has = host_gpio_ISR_service && host_gpio_pads[pin].handler != NULL && host_gpio_pads[pin].intr_type != GPIO_INTR_DISABLE;
+	pthread_mutex_unlock(&host_gpio_lock);
+
+	return has;
+}
+
+void host_gpio_fail_ISR_add(gpio_num_t pin) {
+	pthread_mutex_lock(&host_gpio_lock);
+	host_gpio_ISR_add_failure = pin;
+	pthread_mutex_unlock(&host_gpio_lock);
+}
+
+////////////// LEDC
+
+// Called with the lock held: the duty right now, fade included
+static uint32_t host_ledc_current(host_ledc_channel_type *c, uint64_t now_us) {
+	if (!c->fading) return c->duty;
+
+	if (now_us >= c->fade_end_us) {
+		c->fading = false;
+		c->duty = c->fade_to;
+		return c->duty;
+	}
+
+	uint64_t span = c->fade_end_us - c->fade_start_us;
+	double t = span ? (double)(now_us - c->fade_start_us) / (double)span : 1.0;
+
+	return (uint32_t)((double)c->fade_from + ((double)c->fade_to - (double)c->fade_from) * t + 0.5);
+}
+
+static host_ledc_channel_type *host_ledc_channel(ledc_mode_t speed_mode, ledc_channel_t channel) {
+	if (speed_mode >= LEDC_SPEED_MODE_MAX || channel >= LEDC_CHANNEL_MAX) return NULL;
+	if (!host_ledc_channels[channel].configured) return NULL;
+
+	return &host_ledc_channels[channel];
+}
+
+esp_err_t ledc_timer_config(const ledc_timer_config_t *config) {
+	if (!config || config->speed_mode >= LEDC_SPEED_MODE_MAX || config->timer_num >= LEDC_TIMER_MAX || config->freq_hz == 0) return ESP_ERR_INVALID_ARG;
+
+	return ESP_OK;
+}
+
+esp_err_t ledc_channel_config(const ledc_channel_config_t *config) {
+	if (!config || config->speed_mode >= LEDC_SPEED_MODE_MAX || config->channel >= LEDC_CHANNEL_MAX) return ESP_ERR_INVALID_ARG;
+	if (!GPIO_IS_VALID_OUTPUT_GPIO(config->gpio_num)) return ESP_ERR_INVALID_ARG;
+
+	pthread_mutex_lock(&host_gpio_lock);
+
+	host_ledc_channel_type *c = &host_ledc_channels[config->channel];
+	memset(c, 0, sizeof(*c));
+	c->configured = true;
+	c->duty = config->duty;
+
+	pthread_mutex_unlock(&host_gpio_lock);
+
+	return ESP_OK;
+}
+
+esp_err_t ledc_fade_func_install(int intr_alloc_flags) {
+	pthread_mutex_lock(&host_gpio_lock);
+	esp_err_t err = host_ledc_fade_installed ? ESP_ERR_INVALID_STATE : ESP_OK;
+	host_ledc_fade_installed = true;
+	pthread_mutex_unlock(&host_gpio_lock);
+
+	return err;
+}
+
+void ledc_fade_func_uninstall(void) {
+	pthread_mutex_lock(&host_gpio_lock);
+	host_ledc_fade_installed = false;
+	pthread_mutex_unlock(&host_gpio_lock);
+}
+
+esp_err_t ledc_set_duty_and_update(ledc_mode_t speed_mode, ledc_channel_t channel, uint32_t duty, uint32_t hpoint) {
+	pthread_mutex_lock(&host_gpio_lock);
+
+	host_ledc_channel_type *c = host_ledc_channel(speed_mode, channel);
+	esp_err_t err = c ? ESP_OK : ESP_ERR_INVALID_ARG;
+
+	if (c) {
+		host_ledc_current(c, host_now_us());
+
+		// The fade engine still owns the channel: this write is lost
+		if (c->fading) host_ledc_statistics.duty_during_fade++;
+		else c->duty = duty;
+	}
+
+	pthread_mutex_unlock(&host_gpio_lock);
+
+	return err;
+}
+
+esp_err_t ledc_set_fade_with_time(ledc_mode_t speed_mode, ledc_channel_t channel, uint32_t target_duty, int max_fade_time_ms) {
+	pthread_mutex_lock(&host_gpio_lock);
+
+	host_ledc_channel_type *c = host_ledc_channel(speed_mode, channel);
+	esp_err_t err = ESP_OK;
+
+	if (!c || max_fade_time_ms < 0) err = ESP_ERR_INVALID_ARG;
+	else if (!host_ledc_fade_installed) err = ESP_ERR_INVALID_STATE;
+	else {
+		c->fade_target = target_duty;
+		c->fade_ms = (uint32_t)max_fade_time_ms;
+	}
+
+	pthread_mutex_unlock(&host_gpio_lock);
+
+	return err;
+}
+
+esp_err_t ledc_fade_start(ledc_mode_t speed_mode, ledc_channel_t channel, ledc_fade_mode_t fade_mode) {
+	pthread_mutex_lock(&host_gpio_lock);
+
+	host_ledc_channel_type *c = host_ledc_channel(speed_mode, channel);
+	esp_err_t err = ESP_OK;
+	uint64_t end_us = 0;
+
+	if (!c) err = ESP_ERR_INVALID_ARG;
+	else if (!host_ledc_fade_installed) err = ESP_ERR_INVALID_STATE;
+	else {
+		uint64_t now = host_now_us();
+		c->fade_from = host_ledc_current(c, now);
+		c->duty = c->fade_from;
+		c->fade_to = c->fade_target;
+		c->fade_start_us = now;
+		c->fade_end_us = now + (uint64_t)c->fade_ms * 1000ULL;
+		c->fading = c->fade_ms > 0;
+		if (!c->fading) c->duty = c->fade_to;
+
+		end_us = c->fade_end_us;
+		host_ledc_statistics.fades++;
+	}
+
+	pthread_mutex_unlock(&host_gpio_lock);
+
+	if (err == ESP_OK && fade_mode == LEDC_FADE_WAIT_DONE) {
+		uint64_t now = host_now_us();
+		if (end_us > now) host_sleep_ms((uint32_t)((end_us - now + 999) / 1000));
+	}
+
+	return err;
+}
+
+esp_err_t ledc_fade_stop(ledc_mode_t speed_mode, ledc_channel_t channel) {
+	pthread_mutex_lock(&host_gpio_lock);
+
+	host_ledc_channel_type *c = host_ledc_channel(speed_mode, channel);
+	esp_err_t err = ESP_OK;
+
+	if (!c) err = ESP_ERR_INVALID_ARG;
+	else if (!host_ledc_fade_installed) err = ESP_ERR_INVALID_STATE;
+	else {
+		// Freezes at the duty reached so far
+		c->duty = host_ledc_current(c, host_now_us());
+		c->fading = false;
+		host_ledc_statistics.stops++;
+	}
+
+	pthread_mutex_unlock(&host_gpio_lock);
+
+	return err;
+}
+
+uint32_t ledc_get_duty(ledc_mode_t speed_mode, ledc_channel_t channel) {
+	pthread_mutex_lock(&host_gpio_lock);
+
+	host_ledc_channel_type *c = host_ledc_channel(speed_mode, channel);
+	uint32_t duty = c ? host_ledc_current(c, host_now_us()) : 0;
+
+	pthread_mutex_unlock(&host_gpio_lock);
+
+	return duty;
+}
+
+////////////// LEDC controls
+
+uint32_t host_ledc_duty(int channel) {
+	return ledc_get_duty(LEDC_LOW_SPEED_MODE, (ledc_channel_t)channel);
+}
+
+void host_ledc_stats(host_ledc_stats_type *out) {
+	pthread_mutex_lock(&host_gpio_lock);
+	*out = host_ledc_statistics;
+	pthread_mutex_unlock(&host_gpio_lock);
+}
@@ -0,0 +1,47 @@
+/*
+Shared between the shim translation units only (not on the include path of the modules).
+*/
+
+#ifndef woXrooX_host_internal_H
+#define woXrooX_host_internal_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+////////////// Heap
+
+// false when the simulated heap cannot hold `bytes` (the caller fails like the device would)
+bool host_heap_take(size_t bytes);
+void host_heap_give(size_t bytes);
+
+////////////// Waiting
+
+// Condition variables on CLOCK_MONOTONIC, so deadlines line up with host_now_us()
+void host_cond_init(pthread_cond_t *cond);
+
+// Absolute deadline `ticks` from now; false for portMAX_DELAY (wait forever)
+bool host_deadline_ticks(TickType_t ticks, struct timespec *out);
+void host_deadline_at_us(uint64_t at_us, struct timespec *out);
+
+// pthread_cond_(timed)wait that leaves the mutex unlocked if the task is deleted meanwhile.
+// Returns 0, or ETIMEDOUT once the deadline (NULL = none) has passed.
+int host_cond_wait(pthread_cond_t *cond, pthread_mutex_t *mutex, const struct timespec *deadline);
+
+////////////// Tasks
+
+// A thread registered as a task, like the IDF's own tasks (esp_timer, Tmr Svc, sys_evt, ...):
+// listed by uxTaskGetSystemState() but not charged to the simulated heap
+TaskHandle_t host_service_task(const char *name, UBaseType_t priority, BaseType_t core, uint32_t stack_bytes, TaskFunction_t function, void *arg);
+
+////////////// Network
+
+// The station has an IP, or no Wi-Fi was brought up at all (tests that only need a network)
+bool host_wifi_online(void);
+
+#endif
@@ -0,0 +1,352 @@
+/*
+I2S standard-mode RX on the host (see driver/i2s_std.h for the model).
+
+Two ports with one RX channel each, like the ESP32: a second i2s_new_channel() on a port whose
+channel was not deleted fails with ESP_ERR_NOT_FOUND. Calls made in the wrong channel state
+return ESP_ERR_INVALID_STATE as the driver does.
+*/
+
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "driver/i2s_std.h"
+
+#include "host.h"
+#include "host_internal.h"
+
+////////////// DEFINES
+
+#define HOST_I2S_PORTS 2
+#define HOST_I2S_FAILURES 8
+
+////////////// TYPES
+
+struct host_i2s_channel {
+	i2s_port_t port;
+	uint32_t buffers;
+	uint32_t words;
+	uint32_t rate_Hz;
+
+	bool initialised;
+	bool enabled;
+
+	i2s_isr_callback_t on_recv_q_ovf;
+	void *user_data;
+
+	// Buffers since enable: handed to the reader, and lost to overflow
+	uint64_t enabled_us;
+	uint64_t read;
+	uint64_t lost;
+};
+
+////////////// GLOBALS
+
+static pthread_mutex_t host_i2s_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct host_i2s_channel *host_i2s_ports[HOST_I2S_PORTS];
+static int host_i2s_live = 0;
+static uint32_t host_i2s_lost = 0;
+
+static float host_i2s_frequency_Hz = 1000.0f;
+static float host_i2s_amplitude = 0.02f;
+static bool host_i2s_unpaced = false;
+
+static uint32_t host_i2s_last_rate = 0;
+static uint32_t host_i2s_last_buffers = 0;
+static uint32_t host_i2s_last_words = 0;
+
+static struct {
+	const char *function;
+	esp_err_t err;
+} host_i2s_failures[HOST_I2S_FAILURES];
+
+////////////// Controls
+
+void host_i2s_tone(float frequency_Hz, float amplitude) {
+	pthread_mutex_lock(&host_i2s_lock);
+	host_i2s_frequency_Hz = frequency_Hz;
+	host_i2s_amplitude = amplitude;
+	pthread_mutex_unlock(&host_i2s_lock);
+}
+
+void host_i2s_free_run(bool on) {
+	__atomic_store_n(&host_i2s_unpaced, on, __ATOMIC_RELAXED);
+}
+
+void host_i2s_fail_next(const char *function, esp_err_t err) {
+	pthread_mutex_lock(&host_i2s_lock);
+
+	for (int i = 0; i < HOST_I2S_FAILURES; ++i) {
+		if (!host_i2s_failures[i].function) {
+			host_i2s_failures[i].function = function;
+			host_i2s_failures[i].err = err;
+			break;
+		}
+	}
+
+	pthread_mutex_unlock(&host_i2s_lock);
+}
+
+int host_i2s_channels(void) {
+	pthread_mutex_lock(&host_i2s_lock);
+	int n = host_i2s_live;
+	pthread_mutex_unlock(&host_i2s_lock);
+
+	return n;
+}
+
+void host_i2s_layout(uint32_t *rate_Hz, uint32_t *buffers, uint32_t *words) {
+	pthread_mutex_lock(&host_i2s_lock);
+	if (rate_Hz) *rate_Hz = host_i2s_last_rate;
+	if (buffers) *buffers = host_i2s_last_buffers;
+	if (words) *words = host_i2s_last_words;
+	pthread_mutex_unlock(&host_i2s_lock);
+}
+
+uint32_t host_i2s_overflows(void) {
+	return __atomic_load_n(&host_i2s_lost, __ATOMIC_RELAXED);
+}
+
+// Caller holds host_i2s_lock
+static esp_err_t host_i2s_injected(const char *function) {
+	for (int i = 0; i < HOST_I2S_FAILURES; ++i) {
+		if (host_i2s_failures[i].function && strcmp(host_i2s_failures[i].function, function) == 0) {
+			esp_err_t err = host_i2s_failures[i].err;
+			host_i2s_failures[i].function = NULL;
+			return err;
+		}
+	}
+
+	return ESP_OK;
+}
+
+////////////// Driver
+
+esp_err_t i2s_new_channel(const i2s_chan_config_t *config, i2s_chan_handle_t *tx, i2s_chan_handle_t *rx) {
+	if (!config || tx || !rx) return ESP_ERR_INVALID_ARG;
+	if (config->dma_desc_num < 2 || config->dma_frame_num == 0 || config->dma_frame_num * 4 > 4092) return ESP_ERR_INVALID_ARG;
+
+	pthread_mutex_lock(&host_i2s_lock);
+
+	esp_err_t err = host_i2s_injected(__func__);
+	int port = config->id == I2S_NUM_AUTO ? 0 : (int)config->id;
+
+	if (err == ESP_OK && config->id == I2S_NUM_AUTO) {
+		while (port < HOST_I2S_PORTS && host_i2s_ports[port]) port++;
+	}
+
+	if (err == ESP_OK && (port >= HOST_I2S_PORTS || host_i2s_ports[port])) err = ESP_ERR_NOT_FOUND;
+
+	// The driver allocates the descriptors and buffers up front
+	size_t cost = (size_t)config->dma_desc_num * (config->dma_frame_num * 4 + 12) + 256;
+	if (err == ESP_OK && !host_heap_take(cost)) err = ESP_ERR_NO_MEM;
+
+	if (err != ESP_OK) {
+		pthread_mutex_unlock(&host_i2s_lock);
+		return err;
+	}
+
+	struct host_i2s_channel *c = calloc(1, sizeof(*c));
+	if (!c) abort();
+
+	c->port = (i2s_port_t)port;
+	c->buffers = config->dma_desc_num;
+	c->words = config->dma_frame_num;
+
+	host_i2s_ports[port] = c;
+	host_i2s_live++;
+
+	pthread_mutex_unlock(&host_i2s_lock);
+
+	*rx = c;
+
+	return ESP_OK;
+}
+
+esp_err_t i2s_del_channel(i2s_chan_handle_t channel) {
+	if (!channel) return ESP_ERR_INVALID_ARG;
+
+	pthread_mutex_lock(&host_i2s_lock);
+
+	if (channel->enabled) {
+		pthread_mutex_unlock(&host_i2s_lock);
+		return ESP_ERR_INVALID_STATE;
+	}
+
+	host_i2s_ports[channel->port] = NULL;
+	host_i2s_live--;
+	host_heap_give((size_t)channel->buffers * (channel->words * 4 + 12) + 256);
+
+	pthread_mutex_unlock(&host_i2s_lock);
+
+	free(channel);
+
+	return ESP_OK;
+}
+
+esp_err_t i2s_channel_init_std_mode(i2s_chan_handle_t channel, const i2s_std_config_t *config) {
+	if (!channel || !config || config->clk_cfg.sample_rate_hz == 0) return ESP_ERR_INVALID_ARG;
+
+	pthread_mutex_lock(&host_i2s_lock);
+
+	esp_err_t err = host_i2s_injected(__func__);
+	if (err == ESP_OK && (channel->initialised || channel->enabled)) err = ESP_ERR_INVALID_STATE;
+
+	if (err == ESP_OK) {
+		channel->rate_Hz = config->clk_cfg.sample_rate_hz;
+		channel->initialised = true;
+
+		host_i2s_last_rate = channel->rate_Hz;
+		host_i2s_last_buffers = channel->buffers;
+		host_i2s_last_words = channel->words;
+	}
+
+	pthread_mutex_unlock(&host_i2s_lock);
+
+	return err;
+}
+
+esp_err_t i2s_channel_register_event_callback(i2s_chan_handle_t channel, const i2s_event_callbacks_t *callbacks, void *user_data) {
+	if (!channel || !callbacks) return ESP_ERR_INVALID_ARG;
+
+	pthread_mutex_lock(&host_i2s_lock);
+
+	esp_err_t err = host_i2s_injected(__func__);
+	if (err == ESP_OK && channel->enabled) err = ESP_ERR_INVALID_STATE;
+
+	if (err == ESP_OK) {
+		channel->on_recv_q_ovf = callbacks->on_recv_q_ovf;
+		channel->user_data = user_data;
+	}
+
+	pthread_mutex_unlock(&host_i2s_lock);
+
+	return err;
+}
+
+esp_err_t i2s_channel_enable(i2s_chan_handle_t channel) {
+	if (!channel) return ESP_ERR_INVALID_ARG;
+
+	pthread_mutex_lock(&host_i2s_lock);
+
+	esp_err_t err = host_i2s_injected(__func__);
+	if (err == ESP_OK && (!channel->initialised || channel->enabled)) err = ESP_ERR_INVALID_STATE;
+
+	if (err == ESP_OK) {
+		channel->enabled = true;
+		channel->enabled_us = host_now_us();
+		channel->read = 0;
+		channel->lost = 0;
+	}
+
+	pthread_mutex_unlock(&host_i2s_lock);
+
+	return err;
+}
+
+esp_err_t i2s_channel_disable(i2s_chan_handle_t channel) {
+	if (!channel) return ESP_ERR_INVALID_ARG;
+
+	pthread_mutex_lock(&host_i2s_lock);
+
+	esp_err_t err = channel->enabled ? ESP_OK : ESP_ERR_INVALID_STATE;
+	channel->enabled = false;
+
+	pthread_mutex_unlock(&host_i2s_lock);
+
+	return err;
+}
+
+// One DMA buffer of the tone, continuing the phase of the previous one
+static void host_i2s_fill(const struct host_i2s_channel *c, int32_t *out, uint64_t buffer_index, float frequency_Hz, float amplitude) {
+	const double pi = 3.14159265358979323846;
+	uint64_t first = buffer_index * c->words;
+
+	for (uint32_t i = 0; i < c->words; ++i) {
+		double phase = 2.0 * pi * frequency_Hz * (double)((first + i) % c->rate_Hz) / (double)c->rate_Hz;
+		int32_t sample = (int32_t)lround(sin(phase) * amplitude * 8388607.0);
+
+		// 24 valid bits, left-justified in the 32-bit slot
+		out[i] = (int32_t)((uint32_t)sample << 8);
+	}
+}
+
+esp_err_t i2s_channel_read(i2s_chan_handle_t channel, void *dest, size_t size, size_t *bytes_read, uint32_t timeout_ms) {
+	if (!channel || !dest) return ESP_ERR_INVALID_ARG;
+
+	uint8_t *out = dest;
+	size_t done = 0;
+	size_t buffer_bytes = 0;
+	uint64_t deadline_us = host_now_us() + (uint64_t)timeout_ms * 1000ULL;
+
+	while (done + buffer_bytes <= size) {
+		pthread_mutex_lock(&host_i2s_lock);
+
+		if (!channel->enabled) {
+			pthread_mutex_unlock(&host_i2s_lock);
+			if (bytes_read) *bytes_read = done;
+			return ESP_ERR_INVALID_STATE;
+		}
+
+		buffer_bytes = (size_t)channel->words * sizeof(int32_t);
+		if (done + buffer_bytes > size) {
+			pthread_mutex_unlock(&host_i2s_lock);
+			break;
+		}
+
+		uint64_t buffer_us = (uint64_t)channel->words * 1000000ULL / channel->rate_Hz;
+		uint64_t now = host_now_us();
+		bool unpaced = __atomic_load_n(&host_i2s_unpaced, __ATOMIC_RELAXED);
+
+		// Ring overflow: everything beyond `buffers` unread DMA buffers is gone
+		uint64_t lost_now = 0;
+		if (!unpaced) {
+			uint64_t produced = (now - channel->enabled_us) / buffer_us;
+			uint64_t unread = produced - channel->read - channel->lost;
+
+			if (unread > channel->buffers) {
+				lost_now = unread - channel->buffers;
+				channel->lost += lost_now;
+			}
+		}
+
+		uint64_t index = channel->read + channel->lost;
+		uint64_t ready_us = channel->enabled_us + (index + 1) * buffer_us;
+
+		if (unpaced || ready_us <= now) {
+			host_i2s_fill(channel, (int32_t *)(out + done), index, host_i2s_frequency_Hz, host_i2s_amplitude);
+			channel->read++;
+			done += buffer_bytes;
+		}
+
+		i2s_isr_callback_t overflow = channel->on_recv_q_ovf;
+		void *user_data = channel->user_data;
+
+		pthread_mutex_unlock(&host_i2s_lock);
+
+		for (uint64_t i = 0; i < lost_now; ++i) {
+			__atomic_fetch_add(&host_i2s_lost, 1, __ATOMIC_RELAXED);
+			if (overflow) overflow(channel, &(i2s_event_data_t){ .data = NULL, .size = buffer_bytes }, user_data);
+		}
+
+		if (unpaced || ready_us <= now) continue;
+
+		// Next buffer not there yet: wait for it, or give up with what we have
+		if (done) break;
+		if (timeout_ms != portMAX_DELAY && ready_us > deadline_us) {
+			if (deadline_us > now) host_sleep_ms((uint32_t)((deadline_us - now) / 1000ULL));
+			if (bytes_read) *bytes_read = 0;
+			return ESP_ERR_TIMEOUT;
+		}
+
+		struct timespec ts;
+		host_deadline_at_us(ready_us, &ts);
+		while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) { }
+	}
+
+	if (bytes_read) *bytes_read = done;
+
+	return ESP_OK;
+}
@@ -0,0 +1,76 @@
+/*
+GPIO on the host: 40 simulated pads. Outputs keep the level written to them, inputs float to
+their pull (high with a pull-up, low otherwise) until a test drives them with host_gpio_input().
+A driven edge on a pin with an interrupt type and a registered handler runs the handler at once,
+on the driving thread, the way an ISR preempts whatever was running.
+*/
+
+#ifndef woXrooX_host_gpio_H
+#define woXrooX_host_gpio_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "hal/gpio_types.h"
+#include "esp_err.h"
+
+////////////// DEFINES
+
+// ESP32 pads: 0..19, 21..23, 25..27, 32..39
+#define GPIO_IS_VALID_GPIO(pin) ((int)(pin) >= 0 && (int)(pin) < GPIO_NUM_MAX && ((0xFF0EEFFFFFULL >> (int)(pin)) & 1))
+#define GPIO_IS_VALID_OUTPUT_GPIO(pin) (GPIO_IS_VALID_GPIO(pin) && (int)(pin) < 34)
+
+#define BIT64(n) (1ULL << (n))
+
+////////////// TYPES
+
+typedef enum {
+	GPIO_MODE_DISABLE = 0,
+	GPIO_MODE_INPUT = 1,
+	GPIO_MODE_OUTPUT = 2,
+	GPIO_MODE_OUTPUT_OD = 6,
+	GPIO_MODE_INPUT_OUTPUT_OD = 7,
+	GPIO_MODE_INPUT_OUTPUT = 3,
+} gpio_mode_t;
+
+typedef enum { GPIO_PULLUP_DISABLE = 0, GPIO_PULLUP_ENABLE = 1 } gpio_pullup_t;
+typedef enum { GPIO_PULLDOWN_DISABLE = 0, GPIO_PULLDOWN_ENABLE = 1 } gpio_pulldown_t;
+
+typedef enum {
+	GPIO_INTR_DISABLE = 0,
+	GPIO_INTR_POSEDGE,
+	GPIO_INTR_NEGEDGE,
+	GPIO_INTR_ANYEDGE,
+	GPIO_INTR_LOW_LEVEL,
+	GPIO_INTR_HIGH_LEVEL,
+	GPIO_INTR_MAX
+} gpio_int_type_t;
+
+typedef struct {
+	uint64_t pin_bit_mask;
+	gpio_mode_t mode;
+	gpio_pullup_t pull_up_en;
+	gpio_pulldown_t pull_down_en;
+	gpio_int_type_t intr_type;
+} gpio_config_t;
+
+typedef void (*gpio_isr_t)(void *arg);
+
+////////////// API
+
+esp_err_t gpio_config(const gpio_config_t *config);
+esp_err_t gpio_reset_pin(gpio_num_t gpio_num);
+
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level);
+int gpio_get_level(gpio_num_t gpio_num);
+
+esp_err_t gpio_set_intr_type(gpio_num_t gpio_num, gpio_int_type_t intr_type);
+
+// ESP_ERR_INVALID_STATE when already installed, as the driver does
+esp_err_t gpio_install_isr_service(int intr_alloc_flags);
+void gpio_uninstall_isr_service(void);
+
+esp_err_t gpio_isr_handler_add(gpio_num_t gpio_num, gpio_isr_t isr_handler, void *args);
+esp_err_t gpio_isr_handler_remove(gpio_num_t gpio_num);
+
+#endif
@@ -0,0 +1,136 @@
+/*
+I2S standard-mode RX on the host.
+
+A channel produces dma_frame_num 32-bit words per DMA buffer at the configured rate: a sine
+(host_i2s_tone(), 24 bits left-justified like an INMP441) paced against CLOCK_MONOTONIC. The DMA
+ring holds dma_desc_num buffers; buffers produced while the ring is full are lost, and
+on_recv_q_ovf runs for each, like the driver's receive queue overflowing. host_i2s_free_run()
+drops the pacing so a read always returns at once (throughput benchmarks).
+*/
+
+#ifndef woXrooX_host_i2s_std_H
+#define woXrooX_host_i2s_std_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "freertos/FreeRTOS.h"
+#include "hal/gpio_types.h"
+#include "esp_err.h"
+
+////////////// TYPES
+
+typedef struct host_i2s_channel *i2s_chan_handle_t;
+
+typedef enum { I2S_NUM_0 = 0, I2S_NUM_1 = 1, I2S_NUM_AUTO } i2s_port_t;
+typedef enum { I2S_ROLE_MASTER = 0, I2S_ROLE_SLAVE } i2s_role_t;
+typedef enum { I2S_CLK_SRC_DEFAULT = 0, I2S_CLK_SRC_PLL_160M, I2S_CLK_SRC_APLL } i2s_clock_src_t;
+typedef enum { I2S_MCLK_MULTIPLE_128 = 128, I2S_MCLK_MULTIPLE_256 = 256, I2S_MCLK_MULTIPLE_384 = 384 } i2s_mclk_multiple_t;
+
+typedef enum {
+	I2S_DATA_BIT_WIDTH_8BIT = 8,
+	I2S_DATA_BIT_WIDTH_16BIT = 16,
+	I2S_DATA_BIT_WIDTH_24BIT = 24,
+	I2S_DATA_BIT_WIDTH_32BIT = 32
+} i2s_data_bit_width_t;
+
+typedef enum {
+	I2S_SLOT_BIT_WIDTH_AUTO = 0,
+	I2S_SLOT_BIT_WIDTH_8BIT = 8,
+	I2S_SLOT_BIT_WIDTH_16BIT = 16,
+	I2S_SLOT_BIT_WIDTH_24BIT = 24,
+	I2S_SLOT_BIT_WIDTH_32BIT = 32
+} i2s_slot_bit_width_t;
+
+typedef enum { I2S_SLOT_MODE_MONO = 1, I2S_SLOT_MODE_STEREO = 2 } i2s_slot_mode_t;
+typedef enum { I2S_STD_SLOT_LEFT = 1, I2S_STD_SLOT_RIGHT = 2, I2S_STD_SLOT_BOTH = 3 } i2s_std_slot_mask_t;
+
+#define I2S_GPIO_UNUSED GPIO_NUM_NC
+
+typedef struct {
+	i2s_port_t id;
+	i2s_role_t role;
+	uint32_t dma_desc_num;
+	uint32_t dma_frame_num;
+	bool auto_clear;
+	int intr_priority;
+} i2s_chan_config_t;
+
+#define I2S_CHANNEL_DEFAULT_CONFIG(i2s_num, i2s_role) { \
+	.id = (i2s_num), \
+	.role = (i2s_role), \
+	.dma_desc_num = 6, \
+	.dma_frame_num = 240, \
+	.auto_clear = false, \
+	.intr_priority = 0, \
+}
+
+typedef struct {
+	uint32_t sample_rate_hz;
+	i2s_clock_src_t clk_src;
+	i2s_mclk_multiple_t mclk_multiple;
+} i2s_std_clk_config_t;
+
+#define I2S_STD_CLK_DEFAULT_CONFIG(rate) { \
+	.sample_rate_hz = (rate), \
+	.clk_src = I2S_CLK_SRC_DEFAULT, \
+	.mclk_multiple = I2S_MCLK_MULTIPLE_256, \
+}
+
+typedef struct {
+	i2s_data_bit_width_t data_bit_width;
+	i2s_slot_bit_width_t slot_bit_width;
+	i2s_slot_mode_t slot_mode;
+	i2s_std_slot_mask_t slot_mask;
+	uint32_t ws_width;
+	bool ws_pol;
+	bool bit_shift;
+	bool msb_right;
+} i2s_std_slot_config_t;
+
+typedef struct {
+	gpio_num_t mclk;
+	gpio_num_t bclk;
+	gpio_num_t ws;
+	gpio_num_t dout;
+	gpio_num_t din;
+
+	struct {
+		uint32_t mclk_inv: 1;
+		uint32_t bclk_inv: 1;
+		uint32_t ws_inv: 1;
+	} invert_flags;
+} i2s_std_gpio_config_t;
+
+typedef struct {
+	i2s_std_clk_config_t clk_cfg;
+	i2s_std_slot_config_t slot_cfg;
+	i2s_std_gpio_config_t gpio_cfg;
+} i2s_std_config_t;
+
+typedef struct {
+	void *data;
+	size_t size;
+} i2s_event_data_t;
+
+typedef bool (*i2s_isr_callback_t)(i2s_chan_handle_t handle, i2s_event_data_t *event, void *user_ctx);
+
+typedef struct {
+	i2s_isr_callback_t on_recv;
+	i2s_isr_callback_t on_recv_q_ovf;
+	i2s_isr_callback_t on_sent;
+	i2s_isr_callback_t on_send_q_ovf;
+} i2s_event_callbacks_t;
+
+////////////// API
+
+esp_err_t i2s_new_channel(const i2s_chan_config_t *config, i2s_chan_handle_t *tx, i2s_chan_handle_t *rx);
+esp_err_t i2s_del_channel(i2s_chan_handle_t channel);
+esp_err_t i2s_channel_init_std_mode(i2s_chan_handle_t channel, const i2s_std_config_t *config);
+esp_err_t i2s_channel_register_event_callback(i2s_chan_handle_t channel, const i2s_event_callbacks_t *callbacks, void *user_data);
+esp_err_t i2s_channel_enable(i2s_chan_handle_t channel);
+esp_err_t i2s_channel_disable(i2s_chan_handle_t channel);
+esp_err_t i2s_channel_read(i2s_chan_handle_t channel, void *dest, size_t size, size_t *bytes_read, uint32_t timeout_ms);
+
+#endif
@@ -0,0 +1,89 @@
+/*
+LEDC on the host: channels remember their duty, and a hardware fade ramps it linearly from the
+duty at ledc_fade_start() to the target over the requested time, read back with
+host_ledc_duty(). As on the ESP32, writing a new duty while a fade is still running is a
+misuse (the fade engine keeps going and overwrites it); host_ledc_stats() counts those writes.
+*/
+
+#ifndef woXrooX_host_ledc_H
+#define woXrooX_host_ledc_H
+
+#include <stdint.h>
+
+#include "hal/gpio_types.h"
+#include "esp_err.h"
+
+////////////// TYPES
+
+typedef enum { LEDC_LOW_SPEED_MODE = 0, LEDC_SPEED_MODE_MAX } ledc_mode_t;
+
+typedef enum {
+	LEDC_TIMER_0 = 0,
+	LEDC_TIMER_1,
+	LEDC_TIMER_2,
+	LEDC_TIMER_3,
+	LEDC_TIMER_MAX
+} ledc_timer_t;
+
+typedef enum {
+	LEDC_CHANNEL_0 = 0,
+	LEDC_CHANNEL_1,
+	LEDC_CHANNEL_2,
+	LEDC_CHANNEL_3,
+	LEDC_CHANNEL_4,
+	LEDC_CHANNEL_5,
+	LEDC_CHANNEL_6,
+	LEDC_CHANNEL_7,
+	LEDC_CHANNEL_MAX
+} ledc_channel_t;
+
+typedef enum {
+	LEDC_TIMER_1_BIT = 1,
+	LEDC_TIMER_8_BIT = 8,
+	LEDC_TIMER_10_BIT = 10,
+	LEDC_TIMER_12_BIT = 12,
+	LEDC_TIMER_13_BIT = 13,
+	LEDC_TIMER_BIT_MAX = 21
+} ledc_timer_bit_t;
+
+typedef enum { LEDC_AUTO_CLK = 0 } ledc_clk_cfg_t;
+typedef enum { LEDC_INTR_DISABLE = 0, LEDC_INTR_FADE_END } ledc_intr_type_t;
+typedef enum { LEDC_FADE_NO_WAIT = 0, LEDC_FADE_WAIT_DONE } ledc_fade_mode_t;
+
+typedef struct {
+	ledc_mode_t speed_mode;
+	ledc_timer_bit_t duty_resolution;
+	ledc_timer_t timer_num;
+	uint32_t freq_hz;
+	ledc_clk_cfg_t clk_cfg;
+} ledc_timer_config_t;
+
+typedef struct {
+	int gpio_num;
+	ledc_mode_t speed_mode;
+	ledc_channel_t channel;
+	ledc_intr_type_t intr_type;
+	ledc_timer_t timer_sel;
+	uint32_t duty;
+	int hpoint;
+	struct {
+		unsigned int output_invert: 1;
+	} flags;
+} ledc_channel_config_t;
+
+////////////// API
+
+esp_err_t ledc_timer_config(const ledc_timer_config_t *config);
+esp_err_t ledc_channel_config(const ledc_channel_config_t *config);
+
+esp_err_t ledc_fade_func_install(int intr_alloc_flags);
+void ledc_fade_func_uninstall(void);
+
+esp_err_t ledc_set_duty_and_update(ledc_mode_t speed_mode, ledc_channel_t channel, uint32_t duty, uint32_t hpoint);
+esp_err_t ledc_set_fade_with_time(ledc_mode_t speed_mode, ledc_channel_t channel, uint32_t target_duty, int max_fade_time_ms);
+esp_err_t ledc_fade_start(ledc_mode_t speed_mode, ledc_channel_t channel, ledc_fade_mode_t fade_mode);
+esp_err_t ledc_fade_stop(ledc_mode_t speed_mode, ledc_channel_t channel);
+
+uint32_t ledc_get_duty(ledc_mode_t speed_mode, ledc_channel_t channel);
+
+#endif
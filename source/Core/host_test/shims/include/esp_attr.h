@@ -0,0 +1,12 @@
+#ifndef woXrooX_host_esp_attr_H
+#define woXrooX_host_esp_attr_H
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define RTC_DATA_ATTR
+#define RTC_NOINIT_ATTR
+#define EXT_RAM_BSS_ATTR
+#define WORD_ALIGNED_ATTR __attribute__((aligned(4)))
+#define NOINLINE_ATTR __attribute__((noinline))
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef woXrooX_host_esp_cpu_H
+#define woXrooX_host_esp_cpu_H
+
+#include <stdint.h>
+
+////////////// API
+
+typedef uint32_t esp_cpu_cycle_count_t;
+
+// Host cycles (TSC), so per-call costs are comparable between runs on one machine, not with the ESP32
+esp_cpu_cycle_count_t esp_cpu_get_cycle_count(void);
+
+// Core the calling task is pinned to (0 when unpinned or not a task)
+int esp_cpu_get_core_id(void);
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef woXrooX_host_esp_crt_bundle_H
+#define woXrooX_host_esp_crt_bundle_H
+
+#include "esp_err.h"
+
+////////////// API
+
+// Only ever passed as a pointer; clients given it verify against the host's system roots
+esp_err_t esp_crt_bundle_attach(void *conf);
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef woXrooX_host_esp_heap_caps_H
+#define woXrooX_host_esp_heap_caps_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+////////////// DEFINES
+
+#define MALLOC_CAP_EXEC (1 << 0)
+#define MALLOC_CAP_32BIT (1 << 1)
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_DMA (1 << 3)
+#define MALLOC_CAP_SPIRAM (1 << 10)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+#define MALLOC_CAP_DEFAULT (1 << 12)
+
+////////////// API
+
+/*
+One simulated internal heap of host_heap_reset() bytes (default HOST_HEAP_TOTAL in host.h).
+What the device would take from it is charged here: task stacks and TCBs, queues, semaphores,
+event groups, esp_timers and heap_caps_malloc(). Every capability reports the same heap, and
+the largest free block is the whole free size (no fragmentation model).
+*/
+size_t heap_caps_get_free_size(uint32_t caps);
+size_t heap_caps_get_minimum_free_size(uint32_t caps);
+size_t heap_caps_get_largest_free_block(uint32_t caps);
+size_t heap_caps_get_total_size(uint32_t caps);
+
+void *heap_caps_malloc(size_t size, uint32_t caps);
+void *heap_caps_calloc(size_t n, size_t size, uint32_t caps);
+void heap_caps_free(void *pointer);
+
+size_t esp_get_free_heap_size(void);
+size_t esp_get_minimum_free_heap_size(void);
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef woXrooX_host_esp_http_client_H
+#define woXrooX_host_esp_http_client_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+////////////// TYPES
+
+typedef struct host_http_client *esp_http_client_handle_t;
+
+typedef enum {
+	HTTP_METHOD_GET = 0,
+	HTTP_METHOD_POST,
+	HTTP_METHOD_PUT,
+	HTTP_METHOD_DELETE,
+	HTTP_METHOD_HEAD,
+	HTTP_METHOD_MAX
+} esp_http_client_method_t;
+
+typedef struct {
+	const char *url;
+	int timeout_ms;
+	bool keep_alive_enable;
+	esp_http_client_method_t method;
+
+	// Trust: the esp_tls global CA store, or the system roots standing in for the cert bundle
+	bool use_global_ca_store;
+	esp_err_t (*crt_bundle_attach)(void *conf);
+} esp_http_client_config_t;
+
+////////////// API
+
+// HTTP/1.1 over a real socket (OpenSSL for https://), with the IDF's streaming call sequence:
+// open → write → fetch_headers → read, the connection kept between requests
+esp_http_client_handle_t esp_http_client_init(const esp_http_client_config_t *config);
+esp_err_t esp_http_client_cleanup(esp_http_client_handle_t client);
+esp_err_t esp_http_client_close(esp_http_client_handle_t client);
+
+esp_err_t esp_http_client_set_url(esp_http_client_handle_t client, const char *url);
+esp_err_t esp_http_client_set_method(esp_http_client_handle_t client, esp_http_client_method_t method);
+esp_err_t esp_http_client_set_header(esp_http_client_handle_t client, const char *key, const char *value);
+esp_err_t esp_http_client_delete_header(esp_http_client_handle_t client, const char *key);
+esp_err_t esp_http_client_set_timeout_ms(esp_http_client_handle_t client, int timeout_ms);
+
+esp_err_t esp_http_client_open(esp_http_client_handle_t client, int write_len);
+int esp_http_client_write(esp_http_client_handle_t client, const char *buffer, int len);
+int64_t esp_http_client_fetch_headers(esp_http_client_handle_t client);
+int esp_http_client_read(esp_http_client_handle_t client, char *buffer, int len);
+
+int esp_http_client_get_status_code(esp_http_client_handle_t client);
+bool esp_http_client_is_chunked_response(esp_http_client_handle_t client);
+bool esp_http_client_is_complete_data_received(esp_http_client_handle_t client);
+
+#endif
@@ -0,0 +1,119 @@
+#ifndef woXrooX_host_esp_http_server_H
+#define woXrooX_host_esp_http_server_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "esp_err.h"
+
+////////////// DEFINES
+
+#define ESP_ERR_HTTPD_BASE 0xb000
+#define ESP_ERR_HTTPD_HANDLERS_FULL (ESP_ERR_HTTPD_BASE + 1)
+#define ESP_ERR_HTTPD_HANDLER_EXISTS (ESP_ERR_HTTPD_BASE + 2)
+#define ESP_ERR_HTTPD_INVALID_REQ (ESP_ERR_HTTPD_BASE + 3)
+#define ESP_ERR_HTTPD_RESULT_TRUNC (ESP_ERR_HTTPD_BASE + 4)
+#define ESP_ERR_HTTPD_RESP_HDR (ESP_ERR_HTTPD_BASE + 5)
+#define ESP_ERR_HTTPD_RESP_SEND (ESP_ERR_HTTPD_BASE + 6)
+#define ESP_ERR_HTTPD_ALLOC_MEM (ESP_ERR_HTTPD_BASE + 7)
+#define ESP_ERR_HTTPD_TASK (ESP_ERR_HTTPD_BASE + 8)
+
+#define HTTPD_MAX_URI_LEN 512
+#define HTTPD_RESP_USE_STRLEN -1
+
+#define HTTPD_DEFAULT_CONFIG() { \
+	.task_priority = tskIDLE_PRIORITY + 5, \
+	.stack_size = 4096, \
+	.core_id = tskNO_AFFINITY, \
+	.server_port = 80, \
+	.ctrl_port = 32768, \
+	.max_open_sockets = 7, \
+	.max_uri_handlers = 8, \
+	.max_resp_headers = 8, \
+	.backlog_conn = 5, \
+	.lru_purge_enable = false, \
+	.recv_wait_timeout = 5, \
+	.send_wait_timeout = 5, \
+}
+
+////////////// TYPES
+
+typedef void *httpd_handle_t;
+
+// http_parser's method numbers
+enum http_method {
+	HTTP_DELETE = 0,
+	HTTP_GET = 1,
+	HTTP_HEAD = 2,
+	HTTP_POST = 3,
+	HTTP_PUT = 4
+};
+
+typedef enum http_method httpd_method_t;
+
+typedef struct {
+	unsigned task_priority;
+	size_t stack_size;
+	BaseType_t core_id;
+	uint16_t server_port;
+	uint16_t ctrl_port;
+	uint16_t max_open_sockets;
+	uint16_t max_uri_handlers;
+	uint16_t max_resp_headers;
+	uint16_t backlog_conn;
+	bool lru_purge_enable;
+	uint16_t recv_wait_timeout;
+	uint16_t send_wait_timeout;
+} httpd_config_t;
+
+typedef struct httpd_req {
+	httpd_handle_t handle;
+	int method;
+	char uri[HTTPD_MAX_URI_LEN + 1];
+	size_t content_len;
+	void *aux;
+	void *user_ctx;
+	void *sess_ctx;
+	void (*free_ctx)(void *ctx);
+	bool ignore_sess_ctx_changes;
+} httpd_req_t;
+
+typedef struct httpd_uri {
+	const char *uri;
+	httpd_method_t method;
+	esp_err_t (*handler)(httpd_req_t *r);
+	void *user_ctx;
+} httpd_uri_t;
+
+////////////// API
+
+// A real TCP server on 127.0.0.1 (server_port 0 = any free port, see host_httpd_port()), one
+// "httpd" task serving every socket like the IDF one. A connection beyond max_open_sockets is
+// accepted and closed at once, or with lru_purge_enable the least recently used session is closed
+// to make room. Sessions are keep-alive; a handler closes one with httpd_sess_trigger_close().
+esp_err_t httpd_start(httpd_handle_t *handle, const httpd_config_t *config);
+esp_err_t httpd_stop(httpd_handle_t handle);
+
+esp_err_t httpd_register_uri_handler(httpd_handle_t handle, const httpd_uri_t *uri_handler);
+
+esp_err_t httpd_resp_set_status(httpd_req_t *r, const char *status);
+esp_err_t httpd_resp_set_type(httpd_req_t *r, const char *type);
+esp_err_t httpd_resp_set_hdr(httpd_req_t *r, const char *field, const char *value);
+
+esp_err_t httpd_resp_send(httpd_req_t *r, const char *buf, ssize_t buf_len);
+esp_err_t httpd_resp_send_chunk(httpd_req_t *r, const char *buf, ssize_t buf_len);
+esp_err_t httpd_resp_send_500(httpd_req_t *r);
+
+// The request outlives the handler: *out is a copy any task may respond on, until _complete()
+esp_err_t httpd_req_async_handler_begin(httpd_req_t *r, httpd_req_t **out);
+esp_err_t httpd_req_async_handler_complete(httpd_req_t *r);
+
+int httpd_req_to_sockfd(httpd_req_t *r);
+esp_err_t httpd_sess_trigger_close(httpd_handle_t handle, int sockfd);
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef woXrooX_host_esp_log_H
+#define woXrooX_host_esp_log_H
+
+#include <stdarg.h>
+#include <stdint.h>
+
+#include "sdkconfig.h"
+
+////////////// TYPES
+
+typedef enum {
+	ESP_LOG_NONE = 0,
+	ESP_LOG_ERROR,
+	ESP_LOG_WARN,
+	ESP_LOG_INFO,
+	ESP_LOG_DEBUG,
+	ESP_LOG_VERBOSE
+} esp_log_level_t;
+
+typedef int (*vprintf_like_t)(const char *, va_list);
+
+////////////// API
+
+void esp_log_write(esp_log_level_t level, const char *tag, const char *format, ...) __attribute__((format(printf, 3, 4)));
+void esp_log_writev(esp_log_level_t level, const char *tag, const char *format, va_list args);
+uint32_t esp_log_timestamp(void);
+void esp_log_level_set(const char *tag, esp_log_level_t level);
+
+// Redirect every write (tests capture the log through this); returns the previous one
+vprintf_like_t esp_log_set_vprintf(vprintf_like_t function);
+
+////////////// ESP_LOGx: one esp_log_write per line, in the device layout
+
+#ifndef LOG_LOCAL_LEVEL
+#define LOG_LOCAL_LEVEL CONFIG_LOG_MAXIMUM_LEVEL
+#endif
+
+#define ESP_LOG_LEVEL_LOCAL(level, letter, tag, format, ...) do { \
+	if (LOG_LOCAL_LEVEL >= (level)) esp_log_write((level), (tag), letter " (%u) %s: " format "\n", (unsigned)esp_log_timestamp(), (tag), ##__VA_ARGS__); \
+} while (0)
+
+#define ESP_LOGE(tag, format, ...) ESP_LOG_LEVEL_LOCAL(ESP_LOG_ERROR, "E", tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) ESP_LOG_LEVEL_LOCAL(ESP_LOG_WARN, "W", tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) ESP_LOG_LEVEL_LOCAL(ESP_LOG_INFO, "I", tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) ESP_LOG_LEVEL_LOCAL(ESP_LOG_DEBUG, "D", tag, format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...) ESP_LOG_LEVEL_LOCAL(ESP_LOG_VERBOSE, "V", tag, format, ##__VA_ARGS__)
+
+#endif
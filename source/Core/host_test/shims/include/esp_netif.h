@@ -0,0 +1,99 @@
+#ifndef woXrooX_host_esp_netif_H
+#define woXrooX_host_esp_netif_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "esp_event.h"
+
+////////////// DEFINES
+
+#define ESP_ERR_ESP_NETIF_BASE 0x5000
+#define ESP_ERR_ESP_NETIF_INVALID_PARAMS (ESP_ERR_ESP_NETIF_BASE + 0x01)
+#define ESP_ERR_ESP_NETIF_IF_NOT_READY (ESP_ERR_ESP_NETIF_BASE + 0x02)
+#define ESP_ERR_ESP_NETIF_DHCPC_START_FAILED (ESP_ERR_ESP_NETIF_BASE + 0x03)
+#define ESP_ERR_ESP_NETIF_DHCP_ALREADY_STARTED (ESP_ERR_ESP_NETIF_BASE + 0x04)
+#define ESP_ERR_ESP_NETIF_DHCP_ALREADY_STOPPED (ESP_ERR_ESP_NETIF_BASE + 0x05)
+#define ESP_ERR_ESP_NETIF_DHCP_NOT_STOPPED (ESP_ERR_ESP_NETIF_BASE + 0x08)
+
+#define ESP_IPADDR_TYPE_V4 0
+#define ESP_IPADDR_TYPE_V6 6
+
+#define esp_ip4_addr1(ipaddr) (((const uint8_t *)(&(ipaddr)->addr))[0])
+#define esp_ip4_addr2(ipaddr) (((const uint8_t *)(&(ipaddr)->addr))[1])
+#define esp_ip4_addr3(ipaddr) (((const uint8_t *)(&(ipaddr)->addr))[2])
+#define esp_ip4_addr4(ipaddr) (((const uint8_t *)(&(ipaddr)->addr))[3])
+
+#define IPSTR "%d.%d.%d.%d"
+#define IP2STR(ipaddr) esp_ip4_addr1(ipaddr), esp_ip4_addr2(ipaddr), esp_ip4_addr3(ipaddr), esp_ip4_addr4(ipaddr)
+
+// Network byte order, like lwIP
+#define ESP_IP4TOADDR(a, b, c, d) ((uint32_t)(a) | ((uint32_t)(b) << 8) | ((uint32_t)(c) << 16) | ((uint32_t)(d) << 24))
+
+ESP_EVENT_DECLARE_BASE(IP_EVENT);
+
+////////////// TYPES
+
+typedef struct host_netif esp_netif_t;
+
+typedef struct {
+	uint32_t addr;
+} esp_ip4_addr_t;
+
+typedef struct {
+	uint32_t addr[4];
+	uint8_t zone;
+} esp_ip6_addr_t;
+
+typedef struct {
+	union {
+		esp_ip6_addr_t ip6;
+		esp_ip4_addr_t ip4;
+	} u_addr;
+	uint8_t type;
+} esp_ip_addr_t;
+
+typedef struct {
+	esp_ip4_addr_t ip;
+	esp_ip4_addr_t netmask;
+	esp_ip4_addr_t gw;
+} esp_netif_ip_info_t;
+
+typedef enum {
+	ESP_NETIF_DNS_MAIN = 0,
+	ESP_NETIF_DNS_BACKUP,
+	ESP_NETIF_DNS_FALLBACK,
+	ESP_NETIF_DNS_MAX
+} esp_netif_dns_type_t;
+
+typedef struct {
+	esp_ip_addr_t ip;
+} esp_netif_dns_info_t;
+
+typedef enum {
+	IP_EVENT_STA_GOT_IP = 0,
+	IP_EVENT_STA_LOST_IP,
+} ip_event_t;
+
+typedef struct {
+	esp_netif_t *esp_netif;
+	esp_netif_ip_info_t ip_info;
+	bool ip_changed;
+} ip_event_got_ip_t;
+
+////////////// API
+
+esp_err_t esp_netif_init(void);
+esp_netif_t *esp_netif_create_default_wifi_sta(void);
+
+// Starting DHCP clears the address until the lease arrives (IP_EVENT_STA_GOT_IP), as on the device
+esp_err_t esp_netif_dhcpc_start(esp_netif_t *netif);
+esp_err_t esp_netif_dhcpc_stop(esp_netif_t *netif);
+
+esp_err_t esp_netif_set_ip_info(esp_netif_t *netif, const esp_netif_ip_info_t *ip_info);
+esp_err_t esp_netif_get_ip_info(esp_netif_t *netif, esp_netif_ip_info_t *ip_info);
+esp_err_t esp_netif_set_dns_info(esp_netif_t *netif, esp_netif_dns_type_t type, esp_netif_dns_info_t *dns);
+esp_err_t esp_netif_get_dns_info(esp_netif_t *netif, esp_netif_dns_type_t type, esp_netif_dns_info_t *dns);
+
+#endif
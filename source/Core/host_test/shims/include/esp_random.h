@@ -0,0 +1,10 @@
+#ifndef woXrooX_host_esp_random_H
+#define woXrooX_host_esp_random_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+uint32_t esp_random(void);
+void esp_fill_random(void *buffer, size_t length);
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef woXrooX_host_esp_tls_H
+#define woXrooX_host_esp_tls_H
+
+#include "esp_err.h"
+
+////////////// API
+
+// One process-wide CA store (PEM, length including the NUL) that clients opt into with
+// use_global_ca_store, as on the device
+esp_err_t esp_tls_init_global_ca_store(void);
+esp_err_t esp_tls_set_global_ca_store(const unsigned char *cacert_pem_buf, const unsigned int cacert_pem_bytes);
+void esp_tls_free_global_ca_store(void);
+
+#endif
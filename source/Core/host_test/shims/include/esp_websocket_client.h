@@ -0,0 +1,72 @@
+/*
+esp_websocket_client on the host, against a simulated server: no socket is opened. The client task
+connects once the station is associated and host_ws_server() says the server is up, and reconnects
+HOST_WS_RECONNECT_MS after losing either. Sent messages are counted and handed to the test's
+host_ws_on_message() hook; host_ws_receive() delivers a server message as WEBSOCKET_EVENT_DATA.
+*/
+
+#ifndef woXrooX_host_esp_websocket_client_H
+#define woXrooX_host_esp_websocket_client_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "freertos/FreeRTOS.h"
+
+#include "esp_err.h"
+#include "esp_event.h"
+
+////////////// TYPES
+
+typedef struct host_websocket_client *esp_websocket_client_handle_t;
+
+ESP_EVENT_DECLARE_BASE(WEBSOCKET_EVENTS);
+
+typedef enum {
+	WEBSOCKET_EVENT_ANY = -1,
+	WEBSOCKET_EVENT_ERROR = 0,
+	WEBSOCKET_EVENT_CONNECTED,
+	WEBSOCKET_EVENT_DISCONNECTED,
+	WEBSOCKET_EVENT_DATA,
+	WEBSOCKET_EVENT_CLOSED,
+	WEBSOCKET_EVENT_BEFORE_CONNECT,
+	WEBSOCKET_EVENT_MAX
+} esp_websocket_event_id_t;
+
+typedef struct {
+	const char *data_ptr;
+	int data_len;
+	bool fin;
+	uint8_t op_code;
+	esp_websocket_client_handle_t client;
+	void *user_context;
+	int payload_len;
+	int payload_offset;
+} esp_websocket_event_data_t;
+
+typedef struct {
+	const char *uri;
+	const char *subprotocol;
+
+	bool disable_auto_reconnect;
+	int network_timeout_ms;
+	int ping_interval_sec;
+
+	bool use_global_ca_store;
+	esp_err_t (*crt_bundle_attach)(void *conf);
+} esp_websocket_client_config_t;
+
+////////////// API
+
+esp_websocket_client_handle_t esp_websocket_client_init(const esp_websocket_client_config_t *config);
+esp_err_t esp_websocket_register_events(esp_websocket_client_handle_t client, esp_websocket_event_id_t event, esp_event_handler_t event_handler, void *event_handler_arg);
+esp_err_t esp_websocket_client_start(esp_websocket_client_handle_t client);
+esp_err_t esp_websocket_client_stop(esp_websocket_client_handle_t client);
+esp_err_t esp_websocket_client_destroy(esp_websocket_client_handle_t client);
+
+bool esp_websocket_client_is_connected(esp_websocket_client_handle_t client);
+
+// Bytes sent, or -1 when not connected or the send timed out
+int esp_websocket_client_send_bin(esp_websocket_client_handle_t client, const char *data, int len, TickType_t timeout);
+
+#endif
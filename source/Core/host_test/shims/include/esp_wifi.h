@@ -0,0 +1,174 @@
+#ifndef woXrooX_host_esp_wifi_H
+#define woXrooX_host_esp_wifi_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "esp_event.h"
+
+////////////// DEFINES
+
+#define ESP_ERR_WIFI_BASE 0x3000
+#define ESP_ERR_WIFI_NOT_INIT (ESP_ERR_WIFI_BASE + 1)
+#define ESP_ERR_WIFI_NOT_STARTED (ESP_ERR_WIFI_BASE + 2)
+#define ESP_ERR_WIFI_IF (ESP_ERR_WIFI_BASE + 4)
+#define ESP_ERR_WIFI_MODE (ESP_ERR_WIFI_BASE + 5)
+#define ESP_ERR_WIFI_STATE (ESP_ERR_WIFI_BASE + 6)
+#define ESP_ERR_WIFI_CONN (ESP_ERR_WIFI_BASE + 7)
+#define ESP_ERR_WIFI_NOT_CONNECT (ESP_ERR_WIFI_BASE + 15)
+
+ESP_EVENT_DECLARE_BASE(WIFI_EVENT);
+
+////////////// TYPES
+
+typedef enum {
+	WIFI_EVENT_WIFI_READY = 0,
+	WIFI_EVENT_SCAN_DONE,
+	WIFI_EVENT_STA_START,
+	WIFI_EVENT_STA_STOP,
+	WIFI_EVENT_STA_CONNECTED,
+	WIFI_EVENT_STA_DISCONNECTED,
+} wifi_event_t;
+
+typedef enum {
+	WIFI_REASON_ASSOC_LEAVE = 8,
+	WIFI_REASON_BEACON_TIMEOUT = 200,
+	WIFI_REASON_NO_AP_FOUND = 201,
+	WIFI_REASON_AUTH_FAIL = 202,
+} wifi_err_reason_t;
+
+typedef enum {
+	WIFI_MODE_NULL = 0,
+	WIFI_MODE_STA,
+	WIFI_MODE_AP,
+	WIFI_MODE_APSTA,
+} wifi_mode_t;
+
+typedef enum {
+	WIFI_IF_STA = 0,
+	WIFI_IF_AP,
+} wifi_interface_t;
+
+typedef enum {
+	WIFI_AUTH_OPEN = 0,
+	WIFI_AUTH_WEP,
+	WIFI_AUTH_WPA_PSK,
+	WIFI_AUTH_WPA2_PSK,
+	WIFI_AUTH_WPA_WPA2_PSK,
+	WIFI_AUTH_WPA2_ENTERPRISE,
+	WIFI_AUTH_WPA3_PSK,
+	WIFI_AUTH_WPA2_WPA3_PSK,
+} wifi_auth_mode_t;
+
+typedef enum {
+	WIFI_FAST_SCAN = 0,
+	WIFI_ALL_CHANNEL_SCAN,
+} wifi_scan_method_t;
+
+typedef enum {
+	WIFI_CONNECT_AP_BY_SIGNAL = 0,
+	WIFI_CONNECT_AP_BY_SECURITY,
+} wifi_sort_method_t;
+
+typedef enum {
+	WPA3_SAE_PWE_UNSPECIFIED = 0,
+	WPA3_SAE_PWE_HUNT_AND_PECK,
+	WPA3_SAE_PWE_HASH_TO_ELEMENT,
+	WPA3_SAE_PWE_BOTH,
+} wifi_sae_pwe_method_t;
+
+typedef enum {
+	WIFI_PS_NONE = 0,
+	WIFI_PS_MIN_MODEM,
+	WIFI_PS_MAX_MODEM,
+} wifi_ps_type_t;
+
+typedef enum {
+	WIFI_PHY_MODE_LR = 0,
+	WIFI_PHY_MODE_11B,
+	WIFI_PHY_MODE_11G,
+	WIFI_PHY_MODE_HT20,
+	WIFI_PHY_MODE_HT40,
+	WIFI_PHY_MODE_HE20,
+} wifi_phy_mode_t;
+
+typedef struct {
+	int8_t rssi;
+	wifi_auth_mode_t authmode;
+} wifi_scan_threshold_t;
+
+typedef struct {
+	uint8_t ssid[32];
+	uint8_t password[64];
+	wifi_scan_method_t scan_method;
+	bool bssid_set;
+	uint8_t bssid[6];
+	uint8_t channel;
+	uint16_t listen_interval;
+	wifi_sort_method_t sort_method;
+	wifi_scan_threshold_t threshold;
+	wifi_sae_pwe_method_t sae_pwe_h2e;
+} wifi_sta_config_t;
+
+typedef struct {
+	uint8_t ssid[32];
+	uint8_t password[64];
+	uint8_t channel;
+} wifi_ap_config_t;
+
+typedef union {
+	wifi_ap_config_t ap;
+	wifi_sta_config_t sta;
+} wifi_config_t;
+
+typedef struct {
+	uint8_t bssid[6];
+	uint8_t ssid[33];
+	uint8_t primary;
+	int8_t rssi;
+	wifi_auth_mode_t authmode;
+} wifi_ap_record_t;
+
+typedef struct {
+	uint8_t ssid[32];
+	uint8_t ssid_len;
+	uint8_t bssid[6];
+	uint8_t channel;
+	wifi_auth_mode_t authmode;
+	uint16_t aid;
+} wifi_event_sta_connected_t;
+
+typedef struct {
+	uint8_t ssid[32];
+	uint8_t ssid_len;
+	uint8_t bssid[6];
+	uint8_t reason;
+	int8_t rssi;
+} wifi_event_sta_disconnected_t;
+
+typedef struct {
+	int magic;
+} wifi_init_config_t;
+
+#define WIFI_INIT_CONFIG_DEFAULT() { .magic = 0x1F2F3F4F }
+
+////////////// API
+
+// A simulated access point and DHCP server (host.h: host_wifi_*) behind the IDF calls
+esp_err_t esp_wifi_init(const wifi_init_config_t *config);
+esp_err_t esp_wifi_set_mode(wifi_mode_t mode);
+esp_err_t esp_wifi_set_config(wifi_interface_t interface, wifi_config_t *conf);
+esp_err_t esp_wifi_get_config(wifi_interface_t interface, wifi_config_t *conf);
+esp_err_t esp_wifi_start(void);
+esp_err_t esp_wifi_connect(void);
+esp_err_t esp_wifi_disconnect(void);
+
+esp_err_t esp_wifi_set_ps(wifi_ps_type_t type);
+esp_err_t esp_wifi_get_ps(wifi_ps_type_t *type);
+
+esp_err_t esp_wifi_sta_get_ap_info(wifi_ap_record_t *ap_info);
+esp_err_t esp_wifi_sta_get_rssi(int *rssi);
+esp_err_t esp_wifi_sta_get_negotiated_phymode(wifi_phy_mode_t *phymode);
+
+#endif
@@ -0,0 +1,72 @@
+/*
+FreeRTOS (ESP-IDF SMP flavour) on POSIX threads, for the host build.
+
+Tasks are pthreads, ticks are CLOCK_MONOTONIC milliseconds, and a portMUX is a recursive mutex:
+the same code paths run, with the same blocking and timeout semantics, but real parallelism
+instead of priorities. Nothing here simulates priorities or core affinity beyond reporting them.
+*/
+
+#ifndef woXrooX_host_FreeRTOS_H
+#define woXrooX_host_FreeRTOS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "sdkconfig.h"
+
+////////////// DEFINES
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+// IDF: stack sizes are in bytes
+typedef uint8_t StackType_t;
+
+#define configTICK_RATE_HZ CONFIG_FREERTOS_HZ
+#define configMAX_TASK_NAME_LEN 16
+#define configMAX_PRIORITIES 25
+#define configRUN_TIME_COUNTER_TYPE uint32_t
+#define configUSE_TRACE_FACILITY CONFIG_FREERTOS_USE_TRACE_FACILITY
+#define configGENERATE_RUN_TIME_STATS CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+
+#define portNUM_PROCESSORS CONFIG_FREERTOS_NUMBER_OF_CORES
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFFUL)
+#define portTICK_PERIOD_MS (1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(((uint64_t)(ms) * configTICK_RATE_HZ) / 1000U))
+#define pdTICKS_TO_MS(ticks) ((uint32_t)(((uint64_t)(ticks) * 1000U) / configTICK_RATE_HZ))
+
+#define pdFALSE ((BaseType_t)0)
+#define pdTRUE ((BaseType_t)1)
+#define pdFAIL pdFALSE
+#define pdPASS pdTRUE
+#define errQUEUE_EMPTY ((BaseType_t)0)
+#define errQUEUE_FULL ((BaseType_t)0)
+#define errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY ((BaseType_t)-1)
+
+////////////// Critical sections
+
+// Recursive, like a portMUX taken twice by the same core
+typedef pthread_mutex_t portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP
+
+void host_critical_enter(portMUX_TYPE *mux);
+void host_critical_exit(portMUX_TYPE *mux);
+
+#define portENTER_CRITICAL(mux) host_critical_enter(mux)
+#define portEXIT_CRITICAL(mux) host_critical_exit(mux)
+#define portENTER_CRITICAL_ISR(mux) host_critical_enter(mux)
+#define portEXIT_CRITICAL_ISR(mux) host_critical_exit(mux)
+#define portENTER_CRITICAL_SAFE(mux) host_critical_enter(mux)
+#define portEXIT_CRITICAL_SAFE(mux) host_critical_exit(mux)
+#define taskENTER_CRITICAL(mux) host_critical_enter(mux)
+#define taskEXIT_CRITICAL(mux) host_critical_exit(mux)
+#define taskENTER_CRITICAL_ISR(mux) host_critical_enter(mux)
+#define taskEXIT_CRITICAL_ISR(mux) host_critical_exit(mux)
+
+#define portYIELD_FROM_ISR(...) ((void)0)
+#define portYIELD() sched_yield()
+
+#endif
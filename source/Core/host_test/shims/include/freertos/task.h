@@ -0,0 +1,78 @@
+#ifndef woXrooX_host_task_H
+#define woXrooX_host_task_H
+
+#include <sched.h>
+
+#include "freertos/FreeRTOS.h"
+
+////////////// TYPES
+
+typedef struct host_task *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+#define tskNO_AFFINITY ((BaseType_t)0x7FFFFFFF)
+#define tskIDLE_PRIORITY ((UBaseType_t)0)
+
+typedef enum {
+	eRunning = 0,
+	eReady,
+	eBlocked,
+	eSuspended,
+	eDeleted,
+	eInvalid
+} eTaskState;
+
+typedef enum {
+	eNoAction = 0,
+	eSetBits,
+	eIncrement,
+	eSetValueWithOverwrite,
+	eSetValueWithoutOverwrite
+} eNotifyAction;
+
+typedef struct {
+	TaskHandle_t xHandle;
+	const char *pcTaskName;
+	UBaseType_t xTaskNumber;
+	eTaskState eCurrentState;
+	UBaseType_t uxCurrentPriority;
+	UBaseType_t uxBasePriority;
+	configRUN_TIME_COUNTER_TYPE ulRunTimeCounter;
+	StackType_t *pxStackBase;
+	uint32_t usStackHighWaterMark;
+	BaseType_t xCoreID;
+} TaskStatus_t;
+
+////////////// API
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char *name, uint32_t stack_bytes, void *arg, UBaseType_t priority, TaskHandle_t *out_handle, BaseType_t core);
+BaseType_t xTaskCreate(TaskFunction_t function, const char *name, uint32_t stack_bytes, void *arg, UBaseType_t priority, TaskHandle_t *out_handle);
+void vTaskDelete(TaskHandle_t task);
+
+void vTaskDelay(TickType_t ticks);
+BaseType_t xTaskDelayUntil(TickType_t *previous_wake, TickType_t increment);
+#define vTaskDelayUntil(previous_wake, increment) ((void)xTaskDelayUntil((previous_wake), (increment)))
+
+TickType_t xTaskGetTickCount(void);
+TickType_t xTaskGetTickCountFromISR(void);
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+char *pcTaskGetName(TaskHandle_t task);
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task);
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+
+UBaseType_t uxTaskGetNumberOfTasks(void);
+
+// 0 when array_size is smaller than the number of tasks, like the real one
+UBaseType_t uxTaskGetSystemState(TaskStatus_t *array, UBaseType_t array_size, configRUN_TIME_COUNTER_TYPE *total_run_time);
+
+// Notifications (index 0 only)
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action);
+BaseType_t xTaskNotifyFromISR(TaskHandle_t task, uint32_t value, eNotifyAction action, BaseType_t *higher_priority_woken);
+BaseType_t xTaskNotifyWait(uint32_t clear_on_entry, uint32_t clear_on_exit, uint32_t *value, TickType_t ticks);
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks);
+
+#define xTaskNotifyGive(task) xTaskNotify((task), 0, eIncrement)
+#define vTaskNotifyGiveFromISR(task, woken) ((void)xTaskNotifyFromISR((task), 0, eIncrement, (woken)))
+
+#endif
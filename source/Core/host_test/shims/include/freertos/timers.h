@@ -0,0 +1,39 @@
+#ifndef woXrooX_host_timers_H
+#define woXrooX_host_timers_H
+
+#include "freertos/FreeRTOS.h"
+
+////////////// TYPES
+
+typedef struct host_timer *TimerHandle_t;
+typedef void (*TimerCallbackFunction_t)(TimerHandle_t timer);
+typedef void (*PendedFunction_t)(void *, uint32_t);
+
+typedef struct {
+	void *host;
+} StaticTimer_t;
+
+////////////// API
+
+// Callbacks and pended calls all run on one "Tmr Svc" task, in order, like the timer daemon
+TimerHandle_t xTimerCreate(const char *name, TickType_t period, UBaseType_t auto_reload, void *id, TimerCallbackFunction_t callback);
+TimerHandle_t xTimerCreateStatic(const char *name, TickType_t period, UBaseType_t auto_reload, void *id, TimerCallbackFunction_t callback, StaticTimer_t *buffer);
+
+BaseType_t xTimerStart(TimerHandle_t timer, TickType_t ticks);
+BaseType_t xTimerStop(TimerHandle_t timer, TickType_t ticks);
+BaseType_t xTimerReset(TimerHandle_t timer, TickType_t ticks);
+BaseType_t xTimerChangePeriod(TimerHandle_t timer, TickType_t period, TickType_t ticks);
+BaseType_t xTimerDelete(TimerHandle_t timer, TickType_t ticks);
+BaseType_t xTimerIsTimerActive(TimerHandle_t timer);
+void *pvTimerGetTimerID(TimerHandle_t timer);
+
+#define xTimerStartFromISR(timer, woken) xTimerStart((timer), 0)
+#define xTimerStopFromISR(timer, woken) xTimerStop((timer), 0)
+#define xTimerResetFromISR(timer, woken) xTimerReset((timer), 0)
+#define xTimerChangePeriodFromISR(timer, period, woken) xTimerChangePeriod((timer), (period), 0)
+
+// Queue of 10, like CONFIG_FREERTOS_TIMER_QUEUE_LENGTH: pdFAIL when the daemon is that far behind
+BaseType_t xTimerPendFunctionCall(PendedFunction_t function, void *parameter1, uint32_t parameter2, TickType_t ticks);
+BaseType_t xTimerPendFunctionCallFromISR(PendedFunction_t function, void *parameter1, uint32_t parameter2, BaseType_t *higher_priority_woken);
+
+#endif
@@ -0,0 +1,234 @@
+/*
+Controls and probes for the host shims: what a test or the bench sets up around the woXrooX
+headers, and the counters it reads back. None of this exists on the device.
+*/
+
+#ifndef woXrooX_host_H
+#define woXrooX_host_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_err.h"
+#include "hal/gpio_types.h"
+
+////////////// Time
+
+// CLOCK_MONOTONIC since the process started (esp_timer_get_time() reads the same clock)
+uint64_t host_now_us(void);
+void host_sleep_ms(uint32_t ms);
+
+// Poll `condition` every millisecond for up to timeout_ms; true once it holds
+#define host_wait_for(condition, timeout_ms) ({ \
+	uint64_t host_deadline_ = host_now_us() + (uint64_t)(timeout_ms) * 1000ULL; \
+	while (!(condition) && host_now_us() < host_deadline_) host_sleep_ms(1); \
+	(bool)(condition); \
+})
+
+////////////// Heap (esp_heap_caps.h)
+
+// Roughly what an ESP32 has left with Wi-Fi and lwIP up
+#define HOST_HEAP_TOTAL (300 * 1024)
+
+// Forget every charge and start over with `total` bytes (also resets the minimum)
+void host_heap_reset(size_t total);
+size_t host_heap_used(void);
+
+////////////// FreeRTOS
+
+// Items copied by xQueueSend / xQueueReceive and friends since the last reset
+void host_queue_stats(uint64_t *copies, uint64_t *bytes);
+void host_queue_stats_reset(void);
+
+// A task that exists on the device but is not simulated (no thread, no CPU time)
+TaskHandle_t host_task_placeholder(const char *name, UBaseType_t priority, BaseType_t core, uint32_t stack_bytes);
+
+// CPU time of a task in microseconds (0 for placeholders)
+uint64_t host_task_cpu_us(TaskHandle_t task);
+
+// Looks a task up by name; NULL if there is none
+TaskHandle_t host_task_find(const char *name);
+
+////////////// esp_timer
+
+// Timers created and not deleted
+int host_esp_timer_count(void);
+
+////////////// I2S (driver/i2s_std.h)
+
+// Tone every channel produces: frequency and peak as a fraction of full scale (default 1 kHz, 0.02:
+// about -34 dBFS, speech level for an INMP441, which MIC.h scales to a ~21000 peak)
+void host_i2s_tone(float frequency_Hz, float amplitude);
+
+// true: reads return immediately (no pacing, no overflows), for throughput runs
+void host_i2s_free_run(bool on);
+
+// Make the next call to `function` ("i2s_new_channel", "i2s_channel_init_std_mode",
+// "i2s_channel_register_event_callback", "i2s_channel_enable") fail with err
+void host_i2s_fail_next(const char *function, esp_err_t err);
+
+// Channels created and not deleted
+int host_i2s_channels(void);
+
+// Sample rate and DMA layout of the newest channel
+void host_i2s_layout(uint32_t *rate_Hz, uint32_t *buffers, uint32_t *words);
+
+// DMA buffers lost to ring overflow, over all channels
+uint32_t host_i2s_overflows(void);
+
+////////////// GPIO (driver/gpio.h)
+
+// Drive an input pad from outside (a button, a PTT switch): 1 = high, 0 = low. An edge on a pad
+// with a matching interrupt type runs its ISR handler on the calling thread.
+void host_gpio_input(gpio_num_t pin, int level);
+
+// Stop driving the pad; it floats back to its pull
+void host_gpio_release(gpio_num_t pin);
+
+// Level last written by gpio_set_level()
+int host_gpio_output(gpio_num_t pin);
+
+// An ISR handler is registered and the pad's interrupt is enabled
+bool host_gpio_has_ISR(gpio_num_t pin);
+
+// The next gpio_isr_handler_add() for pin fails with ESP_ERR_NO_MEM
+void host_gpio_fail_ISR_add(gpio_num_t pin);
+
+////////////// LEDC (driver/ledc.h)
+
+typedef struct {
+	// ledc_fade_start() and ledc_fade_stop() calls
+	uint32_t fades;
+	uint32_t stops;
+
+	// ledc_set_duty_and_update() while a fade was still running (the write is lost)
+	uint32_t duty_during_fade;
+} host_ledc_stats_type;
+
+// Duty of a channel right now, fade included
+uint32_t host_ledc_duty(int channel);
+void host_ledc_stats(host_ledc_stats_type *out);
+
+////////////// Wi-Fi (esp_wifi.h, esp_netif.h, ping/ping_sock.h)
+
+// Timings of the simulated station (ms), scaled down from an ESP32's ~1-2 s all-channel scan
+#define HOST_WIFI_SCAN_MS 150
+#define HOST_WIFI_ASSOCIATE_MS 20
+#define HOST_WIFI_DHCP_MS 100
+
+typedef struct {
+	// Full all-channel scans, and connects that went straight to a known BSSID/channel
+	uint32_t scans;
+	uint32_t targeted;
+
+	uint32_t associations;
+	uint32_t DHCP_leases;
+
+	// esp_wifi_set_config() calls made while associated
+	uint32_t config_while_associated;
+
+	// listen_interval the driver used for the current association
+	uint16_t listen_interval;
+} host_wifi_stats_type;
+
+// The access point in range (default: CONFIG_WOXROOX_WIFI_SSID's fallback "My_WiFi",
+// 24:0a:c4:00:00:01, channel 6, -55 dBm); channel 0 = out of range
+void host_wifi_AP(const char *ssid, const uint8_t bssid[6], uint8_t channel, int8_t RSSI);
+
+// What the DHCP server hands out (default 192.168.1.50/24, gateway and DNS 192.168.1.1)
+void host_wifi_DHCP(uint32_t ip, uint32_t netmask, uint32_t gateway, uint32_t DNS);
+
+// The AP drops the station (WIFI_EVENT_STA_DISCONNECTED, beacon timeout)
+void host_wifi_drop(void);
+
+void host_wifi_stats(host_wifi_stats_type *out);
+
+// Ping RTT from the gateway in each power-save mode (wifi_ps_type_t): base + up to jitter
+void host_wifi_RTT(int ps_type, uint32_t base_us, uint32_t jitter_us);
+
+////////////// WebSocket (esp_websocket_client.h)
+
+// Delay before the client tries again after losing the server or the station's IP
+#define HOST_WS_RECONNECT_MS 200
+
+typedef struct {
+	uint32_t connects;
+
+	// Messages that went out, by first byte (WS_protocol.h types), and sends that failed
+	uint32_t messages;
+	uint64_t bytes;
+	uint32_t audio;
+	uint32_t PTT;
+	uint32_t spooled;
+	uint32_t features;
+	uint32_t metrics;
+	uint32_t failed;
+} host_ws_stats_type;
+
+typedef void (*host_ws_message_hook)(const uint8_t *data, size_t length);
+
+// The server accepts connections (default) or refuses them and drops the current one
+void host_ws_server(bool up);
+
+// Time every send takes; a send longer than its timeout fails after the timeout
+void host_ws_send_time(uint32_t us);
+
+// Make the next `count` sends fail
+void host_ws_fail_sends(uint32_t count);
+
+// Called with every message that went out, on the sending task
+void host_ws_on_message(host_ws_message_hook hook);
+
+// A binary message from the server, delivered as WEBSOCKET_EVENT_DATA; false if none is connected
+bool host_ws_receive(const uint8_t *data, size_t length);
+
+void host_ws_stats(host_ws_stats_type *out);
+
+////////////// HTTP server (esp_http_server.h)
+
+typedef struct {
+	// Connections taken, turned away for lack of a slot, and closed to make room (LRU purge)
+	uint32_t accepted;
+	uint32_t refused;
+	uint32_t purged;
+
+	uint32_t closed;
+	uint32_t requests;
+} host_httpd_stats_type;
+
+// Port the server listens on (the one picked when server_port was 0)
+uint16_t host_httpd_port(void *handle);
+void host_httpd_stats(void *handle, host_httpd_stats_type *out);
+
+////////////// Flash partitions (esp_partition.h)
+
+typedef struct {
+	uint32_t reads;
+	uint32_t writes;
+	uint32_t erases;
+
+	// Time spent in esp_partition_erase_range(), all callers
+	uint64_t erase_us;
+} host_partition_stats_type;
+
+// A data partition `label` of `size` bytes (whole 4 KB sectors) kept in the file at `path`;
+// what the file already holds is the flash contents, the rest reads erased
+bool host_partition_add(const char *label, const char *path, uint32_t size);
+
+// How long erasing one sector takes (default 45 ms, a typical ESP32 flash)
+void host_partition_erase_ms(uint32_t ms);
+
+void host_partition_stats(host_partition_stats_type *out);
+
+// Sectors erased from the task named `task_name` ("main" outside any task)
+uint32_t host_partition_erases_by(const char *task_name);
+
+////////////// NVS (nvs.h)
+
+// Commits since start (flash writes)
+uint32_t host_nvs_commits(void);
+
+#endif
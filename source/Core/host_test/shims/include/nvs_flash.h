@@ -0,0 +1,15 @@
+#ifndef woXrooX_host_nvs_flash_H
+#define woXrooX_host_nvs_flash_H
+
+#include "esp_err.h"
+
+#include "nvs.h"
+
+////////////// API
+
+// Loads the store from the file named by WOXROOX_HOST_NVS (if set); commits write it back, so
+// a test can "reboot" by running itself again
+esp_err_t nvs_flash_init(void);
+esp_err_t nvs_flash_erase(void);
+
+#endif
@@ -0,0 +1,22 @@
+/*
+Host build configuration: the subset of an ESP32 sdkconfig the woXrooX headers and the shims read.
+
+woXrooX options are left out on purpose, so every module runs on its own fallbacks unless a test
+defines CONFIG_WOXROOX_* itself.
+*/
+
+#ifndef woXrooX_host_sdkconfig_H
+#define woXrooX_host_sdkconfig_H
+
+#define CONFIG_IDF_TARGET "esp32"
+#define CONFIG_IDF_TARGET_ESP32 1
+
+#define CONFIG_FREERTOS_HZ 1000
+#define CONFIG_FREERTOS_NUMBER_OF_CORES 2
+#define CONFIG_FREERTOS_USE_TRACE_FACILITY 1
+#define CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS 1
+
+#define CONFIG_LOG_MAXIMUM_LEVEL 3
+#define CONFIG_LOG_DEFAULT_LEVEL 3
+
+#endif
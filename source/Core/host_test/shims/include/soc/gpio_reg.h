@@ -0,0 +1,8 @@
+#ifndef woXrooX_host_gpio_reg_H
+#define woXrooX_host_gpio_reg_H
+
+// ESP32 addresses; pads 0..31 and 32..39 (low byte of IN1)
+#define GPIO_IN_REG 0x3FF4403C
+#define GPIO_IN1_REG 0x3FF44040
+
+#endif
@@ -0,0 +1,15 @@
+/*
+Register access on the host: REG_READ() of the GPIO input registers returns the simulated pads
+(see driver/gpio.h); no other register exists.
+*/
+
+#ifndef woXrooX_host_soc_H
+#define woXrooX_host_soc_H
+
+#include <stdint.h>
+
+uint32_t host_reg_read(uint32_t address);
+
+#define REG_READ(address) host_reg_read((uint32_t)(address))
+
+#endif
@@ -0,0 +1,312 @@
+/*
+NVS on the host: namespaces of typed key/value entries in memory. With WOXROOX_HOST_NVS set,
+nvs_flash_init() loads the store from that file and nvs_commit() writes it back, so values
+survive a "reboot" (the test running itself again); uncommitted writes are lost, as on the device.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "nvs.h"
+#include "nvs_flash.h"
+
+#include "host.h"
+#include "host_internal.h"
+
+////////////// DEFINES
+
+#define HOST_NVS_ENTRIES_MAX 64
+#define HOST_NVS_HANDLES_MAX 16
+#define HOST_NVS_VALUE_MAX 512
+
+// Entry types (a value read back with another getter is ESP_ERR_NVS_TYPE_MISMATCH)
+#define HOST_NVS_U8 1
+#define HOST_NVS_U32 4
+#define HOST_NVS_BLOB 0x42
+
+////////////// TYPES
+
+typedef struct {
+	char space[NVS_KEY_NAME_MAX_SIZE];
+	char key[NVS_KEY_NAME_MAX_SIZE];
+	uint8_t type;
+	uint16_t length;
+	uint8_t value[HOST_NVS_VALUE_MAX];
+	uint8_t used;
+} host_nvs_entry_type;
+
+typedef struct {
+	char space[NVS_KEY_NAME_MAX_SIZE];
+	nvs_open_mode_t mode;
+	bool used;
+} host_nvs_handle_type;
+
+////////////// GLOBALS
+
+static pthread_mutex_t host_nvs_lock = PTHREAD_MUTEX_INITIALIZER;
+static bool host_nvs_ready = false;
+
+// What a commit makes durable, and what has been written since
+static host_nvs_entry_type host_nvs_flash[HOST_NVS_ENTRIES_MAX];
+static host_nvs_entry_type host_nvs_pending[HOST_NVS_ENTRIES_MAX];
+
+static host_nvs_handle_type host_nvs_handles[HOST_NVS_HANDLES_MAX];
+static uint32_t host_nvs_commit_count = 0;
+
+////////////// File
+
+static void host_nvs_load(void) {
+	memset(host_nvs_flash, 0, sizeof(host_nvs_flash));
+
+	const char *path = getenv("WOXROOX_HOST_NVS");
+	FILE *f = path ? fopen(path, "rb") : NULL;
+	if (!f) return;
+
+	if (fread(host_nvs_flash, sizeof(host_nvs_flash), 1, f) != 1) memset(host_nvs_flash, 0, sizeof(host_nvs_flash));
+	fclose(f);
+}
+
+static void host_nvs_save(void) {
+	const char *path = getenv("WOXROOX_HOST_NVS");
+	FILE *f = path ? fopen(path, "wb") : NULL;
+	if (!f) return;
+
+	fwrite(host_nvs_flash, sizeof(host_nvs_flash), 1, f);
+	fclose(f);
+}
+
+////////////// Flash
+
+esp_err_t nvs_flash_init(void) {
+	pthread_mutex_lock(&host_nvs_lock);
+
+	if (!host_nvs_ready) {
+		host_nvs_load();
+		memcpy(host_nvs_pending, host_nvs_flash, sizeof(host_nvs_flash));
+		host_nvs_ready = true;
+	}
+
+	pthread_mutex_unlock(&host_nvs_lock);
+
+	return ESP_OK;
+}
+
+esp_err_t nvs_flash_erase(void) {
+	pthread_mutex_lock(&host_nvs_lock);
+
+	memset(host_nvs_flash, 0, sizeof(host_nvs_flash));
+	memset(host_nvs_pending, 0, sizeof(host_nvs_pending));
+	host_nvs_ready = false;
+	host_nvs_save();
+
+	pthread_mutex_unlock(&host_nvs_lock);
+
+	return ESP_OK;
+}
+
+////////////// Handles
+
+static host_nvs_handle_type *host_nvs_handle(nvs_handle_t handle) {
+	if (handle == 0 || handle > HOST_NVS_HANDLES_MAX) return NULL;
+
+	host_nvs_handle_type *h = &host_nvs_handles[handle - 1];
+	return h->used ? h : NULL;
+}
+
+static host_nvs_entry_type *host_nvs_find(const char *space, const char *key) {
+	for (int i = 0; i < HOST_NVS_ENTRIES_MAX; ++i) {
+		host_nvs_entry_type *e = &host_nvs_pending[i];
+		if (e->used && strcmp(e->space, space) == 0 && strcmp(e->key, key) == 0) return e;
+	}
+
+	return NULL;
+}
+
+esp_err_t nvs_open(const char *name, nvs_open_mode_t open_mode, nvs_handle_t *out_handle) {
+	if (!name || !out_handle) return ESP_ERR_INVALID_ARG;
+	if (strlen(name) >= NVS_KEY_NAME_MAX_SIZE) return ESP_ERR_NVS_KEY_TOO_LONG;
+
+	pthread_mutex_lock(&host_nvs_lock);
+
+	if (!host_nvs_ready) {
+		pthread_mutex_unlock(&host_nvs_lock);
+		return ESP_ERR_NVS_NOT_INITIALIZED;
+	}
+
+	// Read-only on a namespace that was never written: NOT_FOUND, as on the device
+	bool exists = false;
+	for (int i = 0; i < HOST_NVS_ENTRIES_MAX && !exists; ++i) exists = host_nvs_pending[i].used && strcmp(host_nvs_pending[i].space, name) == 0;
+
+	int slot = -1;
+	for (int i = 0; i < HOST_NVS_HANDLES_MAX && slot < 0; ++i) if (!host_nvs_handles[i].used) slot = i;
+
+	esp_err_t err = ESP_OK;
+	if (open_mode == NVS_READONLY && !exists) err = ESP_ERR_NVS_NOT_FOUND;
+	else if (slot < 0) err = ESP_ERR_NO_MEM;
+	else {
+		host_nvs_handles[slot] = (host_nvs_handle_type){ .mode = open_mode, .used = true };
+		strcpy(host_nvs_handles[slot].space, name);
+		*out_handle = (nvs_handle_t)slot + 1;
+	}
+
+	pthread_mutex_unlock(&host_nvs_lock);
+
+	return err;
+}
+
+void nvs_close(nvs_handle_t handle) {
+	pthread_mutex_lock(&host_nvs_lock);
+
+	host_nvs_handle_type *h = host_nvs_handle(handle);
+	if (h) h->used = false;
+
+	pthread_mutex_unlock(&host_nvs_lock);
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle) {
+	pthread_mutex_lock(&host_nvs_lock);
+
+	host_nvs_handle_type *h = host_nvs_handle(handle);
+
+	if (h) {
+		memcpy(host_nvs_flash, host_nvs_pending, sizeof(host_nvs_flash));
+		host_nvs_commit_count++;
+		host_nvs_save();
+	}
+
+	pthread_mutex_unlock(&host_nvs_lock);
+
+	return h ? ESP_OK : ESP_ERR_NVS_INVALID_HANDLE;
+}
+
+////////////// Values
+
+static esp_err_t host_nvs_set(nvs_handle_t handle, const char *key, uint8_t type, const void *value, size_t length) {
+	if (!key || (!value && length)) return ESP_ERR_INVALID_ARG;
+	if (strlen(key) >= NVS_KEY_NAME_MAX_SIZE) return ESP_ERR_NVS_KEY_TOO_LONG;
+	if (length > HOST_NVS_VALUE_MAX) return ESP_ERR_NVS_VALUE_TOO_LONG;
+
+	pthread_mutex_lock(&host_nvs_lock);
+
+	esp_err_t err = ESP_OK;
+	host_nvs_handle_type *h = host_nvs_handle(handle);
+	host_nvs_entry_type *e = h ? host_nvs_find(h->space, key) : NULL;
+
+	if (!h) err = ESP_ERR_NVS_INVALID_HANDLE;
+	else if (h->mode == NVS_READONLY) err = ESP_ERR_NVS_READ_ONLY;
+	else {
+		for (int i = 0; i < HOST_NVS_ENTRIES_MAX && !e; ++i) if (!host_nvs_pending[i].used) e = &host_nvs_pending[i];
+
+		if (!e) err = ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+		else {
+			memset(e, 0, sizeof(*e));
+			strcpy(e->space, h->space);
+			strcpy(e->key, key);
+			e->type = type;
+			e->length = (uint16_t)length;
+			if (length) memcpy(e->value, value, length);
+			e->used = 1;
+		}
+	}
+
+	pthread_mutex_unlock(&host_nvs_lock);
+
+	return err;
+}
+
+// *length in: capacity of out (ignored when out is NULL), out: stored length
+static esp_err_t host_nvs_get(nvs_handle_t handle, const char *key, uint8_t type, void *out, size_t *length) {
+	if (!key || !length) return ESP_ERR_INVALID_ARG;
+
+	pthread_mutex_lock(&host_nvs_lock);
+
+	esp_err_t err = ESP_OK;
+	host_nvs_handle_type *h = host_nvs_handle(handle);
+	host_nvs_entry_type *e = h ? host_nvs_find(h->space, key) : NULL;
+
+	if (!h) err = ESP_ERR_NVS_INVALID_HANDLE;
+	else if (!e) err = ESP_ERR_NVS_NOT_FOUND;
+	else if (e->type != type) err = ESP_ERR_NVS_TYPE_MISMATCH;
+	else if (out && *length < e->length) err = ESP_ERR_NVS_INVALID_LENGTH;
+	else {
+		if (out) memcpy(out, e->value, e->length);
+		*length = e->length;
+	}
+
+	pthread_mutex_unlock(&host_nvs_lock);
+
+	return err;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value, size_t length) {
+	return host_nvs_set(handle, key, HOST_NVS_BLOB, value, length);
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out_value, size_t *length) {
+	return host_nvs_get(handle, key, HOST_NVS_BLOB, out_value, length);
+}
+
+esp_err_t nvs_set_u8(nvs_handle_t handle, const char *key, uint8_t value) {
+	return host_nvs_set(handle, key, HOST_NVS_U8, &value, sizeof(value));
+}
+
+esp_err_t nvs_get_u8(nvs_handle_t handle, const char *key, uint8_t *out_value) {
+	size_t length = sizeof(*out_value);
+	return host_nvs_get(handle, key, HOST_NVS_U8, out_value, &length);
+}
+
+esp_err_t nvs_set_u32(nvs_handle_t handle, const char *key, uint32_t value) {
+	return host_nvs_set(handle, key, HOST_NVS_U32, &value, sizeof(value));
+}
+
+esp_err_t nvs_get_u32(nvs_handle_t handle, const char *key, uint32_t *out_value) {
+	size_t length = sizeof(*out_value);
+	return host_nvs_get(handle, key, HOST_NVS_U32, out_value, &length);
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char *key) {
+	pthread_mutex_lock(&host_nvs_lock);
+
+	esp_err_t err = ESP_OK;
+	host_nvs_handle_type *h = host_nvs_handle(handle);
+	host_nvs_entry_type *e = h ? host_nvs_find(h->space, key) : NULL;
+
+	if (!h) err = ESP_ERR_NVS_INVALID_HANDLE;
+	else if (h->mode == NVS_READONLY) err = ESP_ERR_NVS_READ_ONLY;
+	else if (!e) err = ESP_ERR_NVS_NOT_FOUND;
+	else e->used = 0;
+
+	pthread_mutex_unlock(&host_nvs_lock);
+
+	return err;
+}
+
+esp_err_t nvs_erase_all(nvs_handle_t handle) {
+	pthread_mutex_lock(&host_nvs_lock);
+
+	esp_err_t err = ESP_OK;
+	host_nvs_handle_type *h = host_nvs_handle(handle);
+
+	if (!h) err = ESP_ERR_NVS_INVALID_HANDLE;
+	else if (h->mode == NVS_READONLY) err = ESP_ERR_NVS_READ_ONLY;
+	else {
+		for (int i = 0; i < HOST_NVS_ENTRIES_MAX; ++i) {
+			if (host_nvs_pending[i].used && strcmp(host_nvs_pending[i].space, h->space) == 0) host_nvs_pending[i].used = 0;
+		}
+	}
+
+	pthread_mutex_unlock(&host_nvs_lock);
+
+	return err;
+}
+
+////////////// Probes
+
+uint32_t host_nvs_commits(void) {
+	pthread_mutex_lock(&host_nvs_lock);
+	uint32_t n = host_nvs_commit_count;
+	pthread_mutex_unlock(&host_nvs_lock);
+
+	return n;
+}
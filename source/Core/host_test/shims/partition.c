@@ -0,0 +1,230 @@
+/*
+Flash partitions on the host: each one a file, so its contents survive the process like flash
+survives a reset. NOR rules: erase sets 4 KB sectors to 0xFF and takes a while, writes only clear
+bits. Reads and writes return at once; the cache pause they cause on the device is not modelled.
+*/
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "esp_partition.h"
+
+#include "host.h"
+#include "host_internal.h"
+
+////////////// DEFINES
+
+#define HOST_PARTITIONS_MAX 4
+#define HOST_PARTITION_SECTOR 4096
+#define HOST_PARTITION_ERASERS_MAX 8
+
+////////////// TYPES
+
+typedef struct {
+	esp_partition_t partition;
+	int fd;
+} host_partition_type;
+
+////////////// GLOBALS
+
+static pthread_mutex_t host_partition_lock = PTHREAD_MUTEX_INITIALIZER;
+static host_partition_type host_partitions[HOST_PARTITIONS_MAX];
+static int host_partition_count = 0;
+
+// A typical 4 KB sector erase on an ESP32's flash (datasheets: 45 ms typical, 400 ms worst)
+static uint32_t host_partition_erase_time_ms = 45;
+
+static host_partition_stats_type host_partition_counters;
+
+// Erases per calling task
+static struct {
+	char name[configMAX_TASK_NAME_LEN];
+	uint32_t erases;
+} host_partition_erasers[HOST_PARTITION_ERASERS_MAX];
+
+////////////// Helpers
+
+static host_partition_type *host_partition_of(const esp_partition_t *partition) {
+	for (int i = 0; i < host_partition_count; ++i) {
+		if (&host_partitions[i].partition == partition) return &host_partitions[i];
+	}
+
+	return NULL;
+}
+
+static bool host_partition_in_range(const esp_partition_t *partition, size_t offset, size_t size) {
+	return offset <= partition->size && size <= partition->size - offset;
+}
+
+////////////// Controls
+
+bool host_partition_add(const char *label, const char *path, uint32_t size) {
+	if (!label || !path || size == 0 || size % HOST_PARTITION_SECTOR) return false;
+
+	pthread_mutex_lock(&host_partition_lock);
+
+	if (host_partition_count >= HOST_PARTITIONS_MAX) {
+		pthread_mutex_unlock(&host_partition_lock);
+		return false;
+	}
+
+	int fd = open(path, O_RDWR | O_CREAT, 0600);
+	if (fd < 0) {
+		pthread_mutex_unlock(&host_partition_lock);
+		return false;
+	}
+
+	// New (or short) file: the missing part reads as erased flash
+	off_t length = lseek(fd, 0, SEEK_END);
+	uint8_t blank[HOST_PARTITION_SECTOR];
+	memset(blank, 0xFF, sizeof(blank));
+
+	for (off_t at = length < 0 ? 0 : length; at < (off_t)size; at += sizeof(blank)) {
+		size_t chunk = (off_t)size - at < (off_t)sizeof(blank) ? (size_t)((off_t)size - at) : sizeof(blank);
+
+		if (pwrite(fd, blank, chunk, at) != (ssize_t)chunk) {
+			close(fd);
+			pthread_mutex_unlock(&host_partition_lock);
+			return false;
+		}
+	}
+
+	host_partition_type *p = &host_partitions[host_partition_count++];
+	memset(p, 0, sizeof(*p));
+	p->fd = fd;
+	p->partition.type = ESP_PARTITION_TYPE_DATA;
+	p->partition.subtype = ESP_PARTITION_SUBTYPE_DATA_UNDEFINED;
+	p->partition.address = 0x110000 + (uint32_t)(host_partition_count - 1) * 0x100000;
+	p->partition.size = size;
+	p->partition.erase_size = HOST_PARTITION_SECTOR;
+	strncpy(p->partition.label, label, sizeof(p->partition.label) - 1);
+
+	pthread_mutex_unlock(&host_partition_lock);
+
+	return true;
+}
+
+void host_partition_erase_ms(uint32_t ms) {
+	__atomic_store_n(&host_partition_erase_time_ms, ms, __ATOMIC_RELAXED);
+}
+
+void host_partition_stats(host_partition_stats_type *out) {
+	pthread_mutex_lock(&host_partition_lock);
+	*out = host_partition_counters;
+	pthread_mutex_unlock(&host_partition_lock);
+}
+
+uint32_t host_partition_erases_by(const char *task_name) {
+	uint32_t erases = 0;
+
+	pthread_mutex_lock(&host_partition_lock);
+
+	for (int i = 0; i < HOST_PARTITION_ERASERS_MAX; ++i) {
+		if (strcmp(host_partition_erasers[i].name, task_name) == 0) erases = host_partition_erasers[i].erases;
+	}
+
+	pthread_mutex_unlock(&host_partition_lock);
+
+	return erases;
+}
+
+////////////// esp_partition.h
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype, const char *label) {
+	const esp_partition_t *found = NULL;
+
+	pthread_mutex_lock(&host_partition_lock);
+
+	for (int i = 0; i < host_partition_count && !found; ++i) {
+		const esp_partition_t *p = &host_partitions[i].partition;
+
+		if (type != ESP_PARTITION_TYPE_ANY && p->type != type) continue;
+		if (subtype != ESP_PARTITION_SUBTYPE_ANY && p->subtype != subtype) continue;
+		if (label && strcmp(p->label, label) != 0) continue;
+
+		found = p;
+	}
+
+	pthread_mutex_unlock(&host_partition_lock);
+
+	return found;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *partition, size_t src_offset, void *dst, size_t size) {
+	host_partition_type *p = host_partition_of(partition);
+	if (!p || !dst) return ESP_ERR_INVALID_ARG;
+	if (!host_partition_in_range(partition, src_offset, size)) return ESP_ERR_INVALID_SIZE;
+
+	pthread_mutex_lock(&host_partition_lock);
+	bool ok = pread(p->fd, dst, size, src_offset) == (ssize_t)size;
+	host_partition_counters.reads++;
+	pthread_mutex_unlock(&host_partition_lock);
+
+	return ok ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t *partition, size_t dst_offset, const void *src, size_t size) {
+	host_partition_type *p = host_partition_of(partition);
+	if (!p || !src) return ESP_ERR_INVALID_ARG;
+	if (!host_partition_in_range(partition, dst_offset, size)) return ESP_ERR_INVALID_SIZE;
+
+	uint8_t cell[256];
+	bool ok = true;
+
+	pthread_mutex_lock(&host_partition_lock);
+
+	// Programming only turns 1s into 0s
+	for (size_t done = 0; done < size && ok; done += sizeof(cell)) {
+		size_t chunk = size - done < sizeof(cell) ? size - done : sizeof(cell);
+
+		ok = pread(p->fd, cell, chunk, dst_offset + done) == (ssize_t)chunk;
+		for (size_t i = 0; ok && i < chunk; ++i) cell[i] &= ((const uint8_t *)src)[done + i];
+		ok = ok && pwrite(p->fd, cell, chunk, dst_offset + done) == (ssize_t)chunk;
+	}
+
+	host_partition_counters.writes++;
+	pthread_mutex_unlock(&host_partition_lock);
+
+	return ok ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t *partition, size_t offset, size_t size) {
+	host_partition_type *p = host_partition_of(partition);
+	if (!p) return ESP_ERR_INVALID_ARG;
+	if (offset % partition->erase_size || size % partition->erase_size) return ESP_ERR_INVALID_ARG;
+	if (!host_partition_in_range(partition, offset, size)) return ESP_ERR_INVALID_SIZE;
+
+	uint64_t start_us = host_now_us();
+
+	// The flash is busy for the whole erase; the calling task just waits
+	host_sleep_ms(__atomic_load_n(&host_partition_erase_time_ms, __ATOMIC_RELAXED) * (uint32_t)(size / partition->erase_size));
+
+	uint8_t blank[HOST_PARTITION_SECTOR];
+	memset(blank, 0xFF, sizeof(blank));
+	bool ok = true;
+
+	pthread_mutex_lock(&host_partition_lock);
+
+	for (size_t at = offset; at < offset + size && ok; at += sizeof(blank)) ok = pwrite(p->fd, blank, sizeof(blank), at) == (ssize_t)sizeof(blank);
+
+	uint64_t erase_us = host_now_us() - start_us;
+	host_partition_counters.erases++;
+	host_partition_counters.erase_us += erase_us;
+
+	const char *name = pcTaskGetName(NULL);
+
+	for (int i = 0; i < HOST_PARTITION_ERASERS_MAX; ++i) {
+		if (host_partition_erasers[i].name[0] == '\0') strncpy(host_partition_erasers[i].name, name, sizeof(host_partition_erasers[i].name) - 1);
+
+		if (strcmp(host_partition_erasers[i].name, name) == 0) {
+			host_partition_erasers[i].erases++;
+			break;
+		}
+	}
+
+	pthread_mutex_unlock(&host_partition_lock);
+
+	return ok ? ESP_OK : ESP_FAIL;
+}
@@ -0,0 +1,311 @@
+/*
+esp_websocket_client on the host (see esp_websocket_client.h for the model).
+
+One client task per started client, like the real component: it owns the connection state and
+runs the registered handler for every event. Sends happen on the caller's task.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_websocket_client.h"
+
+#include "host.h"
+#include "host_internal.h"
+
+////////////// DEFINES
+
+#define HOST_WS_POLL_MS 5
+#define HOST_WS_INBOX 8
+#define HOST_WS_MESSAGE_MAX 1024
+
+ESP_EVENT_DEFINE_BASE(WEBSOCKET_EVENTS);
+
+////////////// TYPES
+
+typedef struct {
+	uint8_t data[HOST_WS_MESSAGE_MAX];
+	int length;
+} host_ws_message_type;
+
+struct host_websocket_client {
+	esp_websocket_client_config_t config;
+
+	esp_event_handler_t handler;
+	void *handler_arg;
+
+	TaskHandle_t task;
+	bool running;
+	bool connected;
+	uint64_t next_attempt_us;
+
+	host_ws_message_type inbox[HOST_WS_INBOX];
+	int inbox_count;
+};
+
+////////////// GLOBALS
+
+static pthread_mutex_t host_ws_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static bool host_ws_up = true;
+static uint32_t host_ws_send_us = 0;
+static uint32_t host_ws_failures = 0;
+static host_ws_message_hook host_ws_hook = NULL;
+static host_ws_stats_type host_ws_statistics;
+
+// The newest started client, for host_ws_receive()
+static struct host_websocket_client *host_ws_current = NULL;
+
+////////////// Client task
+
+static void host_ws_event(struct host_websocket_client *client, int32_t id, esp_websocket_event_data_t *data) {
+	esp_websocket_event_data_t empty = { .client = client };
+	if (!data) data = &empty;
+
+	if (client->handler) client->handler(client->handler_arg, WEBSOCKET_EVENTS, id, data);
+}
+
+static void host_ws_task(void *arg) {
+	struct host_websocket_client *client = arg;
+	static host_ws_message_type message;
+
+	for (;;) {
+		pthread_mutex_lock(&host_ws_lock);
+
+		if (!client->running) {
+			bool was = client->connected;
+			client->connected = false;
+			pthread_mutex_unlock(&host_ws_lock);
+
+			if (was) host_ws_event(client, WEBSOCKET_EVENT_DISCONNECTED, NULL);
+			host_ws_event(client, WEBSOCKET_EVENT_CLOSED, NULL);
+			vTaskDelete(NULL);
+			return;
+		}
+
+		uint64_t now = host_now_us();
+		bool reachable = host_ws_up && host_wifi_online();
+		int32_t event = -1;
+
+		if (!client->connected && reachable && now >= client->next_attempt_us) {
+			client->connected = true;
+			host_ws_statistics.connects++;
+			event = WEBSOCKET_EVENT_CONNECTED;
+		}
+
+		else if (client->connected && !reachable) {
+			client->connected = false;
+			client->next_attempt_us = now + (uint64_t)HOST_WS_RECONNECT_MS * 1000ULL;
+			event = WEBSOCKET_EVENT_DISCONNECTED;
+		}
+
+		bool deliver = event < 0 && client->connected && client->inbox_count > 0;
+
+		if (deliver) {
+			message = client->inbox[0];
+			memmove(client->inbox, client->inbox + 1, (size_t)--client->inbox_count * sizeof(client->inbox[0]));
+		}
+
+		pthread_mutex_unlock(&host_ws_lock);
+
+		if (event >= 0) {
+			host_ws_event(client, event, NULL);
+			continue;
+		}
+
+		if (deliver) {
+			esp_websocket_event_data_t data = {
+				.data_ptr = (const char *)message.data,
+				.data_len = message.length,
+				.fin = true,
+				.op_code = 2,
+				.client = client,
+				.payload_len = message.length,
+				.payload_offset = 0,
+			};
+
+			host_ws_event(client, WEBSOCKET_EVENT_DATA, &data);
+			continue;
+		}
+
+		host_sleep_ms(HOST_WS_POLL_MS);
+	}
+}
+
+////////////// API
+
+esp_websocket_client_handle_t esp_websocket_client_init(const esp_websocket_client_config_t *config) {
+	if (!config || !config->uri) return NULL;
+	if (!host_heap_take(sizeof(struct host_websocket_client))) return NULL;
+
+	struct host_websocket_client *client = calloc(1, sizeof(*client));
+	client->config = *config;
+
+	return client;
+}
+
+esp_err_t esp_websocket_register_events(esp_websocket_client_handle_t client, esp_websocket_event_id_t event, esp_event_handler_t event_handler, void *event_handler_arg) {
+	if (!client || event != WEBSOCKET_EVENT_ANY) return ESP_ERR_INVALID_ARG;
+
+	client->handler = event_handler;
+	client->handler_arg = event_handler_arg;
+
+	return ESP_OK;
+}
+
+esp_err_t esp_websocket_client_start(esp_websocket_client_handle_t client) {
+	if (!client) return ESP_ERR_INVALID_ARG;
+
+	pthread_mutex_lock(&host_ws_lock);
+
+	if (client->running) {
+		pthread_mutex_unlock(&host_ws_lock);
+		return ESP_FAIL;
+	}
+
+	client->running = true;
+	host_ws_current = client;
+
+	pthread_mutex_unlock(&host_ws_lock);
+
+	// The component's own task (default websocket_task, 4 KB, priority 5)
+	if (xTaskCreate(host_ws_task, "websocket_task", 4096, client, 5, &client->task) != pdPASS) {
+		client->running = false;
+		return ESP_ERR_NO_MEM;
+	}
+
+	return ESP_OK;
+}
+
+esp_err_t esp_websocket_client_stop(esp_websocket_client_handle_t client) {
+	if (!client) return ESP_ERR_INVALID_ARG;
+
+	pthread_mutex_lock(&host_ws_lock);
+	client->running = false;
+	pthread_mutex_unlock(&host_ws_lock);
+
+	return ESP_OK;
+}
+
+esp_err_t esp_websocket_client_destroy(esp_websocket_client_handle_t client) {
+	if (!client) return ESP_ERR_INVALID_ARG;
+
+	esp_websocket_client_stop(client);
+
+	// The task exits on its next round; the client is kept (it may still be running a handler)
+	pthread_mutex_lock(&host_ws_lock);
+	if (host_ws_current == client) host_ws_current = NULL;
+	pthread_mutex_unlock(&host_ws_lock);
+
+	return ESP_OK;
+}
+
+bool esp_websocket_client_is_connected(esp_websocket_client_handle_t client) {
+	if (!client) return false;
+
+	pthread_mutex_lock(&host_ws_lock);
+	bool connected = client->connected;
+	pthread_mutex_unlock(&host_ws_lock);
+
+	return connected;
+}
+
+int esp_websocket_client_send_bin(esp_websocket_client_handle_t client, const char *data, int len, TickType_t timeout) {
+	if (!client || !data || len < 0) return -1;
+
+	pthread_mutex_lock(&host_ws_lock);
+
+	bool ok = client->connected;
+	uint32_t send_us = host_ws_send_us;
+
+	if (ok && host_ws_failures) {
+		host_ws_failures--;
+		ok = false;
+	}
+
+	// Time on the wire (the real client blocks in its TCP write, up to `timeout`)
+	uint64_t timeout_us = (uint64_t)timeout * (1000000ULL / configTICK_RATE_HZ);
+	if (ok && send_us > timeout_us) {
+		send_us = (uint32_t)timeout_us;
+		ok = false;
+	}
+
+	if (ok) {
+		host_ws_statistics.messages++;
+		host_ws_statistics.bytes += (uint64_t)len;
+
+		switch (len ? (uint8_t)data[0] : 0) {
+			case 1: host_ws_statistics.audio++; break;
+			case 2: host_ws_statistics.PTT++; break;
+			case 3: host_ws_statistics.spooled++; break;
+			case 4: host_ws_statistics.features++; break;
+			case 'W': host_ws_statistics.metrics++; break;
+			default: break;
+		}
+	}
+
+	else host_ws_statistics.failed++;
+
+	host_ws_message_hook hook = host_ws_hook;
+
+	pthread_mutex_unlock(&host_ws_lock);
+
+	if (send_us) host_sleep_ms((send_us + 999) / 1000);
+
+	if (!ok) return -1;
+
+	if (hook) hook((const uint8_t *)data, (size_t)len);
+
+	return len;
+}
+
+////////////// Controls
+
+void host_ws_server(bool up) {
+	pthread_mutex_lock(&host_ws_lock);
+	host_ws_up = up;
+	pthread_mutex_unlock(&host_ws_lock);
+}
+
+void host_ws_send_time(uint32_t us) {
+	pthread_mutex_lock(&host_ws_lock);
+	host_ws_send_us = us;
+	pthread_mutex_unlock(&host_ws_lock);
+}
+
+void host_ws_fail_sends(uint32_t count) {
+	pthread_mutex_lock(&host_ws_lock);
+	host_ws_failures = count;
+	pthread_mutex_unlock(&host_ws_lock);
+}
+
+void host_ws_on_message(host_ws_message_hook hook) {
+	pthread_mutex_lock(&host_ws_lock);
+	host_ws_hook = hook;
+	pthread_mutex_unlock(&host_ws_lock);
+}
+
+bool host_ws_receive(const uint8_t *data, size_t length) {
+	if (length > HOST_WS_MESSAGE_MAX) return false;
+
+	pthread_mutex_lock(&host_ws_lock);
+
+	struct host_websocket_client *client = host_ws_current;
+	bool ok = client && client->inbox_count < HOST_WS_INBOX;
+
+	if (ok) {
+		host_ws_message_type *m = &client->inbox[client->inbox_count++];
+		memcpy(m->data, data, length);
+		m->length = (int)length;
+	}
+
+	pthread_mutex_unlock(&host_ws_lock);
+
+	return ok;
+}
+
+void host_ws_stats(host_ws_stats_type *out) {
+	pthread_mutex_lock(&host_ws_lock);
+	*out = host_ws_statistics;
+	pthread_mutex_unlock(&host_ws_lock);
+}
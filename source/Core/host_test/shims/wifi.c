@@ -0,0 +1,622 @@
+/*
+A Wi-Fi station, its netif and ping on the host, against one simulated access point and DHCP
+server. The "wifi" task plays the driver: scans (or goes straight to a cached BSSID/channel),
+associates, hands out leases, and posts the same WIFI_EVENT / IP_EVENT sequence as the IDF:
+
+	esp_wifi_start()              → STA_START
+	esp_wifi_connect()            → STA_CONNECTED, then GOT_IP (static address at once, DHCP later)
+	                                or STA_DISCONNECTED (NO_AP_FOUND)
+	host_wifi_drop()              → STA_DISCONNECTED (BEACON_TIMEOUT)
+	esp_netif_dhcpc_start()       → address cleared, GOT_IP when the lease arrives
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_netif.h"
+#include "esp_wifi.h"
+#include "ping/ping_sock.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "host.h"
+#include "host_internal.h"
+
+////////////// DEFINES
+
+#define HOST_WIFI_COMMANDS_MAX 16
+
+ESP_EVENT_DEFINE_BASE(WIFI_EVENT);
+ESP_EVENT_DEFINE_BASE(IP_EVENT);
+
+////////////// TYPES
+
+typedef enum {
+	HOST_WIFI_CONNECT,
+	HOST_WIFI_LEASE,
+	HOST_WIFI_DROP,
+	HOST_WIFI_LEAVE,
+} host_wifi_command_type;
+
+struct host_netif {
+	bool DHCP;
+	esp_netif_ip_info_t ip_info;
+	esp_netif_dns_info_t DNS;
+};
+
+typedef enum {
+	HOST_WIFI_IDLE,
+	HOST_WIFI_CONNECTING,
+	HOST_WIFI_ASSOCIATED,
+} host_wifi_state_type;
+
+typedef struct {
+	esp_ping_config_t config;
+	esp_ping_callbacks_t callbacks;
+	TaskHandle_t task;
+
+	uint32_t sequence;
+	uint32_t replies;
+	uint32_t last_RTT_ms;
+	uint64_t started_us;
+
+	bool stop;
+	bool delete;
+} host_ping_type;
+
+////////////// GLOBALS
+
+static pthread_mutex_t host_wifi_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t host_wifi_changed;
+static pthread_once_t host_wifi_once = PTHREAD_ONCE_INIT;
+
+static bool host_wifi_initialised = false;
+static bool host_wifi_started = false;
+static host_wifi_state_type host_wifi_state = HOST_WIFI_IDLE;
+static wifi_config_t host_wifi_config;
+static wifi_ps_type_t host_wifi_ps = WIFI_PS_MIN_MODEM;
+
+static host_wifi_command_type host_wifi_commands[HOST_WIFI_COMMANDS_MAX];
+static int host_wifi_command_count = 0;
+
+static struct host_netif host_netif_STA;
+static bool host_netif_created = false;
+
+// The world
+static char host_AP_SSID[33] = "My_WiFi";
+static uint8_t host_AP_BSSID[6] = { 0x24, 0x0a, 0xc4, 0x00, 0x00, 0x01 };
+static uint8_t host_AP_channel = 6;
+static int8_t host_AP_RSSI = -55;
+
+static uint32_t host_DHCP_ip = ESP_IP4TOADDR(192, 168, 1, 50);
+static uint32_t host_DHCP_netmask = ESP_IP4TOADDR(255, 255, 255, 0);
+static uint32_t host_DHCP_gateway = ESP_IP4TOADDR(192, 168, 1, 1);
+static uint32_t host_DHCP_DNS = ESP_IP4TOADDR(192, 168, 1, 1);
+
+static uint32_t host_RTT_base_us[3] = { 3000, 25000, 90000 };
+static uint32_t host_RTT_jitter_us[3] = { 1000, 20000, 60000 };
+
+static host_wifi_stats_type host_wifi_statistics;
+
+////////////// Driver task
+
+static void host_wifi_post_disconnected(uint8_t reason) {
+	wifi_event_sta_disconnected_t event = { .reason = reason, .rssi = host_AP_RSSI };
+	memcpy(event.ssid, host_wifi_config.sta.ssid, sizeof(event.ssid));
+	event.ssid_len = (uint8_t)strnlen((const char *)event.ssid, sizeof(event.ssid));
+
+	esp_event_post(WIFI_EVENT, WIFI_EVENT_STA_DISCONNECTED, &event, sizeof(event), portMAX_DELAY);
+}
+
+static void host_wifi_post_got_IP(bool changed) {
+	ip_event_got_ip_t event = { .esp_netif = &host_netif_STA, .ip_info = host_netif_STA.ip_info, .ip_changed = changed };
+	esp_event_post(IP_EVENT, IP_EVENT_STA_GOT_IP, &event, sizeof(event), portMAX_DELAY);
+}
+
+static void host_wifi_queue(host_wifi_command_type command) {
+	if (host_wifi_command_count < HOST_WIFI_COMMANDS_MAX) host_wifi_commands[host_wifi_command_count++] = command;
+	pthread_cond_signal(&host_wifi_changed);
+}
+
+// Called with the lock held; sleeps without it
+static void host_wifi_sleep_unlocked(uint32_t ms) {
+	pthread_mutex_unlock(&host_wifi_lock);
+	host_sleep_ms(ms);
+	pthread_mutex_lock(&host_wifi_lock);
+}
+
+static void host_wifi_connect(void) {
+	if (host_wifi_state != HOST_WIFI_IDLE) return;
+	host_wifi_state = HOST_WIFI_CONNECTING;
+
+	wifi_sta_config_t *sta = &host_wifi_config.sta;
+	bool targeted = sta->bssid_set && sta->channel != 0 && sta->scan_method == WIFI_FAST_SCAN;
+
+	if (targeted) host_wifi_statistics.targeted++;
+	else host_wifi_statistics.scans++;
+
+	host_wifi_sleep_unlocked(targeted ? HOST_WIFI_ASSOCIATE_MS : HOST_WIFI_SCAN_MS + HOST_WIFI_ASSOCIATE_MS);
+
+	bool found = host_AP_channel != 0 && strncmp((const char *)sta->ssid, host_AP_SSID, sizeof(sta->ssid)) == 0;
+	if (found && sta->bssid_set) found = memcmp(sta->bssid, host_AP_BSSID, 6) == 0;
+	if (found && targeted) found = sta->channel == host_AP_channel;
+
+	if (host_wifi_state != HOST_WIFI_CONNECTING) return;
+
+	if (!found) {
+		host_wifi_state = HOST_WIFI_IDLE;
+		host_wifi_post_disconnected(WIFI_REASON_NO_AP_FOUND);
+		return;
+	}
+
+	host_wifi_state = HOST_WIFI_ASSOCIATED;
+	host_wifi_statistics.associations++;
+	host_wifi_statistics.listen_interval = sta->listen_interval ? sta->listen_interval : 3;
+
+	wifi_event_sta_connected_t connected = { .channel = host_AP_channel, .authmode = WIFI_AUTH_WPA2_PSK, .aid = 1 };
+	memcpy(connected.ssid, sta->ssid, sizeof(connected.ssid));
+	memcpy(connected.bssid, host_AP_BSSID, 6);
+	esp_event_post(WIFI_EVENT, WIFI_EVENT_STA_CONNECTED, &connected, sizeof(connected), portMAX_DELAY);
+
+	// Static address: up at once. DHCP: the lease follows.
+	if (host_netif_STA.DHCP) host_wifi_queue(HOST_WIFI_LEASE);
+	else if (host_netif_STA.ip_info.ip.addr) host_wifi_post_got_IP(false);
+}
+
+static void host_wifi_lease(void) {
+	host_wifi_sleep_unlocked(HOST_WIFI_DHCP_MS);
+
+	if (host_wifi_state != HOST_WIFI_ASSOCIATED || !host_netif_STA.DHCP || host_netif_STA.ip_info.ip.addr) return;
+
+	host_netif_STA.ip_info.ip.addr = host_DHCP_ip;
+	host_netif_STA.ip_info.netmask.addr = host_DHCP_netmask;
+	host_netif_STA.ip_info.gw.addr = host_DHCP_gateway;
+	host_netif_STA.DNS.ip.type = ESP_IPADDR_TYPE_V4;
+	host_netif_STA.DNS.ip.u_addr.ip4.addr = host_DHCP_DNS;
+	host_wifi_statistics.DHCP_leases++;
+
+	host_wifi_post_got_IP(true);
+}
+
+static void host_wifi_leave(uint8_t reason) {
+	if (host_wifi_state == HOST_WIFI_IDLE) return;
+
+	host_wifi_state = HOST_WIFI_IDLE;
+
+	// A DHCP address goes with the link; a static one stays configured
+	if (host_netif_STA.DHCP) memset(&host_netif_STA.ip_info, 0, sizeof(host_netif_STA.ip_info));
+
+	host_wifi_post_disconnected(reason);
+}
+
+static void host_wifi_task(void *arg) {
+	(void)arg;
+
+	pthread_mutex_lock(&host_wifi_lock);
+
+	for (;;) {
+		while (host_wifi_command_count == 0) host_cond_wait(&host_wifi_changed, &host_wifi_lock, NULL);
+
+		host_wifi_command_type command = host_wifi_commands[0];
+		memmove(host_wifi_commands, host_wifi_commands + 1, (size_t)--host_wifi_command_count * sizeof(host_wifi_commands[0]));
+
+		switch (command) {
+			case HOST_WIFI_CONNECT: host_wifi_connect(); break;
+			case HOST_WIFI_LEASE: host_wifi_lease(); break;
+			case HOST_WIFI_DROP: host_wifi_leave(WIFI_REASON_BEACON_TIMEOUT); break;
+			case HOST_WIFI_LEAVE: host_wifi_leave(WIFI_REASON_ASSOC_LEAVE); break;
+		}
+	}
+}
+
+static void host_wifi_task_start(void) {
+	host_cond_init(&host_wifi_changed);
+	host_service_task("wifi", 23, 0, 3584, host_wifi_task, NULL);
+}
+
+////////////// esp_wifi
+
+esp_err_t esp_wifi_init(const wifi_init_config_t *config) {
+	if (!config) return ESP_ERR_INVALID_ARG;
+
+	pthread_once(&host_wifi_once, host_wifi_task_start);
+
+	pthread_mutex_lock(&host_wifi_lock);
+	host_wifi_initialised = true;
+	pthread_mutex_unlock(&host_wifi_lock);
+
+	return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_mode(wifi_mode_t mode) {
+	return host_wifi_initialised ? ESP_OK : ESP_ERR_WIFI_NOT_INIT;
+}
+
+esp_err_t esp_wifi_set_config(wifi_interface_t interface, wifi_config_t *conf) {
+	if (!conf) return ESP_ERR_INVALID_ARG;
+	if (interface != WIFI_IF_STA) return ESP_ERR_WIFI_IF;
+
+	pthread_mutex_lock(&host_wifi_lock);
+
+	esp_err_t err = ESP_OK;
+	if (!host_wifi_initialised) err = ESP_ERR_WIFI_NOT_INIT;
+	else {
+		if (host_wifi_state == HOST_WIFI_ASSOCIATED) host_wifi_statistics.config_while_associated++;
+		host_wifi_config = *conf;
+	}
+
+	pthread_mutex_unlock(&host_wifi_lock);
+
+	return err;
+}
+
+esp_err_t esp_wifi_get_config(wifi_interface_t interface, wifi_config_t *conf) {
+	if (!conf) return ESP_ERR_INVALID_ARG;
+	if (interface != WIFI_IF_STA) return ESP_ERR_WIFI_IF;
+
+	pthread_mutex_lock(&host_wifi_lock);
+	*conf = host_wifi_config;
+	esp_err_t err = host_wifi_initialised ? ESP_OK : ESP_ERR_WIFI_NOT_INIT;
+	pthread_mutex_unlock(&host_wifi_lock);
+
+	return err;
+}
+
+esp_err_t esp_wifi_start(void) {
+	pthread_mutex_lock(&host_wifi_lock);
+
+	esp_err_t err = host_wifi_initialised ? ESP_OK : ESP_ERR_WIFI_NOT_INIT;
+	bool post = err == ESP_OK && !host_wifi_started;
+	if (post) host_wifi_started = true;
+
+	pthread_mutex_unlock(&host_wifi_lock);
+
+	if (post) esp_event_post(WIFI_EVENT, WIFI_EVENT_STA_START, NULL, 0, portMAX_DELAY);
+
+	return err;
+}
+
+esp_err_t esp_wifi_connect(void) {
+	pthread_mutex_lock(&host_wifi_lock);
+
+	esp_err_t err = ESP_OK;
+	if (!host_wifi_initialised) err = ESP_ERR_WIFI_NOT_INIT;
+	else if (!host_wifi_started) err = ESP_ERR_WIFI_NOT_STARTED;
+	else if (host_wifi_state == HOST_WIFI_ASSOCIATED) err = ESP_ERR_WIFI_CONN;
+	else host_wifi_queue(HOST_WIFI_CONNECT);
+
+	pthread_mutex_unlock(&host_wifi_lock);
+
+	return err;
+}
+
+esp_err_t esp_wifi_disconnect(void) {
+	pthread_mutex_lock(&host_wifi_lock);
+
+	esp_err_t err = host_wifi_started ? ESP_OK : ESP_ERR_WIFI_NOT_STARTED;
+	if (err == ESP_OK) host_wifi_queue(HOST_WIFI_LEAVE);
+
+	pthread_mutex_unlock(&host_wifi_lock);
+
+	return err;
+}
+
+esp_err_t esp_wifi_set_ps(wifi_ps_type_t type) {
+	if (type > WIFI_PS_MAX_MODEM) return ESP_ERR_INVALID_ARG;
+
+	pthread_mutex_lock(&host_wifi_lock);
+	host_wifi_ps = type;
+	pthread_mutex_unlock(&host_wifi_lock);
+
+	return ESP_OK;
+}
+
+esp_err_t esp_wifi_get_ps(wifi_ps_type_t *type) {
+	if (!type) return ESP_ERR_INVALID_ARG;
+
+	pthread_mutex_lock(&host_wifi_lock);
+	*type = host_wifi_ps;
+	pthread_mutex_unlock(&host_wifi_lock);
+
+	return ESP_OK;
+}
+
+esp_err_t esp_wifi_sta_get_ap_info(wifi_ap_record_t *ap_info) {
+	if (!ap_info) return ESP_ERR_INVALID_ARG;
+
+	pthread_mutex_lock(&host_wifi_lock);
+
+	esp_err_t err = host_wifi_state == HOST_WIFI_ASSOCIATED ? ESP_OK : ESP_ERR_WIFI_NOT_CONNECT;
+
+	if (err == ESP_OK) {
+		memset(ap_info, 0, sizeof(*ap_info));
+		memcpy(ap_info->bssid, host_AP_BSSID, 6);
+		memcpy(ap_info->ssid, host_AP_SSID, strnlen(host_AP_SSID, sizeof(ap_info->ssid) - 1));
+		ap_info->primary = host_AP_channel;
+		ap_info->rssi = host_AP_RSSI;
+		ap_info->authmode = WIFI_AUTH_WPA2_PSK;
+	}
+
+	pthread_mutex_unlock(&host_wifi_lock);
+
+	return err;
+}
+
+esp_err_t esp_wifi_sta_get_rssi(int *rssi) {
+	if (!rssi) return ESP_ERR_INVALID_ARG;
+
+	pthread_mutex_lock(&host_wifi_lock);
+	esp_err_t err = host_wifi_state == HOST_WIFI_ASSOCIATED ? ESP_OK : ESP_ERR_WIFI_NOT_CONNECT;
+	if (err == ESP_OK) *rssi = host_AP_RSSI;
+	pthread_mutex_unlock(&host_wifi_lock);
+
+	return err;
+}
+
+esp_err_t esp_wifi_sta_get_negotiated_phymode(wifi_phy_mode_t *phymode) {
+	if (!phymode) return ESP_ERR_INVALID_ARG;
+
+	pthread_mutex_lock(&host_wifi_lock);
+	esp_err_t err = host_wifi_state == HOST_WIFI_ASSOCIATED ? ESP_OK : ESP_ERR_WIFI_NOT_CONNECT;
+	if (err == ESP_OK) *phymode = WIFI_PHY_MODE_HT20;
+	pthread_mutex_unlock(&host_wifi_lock);
+
+	return err;
+}
+
+////////////// esp_netif
+
+esp_err_t esp_netif_init(void) {
+	return ESP_OK;
+}
+
+esp_netif_t *esp_netif_create_default_wifi_sta(void) {
+	pthread_mutex_lock(&host_wifi_lock);
+
+	if (!host_netif_created) {
+		memset(&host_netif_STA, 0, sizeof(host_netif_STA));
+		host_netif_STA.DHCP = true;
+		host_netif_created = true;
+	}
+
+	pthread_mutex_unlock(&host_wifi_lock);
+
+	return &host_netif_STA;
+}
+
+esp_err_t esp_netif_dhcpc_start(esp_netif_t *netif) {
+	if (netif != &host_netif_STA) return ESP_ERR_ESP_NETIF_INVALID_PARAMS;
+
+	pthread_mutex_lock(&host_wifi_lock);
+
+	esp_err_t err = ESP_OK;
+	if (netif->DHCP) err = ESP_ERR_ESP_NETIF_DHCP_ALREADY_STARTED;
+	else {
+		netif->DHCP = true;
+		memset(&netif->ip_info, 0, sizeof(netif->ip_info));
+		if (host_wifi_state == HOST_WIFI_ASSOCIATED) host_wifi_queue(HOST_WIFI_LEASE);
+	}
+
+	pthread_mutex_unlock(&host_wifi_lock);
+
+	return err;
+}
+
+esp_err_t esp_netif_dhcpc_stop(esp_netif_t *netif) {
+	if (netif != &host_netif_STA) return ESP_ERR_ESP_NETIF_INVALID_PARAMS;
+
+	pthread_mutex_lock(&host_wifi_lock);
+	esp_err_t err = netif->DHCP ? ESP_OK : ESP_ERR_ESP_NETIF_DHCP_ALREADY_STOPPED;
+	netif->DHCP = false;
+	pthread_mutex_unlock(&host_wifi_lock);
+
+	return err;
+}
+
+esp_err_t esp_netif_set_ip_info(esp_netif_t *netif, const esp_netif_ip_info_t *ip_info) {
+	if (netif != &host_netif_STA || !ip_info) return ESP_ERR_ESP_NETIF_INVALID_PARAMS;
+
+	pthread_mutex_lock(&host_wifi_lock);
+	esp_err_t err = netif->DHCP ? ESP_ERR_ESP_NETIF_DHCP_NOT_STOPPED : ESP_OK;
+	if (err == ESP_OK) netif->ip_info = *ip_info;
+	pthread_mutex_unlock(&host_wifi_lock);
+
+	return err;
+}
+
+esp_err_t esp_netif_get_ip_info(esp_netif_t *netif, esp_netif_ip_info_t *ip_info) {
+	if (netif != &host_netif_STA || !ip_info) return ESP_ERR_ESP_NETIF_INVALID_PARAMS;
+
+	pthread_mutex_lock(&host_wifi_lock);
+	*ip_info = netif->ip_info;
+	pthread_mutex_unlock(&host_wifi_lock);
+
+	return ESP_OK;
+}
+
+esp_err_t esp_netif_set_dns_info(esp_netif_t *netif, esp_netif_dns_type_t type, esp_netif_dns_info_t *dns) {
+	if (netif != &host_netif_STA || !dns || type != ESP_NETIF_DNS_MAIN) return ESP_ERR_ESP_NETIF_INVALID_PARAMS;
+
+	pthread_mutex_lock(&host_wifi_lock);
+	netif->DNS = *dns;
+	pthread_mutex_unlock(&host_wifi_lock);
+
+	return ESP_OK;
+}
+
+esp_err_t esp_netif_get_dns_info(esp_netif_t *netif, esp_netif_dns_type_t type, esp_netif_dns_info_t *dns) {
+	if (netif != &host_netif_STA || !dns || type != ESP_NETIF_DNS_MAIN) return ESP_ERR_ESP_NETIF_INVALID_PARAMS;
+
+	pthread_mutex_lock(&host_wifi_lock);
+	*dns = netif->DNS;
+	pthread_mutex_unlock(&host_wifi_lock);
+
+	return ESP_OK;
+}
+
+////////////// Ping
+
+static void host_ping_task(void *arg) {
+	host_ping_type *p = arg;
+
+	// Waits for esp_ping_start()
+	ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+	static uint32_t seed = 12345;
+	p->started_us = host_now_us();
+
+	for (uint32_t i = 0; i < p->config.count && !p->stop; ++i) {
+		if (i) host_sleep_ms(p->config.interval_ms);
+
+		pthread_mutex_lock(&host_wifi_lock);
+		bool reachable = host_wifi_state == HOST_WIFI_ASSOCIATED && host_netif_STA.ip_info.gw.addr == p->config.target_addr.u_addr.ip4.addr;
+		wifi_ps_type_t ps = host_wifi_ps;
+		seed = seed * 1664525u + 1013904223u;
+		uint32_t RTT_us = host_RTT_base_us[ps] + (host_RTT_jitter_us[ps] ? (seed >> 8) % host_RTT_jitter_us[ps] : 0);
+		pthread_mutex_unlock(&host_wifi_lock);
+
+		p->sequence++;
+
+		if (!reachable || RTT_us >= p->config.timeout_ms * 1000U) {
+			host_sleep_ms(p->config.timeout_ms);
+			if (p->callbacks.on_ping_timeout) p->callbacks.on_ping_timeout(p, p->callbacks.cb_args);
+			continue;
+		}
+
+		host_sleep_ms((RTT_us + 999) / 1000);
+
+		p->replies++;
+		p->last_RTT_ms = (RTT_us + 500) / 1000;
+		if (p->callbacks.on_ping_success) p->callbacks.on_ping_success(p, p->callbacks.cb_args);
+	}
+
+	if (p->callbacks.on_ping_end) p->callbacks.on_ping_end(p, p->callbacks.cb_args);
+
+	// esp_ping_delete_session() from on_ping_end (the usual pattern) lands here
+	while (!p->delete) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+	free(p);
+	vTaskDelete(NULL);
+}
+
+esp_err_t esp_ping_new_session(const esp_ping_config_t *config, const esp_ping_callbacks_t *cbs, esp_ping_handle_t *hdl_out) {
+	if (!config || !hdl_out || config->count == 0) return ESP_ERR_INVALID_ARG;
+
+	host_ping_type *p = calloc(1, sizeof(*p));
+	if (!p) return ESP_ERR_NO_MEM;
+
+	p->config = *config;
+	if (cbs) p->callbacks = *cbs;
+
+	if (xTaskCreate(host_ping_task, "ping", config->task_stack_size, p, config->task_prio, &p->task) != pdPASS) {
+		free(p);
+		return ESP_ERR_NO_MEM;
+	}
+
+	*hdl_out = p;
+
+	return ESP_OK;
+}
+
+esp_err_t esp_ping_start(esp_ping_handle_t hdl) {
+	if (!hdl) return ESP_ERR_INVALID_ARG;
+	xTaskNotifyGive(((host_ping_type *)hdl)->task);
+
+	return ESP_OK;
+}
+
+esp_err_t esp_ping_stop(esp_ping_handle_t hdl) {
+	if (!hdl) return ESP_ERR_INVALID_ARG;
+	((host_ping_type *)hdl)->stop = true;
+
+	return ESP_OK;
+}
+
+esp_err_t esp_ping_delete_session(esp_ping_handle_t hdl) {
+	if (!hdl) return ESP_ERR_INVALID_ARG;
+
+	host_ping_type *p = hdl;
+	p->stop = true;
+	p->delete = true;
+
+	if (xTaskGetCurrentTaskHandle() != p->task) xTaskNotifyGive(p->task);
+
+	return ESP_OK;
+}
+
+esp_err_t esp_ping_get_profile(esp_ping_handle_t hdl, esp_ping_profile_t profile, void *data, uint32_t size) {
+	if (!hdl || !data || size < sizeof(uint32_t)) return ESP_ERR_INVALID_ARG;
+
+	host_ping_type *p = hdl;
+	uint32_t value = 0;
+
+	switch (profile) {
+		case ESP_PING_PROF_SEQNO: value = p->sequence; break;
+		case ESP_PING_PROF_REQUEST: value = p->sequence; break;
+		case ESP_PING_PROF_REPLY: value = p->replies; break;
+		case ESP_PING_PROF_TIMEGAP: value = p->last_RTT_ms; break;
+		case ESP_PING_PROF_DURATION: value = (uint32_t)((host_now_us() - p->started_us) / 1000ULL); break;
+		case ESP_PING_PROF_SIZE: value = p->config.data_size; break;
+		case ESP_PING_PROF_TTL: value = (uint32_t)p->config.ttl; break;
+		default: return ESP_ERR_INVALID_ARG;
+	}
+
+	memcpy(data, &value, sizeof(value));
+
+	return ESP_OK;
+}
+
+////////////// Controls
+
+bool host_wifi_online(void) {
+	pthread_mutex_lock(&host_wifi_lock);
+	bool online = !host_wifi_initialised || (host_wifi_state == HOST_WIFI_ASSOCIATED && host_netif_STA.ip_info.ip.addr != 0);
+	pthread_mutex_unlock(&host_wifi_lock);
+
+	return online;
+}
+
+void host_wifi_AP(const char *ssid, const uint8_t bssid[6], uint8_t channel, int8_t RSSI) {
+	pthread_mutex_lock(&host_wifi_lock);
+
+	snprintf(host_AP_SSID, sizeof(host_AP_SSID), "%s", ssid);
+	memcpy(host_AP_BSSID, bssid, 6);
+	host_AP_channel = channel;
+	host_AP_RSSI = RSSI;
+
+	pthread_mutex_unlock(&host_wifi_lock);
+}
+
+void host_wifi_DHCP(uint32_t ip, uint32_t netmask, uint32_t gateway, uint32_t DNS) {
+	pthread_mutex_lock(&host_wifi_lock);
+
+	host_DHCP_ip = ip;
+	host_DHCP_netmask = netmask;
+	host_DHCP_gateway = gateway;
+	host_DHCP_DNS = DNS;
+
+	pthread_mutex_unlock(&host_wifi_lock);
+}
+
+void host_wifi_drop(void) {
+	pthread_mutex_lock(&host_wifi_lock);
+	host_wifi_queue(HOST_WIFI_DROP);
+	pthread_mutex_unlock(&host_wifi_lock);
+}
+
+void host_wifi_stats(host_wifi_stats_type *out) {
+	pthread_mutex_lock(&host_wifi_lock);
+	*out = host_wifi_statistics;
+	pthread_mutex_unlock(&host_wifi_lock);
+}
+
+void host_wifi_RTT(int ps_type, uint32_t base_us, uint32_t jitter_us) {
+	if (ps_type < 0 || ps_type > WIFI_PS_MAX_MODEM) return;
+
+	pthread_mutex_lock(&host_wifi_lock);
+	host_RTT_base_us[ps_type] = base_us;
+	host_RTT_jitter_us[ps_type] = jitter_us;
+	pthread_mutex_unlock(&host_wifi_lock);
+}
@@ -0,0 +1,122 @@
+// IMA ADPCM: round trip quality, block independence, odd lengths and clipping
+
+#include <math.h>
+#include <string.h>
+
+#include "Test.h"
+
+#include "woXrooX/ADPCM.h"
+
+#define SAMPLES 320
+
+static double snr_dB(const int16_t *reference, const int16_t *decoded, size_t n) {
+	double signal = 0.0;
+	double noise = 0.0;
+
+	for (size_t i = 0; i < n; ++i) {
+		double d = (double)reference[i] - decoded[i];
+		signal += (double)reference[i] * reference[i];
+		noise += d * d;
+	}
+
+	return 10.0 * log10(signal / (noise + 1e-9));
+}
+
+static void sine(int16_t *pcm, size_t n, double frequency_Hz, double amplitude, size_t offset) {
+	for (size_t i = 0; i < n; ++i) pcm[i] = (int16_t)lround(amplitude * sin(2.0 * M_PI * frequency_Hz * (double)(i + offset) / 16000.0));
+}
+
+static void test_round_trip(void) {
+	int16_t pcm[SAMPLES];
+	int16_t decoded[SAMPLES];
+	uint8_t packed[ADPCM_BYTES(SAMPLES)];
+
+	ADPCM_state_type state = { 0 };
+
+	// Let the step size settle, then measure a steady-state block
+	sine(pcm, SAMPLES, 440.0, 8000.0, 0);
+	ADPCM_encode(&state, pcm, SAMPLES, packed);
+
+	sine(pcm, SAMPLES, 440.0, 8000.0, SAMPLES);
+	ADPCM_state_type start = state;
+	ADPCM_encode(&state, pcm, SAMPLES, packed);
+	ADPCM_decode(&start, packed, SAMPLES, decoded);
+
+	// IMA ADPCM on a clean tone: well above 20 dB
+	CHECK(snr_dB(pcm, decoded, SAMPLES) > 20.0);
+
+	// Encoder and decoder share ADPCM_step(), so they end in the same state
+	CHECK_EQ(start.predictor, state.predictor);
+	CHECK_EQ(start.index, state.index);
+}
+
+static void test_blocks_independent(void) {
+	int16_t pcm[3][SAMPLES];
+	uint8_t packed[3][ADPCM_BYTES(SAMPLES)];
+	ADPCM_state_type starts[3];
+	ADPCM_state_type state = { 0 };
+
+	for (int b = 0; b < 3; ++b) {
+		sine(pcm[b], SAMPLES, 300.0 + 200.0 * b, 6000.0, (size_t)b * SAMPLES);
+		starts[b] = state;
+		ADPCM_encode(&state, pcm[b], SAMPLES, packed[b]);
+	}
+
+	// Block 2 decodes from its own start state with block 1 lost
+	int16_t alone[SAMPLES];
+	int16_t chained[SAMPLES];
+	ADPCM_state_type s = starts[2];
+	ADPCM_decode(&s, packed[2], SAMPLES, alone);
+
+	ADPCM_state_type c = starts[0];
+	ADPCM_decode(&c, packed[0], SAMPLES, chained);
+	ADPCM_decode(&c, packed[1], SAMPLES, chained);
+	ADPCM_decode(&c, packed[2], SAMPLES, chained);
+
+	CHECK(memcmp(alone, chained, sizeof(alone)) == 0);
+}
+
+static void test_odd_length(void) {
+	int16_t pcm[5] = { 100, 200, 300, 400, 500 };
+	uint8_t packed[ADPCM_BYTES(5)] = { 0 };
+	int16_t decoded[5];
+
+	CHECK_EQ(sizeof(packed), 3);
+
+	ADPCM_state_type e = { 0 };
+	ADPCM_state_type d = { 0 };
+	ADPCM_encode(&e, pcm, 5, packed);
+	ADPCM_decode(&d, packed, 5, decoded);
+
+	// The unused high nibble of the last byte stays zero
+	CHECK_EQ(packed[2] >> 4, 0);
+	CHECK_EQ(d.predictor, e.predictor);
+}
+
+static void test_full_scale(void) {
+	int16_t pcm[SAMPLES];
+	int16_t decoded[SAMPLES];
+	uint8_t packed[ADPCM_BYTES(SAMPLES)];
+
+	for (int i = 0; i < SAMPLES; ++i) pcm[i] = (i / 8) % 2 ? 32767 : -32768;
+
+	ADPCM_state_type e = { 0 };
+	ADPCM_state_type d = { 0 };
+	ADPCM_encode(&e, pcm, SAMPLES, packed);
+	ADPCM_decode(&d, packed, SAMPLES, decoded);
+
+	// Square wave at full scale: the predictor clamps instead of wrapping
+	int wrong_sign = 0;
+	for (int i = 160; i < SAMPLES; ++i) if ((i % 8) == 7 && (decoded[i] > 0) != (pcm[i] > 0)) wrong_sign++;
+	CHECK_EQ(wrong_sign, 0);
+	CHECK(e.index <= 88);
+}
+
+int main(void) {
+	TEST(test_round_trip);
+	TEST(test_blocks_independent);
+	TEST(test_odd_length);
+	TEST(test_full_scale);
+
+	return TEST_END();
+}
@@ -0,0 +1,127 @@
+// Buttons.h on the GPIO shim: events carry the time of the edge rather than of the debounce that
+// confirmed it, a button held through boot is a long press from the start, not at once, and a
+// start that fails half way leaves nothing behind
+
+#include "Test.h"
+#include "host.h"
+
+#include "woXrooX/Buttons.h"
+
+#define HELD_PIN GPIO_NUM_26
+#define PIN GPIO_NUM_25
+
+// The confirming scan comes 3 scans after the first one that saw the edge: that is how far before
+// its arrival an event's stamp must be (less a tick of rounding), however late the scans run
+#define DEBOUNCE_US ((3 * BUTTONS_SCAN_MS - 1) * 1000)
+
+// Stamped at the edge, not at the confirmation: consistent on a loaded host too
+static bool stamped_at_edge(const Buttons_event_type *event, uint64_t edge_us, uint64_t arrived_us) {
+	return event->ts_us >= edge_us && arrived_us - event->ts_us >= DEBOUNCE_US;
+}
+
+static bool next_event(Buttons_event_type *event, uint32_t timeout_ms) {
+	return xQueueReceive(Buttons_queue(), event, pdMS_TO_TICKS(timeout_ms)) == pdTRUE;
+}
+
+static uint64_t started_us;
+
+static void test_held_through_boot(void) {
+	Buttons_event_type event;
+
+	// No PRESS for a button that was already down, and no LONG_PRESS on the first scan
+	CHECK(!next_event(&event, BUTTONS_LONG_PRESS_MS / 2));
+
+	CHECK(next_event(&event, BUTTONS_LONG_PRESS_MS));
+	CHECK_EQ(event.id, 0);
+	CHECK_EQ(event.type, BUTTONS_EVENT_LONG_PRESS);
+	CHECK(event.ts_us - started_us >= BUTTONS_LONG_PRESS_MS * 1000ULL);
+	CHECK(event.ts_us - started_us < (BUTTONS_LONG_PRESS_MS + 100) * 1000ULL);
+
+	// Let go before the first REPEAT: only the RELEASE follows
+	host_gpio_release(HELD_PIN);
+	CHECK(next_event(&event, 200));
+	CHECK_EQ(event.type, BUTTONS_EVENT_RELEASE);
+	CHECK(!next_event(&event, BUTTONS_DOUBLE_CLICK_MS + 50));
+}
+
+static void test_edge_timestamps(void) {
+	Buttons_event_type event;
+
+	uint64_t press_us = host_now_us();
+	host_gpio_input(PIN, 0);
+
+	CHECK(next_event(&event, 200));
+	CHECK_EQ(event.id, 1);
+	CHECK_EQ(event.type, BUTTONS_EVENT_PRESS);
+	CHECK(stamped_at_edge(&event, press_us, host_now_us()));
+
+	host_sleep_ms(60);
+
+	uint64_t release_us = host_now_us();
+	host_gpio_release(PIN);
+
+	CHECK(next_event(&event, 200));
+	CHECK_EQ(event.type, BUTTONS_EVENT_RELEASE);
+	CHECK(stamped_at_edge(&event, release_us, host_now_us()));
+
+	uint64_t released_ts_us = event.ts_us;
+
+	// The click is reported once the double-click window closes, with the release's time
+	CHECK(next_event(&event, BUTTONS_DOUBLE_CLICK_MS + 100));
+	CHECK_EQ(event.type, BUTTONS_EVENT_CLICK);
+	CHECK_EQ(event.ts_us, released_ts_us);
+}
+
+static void test_bounce_stamps_the_settled_edge(void) {
+	Buttons_event_type event;
+
+	// Chatter shorter than the debounce, each gap long enough for a scan to see it, then a clean press
+	for (int i = 0; i < 3; ++i) {
+		host_gpio_input(PIN, 0);
+		host_sleep_ms(2);
+		host_gpio_release(PIN);
+		host_sleep_ms(2 * BUTTONS_SCAN_MS);
+	}
+
+	uint64_t press_us = host_now_us();
+	host_gpio_input(PIN, 0);
+
+	// Stamped with the start of the run that settled, not with the first bounce
+	CHECK(next_event(&event, 200));
+	CHECK_EQ(event.type, BUTTONS_EVENT_PRESS);
+	CHECK(stamped_at_edge(&event, press_us, host_now_us()));
+
+	host_gpio_release(PIN);
+	CHECK(next_event(&event, 200));
+	CHECK_EQ(event.type, BUTTONS_EVENT_RELEASE);
+	CHECK(next_event(&event, BUTTONS_DOUBLE_CLICK_MS + 100));
+	CHECK_EQ(event.type, BUTTONS_EVENT_CLICK);
+}
+
+// Runs before the real start: the second handler fails, so the first must come off again
+static void test_start_rolls_back(void) {
+	host_gpio_fail_ISR_add(PIN);
+
+	CHECK_EQ(Buttons_start(), BUTTONS_return_error);
+	CHECK(Buttons_task_handle == NULL);
+	CHECK(!host_gpio_has_ISR(HELD_PIN));
+	CHECK(!host_gpio_has_ISR(PIN));
+}
+
+int main(void) {
+	if (Buttons_add(HELD_PIN, 0) != BUTTONS_return_OK || Buttons_add(PIN, 1) != BUTTONS_return_OK) return 1;
+
+	// Held before the manager starts
+	host_gpio_input(HELD_PIN, 0);
+
+	TEST(test_start_rolls_back);
+
+	started_us = host_now_us();
+	if (Buttons_start() != BUTTONS_return_OK) return 1;
+
+	TEST(test_held_through_boot);
+	TEST(test_edge_timestamps);
+	TEST(test_bounce_stamps_the_settled_edge);
+
+	return TEST_END();
+}
@@ -0,0 +1,118 @@
+// main/Core.c with Wi-Fi, MIC, the WebSocket stream, the link monitor, power-save profiles and the
+// profiler switched on: everything app_main() brings up runs, and the cross-module hooks fire
+
+#define CONFIG_WOXROOX_WIFI 1
+#define CONFIG_WOXROOX_WIFI_LINK 1
+#define CONFIG_WOXROOX_WIFI_PS 1
+#define CONFIG_WOXROOX_MIC 1
+#define CONFIG_WOXROOX_WS 1
+#define CONFIG_WOXROOX_PROFILER 1
+#define CONFIG_WOXROOX_PTT_PIN 27
+
+#include "Core.c"
+
+#include "Test.h"
+#include "host.h"
+
+static bool has_task(const Profiler_sample_type *s, const char *name) {
+	for (int i = 0; i < s->task_count; ++i) {
+		if (strcmp(s->tasks[i].name, name) == 0) return true;
+	}
+
+	return false;
+}
+
+static void test_brought_up(void) {
+	CHECK(WiFi_wait_connected(pdMS_TO_TICKS(3000)));
+	CHECK(host_wait_for(WS_ready, 2000));
+
+	// First sample is taken as the profiler starts
+	Profiler_sample_type sample;
+	CHECK_EQ(Profiler_latest(&sample), 0);
+	CHECK(has_task(&sample, "DLOG"));
+	CHECK(has_task(&sample, "Profiler"));
+
+	CHECK(host_task_find("MIC_RX") != NULL);
+	CHECK(host_task_find("WS_TX") != NULL);
+	CHECK(host_gpio_has_ISR(GPIO_NUM_27));
+
+	CHECK_EQ(WiFi_PS_profile(), WIFI_PS_PROFILE_BALANCED);
+
+	// The monitor publishes within one period, and the link is good
+	WiFi_link_snapshot_type link;
+	CHECK(host_wait_for((WiFi_link_snapshot(&link), link.connected), WIFI_LINK_PERIOD_MS * 2));
+	CHECK_EQ(link.RSSI, -55);
+	CHECK(!WiFi_link_degraded());
+}
+
+static void test_PTT_hooks(void) {
+	host_ws_stats_type before;
+	host_ws_stats(&before);
+
+	// Active-low PTT: press → WS_tx_task gates audio on and WiFi_PS_streaming(true)
+	host_gpio_input(GPIO_NUM_27, 0);
+
+	CHECK(host_wait_for(WiFi_PS_profile() == WIFI_PS_PROFILE_STREAMING, 1000));
+
+	wifi_ps_type_t ps;
+	esp_wifi_get_ps(&ps);
+	CHECK_EQ(ps, WIFI_PS_NONE);
+
+	host_sleep_ms(500);
+
+	host_ws_stats_type during;
+	host_ws_stats(&during);
+	CHECK_EQ(during.PTT - before.PTT, 1);
+	CHECK(during.audio - before.audio >= 10);
+
+	// WS_send() reported every frame to the link monitor
+	WiFi_link_snapshot_type link;
+	uint32_t sequence = WiFi_link_sequence;
+	CHECK(host_wait_for(WiFi_link_sequence != sequence && WiFi_link_sequence != sequence + 1, WIFI_LINK_PERIOD_MS * 2));
+	CHECK(host_wait_for((WiFi_link_snapshot(&link), link.TX_ok > 0), WIFI_LINK_PERIOD_MS * 2));
+	CHECK(link.TX_bytes_per_s > 0);
+	CHECK_EQ(link.TX_failed, 0);
+
+	// Release: audio stops, back to BALANCED
+	host_gpio_release(GPIO_NUM_27);
+
+	CHECK(host_wait_for(WiFi_PS_profile() == WIFI_PS_PROFILE_BALANCED, 1000));
+
+	// WS_tx_task switches the profile first, then sends the end marker
+	host_ws_stats_type after;
+	CHECK(host_wait_for((host_ws_stats(&after), after.PTT - before.PTT == 2), 1000));
+}
+
+static void parked(void *arg) {
+	(void)arg;
+
+	for (;;) vTaskDelay(portMAX_DELAY);
+}
+
+static void test_profiler_sees_every_task(void) {
+	// Past the old 16-slot limit, about what a full device build runs
+	for (int i = 0; i < 12; ++i) {
+		char name[16];
+		snprintf(name, sizeof(name), "parked_%d", i);
+		xTaskCreate(parked, name, 2048, NULL, 1, NULL);
+	}
+
+	CHECK(uxTaskGetNumberOfTasks() > 16);
+
+	Profiler_sample();
+
+	Profiler_sample_type sample;
+	CHECK_EQ(Profiler_latest(&sample), 0);
+	CHECK_EQ(sample.task_count, uxTaskGetNumberOfTasks());
+	CHECK(has_task(&sample, "parked_11"));
+}
+
+int main(void) {
+	app_main();
+
+	TEST(test_brought_up);
+	TEST(test_PTT_hooks);
+	TEST(test_profiler_sees_every_task);
+
+	return TEST_END();
+}
@@ -0,0 +1,78 @@
+// DLOG_print: a record reaches the log in a single write, laid out like ESP_LOGx, so other tasks'
+// lines can never land inside it; an over-long record is cut short but keeps its newline
+
+#include <string.h>
+
+#include "Test.h"
+#include "host.h"
+
+#include "woXrooX/DLOG.h"
+
+////////////// Captured log writes
+
+static int writes;
+static char written[2 * DLOG_LINE_MAX];
+
+static int capture(const char *format, va_list args) {
+	writes++;
+	return vsnprintf(written, sizeof(written), format, args);
+}
+
+static DLOG_record_type record_for(DLOG_site_type *site, uint32_t ts_ms, uint16_t suppressed) {
+	DLOG_record_type r = { .ts_ms = ts_ms, .site = site, .suppressed = suppressed, .argument_count = 2 };
+	r.arguments[0] = (uint32_t)-5;
+	r.arguments[1] = 42;
+
+	return r;
+}
+
+static void test_one_write_per_record(void) {
+	static DLOG_site_type site = { .format = "send_bin failed (%d), seq=%u", .tag = "woXrooX::WS:", .level = ESP_LOG_WARN };
+	DLOG_record_type r = record_for(&site, 1234, 0);
+
+	writes = 0;
+	DLOG_print(&r);
+
+	CHECK_EQ(writes, 1);
+	CHECK(strcmp(written, "W (1234) woXrooX::WS:: send_bin failed (-5), seq=42\n") == 0);
+}
+
+static void test_suppressed_on_same_line(void) {
+	static DLOG_site_type site = { .format = "seq=%u", .tag = "T", .level = ESP_LOG_INFO };
+	DLOG_record_type r = record_for(&site, 7, 3);
+	r.arguments[0] = 9;
+
+	writes = 0;
+	DLOG_print(&r);
+
+	CHECK_EQ(writes, 1);
+	CHECK(strcmp(written, "I (7) T: seq=9 (+3 suppressed)\n") == 0);
+}
+
+static void test_long_record_cut_short(void) {
+	static char format[DLOG_LINE_MAX * 2];
+	memset(format, 'x', sizeof(format) - 1);
+
+	static DLOG_site_type site = { .format = format, .tag = "T", .level = ESP_LOG_ERROR };
+	DLOG_record_type r = record_for(&site, 1, 9);
+
+	writes = 0;
+	DLOG_print(&r);
+
+	CHECK_EQ(writes, 1);
+	CHECK_EQ(strlen(written), DLOG_LINE_MAX - 1);
+	CHECK_EQ(written[DLOG_LINE_MAX - 2], '\n');
+	CHECK(strncmp(written, "E (1) T: xxx", 12) == 0);
+}
+
+int main(void) {
+	esp_log_set_vprintf(capture);
+
+	TEST(test_one_write_per_record);
+	TEST(test_suppressed_on_same_line);
+	TEST(test_long_record_cut_short);
+
+	esp_log_set_vprintf(NULL);
+
+	return TEST_END();
+}
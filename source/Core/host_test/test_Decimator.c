@@ -0,0 +1,151 @@
+// Polyphase decimator: unity DC gain, pass band, stop band, delay, pass-through and limits
+
+#include <math.h>
+
+#include "Test.h"
+
+#include "woXrooX/Decimator.h"
+
+// RMS of the output for a tone fed at rate_in, skipping the filter start-up
+static double tone_rms(uint32_t rate_in, uint32_t rate_out, double frequency_Hz, double amplitude) {
+	static Decimator_type d;
+	Decimator_init(&d, rate_in, rate_out);
+
+	double sum = 0.0;
+	int n = 0;
+
+	for (int i = 0; i < (int)rate_in / 2; ++i) {
+		int16_t y;
+		int16_t x = (int16_t)lround(amplitude * sin(2.0 * M_PI * frequency_Hz * i / rate_in));
+
+		if (!Decimator_push(&d, x, &y)) continue;
+		if (i < 2 * DECIMATOR_TAPS_MAX) continue;
+
+		sum += (double)y * y;
+		n++;
+	}
+
+	return sqrt(sum / n);
+}
+
+static void test_init(void) {
+	static Decimator_type d;
+
+	CHECK_EQ(Decimator_init(&d, 48000, 16000), DECIMATOR_return_OK);
+	CHECK_EQ(d.factor, 3);
+	CHECK_EQ(d.length, 96);
+
+	CHECK_EQ(Decimator_init(&d, 48000, 8000), DECIMATOR_return_OK);
+	CHECK_EQ(d.factor, 6);
+	CHECK_EQ(d.length, DECIMATOR_TAPS_MAX);
+
+	CHECK_EQ(Decimator_init(&d, 48000, 7000), DECIMATOR_return_error);
+	CHECK_EQ(Decimator_init(&d, 48000, 4000), DECIMATOR_return_error);
+	CHECK_EQ(Decimator_init(&d, 48000, 0), DECIMATOR_return_error);
+	CHECK_EQ(Decimator_init(NULL, 48000, 16000), DECIMATOR_return_error);
+}
+
+static void test_taps_sum_to_one(void) {
+	static Decimator_type d;
+	const uint32_t rates[] = { 16000, 12000, 8000 };
+
+	for (int r = 0; r < 3; ++r) {
+		Decimator_init(&d, 48000, rates[r]);
+
+		int32_t sum = 0;
+		for (int k = 0; k < d.length; ++k) sum += d.taps[k];
+		CHECK_EQ(sum, 32768);
+
+		// Linear phase
+		int asymmetric = 0;
+		for (int k = 0; k < d.length / 2 - 1; ++k) if (d.taps[k] != d.taps[d.length - 1 - k]) asymmetric++;
+		CHECK_EQ(asymmetric, 0);
+	}
+}
+
+static void test_DC(void) {
+	static Decimator_type d;
+	Decimator_init(&d, 48000, 16000);
+
+	int16_t y = 0;
+	for (int i = 0; i < 1000; ++i) Decimator_push(&d, 12345, &y);
+
+	CHECK_NEAR(y, 12345, 1);
+}
+
+static void test_pass_band(void) {
+	// 1 kHz at 16 kHz out: within 0.1 dB
+	double rms = tone_rms(48000, 16000, 1000.0, 10000.0);
+	CHECK_NEAR(20.0 * log10(rms / (10000.0 / sqrt(2.0))), 0.0, 0.1);
+
+	// Up to 0.4 × output rate: within 1 dB
+	rms = tone_rms(48000, 16000, 6400.0, 10000.0);
+	CHECK_NEAR(20.0 * log10(rms / (10000.0 / sqrt(2.0))), 0.0, 1.0);
+}
+
+static void test_stop_band(void) {
+	// Above 0.6 × output rate nothing folds back: at least 60 dB down (Blackman: about 74)
+	const double frequencies[] = { 9600.0, 12000.0, 15000.0, 20000.0 };
+
+	for (int i = 0; i < 4; ++i) {
+		double rms = tone_rms(48000, 16000, frequencies[i], 30000.0);
+		double dB = 20.0 * log10((rms + 1e-9) / (30000.0 / sqrt(2.0)));
+		CHECK(dB < -60.0);
+	}
+}
+
+static void test_full_scale(void) {
+	static Decimator_type d;
+	Decimator_init(&d, 48000, 8000);
+
+	// A full-scale square wave at the cut-off rings but must not wrap around
+	int wrapped = 0;
+	int16_t previous = 0;
+
+	for (int i = 0; i < 48000; ++i) {
+		int16_t y;
+		int16_t x = (i / 12) % 2 ? 32767 : -32768;
+
+		if (!Decimator_push(&d, x, &y)) continue;
+		if (i > 1000 && ((previous > 30000 && y < -30000) || (previous < -30000 && y > 30000))) wrapped++;
+		previous = y;
+	}
+
+	CHECK_EQ(wrapped, 0);
+}
+
+static void test_delay_and_pass_through(void) {
+	static Decimator_type d;
+
+	Decimator_init(&d, 48000, 16000);
+	CHECK_EQ(Decimator_delay_us(&d), 95 * 1000000 / (2 * 48000));
+
+	Decimator_init(&d, 16000, 16000);
+	CHECK_EQ(Decimator_delay_us(&d), 0);
+
+	int16_t y = 0;
+	CHECK(Decimator_push(&d, -321, &y));
+	CHECK_EQ(y, -321);
+
+	// Reset clears the history, not the taps
+	Decimator_init(&d, 48000, 16000);
+	for (int i = 0; i < 500; ++i) Decimator_push(&d, 20000, &y);
+	Decimator_reset(&d);
+
+	int outputs = 0;
+	for (int i = 0; i < 3; ++i) outputs += Decimator_push(&d, 0, &y);
+	CHECK_EQ(outputs, 1);
+	CHECK_EQ(y, 0);
+}
+
+int main(void) {
+	TEST(test_init);
+	TEST(test_taps_sum_to_one);
+	TEST(test_DC);
+	TEST(test_pass_band);
+	TEST(test_stop_band);
+	TEST(test_full_scale);
+	TEST(test_delay_and_pass_through);
+
+	return TEST_END();
+}
@@ -0,0 +1,145 @@
+// Broadcast ring: ordering, empty and lapped readers, torn-read detection, and a live writer
+
+#include <pthread.h>
+
+#include "Test.h"
+
+#include "woXrooX/Frame_ring.h"
+
+static Frame_ring_type ring;
+
+static void publish(uint32_t seq) {
+	int16_t pcm[320];
+	for (int i = 0; i < 320; ++i) pcm[i] = (int16_t)(seq + (uint32_t)i);
+
+	Frame_ring_publish(&ring, seq, (uint64_t)seq * 20000, 16000, pcm, 320);
+}
+
+static void test_empty(void) {
+	memset(&ring, 0, sizeof(ring));
+
+	const Frame_ring_slot_type *slot;
+	CHECK_EQ(Frame_ring_head(&ring), 0);
+	CHECK_EQ(Frame_ring_acquire(&ring, 0, &slot), FRAME_RING_return_empty);
+	CHECK_EQ(Frame_ring_acquire(&ring, 1, &slot), FRAME_RING_return_empty);
+}
+
+static void test_in_order(void) {
+	memset(&ring, 0, sizeof(ring));
+
+	uint32_t cursor = Frame_ring_head(&ring) + 1;
+	for (uint32_t seq = 1; seq <= 5; ++seq) publish(seq);
+
+	for (uint32_t seq = 1; seq <= 5; ++seq, ++cursor) {
+		const Frame_ring_slot_type *slot;
+
+		CHECK_EQ(Frame_ring_acquire(&ring, cursor, &slot), FRAME_RING_return_OK);
+		CHECK_EQ(slot->seq, seq);
+		CHECK_EQ(slot->samples, 320);
+		CHECK_EQ(slot->pcm[10], (int16_t)(seq + 10));
+		CHECK(Frame_ring_release(&ring, slot, cursor));
+	}
+
+	const Frame_ring_slot_type *slot;
+	CHECK_EQ(Frame_ring_acquire(&ring, cursor, &slot), FRAME_RING_return_empty);
+}
+
+static void test_lapped(void) {
+	memset(&ring, 0, sizeof(ring));
+
+	for (uint32_t seq = 1; seq <= FRAME_RING_SLOTS * 2; ++seq) publish(seq);
+
+	// A reader FRAME_RING_SLOTS - 1 behind is lapped and jumps to the head
+	const Frame_ring_slot_type *slot;
+	CHECK_EQ(Frame_ring_acquire(&ring, 1, &slot), FRAME_RING_return_lapped);
+	CHECK_EQ(Frame_ring_acquire(&ring, Frame_ring_head(&ring) - (FRAME_RING_SLOTS - 1), &slot), FRAME_RING_return_lapped);
+	CHECK_EQ(Frame_ring_acquire(&ring, Frame_ring_head(&ring), &slot), FRAME_RING_return_OK);
+	CHECK_EQ(slot->seq, FRAME_RING_SLOTS * 2);
+}
+
+static void test_torn(void) {
+	memset(&ring, 0, sizeof(ring));
+	publish(1);
+
+	const Frame_ring_slot_type *slot;
+	CHECK_EQ(Frame_ring_acquire(&ring, 1, &slot), FRAME_RING_return_OK);
+
+	// The writer comes round to the same slot while the reader still holds it
+	for (uint32_t seq = 2; seq <= FRAME_RING_SLOTS + 1; ++seq) publish(seq);
+
+	CHECK(!Frame_ring_release(&ring, slot, 1));
+}
+
+static void test_oversized(void) {
+	memset(&ring, 0, sizeof(ring));
+
+	static int16_t pcm[FRAME_RING_SAMPLES_MAX + 10];
+	Frame_ring_publish(&ring, 1, 0, 16000, pcm, FRAME_RING_SAMPLES_MAX + 10);
+
+	const Frame_ring_slot_type *slot;
+	CHECK_EQ(Frame_ring_acquire(&ring, 1, &slot), FRAME_RING_return_OK);
+	CHECK_EQ(slot->samples, FRAME_RING_SAMPLES_MAX);
+}
+
+static volatile bool writer_done = false;
+
+static void *writer(void *arg) {
+	(void)arg;
+
+	for (uint32_t seq = 1; seq <= 200000; ++seq) publish(seq);
+	__atomic_store_n(&writer_done, true, __ATOMIC_RELEASE);
+
+	return NULL;
+}
+
+static void test_concurrent(void) {
+	memset(&ring, 0, sizeof(ring));
+	writer_done = false;
+
+	pthread_t thread;
+	pthread_create(&thread, NULL, writer, NULL);
+
+	// Whatever the reader sees and then releases successfully must be a consistent frame
+	uint32_t cursor = 1;
+	uint32_t consistent = 0;
+	uint32_t inconsistent = 0;
+
+	while (!__atomic_load_n(&writer_done, __ATOMIC_ACQUIRE)) {
+		const Frame_ring_slot_type *slot;
+
+		switch (Frame_ring_acquire(&ring, cursor, &slot)) {
+			case FRAME_RING_return_OK: {
+				uint32_t seq = slot->seq;
+				int16_t first = slot->pcm[0];
+				int16_t last = slot->pcm[319];
+
+				if (Frame_ring_release(&ring, slot, cursor)) {
+					if (seq == cursor && first == (int16_t)seq && last == (int16_t)(seq + 319)) consistent++;
+					else inconsistent++;
+				}
+
+				cursor++;
+				break;
+			}
+
+			case FRAME_RING_return_empty: break;
+			case FRAME_RING_return_lapped: cursor = Frame_ring_head(&ring); break;
+		}
+	}
+
+	pthread_join(thread, NULL);
+
+	CHECK(consistent > 0);
+	CHECK_EQ(inconsistent, 0);
+}
+
+int main(void) {
+	TEST(test_empty);
+	TEST(test_in_order);
+	TEST(test_lapped);
+	TEST(test_torn);
+	TEST(test_oversized);
+	TEST(test_concurrent);
+
+	return TEST_END();
+}
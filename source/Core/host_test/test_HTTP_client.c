@@ -0,0 +1,187 @@
+// HTTP_client against a local stand-in: keep-alive reuse, TLS accounting, stale-connection retry
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "Test.h"
+#include "host.h"
+#include "Stand_in.h"
+
+#include "woXrooX/HTTP_client.h"
+
+static Stand_in_type *plain;
+static Stand_in_type *secure;
+
+static char plain_URL[64];
+static char secure_URL[64];
+
+static void test_plain_reuse(void) {
+	char *body = NULL;
+	int status = 0;
+	uint32_t reused = Metrics_counter(METRIC_COUNTER_HTTP_reused);
+
+	for (int i = 0; i < 2; ++i) {
+		CHECK_EQ(HTTP_GET(plain_URL, &body, &status), 0);
+		CHECK_EQ(status, 200);
+		CHECK(body && strcmp(body, "ok") == 0);
+		free(body);
+		body = NULL;
+	}
+
+	CHECK_EQ(Stand_in_connections(plain), 1);
+	CHECK_EQ(Metrics_counter(METRIC_COUNTER_HTTP_reused) - reused, 1);
+
+	// No TLS on http://, so nothing for TLS_stats() to count
+	TLS_stats_type stats = TLS_stats();
+	CHECK_EQ(stats.handshakes, 0);
+	CHECK_EQ(stats.reuses, 0);
+}
+
+static void test_secure_reuse(void) {
+	char *body = NULL;
+	int status = 0;
+
+	for (int i = 0; i < 3; ++i) {
+		CHECK_EQ(HTTP_GET(secure_URL, &body, &status), 0);
+		CHECK_EQ(status, 200);
+		free(body);
+		body = NULL;
+	}
+
+	CHECK_EQ(Stand_in_connections(secure), 1);
+
+	TLS_stats_type stats = TLS_stats();
+	CHECK_EQ(stats.handshakes, 1);
+	CHECK_EQ(stats.reuses, 2);
+	CHECK(stats.last_handshake_us > 0);
+}
+
+static void test_chunked(void) {
+	char URL[80];
+	snprintf(URL, sizeof(URL), "%schunked", secure_URL);
+
+	char *body = NULL;
+	int status = 0;
+
+	CHECK_EQ(HTTP_GET(URL, &body, &status), 0);
+	CHECK(body && strcmp(body, "hello world") == 0);
+	free(body);
+
+	// Same origin, same connection
+	CHECK_EQ(Stand_in_connections(secure), 1);
+}
+
+// Exactly HTTP_BODY_MAX is accepted either way; one byte more is refused either way
+static void test_body_limit(void) {
+	static const char *paths[] = { "sized", "chunked" };
+
+	for (int i = 0; i < 2; ++i) {
+		char URL[96];
+		char *body = NULL;
+		int status = 0;
+
+		snprintf(URL, sizeof(URL), "%s%s/%d", plain_URL, paths[i], HTTP_BODY_MAX);
+		CHECK_EQ(HTTP_GET(URL, &body, &status), 0);
+		CHECK_EQ(status, 200);
+		CHECK(body && strlen(body) == HTTP_BODY_MAX);
+		free(body);
+		body = NULL;
+
+		snprintf(URL, sizeof(URL), "%s%s/%d", plain_URL, paths[i], HTTP_BODY_MAX + 1);
+		CHECK_EQ(HTTP_GET(URL, &body, &status), -7);
+		CHECK(body == NULL);
+	}
+}
+
+static void test_stale_GET_retried(void) {
+	Stand_in_close_idle(secure);
+
+	uint32_t requests = Stand_in_requests(secure);
+	char *body = NULL;
+	int status = 0;
+
+	// The cached connection is dead; the GET goes out once more on a new one
+	CHECK_EQ(HTTP_GET(secure_URL, &body, &status), 0);
+	CHECK(body && strcmp(body, "ok") == 0);
+	free(body);
+
+	CHECK_EQ(Stand_in_connections(secure), 2);
+	CHECK_EQ(Stand_in_requests(secure) - requests, 1);
+	CHECK_EQ(TLS_stats().handshakes, 2);
+}
+
+static void test_POST_not_resent(void) {
+	char *body = NULL;
+	int status = 0;
+
+	CHECK_EQ(HTTP_POST_JSON(secure_URL, "{\"n\":1}", &body, &status), 0);
+	CHECK(body && strcmp(body, "{\"n\":1}") == 0);
+	free(body);
+	body = NULL;
+
+	// The server takes the body and hangs up without a reply: the POST may have been acted on,
+	// so it fails instead of going out a second time on a fresh connection
+	uint32_t posts = Stand_in_posts(secure);
+	Stand_in_drop_next_post(secure);
+
+	CHECK_EQ(HTTP_POST_JSON(secure_URL, "{\"n\":2}", &body, &status), -6);
+	CHECK(body == NULL);
+	CHECK_EQ(Stand_in_posts(secure) - posts, 1);
+
+	// Stale at send time: also not re-sent; the next POST opens a new connection
+	CHECK_EQ(HTTP_GET(secure_URL, &body, &status), 0);
+	free(body);
+	body = NULL;
+
+	Stand_in_close_idle(secure);
+	posts = Stand_in_posts(secure);
+
+	CHECK(HTTP_POST_JSON(secure_URL, "{\"n\":3}", &body, &status) != 0);
+	CHECK_EQ(Stand_in_posts(secure) - posts, 0);
+
+	CHECK_EQ(HTTP_POST_JSON(secure_URL, "{\"n\":4}", &body, &status), 0);
+	CHECK_EQ(Stand_in_posts(secure) - posts, 1);
+	free(body);
+}
+
+static void test_close_all(void) {
+	size_t before = host_heap_used();
+
+	HTTP_close_all();
+
+	// Both cached clients gone: the TLS session and the plain one
+	CHECK(host_heap_used() < before);
+
+	char *body = NULL;
+	int status = 0;
+	uint32_t handshakes = TLS_stats().handshakes;
+
+	CHECK_EQ(HTTP_GET(secure_URL, &body, &status), 0);
+	free(body);
+	CHECK_EQ(TLS_stats().handshakes - handshakes, 1);
+}
+
+int main(void) {
+	plain = Stand_in_start(false);
+	secure = Stand_in_start(true);
+	if (!plain || !secure) return 1;
+
+	snprintf(plain_URL, sizeof(plain_URL), "http://127.0.0.1:%u/", Stand_in_port(plain));
+	snprintf(secure_URL, sizeof(secure_URL), "https://127.0.0.1:%u/", Stand_in_port(secure));
+
+	TLS_trust_set_CA(Stand_in_CA_pem(secure), Stand_in_CA_length(secure));
+
+	TEST(test_plain_reuse);
+	TEST(test_secure_reuse);
+	TEST(test_chunked);
+	TEST(test_body_limit);
+	TEST(test_stale_GET_retried);
+	TEST(test_POST_not_resent);
+	TEST(test_close_all);
+
+	HTTP_close_all();
+	Stand_in_stop(plain);
+	Stand_in_stop(secure);
+
+	return TEST_END();
+}
@@ -0,0 +1,348 @@
+// HTTP_server under load over real sockets: every stream client keeps up at the capture rate
+// while /status is hammered from several pollers at once, a client over the limit gets a 503,
+// and no stream socket is ever closed to make room for a poller
+
+#define CONFIG_WOXROOX_HTTP_SERVER_PORT 0
+#define CONFIG_WOXROOX_HTTP_STREAM_CLIENTS 3
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "Test.h"
+#include "host.h"
+
+#include "woXrooX/MIC.h"
+#include "woXrooX/HTTP_server.h"
+
+#define RATE 16000
+
+#define STREAM_MS 1500
+#define POLLERS 8
+#define POLLS 20
+
+// A connection that finds no free slot is closed unanswered; the poller tries again
+#define POLL_ATTEMPTS_MAX 2000
+
+////////////// Client side
+
+static int connect_to_server(void) {
+	int fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (fd < 0) return -1;
+
+	struct timeval timeout = { .tv_sec = 5 };
+	setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+	struct sockaddr_in address = { .sin_family = AF_INET, .sin_port = htons(host_httpd_port(HTTP_server)), .sin_addr.s_addr = htonl(INADDR_LOOPBACK) };
+
+	if (connect(fd, (struct sockaddr *)&address, sizeof(address)) != 0) {
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+static bool send_GET(int fd, const char *path) {
+	char request[128];
+	int n = snprintf(request, sizeof(request), "GET %s HTTP/1.1\r\nHost: woXrooX\r\n\r\n", path);
+
+	return send(fd, request, (size_t)n, MSG_NOSIGNAL) == n;
+}
+
+// Read everything up to EOF; returns the length (0 when the server closed without a reply)
+static size_t read_to_EOF(int fd, char *buffer, size_t size) {
+	size_t length = 0;
+
+	while (length + 1 < size) {
+		ssize_t n = recv(fd, buffer + length, size - 1 - length, 0);
+		if (n <= 0) break;
+		length += (size_t)n;
+	}
+
+	buffer[length] = '\0';
+
+	return length;
+}
+
+////////////// Stream clients
+
+typedef struct {
+	int status;
+	char sample_rate[16];
+
+	uint64_t bytes;
+	uint64_t elapsed_us;
+
+	// The server ended the stream (EOF or reset) before the client hung up
+	bool cut;
+} stream_result_type;
+
+// Read the response head into `head`, leave whatever body bytes came with it in `rest`
+static bool read_head(int fd, char *head, size_t size, size_t *length, char **rest) {
+	*length = 0;
+
+	while (*length + 1 < size) {
+		ssize_t n = recv(fd, head + *length, size - 1 - *length, 0);
+		if (n <= 0) return false;
+
+		*length += (size_t)n;
+		head[*length] = '\0';
+
+		char *end = strstr(head, "\r\n\r\n");
+		if (end) {
+			*rest = end + 4;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void *stream_client(void *arg) {
+	stream_result_type *result = arg;
+
+	int fd = connect_to_server();
+	if (fd < 0 || !send_GET(fd, "/stream.raw")) {
+		result->cut = true;
+		if (fd >= 0) close(fd);
+		return NULL;
+	}
+
+	char buffer[8192];
+	size_t length = 0;
+	char *body = NULL;
+
+	if (!read_head(fd, buffer, sizeof(buffer), &length, &body)) {
+		result->cut = true;
+		close(fd);
+		return NULL;
+	}
+
+	sscanf(buffer, "HTTP/1.1 %d", &result->status);
+
+	const char *rate = strstr(buffer, "X-Sample-Rate: ");
+	if (rate) sscanf(rate + 15, "%15[0-9]", result->sample_rate);
+
+	// Chunked decoding: hex size line, data, CRLF
+	size_t have = length - (size_t)(body - buffer);
+	memmove(buffer, body, have);
+
+	uint64_t start_us = host_now_us();
+	uint64_t chunk_left = 0;
+	bool in_size = true;
+	char size_line[24];
+	size_t size_length = 0;
+
+	while (host_now_us() - start_us < STREAM_MS * 1000ULL) {
+		for (size_t i = 0; i < have; ) {
+			if (in_size) {
+				char c = buffer[i++];
+
+				if (c == '\n') {
+					size_line[size_length] = '\0';
+					chunk_left = strtoull(size_line, NULL, 16);
+					size_length = 0;
+					in_size = false;
+
+					// The data is followed by its own CRLF
+					chunk_left += 2;
+				}
+
+				else if (c != '\r' && size_length + 1 < sizeof(size_line)) size_line[size_length++] = c;
+			}
+
+			else {
+				size_t take = have - i < chunk_left ? have - i : (size_t)chunk_left;
+				chunk_left -= take;
+				i += take;
+
+				result->bytes += take;
+				if (chunk_left == 0) {
+					result->bytes -= 2;
+					in_size = true;
+				}
+			}
+		}
+
+		ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+		if (n <= 0) {
+			result->cut = true;
+			break;
+		}
+
+		have = (size_t)n;
+	}
+
+	result->elapsed_us = host_now_us() - start_us;
+	close(fd);
+
+	return NULL;
+}
+
+////////////// /status pollers
+
+typedef struct {
+	int OK;
+	int bad;
+	int retries;
+} poller_result_type;
+
+static void *status_poller(void *arg) {
+	poller_result_type *result = arg;
+	static __thread char reply[HTTP_STATUS_MAX + 512];
+
+	for (int i = 0; i < POLLS; ++i) {
+		size_t length = 0;
+
+		for (int attempt = 0; attempt < POLL_ATTEMPTS_MAX && length == 0; ++attempt) {
+			int fd = connect_to_server();
+
+			if (fd >= 0 && send_GET(fd, "/status")) length = read_to_EOF(fd, reply, sizeof(reply));
+			if (fd >= 0) close(fd);
+
+			if (length == 0) {
+				result->retries++;
+				host_sleep_ms(1);
+			}
+		}
+
+		// Read to EOF: the server closed the socket itself, right after the reply
+		const char *body = strstr(reply, "\r\n\r\n");
+		const char *content_length = strstr(reply, "Content-Length: ");
+
+		bool OK = length > 0 && strncmp(reply, "HTTP/1.1 200", 12) == 0
+			&& strstr(reply, "Connection: close\r\n") && strstr(reply, "Content-Type: application/json\r\n")
+			&& body && content_length && strtoul(content_length + 16, NULL, 10) == strlen(body + 4)
+			&& body[4] == '{' && reply[length - 1] == '}';
+
+		if (OK) result->OK++;
+		else result->bad++;
+	}
+
+	return NULL;
+}
+
+////////////// Tests
+
+static void test_streams_under_status_load(void) {
+	host_httpd_stats_type before, after;
+	host_httpd_stats(HTTP_server, &before);
+
+	pthread_t streams[HTTP_STREAM_CLIENTS_MAX];
+	stream_result_type stream_results[HTTP_STREAM_CLIENTS_MAX] = { 0 };
+
+	for (int i = 0; i < HTTP_STREAM_CLIENTS_MAX; ++i) pthread_create(&streams[i], NULL, stream_client, &stream_results[i]);
+
+	CHECK(host_wait_for(Metrics_gauge(METRIC_GAUGE_HTTP_stream_clients) == HTTP_STREAM_CLIENTS_MAX, 2000));
+
+	// One stream too many: refused with a hint, and its socket closed
+	int fd = connect_to_server();
+	CHECK(fd >= 0);
+
+	if (fd >= 0) {
+		char reply[512];
+		CHECK(send_GET(fd, "/stream.wav"));
+		CHECK(read_to_EOF(fd, reply, sizeof(reply)) > 0);
+		CHECK(strncmp(reply, "HTTP/1.1 503", 12) == 0);
+		CHECK(strstr(reply, "Retry-After: 5\r\n") != NULL);
+		CHECK(strstr(reply, "Connection: close\r\n") != NULL);
+		close(fd);
+	}
+
+	// Fill the slots left with idle connections: the next one is turned away, and with no LRU purge
+	// it is not a stream (the least recently used sockets) that makes room for it
+	int idle[2];
+	for (int i = 0; i < 2; ++i) idle[i] = connect_to_server();
+	CHECK(host_wait_for((host_httpd_stats(HTTP_server, &after), after.accepted - before.accepted == HTTP_STREAM_CLIENTS_MAX + 1 + 2), 1000));
+
+	fd = connect_to_server();
+	if (fd >= 0) {
+		char reply[512];
+		send_GET(fd, "/status");
+		CHECK_EQ(read_to_EOF(fd, reply, sizeof(reply)), 0);
+		close(fd);
+	}
+
+	for (int i = 0; i < 2; ++i) {
+		if (idle[i] >= 0) close(idle[i]);
+	}
+
+	// Pollers fight over the slots left while the streams run
+	pthread_t pollers[POLLERS];
+	poller_result_type poller_results[POLLERS] = { 0 };
+
+	for (int i = 0; i < POLLERS; ++i) pthread_create(&pollers[i], NULL, status_poller, &poller_results[i]);
+	for (int i = 0; i < POLLERS; ++i) pthread_join(pollers[i], NULL);
+	for (int i = 0; i < HTTP_STREAM_CLIENTS_MAX; ++i) pthread_join(streams[i], NULL);
+
+	int retries = 0;
+
+	for (int i = 0; i < POLLERS; ++i) {
+		CHECK_EQ(poller_results[i].OK, POLLS);
+		CHECK_EQ(poller_results[i].bad, 0);
+		retries += poller_results[i].retries;
+	}
+
+	for (int i = 0; i < HTTP_STREAM_CLIENTS_MAX; ++i) {
+		stream_result_type *s = &stream_results[i];
+		double rate = s->elapsed_us ? (double)s->bytes * 1e6 / (double)s->elapsed_us : 0.0;
+
+		printf("stream %d: %llu B in %.2f s, %.0f B/s\n", i, (unsigned long long)s->bytes, s->elapsed_us / 1e6, rate);
+
+		CHECK_EQ(s->status, 200);
+		CHECK(strcmp(s->sample_rate, "16000") == 0);
+		CHECK(!s->cut);
+
+		// s16le mono at 16 kHz is 32000 B/s; host scheduling takes a little off the edges
+		CHECK(rate >= 0.8 * RATE * sizeof(int16_t));
+	}
+
+	host_httpd_stats(HTTP_server, &after);
+
+	printf("/status: %d requests, %d retries; server refused %u, purged %u\n", POLLERS * POLLS, retries, (unsigned)(after.refused - before.refused), (unsigned)(after.purged - before.purged));
+
+	// Without the LRU purge nothing is ever closed to make room: extra connections are turned away
+	CHECK(after.refused - before.refused >= 1);
+	CHECK_EQ(after.purged - before.purged, 0);
+
+	// Every stream task notices its client is gone and gives the slot back
+	CHECK(host_wait_for(Metrics_gauge(METRIC_GAUGE_HTTP_stream_clients) == 0, 2000));
+}
+
+static void test_status_frees_its_slot(void) {
+	host_httpd_stats_type before;
+	host_httpd_stats(HTTP_server, &before);
+
+	// Back to back on an idle server: each reply closes its socket, so no attempt is ever refused
+	for (int i = 0; i < 50; ++i) {
+		char reply[HTTP_STATUS_MAX + 512];
+		int fd = connect_to_server();
+
+		CHECK(fd >= 0 && send_GET(fd, "/status"));
+		CHECK(read_to_EOF(fd, reply, sizeof(reply)) > 0);
+		if (fd >= 0) close(fd);
+	}
+
+	host_httpd_stats_type after;
+	host_httpd_stats(HTTP_server, &after);
+
+	CHECK_EQ(after.refused - before.refused, 0);
+	CHECK_EQ(after.requests - before.requests, 50);
+}
+
+int main(void) {
+	if (MIC_listen_start() != MIC_return_OK || HTTP_server_start() != 0) return 1;
+
+	// Let the ring fill with a few frames
+	host_sleep_ms(100);
+
+	TEST(test_streams_under_status_load);
+	TEST(test_status_frees_its_slot);
+
+	return TEST_END();
+}
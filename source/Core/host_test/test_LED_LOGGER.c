@@ -0,0 +1,158 @@
+// LED_LOGGER on the LEDC shim: a fade is stopped before anything else drives its channel, so
+// switching off or over mid-fade takes effect at once instead of being lost, and brightness
+// changes race the pattern timer safely
+
+#include <pthread.h>
+
+#include "Test.h"
+#include "host.h"
+
+#include "woXrooX/LED_LOGGER.h"
+
+#define GREEN_CHANNEL 2
+
+static void test_off_mid_fade(void) {
+	host_ledc_stats_type before, after;
+	host_ledc_stats(&before);
+
+	CHECK_EQ(LED_GREEN_pattern(LED_PATTERN_BREATHE), LED_return_OK);
+	host_sleep_ms(400);
+
+	// A quarter into the 1.5 s fade up
+	uint32_t duty = host_ledc_duty(GREEN_CHANNEL);
+	CHECK(duty > 100 && duty < 600);
+
+	CHECK_EQ(LED_GREEN_off(), LED_return_OK);
+	CHECK_EQ(host_ledc_duty(GREEN_CHANNEL), 0);
+
+	// Still off once the fade would have ended
+	host_sleep_ms(1300);
+	CHECK_EQ(host_ledc_duty(GREEN_CHANNEL), 0);
+
+	host_ledc_stats(&after);
+	CHECK_EQ(after.duty_during_fade - before.duty_during_fade, 0);
+	CHECK(after.stops - before.stops >= 1);
+}
+
+static void test_solid_mid_fade(void) {
+	host_ledc_stats_type before, after;
+	host_ledc_stats(&before);
+
+	CHECK_EQ(LED_GREEN_pattern(LED_PATTERN_BREATHE), LED_return_OK);
+	host_sleep_ms(200);
+
+	CHECK_EQ(LED_GREEN_on(0, 0), LED_return_OK);
+	CHECK_EQ(host_ledc_duty(GREEN_CHANNEL), LED_LEDC_DUTY_MAX);
+
+	// Steady LED: brightness applies right away
+	CHECK_EQ(LED_GREEN_brightness(64), LED_return_OK);
+	CHECK_EQ(host_ledc_duty(GREEN_CHANNEL), LED_duty(64, LED_PATTERN_LEVEL_ON));
+
+	host_ledc_stats(&after);
+	CHECK_EQ(after.duty_during_fade - before.duty_during_fade, 0);
+
+	CHECK_EQ(LED_GREEN_brightness(255), LED_return_OK);
+	CHECK_EQ(LED_GREEN_off(), LED_return_OK);
+}
+
+static void test_breathe_segments_back_to_back(void) {
+	host_ledc_stats_type before, after;
+	host_ledc_stats(&before);
+
+	// Each fade starts as the previous one ends: two full breaths
+	CHECK_EQ(LED_GREEN_pattern(LED_PATTERN_BREATHE), LED_return_OK);
+	host_sleep_ms(6100);
+	CHECK_EQ(LED_GREEN_off(), LED_return_OK);
+
+	host_ledc_stats(&after);
+	CHECK(after.fades - before.fades >= 4);
+	CHECK_EQ(after.duty_during_fade - before.duty_during_fade, 0);
+}
+
+static void test_fade_to_same_level(void) {
+	// The second fade targets the level the first one left, then ON holds it without a fade
+	static const uint16_t program[] = {
+		LED_P_FADE(200, 255), LED_P_FADE(200, 255), LED_P_ON(200), LED_P_FADE(200, 0), LED_P_END
+	};
+
+	host_ledc_stats_type before, after;
+	host_ledc_stats(&before);
+	uint32_t transitions = Metrics_counter(METRIC_COUNTER_LED_transitions);
+
+	CHECK_EQ(LED_GREEN_pattern(program), LED_return_OK);
+	CHECK(host_wait_for(!LEDs[2].pattern.running, 2000));
+	host_sleep_ms(250);
+
+	host_ledc_stats(&after);
+
+	// Every segment reached the channel: 3 fades, and the ON in between
+	CHECK_EQ(after.fades - before.fades, 3);
+	CHECK_EQ(Metrics_counter(METRIC_COUNTER_LED_transitions) - transitions, 3);
+	CHECK_EQ(host_ledc_duty(GREEN_CHANNEL), 0);
+
+	CHECK_EQ(LED_GREEN_off(), LED_return_OK);
+}
+
+static volatile bool stop_hammer;
+
+static void *brightness_hammer(void *arg) {
+	(void)arg;
+
+	for (uint32_t i = 0; !stop_hammer; ++i) {
+		LED_GREEN_brightness((uint8_t)(i & 0xFF));
+		host_sleep_ms(1);
+	}
+
+	return NULL;
+}
+
+static void test_brightness_races_timer(void) {
+	stop_hammer = false;
+
+	pthread_t hammer;
+	pthread_create(&hammer, NULL, brightness_hammer, NULL);
+
+	// 10 ms blinks: the timer drives the channel about as often as the hammer writes brightness
+	CHECK_EQ(LED_GREEN_on(10, -1), LED_return_OK);
+	host_sleep_ms(500);
+
+	stop_hammer = true;
+	pthread_join(hammer, NULL);
+
+	// Whatever the interleaving, the last word is the API's
+	CHECK_EQ(LED_GREEN_brightness(128), LED_return_OK);
+	CHECK_EQ(LED_GREEN_on(0, 0), LED_return_OK);
+	CHECK_EQ(host_ledc_duty(GREEN_CHANNEL), LED_duty(128, LED_PATTERN_LEVEL_ON));
+
+	CHECK_EQ(LED_GREEN_off(), LED_return_OK);
+	CHECK_EQ(host_ledc_duty(GREEN_CHANNEL), 0);
+}
+
+static void test_invalid_pattern_refused(void) {
+	static const uint16_t too_deep[] = {
+		LED_P_LOOP, LED_P_LOOP, LED_P_LOOP, LED_P_ON(100), LED_P_REPEAT(2), LED_P_REPEAT(2), LED_P_REPEAT(2), LED_P_END
+	};
+
+	CHECK_EQ(LED_GREEN_on(0, 0), LED_return_OK);
+	uint32_t duty = host_ledc_duty(GREEN_CHANNEL);
+
+	// Refused outright: the LED keeps what it was doing
+	CHECK_EQ(LED_GREEN_pattern(too_deep), LED_return_error);
+	CHECK_EQ(host_ledc_duty(GREEN_CHANNEL), duty);
+	CHECK(duty > 0);
+
+	CHECK_EQ(LED_GREEN_off(), LED_return_OK);
+}
+
+int main(void) {
+	if (LEDs_init() != LED_return_OK) return 1;
+
+	TEST(test_off_mid_fade);
+	TEST(test_solid_mid_fade);
+	TEST(test_breathe_segments_back_to_back);
+	TEST(test_fade_to_same_level);
+	TEST(test_brightness_races_timer);
+	TEST(test_invalid_pattern_refused);
+
+	return TEST_END();
+}
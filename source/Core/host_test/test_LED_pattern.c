@@ -0,0 +1,146 @@
+// LED pattern interpreter on a simulated clock: timing of ON/OFF/FADE, nested loop counts,
+// forever loops, the END level, and programs LED_pattern_valid() rejects
+
+#include "Test.h"
+
+#include "woXrooX/LED_pattern.h"
+
+// Run to `until_ms`, stepping at every deadline; returns how many times the level went to ON
+static int count_on(LED_pattern_state_type *s, uint32_t until_ms) {
+	int on = s->running && s->level == LED_PATTERN_LEVEL_ON;
+
+	while (s->running && !LED_pattern_due(s->next_ms, until_ms)) {
+		uint8_t before = s->level;
+		LED_pattern_step(s, s->next_ms);
+		if (s->running && s->level == LED_PATTERN_LEVEL_ON && before != LED_PATTERN_LEVEL_ON) on++;
+	}
+
+	return on;
+}
+
+static void test_on_off_timing(void) {
+	static const uint16_t program[] = { LED_P_ON(100), LED_P_OFF(250), LED_P_END };
+	LED_pattern_state_type s;
+
+	LED_pattern_start(&s, program, 1000);
+	CHECK(s.running);
+	CHECK_EQ(s.level, LED_PATTERN_LEVEL_ON);
+	CHECK_EQ(s.next_ms, 1100);
+
+	// Not due yet: nothing changes
+	CHECK(LED_pattern_step(&s, 1099));
+	CHECK_EQ(s.level, LED_PATTERN_LEVEL_ON);
+
+	// Late by 30 ms: the next deadline still counts from the planned edge
+	CHECK(LED_pattern_step(&s, 1130));
+	CHECK_EQ(s.level, LED_PATTERN_LEVEL_OFF);
+	CHECK_EQ(s.next_ms, 1350);
+
+	CHECK(!LED_pattern_step(&s, 1350));
+	CHECK_EQ(s.level, LED_PATTERN_LEVEL_OFF);
+}
+
+static void test_fade(void) {
+	static const uint16_t program[] = { LED_P_FADE(1500, 200), LED_P_FADE(500, 0), LED_P_END };
+	LED_pattern_state_type s;
+
+	LED_pattern_start(&s, program, 0);
+	CHECK_EQ(s.level, 200);
+	CHECK_EQ(s.fade_ms, 1500);
+	CHECK_EQ(s.next_ms, 1500);
+
+	CHECK(LED_pattern_step(&s, 1500));
+	CHECK_EQ(s.level, 0);
+	CHECK_EQ(s.fade_ms, 500);
+
+	CHECK(!LED_pattern_step(&s, 2000));
+}
+
+static void test_nested_loops(void) {
+	// 2 short, 1 long, three times over: 9 flashes, ending OFF
+	static const uint16_t program[] = {
+		LED_P_LOOP,
+			LED_P_LOOP, LED_P_ON(150), LED_P_OFF(150), LED_P_REPEAT(2),
+			LED_P_ON(600), LED_P_OFF(1000),
+		LED_P_REPEAT(3), LED_P_END
+	};
+	LED_pattern_state_type s;
+
+	CHECK(LED_pattern_valid(program));
+
+	LED_pattern_start(&s, program, 0);
+	CHECK_EQ(count_on(&s, 100000), 9);
+	CHECK(!s.running);
+	CHECK_EQ(s.level, LED_PATTERN_LEVEL_OFF);
+}
+
+static void test_forever(void) {
+	static const uint16_t program[] = { LED_P_LOOP, LED_P_ON(100), LED_P_OFF(100), LED_P_REPEAT(0), LED_P_END };
+	LED_pattern_state_type s;
+
+	// Clock wraps on the way: the loop keeps going
+	LED_pattern_start(&s, program, 0u - 5000);
+	CHECK_EQ(count_on(&s, 5000), 50);
+	CHECK(s.running);
+}
+
+static void test_valid(void) {
+	static const uint16_t heartbeat[] = { LED_P_LOOP, LED_P_ON(100), LED_P_OFF(100), LED_P_ON(100), LED_P_OFF(700), LED_P_REPEAT(0), LED_P_END };
+	static const uint16_t breathe[] = { LED_P_LOOP, LED_P_FADE(1500, 255), LED_P_FADE(1500, 0), LED_P_REPEAT(0), LED_P_END };
+
+	CHECK(LED_pattern_valid(heartbeat));
+	CHECK(LED_pattern_valid(breathe));
+
+	// The level word is tagged FADE: a level of 0 does not read as END
+	static const uint16_t fade_to_0[] = { LED_P_FADE(100, 0), LED_P_ON(100), LED_P_END };
+	CHECK(LED_pattern_valid(fade_to_0));
+}
+
+static void test_invalid_rejected(void) {
+	// One LOOP deeper than allowed: its REPEAT would run the enclosing loop instead
+	static const uint16_t too_deep[] = {
+		LED_P_LOOP,
+			LED_P_LOOP,
+				LED_P_LOOP, LED_P_ON(100), LED_P_OFF(100), LED_P_REPEAT(2),
+			LED_P_REPEAT(2),
+		LED_P_REPEAT(2), LED_P_END
+	};
+	static const uint16_t stray_repeat[] = { LED_P_ON(100), LED_P_REPEAT(2), LED_P_END };
+	static const uint16_t bad_opcode[] = { LED_P_ON(100), LED_P_OP(0xF, 0), LED_P_END };
+
+	// FADE cut short: its END must not pass for the level, or the scan runs off the array
+	static const uint16_t fade_no_level[] = { LED_P_OP(LED_OP_FADE, 10), LED_P_END };
+	static const uint16_t fade_untagged_level[] = { LED_P_OP(LED_OP_FADE, 10), 200, LED_P_END };
+
+	// Valid opcodes all the way, no END within the limit
+	static uint16_t no_end[LED_PATTERN_MAX_LENGTH + 1];
+	for (int i = 0; i < LED_PATTERN_MAX_LENGTH + 1; ++i) no_end[i] = LED_P_ON(100);
+
+	CHECK(!LED_pattern_valid(too_deep));
+	CHECK(!LED_pattern_valid(stray_repeat));
+	CHECK(!LED_pattern_valid(bad_opcode));
+	CHECK(!LED_pattern_valid(fade_no_level));
+	CHECK(!LED_pattern_valid(fade_untagged_level));
+	CHECK(!LED_pattern_valid(no_end));
+	CHECK(!LED_pattern_valid(NULL));
+
+	// Started anyway, the interpreter stops at the extra LOOP rather than miscounting
+	LED_pattern_state_type s;
+	LED_pattern_start(&s, too_deep, 0);
+	CHECK(!s.running);
+
+	// Or at a FADE with no level word, without reading past it
+	LED_pattern_start(&s, fade_no_level, 0);
+	CHECK(!s.running);
+}
+
+int main(void) {
+	TEST(test_on_off_timing);
+	TEST(test_fade);
+	TEST(test_nested_loops);
+	TEST(test_forever);
+	TEST(test_valid);
+	TEST(test_invalid_rejected);
+
+	return TEST_END();
+}
@@ -0,0 +1,193 @@
+// Log_mel against a double-precision reference (direct DFT, same Hann window and mel triangles):
+// every band of every hop within 0.6 q (0.3 dB), over tones, noise, a chirp, silence and
+// clipping. The cycle cost per hop is in the bench (Log_mel_measure_cost).
+
+#include <stdlib.h>
+
+#include "Test.h"
+
+#include "woXrooX/Log_mel.h"
+
+#define RATE 16000
+#define SECONDS 1
+#define SAMPLES (RATE * SECONDS)
+#define HOPS_MAX (SAMPLES / 160)
+
+// Error bound, in q (0.5 dB steps): rounding to a step is ±0.5, float vs double adds a few hundredths
+#define BOUND_Q 0.6
+
+// Mean over all bands: rounding alone averages 0.25
+#define BOUND_MEAN_Q 0.3
+
+static int16_t pcm[SAMPLES];
+static uint8_t features[HOPS_MAX][LOG_MEL_BANDS];
+static Log_mel_state_type mel;
+
+////////////// Reference
+
+static double reference_mel_from_Hz(double f) {
+	return 2595.0 * log10(1.0 + f / 700.0);
+}
+
+static double reference_mel_to_Hz(double m) {
+	return 700.0 * (pow(10.0, m / 2595.0) - 1.0);
+}
+
+// Unrounded q of each band for the window of `window` samples ending just before pcm + end
+static void reference_hop(const int16_t *signal, size_t end, uint32_t rate, double *q) {
+	int window = (int)(rate * LOG_MEL_WINDOW_MS / 1000);
+	const int16_t *x = signal + end - window;
+
+	double f_max = LOG_MEL_F_MAX;
+	if (f_max > 0.475 * rate) f_max = 0.475 * rate;
+
+	double mel_min = reference_mel_from_Hz(LOG_MEL_F_MIN);
+	double mel_max = reference_mel_from_Hz(f_max);
+	double points[LOG_MEL_BANDS + 2];
+
+	for (int j = 0; j < LOG_MEL_BANDS + 2; ++j) points[j] = reference_mel_to_Hz(mel_min + (mel_max - mel_min) * j / (LOG_MEL_BANDS + 1));
+
+	double energy[LOG_MEL_BANDS] = { 0 };
+
+	for (int k = 0; k < LOG_MEL_BINS; ++k) {
+		double re = 0.0, im = 0.0;
+
+		for (int n = 0; n < window; ++n) {
+			double w = 0.5 - 0.5 * cos(2.0 * M_PI * n / (window - 1));
+			double angle = -2.0 * M_PI * (double)k * n / LOG_MEL_FFT;
+
+			re += x[n] * w * cos(angle);
+			im += x[n] * w * sin(angle);
+		}
+
+		double power = (re * re + im * im) / LOG_MEL_FFT;
+		double f = (double)k * rate / LOG_MEL_FFT;
+
+		// Triangle j rises over [points[j], points[j + 1]) and falls over [points[j + 1], points[j + 2])
+		for (int j = 0; j < LOG_MEL_BANDS; ++j) {
+			if (f >= points[j] && f < points[j + 1]) energy[j] += power * (f - points[j]) / (points[j + 1] - points[j]);
+			else if (f >= points[j + 1] && f < points[j + 2]) energy[j] += power * (points[j + 2] - f) / (points[j + 2] - points[j + 1]);
+		}
+	}
+
+	for (int j = 0; j < LOG_MEL_BANDS; ++j) {
+		double v = 10.0 * log10(energy[j] + 1.0) * LOG_MEL_Q_PER_DB;
+		q[j] = v < 0.0 ? 0.0 : v > 255.0 ? 255.0 : v;
+	}
+}
+
+////////////// Compare
+
+typedef struct {
+	double max_q;
+	double sum_q;
+	uint32_t bands;
+} error_type;
+
+// Run `pcm` through Log_mel in 20 ms frames and check every hop against the reference
+static void compare(const char *name, uint32_t rate, size_t samples, error_type *e) {
+	CHECK_EQ(Log_mel_init(&mel, rate), LOG_MEL_return_OK);
+
+	size_t frame = rate / 50;
+	size_t hop = rate * LOG_MEL_HOP_MS / 1000;
+	size_t window = rate * LOG_MEL_WINDOW_MS / 1000;
+	size_t hops = 0;
+	size_t fed = 0;
+
+	for (; fed + frame <= samples; fed += frame) hops += Log_mel_push(&mel, pcm + fed, frame, features + hops, HOPS_MAX - hops);
+
+	// A vector per hop once the first full window is in: hop i ends at (i + first) × hop
+	size_t first = (window + hop - 1) / hop;
+	CHECK_EQ(hops, fed / hop - first + 1);
+
+	error_type local = { 0 };
+
+	for (size_t i = 0; i < hops; ++i) {
+		double q[LOG_MEL_BANDS];
+		reference_hop(pcm, (i + first) * hop, rate, q);
+
+		for (int b = 0; b < LOG_MEL_BANDS; ++b) {
+			double error = fabs((double)features[i][b] - q[b]);
+
+			if (error > local.max_q) local.max_q = error;
+			local.sum_q += error;
+			local.bands++;
+		}
+	}
+
+	printf("%-24s %3zu hops, error max %.3f q, mean %.3f q\n", name, hops, local.max_q, local.sum_q / local.bands);
+
+	CHECK(local.max_q <= BOUND_Q);
+	CHECK(local.sum_q / local.bands <= BOUND_MEAN_Q);
+
+	if (local.max_q > e->max_q) e->max_q = local.max_q;
+	e->sum_q += local.sum_q;
+	e->bands += local.bands;
+}
+
+static error_type total;
+
+////////////// Tests
+
+static void test_tones(void) {
+	static const double tones_Hz[] = { 100.0, 440.0, 1000.0, 2500.0, 7000.0 };
+	static const double levels[] = { 0.001, 0.05, 0.9 };
+
+	for (size_t t = 0; t < sizeof(tones_Hz) / sizeof(tones_Hz[0]); ++t) {
+		for (size_t l = 0; l < sizeof(levels) / sizeof(levels[0]); ++l) {
+			for (int i = 0; i < SAMPLES / 4; ++i) pcm[i] = (int16_t)lrint(32767.0 * levels[l] * sin(2.0 * M_PI * tones_Hz[t] * i / RATE));
+
+			char name[32];
+			snprintf(name, sizeof(name), "tone %.0f Hz × %.3f", tones_Hz[t], levels[l]);
+			compare(name, RATE, SAMPLES / 4, &total);
+		}
+	}
+}
+
+static void test_noise_and_chirp(void) {
+	uint32_t seed = 12345;
+
+	for (int i = 0; i < SAMPLES; ++i) {
+		seed = seed * 1664525u + 1013904223u;
+		pcm[i] = (int16_t)((int32_t)(seed >> 16) - 32768) / 4;
+	}
+
+	compare("white noise -12 dBFS", RATE, SAMPLES, &total);
+
+	// 50 Hz → 7.9 kHz over one second: every band sees the peak go through
+	double phase = 0.0;
+
+	for (int i = 0; i < SAMPLES; ++i) {
+		double f = 50.0 + (7900.0 - 50.0) * i / SAMPLES;
+		phase += 2.0 * M_PI * f / RATE;
+		pcm[i] = (int16_t)lrint(12000.0 * sin(phase));
+	}
+
+	compare("chirp 50 Hz-7.9 kHz", RATE, SAMPLES, &total);
+}
+
+static void test_edges(void) {
+	// Silence is 0 everywhere
+	memset(pcm, 0, sizeof(pcm));
+	compare("silence", RATE, SAMPLES / 8, &total);
+
+	for (size_t i = 0; i < LOG_MEL_BANDS; ++i) CHECK_EQ(features[0][i], 0);
+
+	// Full-scale square wave: the loudest input there is, harmonics across all bands
+	for (int i = 0; i < SAMPLES / 4; ++i) pcm[i] = (i / 20) % 2 ? 32767 : -32768;
+	compare("square 400 Hz full scale", RATE, SAMPLES / 4, &total);
+
+	// Lower sample rate: band edges pulled below Nyquist, same bound
+	for (int i = 0; i < SAMPLES / 4; ++i) pcm[i] = (int16_t)lrint(8000.0 * sin(2.0 * M_PI * 1234.0 * i / 8000));
+	compare("8 kHz tone 1234 Hz", 8000, SAMPLES / 4, &total);
+}
+
+int main(void) {
+	TEST(test_tones);
+	TEST(test_noise_and_chirp);
+	TEST(test_edges);
+
+	printf("overall: error max %.3f q (%.3f dB), mean %.3f q over %u bands\n", total.max_q, total.max_q / LOG_MEL_Q_PER_DB, total.sum_q / total.bands, (unsigned)total.bands);
+
+	return TEST_END();
+}
@@ -0,0 +1,153 @@
+// Capture chain on the I2S shim: framing, timestamps, level, DMA layout, a runtime change, and the
+// driver refusing one
+
+#include <math.h>
+
+#include "Test.h"
+#include "host.h"
+
+#include "woXrooX/MIC.h"
+
+static MIC_frame_type frame;
+
+static void test_default_capture(void) {
+	uint32_t rate = 0, buffers = 0, words = 0;
+	host_i2s_layout(&rate, &buffers, &words);
+
+	// One DMA buffer per 20 ms frame at 48 kHz, enough of them for MIC_DMA_SLACK_MS
+	CHECK_EQ(rate, MIC_I2S_RATE);
+	CHECK_EQ(words, 960);
+	CHECK_EQ(buffers, 3);
+
+	QueueHandle_t queue = MIC_listen_queue();
+	uint32_t previous_seq = 0;
+	uint64_t previous_ts = 0;
+	uint64_t first_ts = 0;
+	int gaps = 0;
+
+	for (int i = 0; i < 10; ++i) {
+		CHECK(xQueueReceive(queue, &frame, pdMS_TO_TICKS(500)) == pdTRUE);
+		CHECK_EQ(frame.samples, 320);
+		CHECK_EQ(frame.sample_rate, 16000);
+
+		if (previous_seq && frame.seq != previous_seq + 1) gaps++;
+
+		// Back-dated capture times are one frame apart, give or take host scheduling
+		if (previous_ts) CHECK_NEAR((double)(frame.ts_us - previous_ts), 20000.0, 15000.0);
+		else first_ts = frame.ts_us;
+
+		previous_seq = frame.seq;
+		previous_ts = frame.ts_us;
+	}
+
+	CHECK_EQ(gaps, 0);
+
+	// Scheduling noise does not add up: nine intervals span 180 ms
+	CHECK_NEAR((double)(frame.ts_us - first_ts) / 9.0, 20000.0, 1500.0);
+
+	// 1 kHz at 0.02 of 24-bit full scale, >> SHIFT_BITS: peak 20971, RMS 14829
+	double sum = 0.0;
+	for (int i = 0; i < frame.samples; ++i) sum += (double)frame.pcm[i] * frame.pcm[i];
+	CHECK_NEAR(sqrt(sum / frame.samples), 14829.0, 300.0);
+}
+
+static void test_reconfigure(void) {
+	MIC_config_type config = { .sample_rate = 8000, .frame_ms = 10 };
+	CHECK_EQ(MIC_configure(&config), MIC_return_OK);
+
+	MIC_config_type requested;
+	MIC_config(&requested);
+	CHECK_EQ(requested.sample_rate, 8000);
+	CHECK_EQ(requested.frame_ms, 10);
+
+	// Frames already queued keep their own format; the new one shows up within a few frames
+	QueueHandle_t queue = MIC_listen_queue();
+	bool switched = false;
+
+	for (int i = 0; i < 40 && !switched; ++i) {
+		CHECK(xQueueReceive(queue, &frame, pdMS_TO_TICKS(500)) == pdTRUE);
+		switched = frame.sample_rate == 8000;
+	}
+
+	CHECK(switched);
+	CHECK_EQ(frame.samples, 80);
+	CHECK_EQ(host_i2s_channels(), 1);
+
+	config = (MIC_config_type){ .sample_rate = 11025, .frame_ms = 10 };
+	CHECK_EQ(MIC_configure(&config), MIC_return_error);
+
+	config = (MIC_config_type){ .sample_rate = 16000, .frame_ms = 15 };
+	CHECK_EQ(MIC_configure(&config), MIC_return_error);
+}
+
+static void test_timing(void) {
+	MIC_timing_type timing;
+	MIC_timing(&timing);
+
+	CHECK(timing.reads > 0);
+	CHECK_EQ(timing.DMA_overflows, 0);
+	CHECK_EQ(Metrics_counter(METRIC_COUNTER_MIC_frames) > 0, 1);
+}
+
+// Drain what is queued and return the first frame in the format after it
+static bool next_frame_at(uint32_t sample_rate, uint32_t timeout_ms) {
+	QueueHandle_t queue = MIC_listen_queue();
+	uint64_t deadline_us = host_now_us() + (uint64_t)timeout_ms * 1000ULL;
+
+	while (host_now_us() < deadline_us) {
+		if (xQueueReceive(queue, &frame, pdMS_TO_TICKS(100)) == pdTRUE && frame.sample_rate == sample_rate) return true;
+	}
+
+	return false;
+}
+
+static void test_refused_config_rolls_back(void) {
+	// The driver refuses the new channel: MIC_RX keeps capturing at 8 kHz, 10 ms instead of aborting
+	host_i2s_fail_next("i2s_channel_init_std_mode", ESP_ERR_INVALID_ARG);
+
+	MIC_config_type config = { .sample_rate = 16000, .frame_ms = 20 };
+	CHECK_EQ(MIC_configure(&config), MIC_return_OK);
+
+	MIC_config_type active;
+	CHECK(host_wait_for((MIC_config(&active), active.sample_rate == 8000), 1000));
+	CHECK_EQ(active.frame_ms, 10);
+
+	xQueueReset(MIC_listen_queue());
+	CHECK(next_frame_at(8000, 500));
+	CHECK_EQ(frame.samples, 80);
+	CHECK_EQ(host_i2s_channels(), 1);
+
+	// Next time it takes
+	CHECK_EQ(MIC_configure(&config), MIC_return_OK);
+	CHECK(next_frame_at(16000, 1000));
+	CHECK_EQ(frame.samples, 320);
+}
+
+static void test_no_channel_retries(void) {
+	// Neither the new nor the previous config gets a channel: nothing leaks, and MIC_RX tries again
+	host_i2s_fail_next("i2s_channel_enable", ESP_FAIL);
+	host_i2s_fail_next("i2s_new_channel", ESP_ERR_NOT_FOUND);
+
+	MIC_config_type config = { .sample_rate = 8000, .frame_ms = 20 };
+	CHECK_EQ(MIC_configure(&config), MIC_return_OK);
+
+	CHECK(host_wait_for(host_i2s_channels() == 0, 1000));
+
+	// Back after MIC_RETRY_MS on the config that was running
+	xQueueReset(MIC_listen_queue());
+	CHECK(next_frame_at(16000, MIC_RETRY_MS + 1000));
+	CHECK_EQ(frame.samples, 320);
+	CHECK_EQ(host_i2s_channels(), 1);
+}
+
+int main(void) {
+	if (MIC_listen_start() != MIC_return_OK) return 1;
+
+	TEST(test_default_capture);
+	TEST(test_reconfigure);
+	TEST(test_timing);
+	TEST(test_refused_config_rolls_back);
+	TEST(test_no_channel_retries);
+
+	return TEST_END();
+}
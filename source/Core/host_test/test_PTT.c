@@ -0,0 +1,135 @@
+// PTT edge ring: a consumer that falls behind still sees every edge in order up to the overflow,
+// then the newest one, so the gate always ends on the button's real state
+
+#include <pthread.h>
+
+#include "Test.h"
+#include "host.h"
+
+#include "woXrooX/PTT.h"
+
+#define NOW UINT64_MAX
+
+// Take everything before `before_us`; false if timestamps went backwards
+static bool drain(uint64_t before_us, PTT_edge_type *last, int *count) {
+	PTT_edge_type edge;
+	uint64_t previous_us = 0;
+
+	*count = 0;
+
+	while (PTT_edge_take(before_us, &edge)) {
+		if (edge.ts_us < previous_us) return false;
+
+		previous_us = edge.ts_us;
+		*last = edge;
+		(*count)++;
+	}
+
+	return true;
+}
+
+static void test_in_order_within_ring(void) {
+	for (int i = 0; i < PTT_EDGE_RING; ++i) PTT_edge_record(i % 2 == 0, 1000 + i);
+
+	PTT_edge_type last = { 0 };
+	int count = 0;
+
+	CHECK(drain(NOW, &last, &count));
+	CHECK_EQ(count, PTT_EDGE_RING);
+	CHECK_EQ(last.ts_us, 1000 + PTT_EDGE_RING - 1);
+	CHECK_EQ(Metrics_counter(METRIC_COUNTER_PTT_edges_coalesced), 0);
+}
+
+static void test_overflow_keeps_final_release(void) {
+	uint32_t coalesced = Metrics_counter(METRIC_COUNTER_PTT_edges_coalesced);
+
+	// A bouncing burst well past the ring while the sender is stuck, ending released
+	for (int i = 0; i < PTT_EDGE_RING * 3; ++i) PTT_edge_record(i % 2 == 0, 2000 + i);
+
+	CHECK_EQ(Metrics_counter(METRIC_COUNTER_PTT_edges_coalesced) - coalesced, PTT_EDGE_RING * 2);
+
+	PTT_edge_type last = { 0 };
+	int count = 0;
+
+	CHECK(drain(NOW, &last, &count));
+	CHECK_EQ(count, PTT_EDGE_RING + 1);
+	CHECK(!last.active);
+	CHECK_EQ(last.ts_us, 2000 + PTT_EDGE_RING * 3 - 1);
+	CHECK(!get_Button_PTT_FLAG_active());
+
+	// The ring is back in use afterwards
+	PTT_edge_record(true, 9000);
+	CHECK(drain(NOW, &last, &count));
+	CHECK_EQ(count, 1);
+	CHECK(last.active);
+
+	PTT_edge_record(false, 9001);
+	CHECK(drain(NOW, &last, &count));
+}
+
+static void test_coalesced_waits_for_its_frame(void) {
+	for (int i = 0; i <= PTT_EDGE_RING; ++i) PTT_edge_record(i % 2 == 0, 10000 + i * 100);
+
+	// Frames ending before the overflowed edge leave it in place
+	PTT_edge_type last = { 0 };
+	int count = 0;
+
+	CHECK(drain(10000 + PTT_EDGE_RING * 100, &last, &count));
+	CHECK_EQ(count, PTT_EDGE_RING);
+
+	// Newer edges coalesce behind it instead of filling the drained ring ahead of it
+	PTT_edge_record(false, 10000 + PTT_EDGE_RING * 100 + 50);
+
+	CHECK(drain(NOW, &last, &count));
+	CHECK_EQ(count, 1);
+	CHECK(!last.active);
+	CHECK_EQ(last.ts_us, 10000 + PTT_EDGE_RING * 100 + 50);
+}
+
+////////////// Concurrent
+
+#define BURST 200000
+
+static void *button(void *arg) {
+	(void)arg;
+
+	for (uint64_t i = 0; i < BURST; ++i) PTT_edge_record(i % 2 == 0, 100000 + i);
+
+	// Final press: the consumer must end active
+	PTT_edge_record(true, 100000 + BURST);
+
+	return NULL;
+}
+
+static void test_concurrent_burst(void) {
+	pthread_t producer;
+	pthread_create(&producer, NULL, button, NULL);
+
+	PTT_edge_type edge;
+	PTT_edge_type last = { 0 };
+	uint64_t previous_us = 0;
+	int backwards = 0;
+
+	while (last.ts_us != 100000 + BURST) {
+		if (!PTT_edge_take(NOW, &edge)) continue;
+
+		if (edge.ts_us <= previous_us) backwards++;
+		previous_us = edge.ts_us;
+		last = edge;
+	}
+
+	pthread_join(producer, NULL);
+
+	CHECK_EQ(backwards, 0);
+	CHECK(last.active);
+	CHECK(!PTT_edge_take(NOW, &edge));
+}
+
+int main(void) {
+	TEST(test_in_order_within_ring);
+	TEST(test_overflow_keeps_final_release);
+	TEST(test_coalesced_waits_for_its_frame);
+	TEST(test_concurrent_burst);
+
+	return TEST_END();
+}
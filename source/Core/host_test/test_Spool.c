@@ -0,0 +1,204 @@
+// Spool.h on a file-backed "spool" partition with slow erases: pushes from WS_TX never erase
+// (the Spool_erase task does, ahead of the head), a push that catches up waits instead of losing
+// the frame, and everything drains in order with its PTT edges, press and release inside one frame included
+
+#include <math.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "Test.h"
+#include "host.h"
+
+#include "woXrooX/Spool.h"
+
+#define SECTORS 8
+#define RATE 16000
+
+static int16_t pcm[SPOOL_FRAME_SAMPLES];
+
+typedef struct {
+	uint32_t first_seq;
+	uint32_t frames;
+	uint32_t pace_ms;
+
+	uint64_t slowest_us;
+	int failed;
+	volatile bool done;
+} pusher_type;
+
+// Edges for frame `seq`, added the way WS_tx_task does: a press, a press and release, a release and press
+static Spool_PTT_type PTT_for(uint32_t seq) {
+	Spool_PTT_type PTT = { 0 };
+
+	if (seq % 50 == 0) Spool_PTT_add(&PTT, true, 100);
+
+	if (seq % 50 == 25) {
+		Spool_PTT_add(&PTT, true, 40);
+		Spool_PTT_add(&PTT, false, 200);
+	}
+
+	if (seq % 50 == 30) {
+		Spool_PTT_add(&PTT, false, 10);
+		Spool_PTT_add(&PTT, true, 300);
+	}
+
+	return PTT;
+}
+
+// Stands in for WS_tx_task spooling while offline
+static void pusher(void *arg) {
+	pusher_type *p = arg;
+
+	for (uint32_t i = 0; i < p->frames; ++i) {
+		uint32_t seq = p->first_seq + i;
+		Spool_PTT_type PTT = PTT_for(seq);
+
+		uint64_t start_us = host_now_us();
+		if (Spool_push(seq, 1000ULL * 20 * seq, RATE, pcm, SPOOL_FRAME_SAMPLES, &PTT) != SPOOL_return_OK) p->failed++;
+		uint64_t took_us = host_now_us() - start_us;
+
+		if (took_us > p->slowest_us) p->slowest_us = took_us;
+
+		if (p->pace_ms) vTaskDelay(pdMS_TO_TICKS(p->pace_ms));
+	}
+
+	p->done = true;
+	vTaskDelete(NULL);
+}
+
+static void push_from_WS_TX(pusher_type *p) {
+	xTaskCreate(pusher, "WS_TX", 4096, p, 6, NULL);
+	host_wait_for(p->done, 30000);
+}
+
+// Peek/consume everything; true if seqs run from `first` with no gaps and the PTT edges survived
+static bool drain_in_order(uint32_t first, uint32_t count) {
+	Spool_frame_type frame;
+
+	for (uint32_t i = 0; i < count; ++i) {
+		if (Spool_peek(&frame) != SPOOL_return_OK) return false;
+
+		uint32_t seq = first + i;
+		if (frame.seq != seq || frame.samples != SPOOL_FRAME_SAMPLES || frame.sample_rate != RATE) return false;
+		Spool_PTT_type PTT = PTT_for(seq);
+		if (frame.PTT.start_offset != PTT.start_offset || frame.PTT.end_offset != PTT.end_offset) return false;
+		if (frame.PTT.edges != PTT.edges) return false;
+
+		if (Spool_consume() != SPOOL_return_OK) return false;
+	}
+
+	return Spool_peek(&frame) == SPOOL_return_empty;
+}
+
+static void test_push_never_erases(void) {
+	// 4× realtime: a sector fills in ~105 ms, the erase ahead takes 40
+	host_partition_erase_ms(40);
+
+	pusher_type p = { .first_seq = 1, .frames = 100, .pace_ms = 5 };
+	push_from_WS_TX(&p);
+
+	CHECK(p.done);
+	CHECK_EQ(p.failed, 0);
+	CHECK_EQ(host_partition_erases_by("WS_TX"), 0);
+	CHECK(host_partition_erases_by("Spool_erase") >= 100 / SPOOL_RECORDS_PER_SECTOR);
+	CHECK_EQ(Metrics_counter(METRIC_COUNTER_Spool_erase_waits), 0);
+
+	// Writes only: well under one erase
+	CHECK(p.slowest_us < 20000);
+
+	CHECK_EQ(Spool_pending(), 100);
+	CHECK(drain_in_order(1, 100));
+}
+
+static void test_catch_up_waits(void) {
+	// Erase slower than a whole sector of back-to-back pushes: the push waits, nothing is lost
+	host_partition_erase_ms(150);
+	host_wait_for(!Spool_log_erase_needed(&Spool_log), 1000);
+
+	pusher_type p = { .first_seq = 101, .frames = SPOOL_RECORDS_PER_SECTOR * 3 };
+	push_from_WS_TX(&p);
+
+	CHECK(p.done);
+	CHECK_EQ(p.failed, 0);
+	CHECK(Metrics_counter(METRIC_COUNTER_Spool_erase_waits) > 0);
+	CHECK_EQ(host_partition_erases_by("WS_TX"), 0);
+
+	CHECK_EQ(Spool_pending(), p.frames);
+	CHECK(drain_in_order(101, p.frames));
+}
+
+static void test_wrap_keeps_newest(void) {
+	host_partition_erase_ms(5);
+
+	// Two laps while offline: the oldest sectors go, the newest frames stay in order
+	uint32_t frames = SECTORS * SPOOL_RECORDS_PER_SECTOR * 2;
+	pusher_type p = { .first_seq = 1001, .frames = frames, .pace_ms = 1 };
+	push_from_WS_TX(&p);
+
+	CHECK_EQ(p.failed, 0);
+	CHECK_EQ(host_partition_erases_by("WS_TX"), 0);
+
+	uint32_t pending = Spool_pending();
+	CHECK(pending >= (SECTORS - 2) * SPOOL_RECORDS_PER_SECTOR);
+	CHECK(pending <= (SECTORS - 1) * SPOOL_RECORDS_PER_SECTOR);
+	CHECK(drain_in_order(1001 + frames - pending, pending));
+}
+
+static void test_edges_split_with_the_frame(void) {
+	static int16_t long_pcm[SPOOL_FRAME_SAMPLES * 2];
+	Spool_frame_type frame;
+
+	// Press in the first record, release in the second, then a press and release in one record
+	Spool_PTT_type PTT = { 0 };
+	Spool_PTT_add(&PTT, true, 100);
+	Spool_PTT_add(&PTT, false, SPOOL_FRAME_SAMPLES + 50);
+	CHECK_EQ(Spool_push(5000, 0, RATE, long_pcm, SPOOL_FRAME_SAMPLES * 2, &PTT), SPOOL_return_OK);
+
+	PTT = (Spool_PTT_type){ 0 };
+	Spool_PTT_add(&PTT, false, 20);
+	Spool_PTT_add(&PTT, true, 20);
+	CHECK_EQ(Spool_push(5001, 0, RATE, long_pcm, SPOOL_FRAME_SAMPLES, &PTT), SPOOL_return_OK);
+
+	CHECK_EQ(Spool_peek(&frame), SPOOL_return_OK);
+	CHECK_EQ(frame.PTT.edges, SPOOL_PTT_START);
+	CHECK_EQ(frame.PTT.start_offset, 100);
+	CHECK_EQ(Spool_consume(), SPOOL_return_OK);
+
+	CHECK_EQ(Spool_peek(&frame), SPOOL_return_OK);
+	CHECK_EQ(frame.PTT.edges, SPOOL_PTT_END);
+	CHECK_EQ(frame.PTT.end_offset, 50);
+	CHECK_EQ(Spool_consume(), SPOOL_return_OK);
+
+	// Same offset: the order bit still puts the START last, so the gate ends open
+	CHECK_EQ(Spool_peek(&frame), SPOOL_return_OK);
+	CHECK_EQ(frame.PTT.edges, SPOOL_PTT_START | SPOOL_PTT_END | SPOOL_PTT_START_LAST);
+	CHECK(!Spool_PTT_start_first(&frame.PTT));
+	CHECK_EQ(frame.PTT.start_offset, 20);
+	CHECK_EQ(frame.PTT.end_offset, 20);
+	CHECK_EQ(Spool_consume(), SPOOL_return_OK);
+
+	CHECK_EQ(Spool_peek(&frame), SPOOL_return_empty);
+}
+
+int main(void) {
+	for (int i = 0; i < SPOOL_FRAME_SAMPLES; ++i) pcm[i] = (int16_t)(8000.0 * sin(2.0 * M_PI * 440.0 * i / RATE));
+
+	char path[] = "/tmp/woXrooX_spool_XXXXXX";
+	int fd = mkstemp(path);
+	if (fd < 0) return 1;
+	close(fd);
+
+	if (!host_partition_add(SPOOL_PARTITION_LABEL, path, SECTORS * SPOOL_SECTOR_BYTES) || Spool_init() != SPOOL_return_OK) {
+		unlink(path);
+		return 1;
+	}
+
+	TEST(test_push_never_erases);
+	TEST(test_catch_up_waits);
+	TEST(test_wrap_keeps_newest);
+	TEST(test_edges_split_with_the_frame);
+
+	unlink(path);
+
+	return TEST_END();
+}
@@ -0,0 +1,366 @@
+// Spool_log on a file-backed partition that behaves like NOR flash (erase to 0xFF, writes only clear
+// bits, power can be cut in the middle of a write): remount after torn records and after the writer
+// lapped the reader, and erase ahead
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "Test.h"
+
+#include "woXrooX/Spool_log.h"
+
+#define SECTORS 4
+#define CAPACITY (SECTORS * SPOOL_RECORDS_PER_SECTOR)
+
+////////////// File-backed NOR flash
+
+typedef struct {
+	int fd;
+
+	// Bytes the next writes may still put down before the power goes (-1 = no cut)
+	int32_t budget;
+	bool dead;
+
+	uint32_t erases;
+} flash_type;
+
+static int flash_read(void *context, uint32_t offset, void *out, uint32_t length) {
+	flash_type *f = context;
+	if (f->dead) return -1;
+
+	return pread(f->fd, out, length, offset) == (ssize_t)length ? 0 : -1;
+}
+
+static int flash_write(void *context, uint32_t offset, const void *data, uint32_t length) {
+	flash_type *f = context;
+	if (f->dead) return -1;
+
+	uint8_t cell[SPOOL_SECTOR_BYTES];
+	if (length > sizeof(cell) || pread(f->fd, cell, length, offset) != (ssize_t)length) return -1;
+
+	uint32_t written = length;
+	if (f->budget >= 0 && (uint32_t)f->budget < length) written = (uint32_t)f->budget;
+
+	// Programming only turns 1s into 0s
+	for (uint32_t i = 0; i < written; ++i) cell[i] &= ((const uint8_t *)data)[i];
+
+	if (pwrite(f->fd, cell, written, offset) != (ssize_t)written) return -1;
+
+	if (f->budget >= 0) {
+		f->budget -= written;
+
+		if (written < length) {
+			f->dead = true;
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static int flash_erase(void *context, uint32_t offset, uint32_t length) {
+	flash_type *f = context;
+	if (f->dead || offset % SPOOL_SECTOR_BYTES || length % SPOOL_SECTOR_BYTES) return -1;
+
+	uint8_t blank[SPOOL_SECTOR_BYTES];
+	memset(blank, 0xFF, sizeof(blank));
+
+	for (uint32_t at = offset; at < offset + length; at += SPOOL_SECTOR_BYTES) {
+		if (pwrite(f->fd, blank, sizeof(blank), at) != (ssize_t)sizeof(blank)) return -1;
+	}
+
+	f->erases++;
+	return 0;
+}
+
+static char path[] = "/tmp/woXrooX_spool_XXXXXX";
+static flash_type flash;
+static Spool_device_type device = { &flash, SECTORS * SPOOL_SECTOR_BYTES, flash_read, flash_write, flash_erase };
+static Spool_log_type log_;
+
+// Fresh chip: all 0xFF
+static void flash_blank(void) {
+	flash.budget = -1;
+	flash.dead = false;
+	flash.erases = 0;
+
+	CHECK_EQ(flash_erase(&flash, 0, SECTORS * SPOOL_SECTOR_BYTES), 0);
+	flash.erases = 0;
+}
+
+// Power back on: the RAM index is gone, only the file remains
+static int reboot(void) {
+	flash.budget = -1;
+	flash.dead = false;
+
+	return Spool_log_mount(&log_, &device);
+}
+
+static int append(uint32_t seq) {
+	Spool_record_type record = { .seq = seq, .ts_us = 1000000ULL * seq };
+
+	for (int i = 0; i < SPOOL_PAYLOAD_BYTES; ++i) record.payload[i] = (uint8_t)(seq + i);
+
+	return Spool_log_append(&log_, &record);
+}
+
+// Peek and consume everything; true if the seqs are first, first + 1, ... and payloads intact
+static bool drain_in_order(uint32_t first, uint32_t count) {
+	Spool_record_type record;
+
+	for (uint32_t i = 0; i < count; ++i) {
+		if (Spool_log_peek(&log_, &record) != SPOOL_return_OK) return false;
+		if (record.seq != first + i || record.ts_us != 1000000ULL * record.seq) return false;
+		if (record.payload[0] != (uint8_t)record.seq || record.payload[SPOOL_PAYLOAD_BYTES - 1] != (uint8_t)(record.seq + SPOOL_PAYLOAD_BYTES - 1)) return false;
+		if (Spool_log_consume(&log_) != SPOOL_return_OK) return false;
+	}
+
+	return Spool_log_peek(&log_, &record) == SPOOL_return_empty;
+}
+
+////////////// Tests
+
+static void test_remount_keeps_pending(void) {
+	flash_blank();
+	CHECK_EQ(reboot(), SPOOL_return_OK);
+	CHECK_EQ(Spool_log_pending(&log_), 0);
+
+	for (uint32_t seq = 1; seq <= 30; ++seq) CHECK_EQ(append(seq), SPOOL_return_OK);
+
+	// 10 delivered before the reset
+	Spool_record_type record;
+	for (int i = 0; i < 10; ++i) {
+		CHECK_EQ(Spool_log_peek(&log_, &record), SPOOL_return_OK);
+		CHECK_EQ(Spool_log_consume(&log_), SPOOL_return_OK);
+	}
+
+	CHECK_EQ(reboot(), SPOOL_return_OK);
+	CHECK_EQ(Spool_log_pending(&log_), 20);
+	CHECK_EQ(log_.corrupted, 0);
+
+	// Appends carry on after the recovered head
+	CHECK_EQ(append(31), SPOOL_return_OK);
+	CHECK(drain_in_order(11, 21));
+}
+
+static void test_torn_record(void) {
+	flash_blank();
+	CHECK_EQ(reboot(), SPOOL_return_OK);
+
+	for (uint32_t seq = 1; seq <= 5; ++seq) CHECK_EQ(append(seq), SPOOL_return_OK);
+
+	// Power goes 40 bytes into record 6: flags say pending, the CRC does not match
+	flash.budget = 40;
+	CHECK_EQ(append(6), SPOOL_return_device);
+	CHECK(flash.dead);
+
+	CHECK_EQ(reboot(), SPOOL_return_OK);
+	CHECK_EQ(Spool_log_pending(&log_), 5);
+	CHECK_EQ(log_.corrupted, 1);
+
+	// The torn slot is retired on flash: the next mount does not count it again
+	CHECK_EQ(reboot(), SPOOL_return_OK);
+	CHECK_EQ(log_.corrupted, 0);
+	CHECK_EQ(Spool_log_pending(&log_), 5);
+
+	// Writing resumes after the torn slot, nothing is overwritten
+	CHECK_EQ(append(7), SPOOL_return_OK);
+	CHECK_EQ(reboot(), SPOOL_return_OK);
+
+	Spool_record_type record;
+	for (uint32_t seq = 1; seq <= 5; ++seq) {
+		CHECK_EQ(Spool_log_peek(&log_, &record), SPOOL_return_OK);
+		CHECK_EQ(record.seq, seq);
+		CHECK_EQ(Spool_log_consume(&log_), SPOOL_return_OK);
+	}
+
+	CHECK_EQ(Spool_log_peek(&log_, &record), SPOOL_return_OK);
+	CHECK_EQ(record.seq, 7);
+}
+
+static void test_torn_record_at_tail(void) {
+	flash_blank();
+	CHECK_EQ(reboot(), SPOOL_return_OK);
+
+	for (uint32_t seq = 1; seq <= 3; ++seq) CHECK_EQ(append(seq), SPOOL_return_OK);
+
+	// A bit of the oldest record's payload flips to 0 after mount: peek retires it and moves on
+	uint8_t zero = 0x00;
+	CHECK_EQ(flash_write(&flash, Spool_record_offset(0, 0) + SPOOL_RECORD_HEADER + 1, &zero, 1), 0);
+
+	Spool_record_type record;
+	CHECK_EQ(Spool_log_peek(&log_, &record), SPOOL_return_OK);
+	CHECK_EQ(record.seq, 2);
+	CHECK_EQ(log_.corrupted, 1);
+	CHECK_EQ(Spool_log_pending(&log_), 2);
+}
+
+static void test_wrap(void) {
+	flash_blank();
+	CHECK_EQ(reboot(), SPOOL_return_OK);
+	CHECK_EQ(Spool_log_capacity(&log_), CAPACITY);
+
+	// 2.5 laps without the reader: each new sector drops the oldest one whole
+	uint32_t total = CAPACITY * 2 + CAPACITY / 2;
+	for (uint32_t seq = 1; seq <= total; ++seq) CHECK_EQ(append(seq), SPOOL_return_OK);
+
+	uint32_t pending = Spool_log_pending(&log_);
+	CHECK(pending > CAPACITY - SPOOL_RECORDS_PER_SECTOR && pending <= CAPACITY);
+	CHECK_EQ(log_.dropped, total - pending);
+
+	// Every sector was erased once per lap, none more than the others
+	CHECK_EQ(flash.erases, (total + SPOOL_RECORDS_PER_SECTOR - 1) / SPOOL_RECORDS_PER_SECTOR);
+
+	// Recovery finds the newest sector by header seq, and the oldest survivor right after it
+	CHECK_EQ(reboot(), SPOOL_return_OK);
+	CHECK_EQ(Spool_log_pending(&log_), pending);
+	CHECK_EQ(log_.corrupted, 0);
+	CHECK(drain_in_order(total - pending + 1, pending));
+
+	// Empty after a lap: the next mount agrees
+	CHECK_EQ(reboot(), SPOOL_return_OK);
+	CHECK_EQ(Spool_log_pending(&log_), 0);
+	CHECK_EQ(append(total + 1), SPOOL_return_OK);
+	CHECK(drain_in_order(total + 1, 1));
+}
+
+static void test_wrap_torn_head(void) {
+	flash_blank();
+	CHECK_EQ(reboot(), SPOOL_return_OK);
+
+	uint32_t total = CAPACITY + 7;
+	for (uint32_t seq = 1; seq <= total; ++seq) CHECK_EQ(append(seq), SPOOL_return_OK);
+
+	uint32_t pending = Spool_log_pending(&log_);
+
+	// Cut inside the next record after the lap
+	flash.budget = SPOOL_RECORD_BYTES / 2;
+	CHECK_EQ(append(total + 1), SPOOL_return_device);
+
+	CHECK_EQ(reboot(), SPOOL_return_OK);
+	CHECK_EQ(log_.corrupted, 1);
+	CHECK_EQ(Spool_log_pending(&log_), pending);
+	CHECK(drain_in_order(total - pending + 1, pending));
+}
+
+static void test_erase_ahead(void) {
+	flash_blank();
+	CHECK_EQ(reboot(), SPOOL_return_OK);
+
+	// Blank region: sector 0 is erased ahead, so the first append only writes
+	CHECK(Spool_log_erase_needed(&log_));
+	CHECK_EQ(Spool_log_erase_ahead(&log_), SPOOL_return_OK);
+	CHECK_EQ(flash.erases, 1);
+	CHECK(!Spool_log_erase_needed(&log_));
+
+	// Already done: no second erase
+	CHECK_EQ(Spool_log_erase_ahead(&log_), SPOOL_return_OK);
+	CHECK_EQ(flash.erases, 1);
+
+	CHECK_EQ(append(1), SPOOL_return_OK);
+	CHECK_EQ(flash.erases, 1);
+
+	// Keep one sector ahead all the way round: no append ever erases
+	uint32_t seq = 2;
+	for (; seq <= CAPACITY * 2; ++seq) {
+		if (Spool_log_erase_needed(&log_)) CHECK_EQ(Spool_log_erase_ahead(&log_), SPOOL_return_OK);
+
+		uint32_t erases = flash.erases;
+		CHECK_EQ(append(seq), SPOOL_return_OK);
+		CHECK_EQ(flash.erases, erases);
+	}
+
+	// The sector erased ahead is one fewer to hold data
+	uint32_t pending = Spool_log_pending(&log_);
+	CHECK(pending <= CAPACITY - SPOOL_RECORDS_PER_SECTOR);
+	CHECK_EQ(log_.dropped, seq - 1 - pending);
+
+	CHECK_EQ(reboot(), SPOOL_return_OK);
+	CHECK_EQ(Spool_log_pending(&log_), pending);
+	CHECK(drain_in_order(seq - pending, pending));
+}
+
+static void test_erase_split(void) {
+	flash_blank();
+	CHECK_EQ(reboot(), SPOOL_return_OK);
+
+	for (uint32_t seq = 1; seq <= SPOOL_RECORDS_PER_SECTOR; ++seq) CHECK_EQ(append(seq), SPOOL_return_OK);
+
+	// Another task erases between begin and end; until then the head cannot move on
+	uint32_t offset = 0;
+	CHECK_EQ(Spool_log_erase_begin(&log_, &offset), SPOOL_return_OK);
+	CHECK_EQ(offset, SPOOL_SECTOR_BYTES);
+	CHECK_EQ(Spool_log_erase_begin(&log_, &offset), SPOOL_return_empty);
+
+	CHECK_EQ(append(SPOOL_RECORDS_PER_SECTOR + 1), SPOOL_return_busy);
+	CHECK_EQ(Spool_log_pending(&log_), SPOOL_RECORDS_PER_SECTOR);
+
+	// The reader is not affected meanwhile
+	Spool_record_type record;
+	CHECK_EQ(Spool_log_peek(&log_, &record), SPOOL_return_OK);
+	CHECK_EQ(record.seq, 1);
+
+	CHECK_EQ(flash_erase(&flash, offset, SPOOL_SECTOR_BYTES), 0);
+	Spool_log_erase_end(&log_, true);
+
+	uint32_t erases = flash.erases;
+	CHECK_EQ(append(SPOOL_RECORDS_PER_SECTOR + 1), SPOOL_return_OK);
+	CHECK_EQ(flash.erases, erases);
+
+	// A failed erase falls back to erasing inline when the head gets there
+	for (uint32_t seq = SPOOL_RECORDS_PER_SECTOR + 2; seq <= SPOOL_RECORDS_PER_SECTOR * 2; ++seq) CHECK_EQ(append(seq), SPOOL_return_OK);
+
+	CHECK_EQ(Spool_log_erase_begin(&log_, &offset), SPOOL_return_OK);
+	Spool_log_erase_end(&log_, false);
+	CHECK(Spool_log_erase_needed(&log_));
+
+	erases = flash.erases;
+	CHECK_EQ(append(SPOOL_RECORDS_PER_SECTOR * 2 + 1), SPOOL_return_OK);
+	CHECK_EQ(flash.erases, erases + 1);
+
+	CHECK(drain_in_order(1, SPOOL_RECORDS_PER_SECTOR * 2 + 1));
+}
+
+static void test_erase_ahead_drops_oldest(void) {
+	flash_blank();
+	CHECK_EQ(reboot(), SPOOL_return_OK);
+
+	// Full ring: the sector after the head holds the oldest records, and erasing it ahead drops them
+	for (uint32_t seq = 1; seq <= CAPACITY; ++seq) CHECK_EQ(append(seq), SPOOL_return_OK);
+	CHECK_EQ(Spool_log_pending(&log_), CAPACITY);
+
+	CHECK_EQ(Spool_log_erase_ahead(&log_), SPOOL_return_OK);
+	CHECK_EQ(log_.dropped, SPOOL_RECORDS_PER_SECTOR);
+	CHECK_EQ(Spool_log_pending(&log_), CAPACITY - SPOOL_RECORDS_PER_SECTOR);
+
+	Spool_record_type record;
+	CHECK_EQ(Spool_log_peek(&log_, &record), SPOOL_return_OK);
+	CHECK_EQ(record.seq, SPOOL_RECORDS_PER_SECTOR + 1);
+
+	// A reset right after the erase: the blank sector is skipped, the rest recovered
+	CHECK_EQ(reboot(), SPOOL_return_OK);
+	CHECK(drain_in_order(SPOOL_RECORDS_PER_SECTOR + 1, CAPACITY - SPOOL_RECORDS_PER_SECTOR));
+}
+
+int main(void) {
+	flash.fd = mkstemp(path);
+	if (flash.fd < 0) return 1;
+
+	if (ftruncate(flash.fd, SECTORS * SPOOL_SECTOR_BYTES) != 0) return 1;
+
+	TEST(test_remount_keeps_pending);
+	TEST(test_torn_record);
+	TEST(test_torn_record_at_tail);
+	TEST(test_wrap);
+	TEST(test_wrap_torn_head);
+	TEST(test_erase_ahead);
+	TEST(test_erase_split);
+	TEST(test_erase_ahead_drops_oldest);
+
+	close(flash.fd);
+	unlink(path);
+
+	return TEST_END();
+}
@@ -0,0 +1,124 @@
+// Wire format: header layout, every message type, config parsing and PTT sample offsets
+
+#include "Test.h"
+
+#include "woXrooX/WS_protocol.h"
+
+static uint32_t read_32(const uint8_t *p) {
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint64_t read_64(const uint8_t *p) {
+	return (uint64_t)read_32(p) | ((uint64_t)read_32(p + 4) << 32);
+}
+
+static void test_header(void) {
+	uint8_t out[WS_HEADER_BYTES];
+	WS_pack_header(out, WS_TYPE_AUDIO, 16000, 0x1234, 0xA1B2C3D4u, 0x0102030405060708ULL);
+
+	CHECK_EQ(out[0], WS_TYPE_AUDIO);
+	CHECK_EQ(out[1], 16);
+	CHECK_EQ(out[2], 0x34);
+	CHECK_EQ(out[3], 0x12);
+	CHECK_EQ(read_32(out + 4), 0xA1B2C3D4u);
+	CHECK(read_64(out + 8) == 0x0102030405060708ULL);
+}
+
+static void test_audio(void) {
+	int16_t pcm[320];
+	for (int i = 0; i < 320; ++i) pcm[i] = (int16_t)(i * 97 - 15000);
+
+	uint8_t out[WS_AUDIO_BYTES(320)];
+	size_t n = WS_pack_audio(out, 7, 123456789, 16000, pcm, 320);
+
+	CHECK_EQ(n, 656);
+	CHECK_EQ(out[0], WS_TYPE_AUDIO);
+	CHECK_EQ(out[2] | (out[3] << 8), 320);
+	CHECK_EQ(read_32(out + 4), 7);
+	CHECK(read_64(out + 8) == 123456789ULL);
+
+	int16_t back[320];
+	memcpy(back, out + WS_HEADER_BYTES, sizeof(back));
+	CHECK(memcmp(back, pcm, sizeof(pcm)) == 0);
+}
+
+static void test_PTT_marker(void) {
+	uint8_t out[WS_PTT_MARKER_BYTES];
+
+	WS_pack_PTT_marker(out, 9, 5000, 16000, true, 17);
+	CHECK_EQ(out[0], WS_TYPE_PTT);
+	CHECK_EQ(out[2] | (out[3] << 8), 17);
+	CHECK_EQ(out[16], WS_PTT_START);
+	CHECK_EQ(out[17] | out[18] | out[19], 0);
+
+	WS_pack_PTT_marker(out, 10, 6000, 16000, false, 0);
+	CHECK_EQ(out[16], WS_PTT_END);
+}
+
+static void test_spooled(void) {
+	uint8_t adpcm[160];
+	for (int i = 0; i < 160; ++i) adpcm[i] = (uint8_t)i;
+
+	uint8_t out[WS_SPOOLED_BYTES(320)];
+	size_t n = WS_pack_spooled(out, 3, 42, 16000, -1234, 55, adpcm, 320);
+
+	CHECK_EQ(n, 180);
+	CHECK_EQ(out[0], WS_TYPE_SPOOLED);
+	CHECK_EQ((int16_t)(out[16] | (out[17] << 8)), -1234);
+	CHECK_EQ(out[18], 55);
+	CHECK(memcmp(out + 20, adpcm, 160) == 0);
+
+	// Odd sample counts round the payload up
+	CHECK_EQ(WS_SPOOLED_BYTES(81), WS_HEADER_BYTES + 4 + 41);
+}
+
+static void test_features(void) {
+	uint8_t features[2 * 40];
+	for (int i = 0; i < 80; ++i) features[i] = (uint8_t)(255 - i);
+
+	uint8_t out[WS_FEATURES_BYTES(2, 40)];
+	size_t n = WS_pack_features(out, 11, 99, 16000, 2, 40, features);
+
+	CHECK_EQ(n, 100);
+	CHECK_EQ(out[0], WS_TYPE_FEATURES);
+	CHECK_EQ(out[2], 2);
+	CHECK_EQ(out[16], 40);
+	CHECK(memcmp(out + 20, features, 80) == 0);
+}
+
+static void test_config(void) {
+	const uint8_t message[WS_CONFIG_BYTES] = { WS_TYPE_CONFIG, 0, 10, 0, 0x40, 0x1F, 0, 0 };
+	uint32_t rate = 0;
+	uint16_t frame_ms = 0;
+
+	CHECK(WS_parse_config(message, sizeof(message), &rate, &frame_ms));
+	CHECK_EQ(rate, 8000);
+	CHECK_EQ(frame_ms, 10);
+
+	CHECK(!WS_parse_config(message, sizeof(message) - 1, &rate, &frame_ms));
+
+	const uint8_t audio[WS_CONFIG_BYTES] = { WS_TYPE_AUDIO };
+	CHECK(!WS_parse_config(audio, sizeof(audio), &rate, &frame_ms));
+}
+
+static void test_sample_offset(void) {
+	// Before the frame: first sample; inside: by time; past the end: last sample
+	CHECK_EQ(WS_sample_offset(1000000, 999000, 16000, 320), 0);
+	CHECK_EQ(WS_sample_offset(1000000, 1000000, 16000, 320), 0);
+	CHECK_EQ(WS_sample_offset(1000000, 1010000, 16000, 320), 160);
+	CHECK_EQ(WS_sample_offset(1000000, 1019999, 16000, 320), 319);
+	CHECK_EQ(WS_sample_offset(1000000, 1500000, 16000, 320), 319);
+	CHECK_EQ(WS_sample_offset(1000000, 1005000, 8000, 80), 40);
+}
+
+int main(void) {
+	TEST(test_header);
+	TEST(test_audio);
+	TEST(test_PTT_marker);
+	TEST(test_spooled);
+	TEST(test_features);
+	TEST(test_config);
+	TEST(test_sample_offset);
+
+	return TEST_END();
+}
@@ -0,0 +1,228 @@
+// Wi-Fi fast path across reboots: the test runs itself once per boot with NVS in a file, and checks
+// when the cached BSSID/channel/lease is used, that the address stays up on it, that DHCP takes over
+// at T1 or after a disconnect, and the fast-boot count
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "Test.h"
+#include "host.h"
+
+#include "woXrooX/Wifi.h"
+
+typedef struct {
+	int targeted;
+	int scans;
+	int leases;
+	int fast_boots;
+	int DHCP_running;
+	int commits;
+	int connects;
+	int held;
+} boot_type;
+
+static const char *self;
+
+// Cleared if the station was ever without an address from its first GOT_IP on
+static volatile bool address_held = true;
+
+static bool has_address(void) {
+	esp_netif_ip_info_t ip_info;
+	return esp_netif_get_ip_info(WiFi_STA_netif, &ip_info) == ESP_OK && ip_info.ip.addr != 0;
+}
+
+static void got_IP_handler(void *arg, esp_event_base_t event_base, int32_t event_id, void *event_data) {
+	if (!has_address()) address_held = false;
+}
+
+////////////// Child: one boot
+
+// argv: boot [lease] [drop] [renew]
+//   lease: the DHCP server hands out .51 instead of .50
+//   drop:  once settled, the AP drops the station and it reconnects with DHCP
+//   renew: once settled, lease T1 comes (the timer is fired by hand) and DHCP takes over
+static int boot(int argc, char **argv) {
+	bool lease = false, drop = false, renew = false;
+
+	for (int i = 2; i < argc; ++i) {
+		if (strcmp(argv[i], "lease") == 0) lease = true;
+		if (strcmp(argv[i], "drop") == 0) drop = true;
+		if (strcmp(argv[i], "renew") == 0) renew = true;
+	}
+
+	if (lease) host_wifi_DHCP(ESP_IP4TOADDR(192, 168, 1, 51), ESP_IP4TOADDR(255, 255, 255, 0), ESP_IP4TOADDR(192, 168, 1, 1), ESP_IP4TOADDR(192, 168, 1, 1));
+
+	// Registered before WiFi_start() so the first GOT_IP is seen too
+	esp_event_loop_create_default();
+	esp_event_handler_instance_register(IP_EVENT, IP_EVENT_STA_GOT_IP, got_IP_handler, NULL, NULL);
+
+	if (WiFi_start() != 0) return 2;
+	if (!WiFi_wait_connected(pdMS_TO_TICKS(3000))) return 3;
+
+	// Connected means addressed, and it stays that way: no DHCP restart behind the station's back
+	for (int i = 0; i < 200; ++i) {
+		if (!has_address()) address_held = false;
+		host_sleep_ms(1);
+	}
+
+	host_wifi_stats_type stats;
+	uint32_t commits = host_nvs_commits();
+	uint32_t leases = (host_wifi_stats(&stats), stats.DHCP_leases);
+
+	if (drop) {
+		host_wifi_drop();
+		host_wait_for(!WiFi_is_connected(), 1000);
+	}
+
+	if (renew) WiFi_lease_timer_callback(NULL);
+
+	if (drop || renew) {
+		host_wait_for((host_wifi_stats(&stats), stats.DHCP_leases > leases) && WiFi_is_connected(), 3000);
+		host_sleep_ms(20);
+
+		// Taking over the same lease wrote nothing
+		commits = host_nvs_commits() - commits;
+	}
+
+	else commits = 0;
+
+	host_wifi_stats(&stats);
+
+	// Already running: DHCP has the address
+	bool DHCP_running = esp_netif_dhcpc_start(WiFi_STA_netif) == ESP_ERR_ESP_NETIF_DHCP_ALREADY_STARTED;
+
+	printf("boot: %u %u %u %u %d %u %u %d\n", (unsigned)stats.targeted, (unsigned)stats.scans, (unsigned)stats.DHCP_leases, (unsigned)WiFi_cache.fast_boots, DHCP_running, (unsigned)commits, (unsigned)Metrics_counter(METRIC_COUNTER_WiFi_connects), address_held);
+
+	return 0;
+}
+
+////////////// Parent
+
+static bool reboot(const char *arguments, boot_type *out) {
+	char command[512];
+	snprintf(command, sizeof(command), "'%s' boot %s", self, arguments);
+
+	FILE *child = popen(command, "r");
+	if (!child) return false;
+
+	// The child's log lines share stdout with its report
+	char line[256];
+	int n = 0;
+
+	while (fgets(line, sizeof(line), child)) {
+		if (strncmp(line, "boot: ", 6) == 0) n = sscanf(line + 6, "%d %d %d %d %d %d %d %d", &out->targeted, &out->scans, &out->leases, &out->fast_boots, &out->DHCP_running, &out->commits, &out->connects, &out->held);
+	}
+
+	int status = pclose(child);
+
+	return n == 8 && status == 0;
+}
+
+static void test_fast_path_cycle(void) {
+	boot_type b;
+
+	// Nothing cached: scan + DHCP, count starts at 0
+	CHECK(reboot("", &b));
+	CHECK_EQ(b.scans, 1);
+	CHECK_EQ(b.targeted, 0);
+	CHECK_EQ(b.leases, 1);
+	CHECK_EQ(b.fast_boots, 0);
+	CHECK_EQ(b.DHCP_running, 1);
+	CHECK_EQ(b.held, 1);
+
+	// Cached: straight to the BSSID/channel, and online on the cached lease with no DHCP exchange
+	for (int i = 1; i <= WIFI_FAST_PATH_MAX_BOOTS; ++i) {
+		CHECK(reboot("", &b));
+		CHECK_EQ(b.targeted, 1);
+		CHECK_EQ(b.scans, 0);
+		CHECK_EQ(b.leases, 0);
+		CHECK_EQ(b.fast_boots, i);
+		CHECK_EQ(b.DHCP_running, 0);
+		CHECK_EQ(b.held, 1);
+		CHECK_EQ(b.connects, 1);
+	}
+
+	// Limit reached: a full scan, and the count starts over
+	CHECK(reboot("", &b));
+	CHECK_EQ(b.scans, 1);
+	CHECK_EQ(b.targeted, 0);
+	CHECK_EQ(b.fast_boots, 0);
+
+	CHECK(reboot("", &b));
+	CHECK_EQ(b.targeted, 1);
+	CHECK_EQ(b.fast_boots, 1);
+}
+
+static void test_renewal_at_T1(void) {
+	boot_type b;
+
+	// Same lease: DHCP confirms it over the same link, not a second connection
+	CHECK(reboot("renew", &b));
+	CHECK_EQ(b.targeted, 1);
+	CHECK_EQ(b.leases, 1);
+	CHECK_EQ(b.fast_boots, 2);
+	CHECK_EQ(b.DHCP_running, 1);
+	CHECK_EQ(b.held, 1);
+	CHECK_EQ(b.commits, 0);
+	CHECK_EQ(b.connects, 1);
+}
+
+static void test_lease_change_resets(void) {
+	boot_type b;
+
+	// Until T1 the station keeps the cached lease whatever the server would hand out now
+	CHECK(reboot("lease", &b));
+	CHECK_EQ(b.leases, 0);
+	CHECK_EQ(b.fast_boots, 3);
+
+	// DHCP replaced the cached lease: the cache takes the new one and the count restarts
+	CHECK(reboot("lease renew", &b));
+	CHECK_EQ(b.targeted, 1);
+	CHECK_EQ(b.fast_boots, 0);
+	CHECK_EQ(b.DHCP_running, 1);
+
+	CHECK(reboot("lease", &b));
+	CHECK_EQ(b.targeted, 1);
+	CHECK_EQ(b.fast_boots, 1);
+}
+
+static void test_reconnect_keeps_count(void) {
+	boot_type b;
+
+	// Dropped, back with DHCP on the same lease: fast_boots survives and nothing is written to flash
+	CHECK(reboot("lease drop", &b));
+	CHECK_EQ(b.fast_boots, 2);
+	CHECK_EQ(b.leases, 1);
+	CHECK_EQ(b.DHCP_running, 1);
+	CHECK_EQ(b.commits, 0);
+	CHECK_EQ(b.connects, 2);
+
+	CHECK(reboot("lease", &b));
+	CHECK_EQ(b.targeted, 1);
+	CHECK_EQ(b.fast_boots, 3);
+}
+
+int main(int argc, char **argv) {
+	if (argc > 1 && strcmp(argv[1], "boot") == 0) return boot(argc, argv);
+
+	self = argv[0];
+
+	char path[] = "/tmp/woXrooX_NVS_XXXXXX";
+	int fd = mkstemp(path);
+	if (fd < 0) return 1;
+	close(fd);
+	unlink(path);
+
+	setenv("WOXROOX_HOST_NVS", path, 1);
+
+	TEST(test_fast_path_cycle);
+	TEST(test_renewal_at_T1);
+	TEST(test_lease_change_resets);
+	TEST(test_reconnect_keeps_count);
+
+	unlink(path);
+
+	return TEST_END();
+}
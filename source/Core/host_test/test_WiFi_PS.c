@@ -0,0 +1,205 @@
+// Wi-Fi power-save profiles on the simulated station: probe stats, RFC 3550 jitter, deferred
+// listen_interval, concurrent switching, and an idle timer that fires just as streaming starts
+
+#include <stdlib.h>
+
+#include "Test.h"
+#include "host.h"
+
+#include "woXrooX/WiFi_PS.h"
+
+// A probe is WIFI_PS_PROBE_COUNT pings WIFI_PS_PROBE_INTERVAL_MS apart
+#define PROBE_TIMEOUT_MS 4000
+
+static bool probe_done(WiFi_PS_profile_type profile, uint32_t samples) {
+	return host_wait_for(WiFi_PS_stats(profile).samples + WiFi_PS_stats(profile).lost >= samples && WiFi_PS_ping == NULL, PROBE_TIMEOUT_MS);
+}
+
+static void test_probe_stats(void) {
+	// Constant 30 ms under MIN_MODEM: mean = max = 30, no jitter
+	CHECK_EQ(WiFi_PS_start(), 0);
+	CHECK_EQ(WiFi_PS_profile(), WIFI_PS_PROFILE_BALANCED);
+
+	CHECK(probe_done(WIFI_PS_PROFILE_BALANCED, WIFI_PS_PROBE_COUNT));
+
+	WiFi_PS_stats_type s = WiFi_PS_stats(WIFI_PS_PROFILE_BALANCED);
+	CHECK_EQ(s.samples, WIFI_PS_PROBE_COUNT);
+	CHECK_EQ(s.lost, 0);
+	CHECK_EQ(s.RTT_mean_ms, 30);
+	CHECK_EQ(s.RTT_max_ms, 30);
+	CHECK_EQ(s.jitter_ms, 0);
+
+	wifi_ps_type_t ps;
+	esp_wifi_get_ps(&ps);
+	CHECK_EQ(ps, WIFI_PS_MIN_MODEM);
+}
+
+static void test_jitter_RFC3550(void) {
+	// Streaming pinned; its own probe sees a flat 3 ms
+	CHECK_EQ(WiFi_PS_profile_set(WIFI_PS_PROFILE_STREAMING), 0);
+	CHECK(probe_done(WIFI_PS_PROFILE_STREAMING, WIFI_PS_PROBE_COUNT));
+
+	WiFi_PS_stats_type s = WiFi_PS_stats(WIFI_PS_PROFILE_STREAMING);
+	CHECK_EQ(s.RTT_mean_ms, 3);
+	CHECK_EQ(s.jitter_ms, 0);
+
+	// Then a jittery series, against the textbook J += (|D| - J) / 16 in double precision
+	static const uint32_t RTT_ms[] = { 3, 40, 5, 3, 90, 12, 7, 7, 60, 4, 3, 25, 3, 3, 110, 8 };
+	double J = 0.0;
+	double previous = 3.0;
+	uint64_t sum = (uint64_t)s.RTT_mean_ms * s.samples;
+
+	for (size_t i = 0; i < sizeof(RTT_ms) / sizeof(RTT_ms[0]); ++i) {
+		WiFi_PS_record_RTT(RTT_ms[i]);
+
+		J += (fabs((double)RTT_ms[i] - previous) - J) / 16.0;
+		previous = RTT_ms[i];
+		sum += RTT_ms[i];
+	}
+
+	s = WiFi_PS_stats(WIFI_PS_PROFILE_STREAMING);
+
+	// Fixed point keeps 1/16 ms and truncates to whole ms on the way out
+	CHECK_NEAR(s.jitter_ms, J, 1.0);
+	CHECK_EQ(s.RTT_mean_ms, sum / s.samples);
+	CHECK_EQ(s.RTT_max_ms, 110);
+}
+
+static void test_listen_interval_deferred(void) {
+	host_wifi_stats_type before;
+	host_wifi_stats(&before);
+
+	// MAX_MODEM at once; its listen_interval waits for the next association
+	CHECK_EQ(WiFi_PS_profile_set(WIFI_PS_PROFILE_IDLE), 0);
+
+	wifi_ps_type_t ps;
+	esp_wifi_get_ps(&ps);
+	CHECK_EQ(ps, WIFI_PS_MAX_MODEM);
+	CHECK_EQ(WiFi_PS_listen_interval_pending, 10);
+
+	host_wifi_stats_type stats;
+	host_wifi_stats(&stats);
+	CHECK_EQ(stats.listen_interval, before.listen_interval);
+
+	// Link drops and comes back: the new association uses it
+	host_wifi_drop();
+	CHECK(host_wait_for((host_wifi_stats(&stats), stats.associations > before.associations) && WiFi_is_connected(), 3000));
+
+	CHECK_EQ(stats.listen_interval, 10);
+	CHECK_EQ(WiFi_PS_listen_interval_pending, 0);
+
+	// Never rewritten under an association
+	CHECK_EQ(stats.config_while_associated, 0);
+
+	CHECK(probe_done(WIFI_PS_PROFILE_IDLE, WIFI_PS_PROBE_COUNT));
+}
+
+static volatile int switchers_done = 0;
+
+static void switcher(void *arg) {
+	uint32_t seed = (uint32_t)(uintptr_t)arg;
+
+	for (int i = 0; i < 300; ++i) {
+		seed = seed * 1664525u + 1013904223u;
+		WiFi_PS_profile_set((WiFi_PS_profile_type)((seed >> 16) % WIFI_PS_PROFILE_COUNT));
+	}
+
+	__atomic_add_fetch(&switchers_done, 1, __ATOMIC_SEQ_CST);
+	vTaskDelete(NULL);
+}
+
+static void test_concurrent_switching(void) {
+	xTaskCreate(switcher, "switch_a", 3072, (void *)(uintptr_t)1, 5, NULL);
+	xTaskCreate(switcher, "switch_b", 3072, (void *)(uintptr_t)2, 5, NULL);
+
+	CHECK(host_wait_for(switchers_done == 2, 10000));
+
+	// Driver mode and the recorded profile agree however the two interleaved
+	wifi_ps_type_t ps;
+	esp_wifi_get_ps(&ps);
+	CHECK_EQ(ps, WiFi_PS_profiles[WiFi_PS_profile()].ps);
+
+	host_wifi_stats_type stats;
+	host_wifi_stats(&stats);
+	CHECK_EQ(stats.config_while_associated, 0);
+
+	WiFi_PS_auto();
+	CHECK_EQ(WiFi_PS_profile(), WIFI_PS_PROFILE_BALANCED);
+
+	// Let the last probe finish before exit
+	host_wait_for(WiFi_PS_ping == NULL, PROBE_TIMEOUT_MS);
+}
+
+static volatile int idle_callbacks_done = 0;
+
+static void late_idle_timer(void *arg) {
+	(void)arg;
+
+	WiFi_PS_idle_timer_callback(NULL);
+
+	__atomic_add_fetch(&idle_callbacks_done, 1, __ATOMIC_SEQ_CST);
+	vTaskDelete(NULL);
+}
+
+// The idle timer fired and waits for the mutex while another switch holds it
+static void idle_timer_behind(void (*switched)(void)) {
+	int done = idle_callbacks_done;
+
+	xSemaphoreTake(WiFi_PS_mutex, portMAX_DELAY);
+	xTaskCreate(late_idle_timer, "idle_timer", 3072, NULL, 5, NULL);
+	host_sleep_ms(20);
+
+	switched();
+	xSemaphoreGive(WiFi_PS_mutex);
+
+	CHECK(host_wait_for(idle_callbacks_done == done + 1, 1000));
+}
+
+// What WiFi_PS_streaming(true) and WiFi_PS_profile_set() leave behind under the mutex
+static void streaming_started(void) {
+	WiFi_PS_current = WIFI_PS_PROFILE_STREAMING;
+}
+
+static void profile_pinned(void) {
+	WiFi_PS_automatic = false;
+}
+
+static void test_idle_timer_loses_race(void) {
+	WiFi_PS_auto();
+	CHECK_EQ(WiFi_PS_profile(), WIFI_PS_PROFILE_BALANCED);
+
+	// Streaming got in first: the stale timer must not put the modem to sleep under it
+	idle_timer_behind(streaming_started);
+	CHECK_EQ(WiFi_PS_profile(), WIFI_PS_PROFILE_STREAMING);
+
+	WiFi_PS_auto();
+	CHECK_EQ(WiFi_PS_profile(), WIFI_PS_PROFILE_BALANCED);
+
+	// BALANCED pinned: it stays
+	idle_timer_behind(profile_pinned);
+	CHECK_EQ(WiFi_PS_profile(), WIFI_PS_PROFILE_BALANCED);
+
+	// Automatic and still BALANCED when it runs: IDLE as before
+	WiFi_PS_auto();
+	WiFi_PS_idle_timer_callback(NULL);
+	CHECK_EQ(WiFi_PS_profile(), WIFI_PS_PROFILE_IDLE);
+
+	WiFi_PS_auto();
+	host_wait_for(WiFi_PS_ping == NULL, PROBE_TIMEOUT_MS);
+}
+
+int main(void) {
+	host_wifi_RTT(WIFI_PS_NONE, 3000, 0);
+	host_wifi_RTT(WIFI_PS_MIN_MODEM, 30000, 0);
+	host_wifi_RTT(WIFI_PS_MAX_MODEM, 100000, 0);
+
+	if (WiFi_start() != 0 || !WiFi_wait_connected(pdMS_TO_TICKS(3000))) return 1;
+
+	TEST(test_probe_stats);
+	TEST(test_jitter_RFC3550);
+	TEST(test_listen_interval_deferred);
+	TEST(test_concurrent_switching);
+	TEST(test_idle_timer_loses_race);
+
+	return TEST_END();
+}
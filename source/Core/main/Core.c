@@ -1,16 +1,98 @@
+// Modules come from menuconfig (woXrooX → Modules); order matters, later headers hook into earlier ones
+#include "sdkconfig.h"
+
+#include "woXrooX/DLOG.h"
+
+#ifdef CONFIG_WOXROOX_PROFILER
+#include "woXrooX/Profiler.h"
+#endif
+
 #include "woXrooX/LED_LOGGER.h"
-#include "woXrooX/WiFi.h"
 #include "woXrooX/Button.h"
-// #include "woXrooX/MIC.h"
-// #include "woXrooX/WebSocket_client.h"
-// #include "woXrooX/HTTP_client.h"
+
+#ifdef CONFIG_WOXROOX_WIFI
+#include "woXrooX/Wifi.h"
+
+// Before the senders: WebSocket_client.h and HTTP_client.h hook into both when included
+#ifdef CONFIG_WOXROOX_WIFI_LINK
+#include "woXrooX/WiFi_link.h"
+#endif
+
+#ifdef CONFIG_WOXROOX_WIFI_PS
+#include "woXrooX/WiFi_PS.h"
+#endif
+#endif
+
+#ifdef CONFIG_WOXROOX_MIC
+#include "woXrooX/MIC.h"
+#endif
+
+#ifdef CONFIG_WOXROOX_WS
+#include "woXrooX/PTT.h"
+
+#ifdef CONFIG_WOXROOX_SPOOL
+#include "woXrooX/Spool.h"
+#endif
+
+#ifdef CONFIG_WOXROOX_LOG_MEL
+#include "woXrooX/Log_mel.h"
+#endif
+
+#include "woXrooX/WebSocket_client.h"
+#endif
+
+#ifdef CONFIG_WOXROOX_HTTP_CLIENT
+#include "woXrooX/HTTP_client.h"
+#endif
+
+#ifdef CONFIG_WOXROOX_HTTP_SERVER
+#include "woXrooX/HTTP_server.h"
+#endif
 
 void app_main(void) {
+	// Prints what hot paths logged through DLOG_x
+	DLOG_start();
+
+	#ifdef CONFIG_WOXROOX_PROFILER
+	Profiler_start();
+	#endif
+
 	if (LEDs_init() != 0) return;
 
-	// if (init_WiFi() != 0) return;
+	#ifdef CONFIG_WOXROOX_WIFI
+	// Non-blocking: association runs while the rest is brought up
+	if (WiFi_start() != 0) return;
+
+	#ifdef CONFIG_WOXROOX_WIFI_LINK
+	WiFi_link_start();
+	#endif
+
+	#ifdef CONFIG_WOXROOX_WIFI_PS
+	// BALANCED until PTT streams, IDLE after WIFI_PS_IDLE_AFTER_MS
+	WiFi_PS_start();
+	#endif
+	#endif
+
+	#ifdef CONFIG_WOXROOX_MIC
+	MIC_listen_start();
+	#endif
+
+	#ifdef CONFIG_WOXROOX_WS
+	static button_type PTT_button = { .pin = (gpio_num_t)CONFIG_WOXROOX_PTT_PIN };
+
+	PTT_button_attach(&PTT_button);
+	if (Button_ISR_start(&PTT_button) != 0) return;
+
+	#ifdef CONFIG_WOXROOX_SPOOL
+	// Without a "spool" partition the stream still runs, it just drops audio while offline
+	Spool_init();
+	#endif
 
-	// MIC_listen_start();
+	WS_start(MIC_listen_queue());
+	#endif
 
-	// WS_start(MIC_listen_queue());
+	#ifdef CONFIG_WOXROOX_HTTP_SERVER
+	// LAN pull: /stream.wav, /stream.raw, /status
+	HTTP_server_start();
+	#endif
 }